@@ -186,7 +186,7 @@ main(
         // for processing messages on the feedback channel.
         //
         ObjectDeserializationCallback::Mlos::Core::SharedConfigUpdatedFeedbackMessage_Callback =
-            [&waitForConfigMutex, &waitForConfigCondVar,
+            [&mlosContext, &waitForConfigMutex, &waitForConfigCondVar,
              &isConfigReady](Proxy::Mlos::Core::SharedConfigUpdatedFeedbackMessage&& msg)
             {
                 // The contents of the message are irrelevant in this case.
@@ -195,6 +195,11 @@ main(
                 //
                 UNUSED(msg);
 
+                // The agent might have also tuned the shared channel spin
+                // policy, copy the updated thresholds to the channels.
+                //
+                mlosContext.RefreshSharedChannelSpinPolicyConfig();
+
                 // So, we will just notify the waiting loop (below) that the
                 // message has been processed now and is ready to be read.
                 //
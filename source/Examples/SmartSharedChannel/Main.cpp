@@ -88,10 +88,115 @@ main(
     hr = RegisterSmartConfigs(mlosContext);
     CheckHR(hr);
 
-    // Run the benchmark.
+    // Run the benchmark, first sending the messages one by one, then sending them in batches.
+    // Compare the default channel with the single producer single consumer channel.
     //
-    uint64_t messageCount = RunSharedChannelBenchmark(
-        g_SharedChannelConfig,
-        g_MicrobenchmarkConfig);
-    (void)messageCount;
+    ComponentConfig<MicrobenchmarkConfig>& microbenchmarkConfig = g_MicrobenchmarkConfig;
+
+    for (bool useSingleProducerSingleConsumer : { false, true })
+    {
+        for (bool useSendBatch : { false, true })
+        {
+            microbenchmarkConfig.UseSendBatch = useSendBatch;
+            microbenchmarkConfig.UseSingleProducerSingleConsumer = useSingleProducerSingleConsumer;
+
+            uint64_t messageCount = RunSharedChannelBenchmark(
+                g_SharedChannelConfig,
+                microbenchmarkConfig);
+
+            printf(
+                "%s%s: %.0f messages/sec\n",
+                useSendBatch ? "SendBatch" : "SendMessage",
+                useSingleProducerSingleConsumer ? " (single producer single consumer)" : "",
+                static_cast<double>(messageCount) / microbenchmarkConfig.DurationInSec);
+        }
+    }
+
+    microbenchmarkConfig.UseSingleProducerSingleConsumer = false;
+    microbenchmarkConfig.UseSendBatch = false;
+
+    // Compare the regular and the huge pages with a large channel buffer.
+    // The readers walk through the whole buffer, with the regular pages they keep missing the TLB.
+    //
+    ComponentConfig<SharedChannelConfig>& sharedChannelConfig = g_SharedChannelConfig;
+
+    SharedChannelConfig largeBufferConfig = sharedChannelConfig;
+    largeBufferConfig.BufferSize = 64 * 1024 * 1024;
+
+    for (bool useHugePages : { false, true })
+    {
+        microbenchmarkConfig.UseHugePages = useHugePages;
+
+        uint64_t messageCount = RunSharedChannelBenchmark(
+            largeBufferConfig,
+            microbenchmarkConfig);
+
+        printf(
+            "SendMessage (%d MB buffer, %s pages): %.0f messages/sec\n",
+            largeBufferConfig.BufferSize / (1024 * 1024),
+            useHugePages ? "huge" : "regular",
+            static_cast<double>(messageCount) / microbenchmarkConfig.DurationInSec);
+    }
+
+    microbenchmarkConfig.UseHugePages = false;
+
+    // Compare the inline write region fast path with acquiring every write region with the virtual call.
+    //
+    for (bool useVirtualWriteRegion : { true, false })
+    {
+        microbenchmarkConfig.UseVirtualWriteRegion = useVirtualWriteRegion;
+
+        uint64_t messageCount = RunSharedChannelBenchmark(
+            g_SharedChannelConfig,
+            microbenchmarkConfig);
+
+        printf(
+            "SendMessage (%s write region): %.0f messages/sec\n",
+            useVirtualWriteRegion ? "virtual" : "inline",
+            static_cast<double>(messageCount) / microbenchmarkConfig.DurationInSec);
+    }
+
+    microbenchmarkConfig.UseVirtualWriteRegion = false;
+
+    // Compare the CPU time and the latency across the spin policy settings.
+    // Spin: readers never stop spinning. Park: readers park immediately.
+    // Adaptive: the registered config, tuned by MLOS.
+    //
+    ComponentConfig<SharedChannelSpinPolicyConfig>& spinPolicyConfig = g_SpinPolicyConfig;
+
+    SharedChannelSpinPolicyConfig spinOnlyConfig = spinPolicyConfig;
+    spinOnlyConfig.PauseSpinCount = std::numeric_limits<int32_t>::max();
+
+    SharedChannelSpinPolicyConfig parkOnlyConfig = spinPolicyConfig;
+    parkOnlyConfig.PauseSpinCount = 0;
+    parkOnlyConfig.MaxBackoffPauseCount = 0;
+    parkOnlyConfig.YieldCount = 0;
+
+    const std::pair<const char*, SharedChannelSpinPolicyConfig> spinPolicySettings[] =
+    {
+        { "Spin", spinOnlyConfig },
+        { "Adaptive", spinPolicyConfig },
+        { "Park", parkOnlyConfig },
+    };
+
+    for (const auto& spinPolicySetting : spinPolicySettings)
+    {
+        SharedChannelSpinPolicy::UpdateConfig(spinPolicySetting.second);
+
+        SpinPolicyBenchmarkResult result = RunSpinPolicyBenchmark(
+            g_SharedChannelConfig,
+            microbenchmarkConfig);
+
+        printf(
+            "%s spin policy: %.1f%% cpu, %.1f us average latency, %.1f us max latency (%llu probes)\n",
+            spinPolicySetting.first,
+            result.CpuUtilization * 100,
+            result.AverageLatencyInMicroseconds,
+            result.MaxLatencyInMicroseconds,
+            static_cast<unsigned long long>(result.ProbeCount));
+    }
+
+    // Restore the registered spin policy settings.
+    //
+    SharedChannelSpinPolicy::UpdateConfig(spinPolicyConfig);
 }
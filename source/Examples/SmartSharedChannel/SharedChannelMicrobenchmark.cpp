@@ -16,6 +16,12 @@
 #include "stdafx.h"
 
 #include <assert.h>
+#include <chrono>
+#include <thread>
+
+#ifndef _WIN64
+#include <time.h>
+#endif
 
 // Define retail assert.
 //
@@ -35,6 +41,116 @@ void assert_failed(
 //
 StaticSingleton<ComponentConfig<SharedChannelConfig>> g_SharedChannelConfig;
 StaticSingleton<ComponentConfig<MicrobenchmarkConfig>> g_MicrobenchmarkConfig;
+StaticSingleton<ComponentConfig<SharedChannelSpinPolicyConfig>> g_SpinPolicyConfig;
+
+//----------------------------------------------------------------------------
+// NAME: SteadyClockNanoseconds
+//
+// PURPOSE:
+//  Gets the current time of the steady clock.
+//
+// RETURNS:
+//  Time in nanoseconds.
+//
+// NOTES:
+//
+static uint64_t SteadyClockNanoseconds()
+{
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+//----------------------------------------------------------------------------
+// NAME: ProcessCpuTimeNanoseconds
+//
+// PURPOSE:
+//  Gets the CPU time consumed by all the threads of the current process.
+//
+// RETURNS:
+//  CPU time (user and kernel) in nanoseconds.
+//
+// NOTES:
+//
+static uint64_t ProcessCpuTimeNanoseconds()
+{
+#ifdef _WIN64
+    FILETIME creationTime;
+    FILETIME exitTime;
+    FILETIME kernelTime;
+    FILETIME userTime;
+
+    if (!GetProcessTimes(GetCurrentProcess(), &creationTime, &exitTime, &kernelTime, &userTime))
+    {
+        return 0;
+    }
+
+    // FILETIME is in 100 nanosecond intervals.
+    //
+    const uint64_t kernelTime100ns = (static_cast<uint64_t>(kernelTime.dwHighDateTime) << 32) | kernelTime.dwLowDateTime;
+    const uint64_t userTime100ns = (static_cast<uint64_t>(userTime.dwHighDateTime) << 32) | userTime.dwLowDateTime;
+
+    return (kernelTime100ns + userTime100ns) * 100;
+#else
+    timespec cpuTime;
+
+    if (clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &cpuTime) != 0)
+    {
+        return 0;
+    }
+
+    return static_cast<uint64_t>(cpuTime.tv_sec) * 1000000000 + static_cast<uint64_t>(cpuTime.tv_nsec);
+#endif
+}
+
+//----------------------------------------------------------------------------
+// NAME: VirtualWriteRegionSharedChannel<TSharedChannel>
+//
+// PURPOSE:
+//  Shared channel sending the messages as the send path did before the inline write region fast path.
+//
+// NOTES:
+//  SendMessageWithVirtualWriteRegion is ISharedChannel::SendMessage, except that every write region
+//  is acquired with the virtual AcquireWriteRegionForFrame call.
+//  The interface pointer is read from a volatile variable, so the compiler cannot devirtualize and inline the call.
+//
+template<typename TSharedChannel>
+class VirtualWriteRegionSharedChannel : public TSharedChannel
+{
+public:
+    using TSharedChannel::TSharedChannel;
+
+    template<typename TMessage>
+    void SendMessageWithVirtualWriteRegion(const TMessage& msg)
+    {
+        ISharedChannel* volatile channelInterface = this;
+
+        int32_t frameLength = this->CalculateFrameLength(msg);
+
+        uint32_t writeOffset = channelInterface->AcquireWriteRegionForFrame(frameLength, ISharedChannel::InfiniteTimeout);
+
+        if (writeOffset == std::numeric_limits<uint32_t>::max())
+        {
+            // The write has been terminated or the channel dropped the message, ignore the send.
+            //
+            if (!this->Sync.TerminateChannel.load(std::memory_order_relaxed))
+            {
+                channelInterface->MessagesDropped(TypeMetadataInfo::CodegenTypeIndex<TMessage>(), 1);
+            }
+
+            return;
+        }
+
+        this->Frame(writeOffset).Length.store(frameLength | 1, std::memory_order_relaxed);
+        this->PublishWriteRegion(frameLength);
+
+        this->WriteFrame(writeOffset, frameLength, msg);
+
+        if (this->HasReadersInWaitingState())
+        {
+            channelInterface->NotifyExternalReader();
+        }
+    }
+};
 
 //----------------------------------------------------------------------------
 // NAME: RegisterSmartConfigs
@@ -73,6 +189,11 @@ HRESULT RegisterSmartConfigs(MlosContext& mlosContext)
 
         microbenchmarkConfig.WriterCount = 1;
         microbenchmarkConfig.DurationInSec = 10;
+        microbenchmarkConfig.UseSendBatch = false;
+        microbenchmarkConfig.UseSingleProducerSingleConsumer = false;
+        microbenchmarkConfig.LatencyProbeIntervalInMicroseconds = 1000;
+        microbenchmarkConfig.UseHugePages = false;
+        microbenchmarkConfig.UseVirtualWriteRegion = false;
 
         HRESULT hr = mlosContext.RegisterComponentConfig(microbenchmarkConfig);
         if (FAILED(hr))
@@ -83,21 +204,45 @@ HRESULT RegisterSmartConfigs(MlosContext& mlosContext)
         g_MicrobenchmarkConfig.Initialize(std::move(microbenchmarkConfig));
     }
 
+    // Shared channel spin policy config.
+    // The context has already registered it, the lookup returns the thresholds used by the channels.
+    //
+    {
+        ComponentConfig<SharedChannelSpinPolicyConfig> spinPolicyConfig(mlosContext);
+
+        static_cast<SharedChannelSpinPolicyConfig&>(spinPolicyConfig) = SharedChannelSpinPolicy::CurrentConfig();
+
+        HRESULT hr = mlosContext.RegisterComponentConfig(spinPolicyConfig);
+        if (FAILED(hr))
+        {
+            return hr;
+        }
+
+        g_SpinPolicyConfig.Initialize(std::move(spinPolicyConfig));
+    }
+
     return S_OK;
 }
 
 //----------------------------------------------------------------------------
-// NAME: RunSharedChannelBenchmark
+// NAME: RunSharedChannelBenchmark<TSharedChannel>
 //
 // PURPOSE:
-//  Run the shared channel benchmark.
+//  Run the shared channel benchmark using the given channel type.
 //
 // RETURNS:
-//  Toal number of messages send durning the benchmark run.
+//  Total number of messages sent during the benchmark run.
 //
 // NOTES:
+//  Each writer iteration sends five messages, either one by one or as a single batch.
+//  The messages sent one by one acquire the write region with the inline fast path,
+//  or with the virtual call (VirtualWriteRegionSharedChannel).
+//  The channel buffer is a shared memory view, optionally backed by huge pages.
 //
-uint64_t RunSharedChannelBenchmark(
+template<typename TSharedChannel>
+static uint64_t RunSharedChannelBenchmark(
+    int32_t readerCount,
+    int32_t writerCount,
     const SharedChannelConfig& sharedChannelConfig,
     const MicrobenchmarkConfig& microbenchmarkConfig)
 {
@@ -130,12 +275,16 @@ uint64_t RunSharedChannelBenchmark(
             rtl_assert(point3d.Z == z);
         };
 
-    std::vector<byte> vectorBuffer;
-    vectorBuffer.resize(sharedChannelConfig.BufferSize);
+    SharedMemoryMapView channelMemoryMapView;
+    channelMemoryMapView.UseHugePages = microbenchmarkConfig.UseHugePages;
+
+    HRESULT hr = channelMemoryMapView.Create("Host_SmartSharedChannel.Microbenchmark", sharedChannelConfig.BufferSize);
+    CheckHR(hr);
+
+    channelMemoryMapView.CleanupOnClose = true;
 
-    BytePtr buffer(&vectorBuffer.front());
     ChannelSynchronization sync = { 0 };
-    TestSharedChannel sharedChannel(sync, buffer, sharedChannelConfig.BufferSize);
+    VirtualWriteRegionSharedChannel<TSharedChannel> sharedChannel(sync, channelMemoryMapView.Buffer, sharedChannelConfig.BufferSize);
 
     // Setup deserialize callbacks to verify received objects.
     //
@@ -147,9 +296,8 @@ uint64_t RunSharedChannelBenchmark(
             sharedChannel.Sync.TerminateChannel.store(true);
         };
 
-    // Setup writers.
+    // Setup readers.
     //
-    int32_t readerCount = sharedChannelConfig.ReaderCount;
     std::vector<std::future<bool>> readers;
     readers.reserve(readerCount);
 
@@ -172,29 +320,48 @@ uint64_t RunSharedChannelBenchmark(
 
     // Setup writers.
     //
-    std::vector<std::future<uint32_t>> writers;
-    writers.reserve(microbenchmarkConfig.WriterCount);
+    std::vector<std::future<uint64_t>> writers;
+    writers.reserve(writerCount);
+
+    const bool useSendBatch = microbenchmarkConfig.UseSendBatch;
+    const bool useVirtualWriteRegion = microbenchmarkConfig.UseVirtualWriteRegion;
 
-    for (int i = 0; i < microbenchmarkConfig.WriterCount; i++)
+    for (int i = 0; i < writerCount; i++)
     {
         writers.push_back(
             std::async(
                 std::launch::async,
-                [&sharedChannel, &point, &point3d]
+                [&sharedChannel, &point, &point3d, useSendBatch, useVirtualWriteRegion]
         {
-            uint32_t i = 0;
+            uint64_t messageCount = 0;
 
             while (!sharedChannel.Sync.TerminateChannel.load(std::memory_order_relaxed))
             {
-                sharedChannel.SendMessage(point3d);
-                sharedChannel.SendMessage(point3d);
-                sharedChannel.SendMessage(point3d);
-                sharedChannel.SendMessage(point);
-                sharedChannel.SendMessage(point);
-                i++;
+                if (useSendBatch)
+                {
+                    sharedChannel.SendBatch(point3d, point3d, point3d, point, point);
+                }
+                else if (useVirtualWriteRegion)
+                {
+                    sharedChannel.SendMessageWithVirtualWriteRegion(point3d);
+                    sharedChannel.SendMessageWithVirtualWriteRegion(point3d);
+                    sharedChannel.SendMessageWithVirtualWriteRegion(point3d);
+                    sharedChannel.SendMessageWithVirtualWriteRegion(point);
+                    sharedChannel.SendMessageWithVirtualWriteRegion(point);
+                }
+                else
+                {
+                    sharedChannel.SendMessage(point3d);
+                    sharedChannel.SendMessage(point3d);
+                    sharedChannel.SendMessage(point3d);
+                    sharedChannel.SendMessage(point);
+                    sharedChannel.SendMessage(point);
+                }
+
+                messageCount += 5;
             }
 
-            return i;
+            return messageCount;
         }));
     }
 
@@ -215,7 +382,7 @@ uint64_t RunSharedChannelBenchmark(
     // Wait for the writers to join.
     //
     uint64_t writeMessageCount = 0;
-    for (std::future<uint32_t>& waiter : writers)
+    for (std::future<uint64_t>& waiter : writers)
     {
         writeMessageCount += waiter.get();
     }
@@ -233,3 +400,153 @@ uint64_t RunSharedChannelBenchmark(
 
     return writeMessageCount;
 }
+
+//----------------------------------------------------------------------------
+// NAME: RunSharedChannelBenchmark
+//
+// PURPOSE:
+//  Run the shared channel benchmark.
+//
+// RETURNS:
+//  Total number of messages sent during the benchmark run.
+//
+// NOTES:
+//  The single producer single consumer channel always runs with one writer and one reader thread.
+//
+uint64_t RunSharedChannelBenchmark(
+    const SharedChannelConfig& sharedChannelConfig,
+    const MicrobenchmarkConfig& microbenchmarkConfig)
+{
+    if (microbenchmarkConfig.UseSingleProducerSingleConsumer)
+    {
+        return RunSharedChannelBenchmark<SingleProducerSingleConsumerTestSharedChannel>(
+            1 /* readerCount */,
+            1 /* writerCount */,
+            sharedChannelConfig,
+            microbenchmarkConfig);
+    }
+
+    return RunSharedChannelBenchmark<TestSharedChannel>(
+        sharedChannelConfig.ReaderCount,
+        microbenchmarkConfig.WriterCount,
+        sharedChannelConfig,
+        microbenchmarkConfig);
+}
+
+//----------------------------------------------------------------------------
+// NAME: RunSpinPolicyBenchmark
+//
+// PURPOSE:
+//  Measures the CPU time and the latency of the shared channel with the current spin policy settings.
+//
+// RETURNS:
+//  Number of the received probes, the latency and the CPU utilization.
+//
+// NOTES:
+//  A single writer sends the latency probes with a fixed interval, so the readers are idle most of the time.
+//  The spin policy decides how fast the readers notice a new frame and how much CPU time they burn while waiting.
+//
+SpinPolicyBenchmarkResult RunSpinPolicyBenchmark(
+    const SharedChannelConfig& sharedChannelConfig,
+    const MicrobenchmarkConfig& microbenchmarkConfig)
+{
+    std::atomic<uint64_t> probeCount(0);
+    std::atomic<uint64_t> totalLatency(0);
+    std::atomic<uint64_t> maxLatency(0);
+
+    // Setup receiver handler to measure the latency.
+    // Handler will be called from the receiver thread.
+    //
+    ObjectDeserializationCallback::SmartSharedChannel::LatencyProbeMessage_Callback =
+        [&probeCount, &totalLatency, &maxLatency](Proxy::SmartSharedChannel::LatencyProbeMessage&& recvProbe)
+        {
+            const uint64_t latency = SteadyClockNanoseconds() - recvProbe.SendTimestamp();
+
+            probeCount.fetch_add(1, std::memory_order_relaxed);
+            totalLatency.fetch_add(latency, std::memory_order_relaxed);
+
+            uint64_t currentMaxLatency = maxLatency.load(std::memory_order_relaxed);
+            while (latency > currentMaxLatency && !maxLatency.compare_exchange_weak(currentMaxLatency, latency))
+            {
+            }
+        };
+
+    std::vector<byte> vectorBuffer;
+    vectorBuffer.resize(sharedChannelConfig.BufferSize);
+
+    BytePtr buffer(&vectorBuffer.front());
+    ChannelSynchronization sync = { 0 };
+    TestSharedChannel sharedChannel(sync, buffer, sharedChannelConfig.BufferSize);
+
+    ObjectDeserializationCallback::Mlos::Core::TerminateReaderThreadRequestMessage_Callback =
+        [&sharedChannel](Proxy::Mlos::Core::TerminateReaderThreadRequestMessage&&)
+        {
+            // Stop the read thread
+            //
+            sharedChannel.Sync.TerminateChannel.store(true);
+        };
+
+    const uint64_t startCpuTime = ProcessCpuTimeNanoseconds();
+    const uint64_t startTime = SteadyClockNanoseconds();
+
+    // Setup readers.
+    //
+    int32_t readerCount = sharedChannelConfig.ReaderCount;
+    std::vector<std::future<bool>> readers;
+    readers.reserve(readerCount);
+
+    for (int i = 0; i < readerCount; i++)
+    {
+        readers.push_back(
+            std::async(
+                std::launch::async,
+                [&sharedChannel]
+        {
+            auto globalDispatchTable = GlobalDispatchTable();
+
+            sharedChannel.ProcessMessages(globalDispatchTable.data(), globalDispatchTable.size());
+
+            return true;
+        }));
+    }
+
+    // Send the probes from the current thread.
+    //
+    const uint64_t duration = static_cast<uint64_t>(microbenchmarkConfig.DurationInSec) * 1000000000;
+    const std::chrono::microseconds probeInterval(microbenchmarkConfig.LatencyProbeIntervalInMicroseconds);
+
+    while (SteadyClockNanoseconds() - startTime < duration)
+    {
+        SmartSharedChannel::LatencyProbeMessage probe;
+        probe.SendTimestamp = SteadyClockNanoseconds();
+
+        sharedChannel.SendMessage(probe);
+
+        std::this_thread::sleep_for(probeInterval);
+    }
+
+    // Stop the readers.
+    //
+    sharedChannel.SendMessage(Mlos::Core::TerminateReaderThreadRequestMessage());
+
+    for (std::future<bool>& reader : readers)
+    {
+        reader.get();
+    }
+
+    const uint64_t cpuTime = ProcessCpuTimeNanoseconds() - startCpuTime;
+    const uint64_t elapsedTime = SteadyClockNanoseconds() - startTime;
+
+    SpinPolicyBenchmarkResult result = { 0 };
+    result.ProbeCount = probeCount.load();
+
+    if (result.ProbeCount != 0)
+    {
+        result.AverageLatencyInMicroseconds = static_cast<double>(totalLatency.load()) / result.ProbeCount / 1000;
+        result.MaxLatencyInMicroseconds = static_cast<double>(maxLatency.load()) / 1000;
+    }
+
+    result.CpuUtilization = static_cast<double>(cpuTime) / elapsedTime;
+
+    return result;
+}
@@ -46,6 +46,49 @@ namespace SmartSharedChannel
         /// </summary>
         [ScalarSetting]
         internal int WriterCount;
+
+        /// <summary>
+        /// If true, writers send the messages in batches instead of one by one.
+        /// </summary>
+        [ScalarSetting]
+        internal bool UseSendBatch;
+
+        /// <summary>
+        /// If true, the benchmark uses the single producer single consumer channel with one writer and one reader thread.
+        /// </summary>
+        [ScalarSetting]
+        internal bool UseSingleProducerSingleConsumer;
+
+        /// <summary>
+        /// Interval between the latency probes sent by the spin policy benchmark, in microseconds.
+        /// </summary>
+        [ScalarSetting]
+        internal int LatencyProbeIntervalInMicroseconds;
+
+        /// <summary>
+        /// If true, the channel buffer is backed by huge pages.
+        /// </summary>
+        [ScalarSetting]
+        internal bool UseHugePages;
+
+        /// <summary>
+        /// If true, writers acquire every write region with the virtual call instead of the inline fast path.
+        /// </summary>
+        [ScalarSetting]
+        internal bool UseVirtualWriteRegion;
+    }
+
+    /// <summary>
+    /// A message sent by the spin policy benchmark to measure the channel latency.
+    /// </summary>
+    [CodegenMessage]
+    internal partial struct LatencyProbeMessage
+    {
+        /// <summary>
+        /// Time when the message was sent, in nanoseconds (steady clock).
+        /// </summary>
+        [ScalarSetting]
+        internal ulong SendTimestamp;
     }
 
     // <summary>
@@ -37,6 +37,25 @@ using namespace SmartSharedChannel;
 //
 extern StaticSingleton<ComponentConfig<SharedChannelConfig>> g_SharedChannelConfig;
 extern StaticSingleton<ComponentConfig<MicrobenchmarkConfig>> g_MicrobenchmarkConfig;
+extern StaticSingleton<ComponentConfig<SharedChannelSpinPolicyConfig>> g_SpinPolicyConfig;
+
+// Result of the spin policy benchmark.
+//
+struct SpinPolicyBenchmarkResult
+{
+    // Number of the received latency probes.
+    //
+    uint64_t ProbeCount;
+
+    // Average and maximum latency of the probes.
+    //
+    double AverageLatencyInMicroseconds;
+    double MaxLatencyInMicroseconds;
+
+    // Process CPU time divided by the duration of the benchmark.
+    //
+    double CpuUtilization;
+};
 
 // Functions declarations.
 //
@@ -45,3 +64,6 @@ HRESULT RegisterSmartConfigs(MlosContext& mlosContext);
 uint64_t RunSharedChannelBenchmark(
     const SharedChannelConfig& sharedChannelConfig,
     const MicrobenchmarkConfig& microbenchmarkConfig);
+SpinPolicyBenchmarkResult RunSpinPolicyBenchmark(
+    const SharedChannelConfig& sharedChannelConfig,
+    const MicrobenchmarkConfig& microbenchmarkConfig);
@@ -28,10 +28,16 @@ namespace Mlos.Agent.Server
         /// <param name="args">The input arguments to parse.</param>
         /// <param name="executablePath">The path to the executable found in the cli args.</param>
         /// <param name="optimizerUri">The optimizer uri found in the cli args.</param>
-        public static void ParseArgs(string[] args, out string executablePath, out Uri optimizerUri)
+        /// <param name="instanceName">The MlosContext instance name found in the cli args.</param>
+        /// <param name="printLatencyStats">True if the telemetry channel latencies should be printed instead of running the agent.</param>
+        /// <param name="anonymousSocketPath">The socket path to accept the anonymous shared memory from, found in the cli args.</param>
+        public static void ParseArgs(string[] args, out string executablePath, out Uri optimizerUri, out string instanceName, out bool printLatencyStats, out string anonymousSocketPath)
         {
             string executableFilePath = null;
             Uri optimizerAddressUri = null;
+            string contextInstanceName = null;
+            bool latencyStats = false;
+            string anonymousSharedMemorySocketPath = null;
 
             IEnumerable<string> extraArgs = null;
 
@@ -41,6 +47,9 @@ namespace Mlos.Agent.Server
                 {
                     executableFilePath = parsedOptions.Executable;
                     optimizerAddressUri = parsedOptions.OptimizerUri;
+                    contextInstanceName = parsedOptions.InstanceName;
+                    latencyStats = parsedOptions.LatencyStats;
+                    anonymousSharedMemorySocketPath = parsedOptions.AnonymousSocket;
                     extraArgs = parsedOptions.ExtraArgs;
                 });
             if (cliOptsParseResult.Tag == ParserResultType.NotParsed)
@@ -54,6 +63,10 @@ namespace Mlos.Agent.Server
             {
                 ShowUsageHelp(cliOptsParseResult, msg: "ERROR: Unknown arguments: " + string.Join(" ", extraArgs));
             }
+            else if (anonymousSharedMemorySocketPath != null && (executableFilePath != null || contextInstanceName != null))
+            {
+                ShowUsageHelp(cliOptsParseResult, msg: "ERROR: --anonymous-socket cannot be combined with --executable or --instance-name.");
+            }
 
             cliOptsParser.Dispose();
 
@@ -61,6 +74,9 @@ namespace Mlos.Agent.Server
             //
             executablePath = executableFilePath;
             optimizerUri = optimizerAddressUri;
+            instanceName = contextInstanceName;
+            printLatencyStats = latencyStats;
+            anonymousSocketPath = anonymousSharedMemorySocketPath;
         }
 
         /// <summary>
@@ -127,6 +143,22 @@ namespace Mlos.Agent.Server
                         "    dotnet Mlos.Agent.Server.dll --executable path/to/executable --optimizer-uri http://localhost:50051",
                         string.Empty,
 
+                        "To attach to an application that uses a named MlosContext instance, add the --instance-name option "
+                        + "to any of the usage modes. Run one agent per instance.",
+                        "    dotnet Mlos.Agent.Server.dll --instance-name SmartCache.1234",
+                        string.Empty,
+
+                        "To print the telemetry channel latency percentiles of a running application and exit, use the --latency-stats "
+                        + "option. The application must enable the latency histograms (MlosContext::EnableTelemetryChannelLatencyStats).",
+                        "    dotnet Mlos.Agent.Server.dll --latency-stats --instance-name SmartCache.1234",
+                        string.Empty,
+
+                        "To accept the anonymous shared memory from an application which calls "
+                        + "InterProcessMlosContextInitializer::InitializeAnonymous (Linux only), use the --anonymous-socket option. "
+                        + "The application defines the instance name and the channel sizes.",
+                        "    dotnet Mlos.Agent.Server.dll --anonymous-socket @SmartCache.1234",
+                        string.Empty,
+
                         "Note: the optimizer service used in these examples can be started using the 'start_optimizer_microservice "
                         + "launch --port 50051' command from the mlos Python module.",
                     });
@@ -147,6 +179,15 @@ namespace Mlos.Agent.Server
             [Option("optimizer-uri", Required = false, Default = null, HelpText = "A URI to connect to the MLOS Optimizer service over GRPC (e.g. 'http://localhost:50051').")]
             public Uri OptimizerUri { get; set; }
 
+            [Option("instance-name", Required = false, Default = null, HelpText = "A name of the MlosContext instance to attach to (e.g. 'SmartCache.1234'), uses the default instance if not set.")]
+            public string InstanceName { get; set; }
+
+            [Option("latency-stats", Required = false, Default = false, HelpText = "Print the telemetry channel latency percentiles of a running application and exit.")]
+            public bool LatencyStats { get; set; }
+
+            [Option("anonymous-socket", Required = false, Default = null, HelpText = "A Unix domain socket path to accept the anonymous shared memory of an application from (e.g. '@SmartCache.1234'), Linux only.")]
+            public string AnonymousSocket { get; set; }
+
             /// <remarks>
             /// Just used to detect any extra arguments so we can throw a warning.
             /// See Also: https://github.com/microsoft/MLOS/issues/112.
@@ -16,6 +16,7 @@ using Microsoft.AspNetCore.Server.Kestrel.Core;
 using Microsoft.Extensions.Hosting;
 
 using Mlos.Core;
+using Proxy.Mlos.Core.Internal;
 
 using MlosOptimizer = Mlos.Model.Services.Client.BayesianOptimizer;
 
@@ -47,6 +48,46 @@ namespace Mlos.Agent.Server
                     webBuilder.UseStartup<GrpcServer.Startup>();
                 });
 
+        /// <summary>
+        /// Prints the telemetry channel latency percentiles of a running application.
+        /// </summary>
+        /// <param name="instanceName">The MlosContext instance name, uses the default instance if null.</param>
+        /// <remarks>
+        /// Maps the latency memory region created by the application and reads the histograms in place,
+        /// the application and its agent keep running.
+        /// </remarks>
+        private static void PrintTelemetryChannelLatencyStats(string instanceName)
+        {
+            var mlosContextOptions = new MlosContextOptions { InstanceName = instanceName };
+
+            try
+            {
+                using SharedMemoryRegionView<ChannelLatencyMemoryRegion> latencyStatsView =
+                    InterProcessMlosContext.OpenTelemetryChannelLatencyStats(mlosContextOptions);
+
+                latencyStatsView.MemoryRegion().WriteLatencyStats(Console.Out);
+            }
+            catch (FileNotFoundException)
+            {
+                Console.Error.WriteLine("ERROR: The application has not enabled the telemetry channel latency histograms.");
+                Environment.Exit(1);
+            }
+        }
+
+        /// <summary>
+        /// Waits for the target process to pass its anonymous shared memory over the Unix domain socket.
+        /// </summary>
+        /// <param name="anonymousSocketPath">Path of the socket the target process connects to.</param>
+        /// <returns>MlosContext attached to the shared memory of the target process.</returns>
+        private static MlosContext AcceptAnonymousSharedMemory(string anonymousSocketPath)
+        {
+            using Mlos.Core.Linux.UnixDomainSocket listeningSocket = Mlos.Core.Linux.UnixDomainSocket.Listen(anonymousSocketPath);
+
+            Console.WriteLine($"Waiting for the target process to connect to {anonymousSocketPath}");
+
+            return InterProcessMlosContext.AcceptAnonymous(listeningSocket);
+        }
+
         /// <summary>
         /// The main external agent server.
         /// </summary>
@@ -55,7 +96,18 @@ namespace Mlos.Agent.Server
         {
             string executableFilePath = null;
             Uri optimizerAddressUri = null;
-            CliOptionsParser.ParseArgs(args, out executableFilePath, out optimizerAddressUri);
+            string instanceName = null;
+            bool printLatencyStats = false;
+            string anonymousSocketPath = null;
+            CliOptionsParser.ParseArgs(args, out executableFilePath, out optimizerAddressUri, out instanceName, out printLatencyStats, out anonymousSocketPath);
+
+            if (printLatencyStats)
+            {
+                // Print the latencies recorded by the running application, do not attach to its channels.
+                //
+                PrintTelemetryChannelLatencyStats(instanceName);
+                return;
+            }
 
             // Check for the executable before setting up any shared memory to
             // reduce cleanup issues.
@@ -92,10 +144,15 @@ namespace Mlos.Agent.Server
             // In the active learning mode, create a new shared memory map before running the target process.
             // On Linux, we unlink existing shared memory map, if they exist.
             // If the agent is not in the active learning mode, create new or open existing to communicate with the target process.
+            // The instance name selects the shared memory maps of the given MlosContext instance.
+            // With the anonymous shared memory, wait for the target process to pass its shared memory over the socket.
             //
-            using MlosContext mlosContext = (executableFilePath != null)
-                ? InterProcessMlosContext.Create()
-                : InterProcessMlosContext.CreateOrOpen();
+            var mlosContextOptions = new MlosContextOptions { InstanceName = instanceName };
+            using MlosContext mlosContext = (anonymousSocketPath != null)
+                ? AcceptAnonymousSharedMemory(anonymousSocketPath)
+                : (executableFilePath != null)
+                ? InterProcessMlosContext.Create(mlosContextOptions)
+                : InterProcessMlosContext.CreateOrOpen(mlosContextOptions);
             using var mainAgent = new MainAgent();
             mainAgent.InitializeSharedChannel(mlosContext);
 
@@ -197,6 +254,10 @@ namespace Mlos.Agent.Server
                 Console.WriteLine($"Exception: {waitForTargetProcessTask.Exception}");
             }
 
+            // Print the telemetry channel latencies, if the target process recorded them.
+            //
+            mainAgent.WriteTelemetryChannelLatencyStats(Console.Out);
+
             // Perform some cleanup.
             //
             waitForTargetProcessTask.Dispose();
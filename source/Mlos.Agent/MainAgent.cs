@@ -11,8 +11,10 @@ using System.Collections.Generic;
 using System.IO;
 using System.Reflection;
 using System.Runtime.InteropServices;
+using System.Threading;
 
 using Mlos.Core;
+using Proxy.Mlos.Core.Internal;
 
 using MlosProxy = Proxy.Mlos.Core;
 using MlosProxyInternal = Proxy.Mlos.Core.Internal;
@@ -37,6 +39,41 @@ namespace Mlos.Agent
 
         public bool KeepRunning = true;
 
+        /// <summary>
+        /// Control channel reader settings.
+        /// </summary>
+        public ChannelSettings ControlChannelSettings = new ChannelSettings
+        {
+            ReaderBatchFrameCount = 64,
+            ReaderBatchLength = 16 * 1024,
+        };
+
+        /// <summary>
+        /// Telemetry channel reader settings.
+        /// </summary>
+        public ChannelSettings TelemetryChannelSettings = new ChannelSettings
+        {
+            ReaderBatchFrameCount = 64,
+            ReaderBatchLength = 16 * 1024,
+        };
+
+        /// <summary>
+        /// How long the telemetry channel readers wait for the control channel reader to register the settings assembly of the received message.
+        /// </summary>
+        /// <remarks>
+        /// The target process does not wait for the agent to register the settings assembly,
+        /// the telemetry messages sent right after the registration might arrive first.
+        /// </remarks>
+        public TimeSpan TelemetryChannelUnregisteredTypeWaitTimeout = TimeSpan.FromSeconds(10);
+
+        /// <summary>
+        /// Gets the telemetry channel latency histograms registered by the target process.
+        /// </summary>
+        /// <remarks>
+        /// The buffer is not set until the target process enables the telemetry channel latency stats.
+        /// </remarks>
+        public MlosProxyInternal.ChannelLatencyMemoryRegion TelemetryChannelLatencyStats { get; private set; }
+
         private bool isDisposed;
 
         #region Shared objects
@@ -68,11 +105,16 @@ namespace Mlos.Agent
             MlosProxyInternal.RegisterAssemblyRequestMessage.Callback = RegisterAssemblyCallback;
             MlosProxyInternal.RegisterMemoryRegionRequestMessage.Callback = RegisterMemoryRegionMessageCallback;
             MlosProxyInternal.RegisterSharedConfigMemoryRegionRequestMessage.Callback = RegisterSharedConfigMemoryRegionRequestMessageCallback;
+            MlosProxyInternal.RegisterChannelLatencyMemoryRegionRequestMessage.Callback = RegisterChannelLatencyMemoryRegionRequestMessageCallback;
             MlosProxy.TerminateReaderThreadRequestMessage.Callback = TerminateReaderThreadRequestMessageCallback;
 
             // Register Mlos.Core assembly.
+            // The process which created the global memory region stored the hash of its Mlos.Core dispatch table.
             //
-            RegisterAssembly(typeof(MlosContext).Assembly, dispatchTableBaseIndex: 0);
+            RegisterAssembly(
+                typeof(MlosContext).Assembly,
+                dispatchTableBaseIndex: 0,
+                dispatchTableHash: mlosContext.GlobalMemoryRegion.MlosCoreDispatchTableHash);
 
             // Register assemblies from the shared config.
             // Assembly Mlos.NetCore does not have a config, as it is always registered first.
@@ -94,6 +136,7 @@ namespace Mlos.Agent
             //
             mlosContext.TerminateControlChannel();
             mlosContext.TerminateFeedbackChannel();
+            mlosContext.TerminateTelemetryChannel();
         }
 
         /// <summary>
@@ -101,11 +144,37 @@ namespace Mlos.Agent
         /// </summary>
         /// <param name="assembly"></param>
         /// <param name="dispatchTableBaseIndex"></param>
-        private void RegisterAssembly(Assembly assembly, uint dispatchTableBaseIndex)
+        /// <param name="dispatchTableHash">Hash of the application dispatch table, zero if unknown.</param>
+        private void RegisterAssembly(Assembly assembly, uint dispatchTableBaseIndex, ulong dispatchTableHash = 0)
         {
-            settingsAssemblyManager.RegisterAssembly(assembly, dispatchTableBaseIndex);
+            settingsAssemblyManager.RegisterAssembly(assembly, dispatchTableBaseIndex, dispatchTableHash);
 
             globalDispatchTable = settingsAssemblyManager.GetGlobalDispatchTable();
+
+            // The assembly initializer has set the message callbacks, stop the telemetry without a handler.
+            //
+            UpdateTelemetrySubscriptions();
+        }
+
+        /// <summary>
+        /// Updates the telemetry subscription bitmap from the message callbacks of the registered settings assemblies.
+        /// </summary>
+        /// <remarks>
+        /// The components do not send the telemetry messages without a callback.
+        /// The agent updates the subscriptions after it registers a settings assembly and when it starts processing the messages.
+        /// Call it again after the message callbacks are set or removed later.
+        /// </remarks>
+        public void UpdateTelemetrySubscriptions()
+        {
+            if (mlosContext == null)
+            {
+                return;
+            }
+
+            foreach (Assembly assembly in settingsAssemblyManager.RegisteredAssemblies)
+            {
+                mlosContext.GlobalMemoryRegion.UpdateTelemetrySubscriptions(assembly);
+            }
         }
 
         /// <summary>
@@ -127,6 +196,14 @@ namespace Mlos.Agent
             {
                 MlosProxyInternal.RegisteredSettingsAssemblyConfig assemblyConfig = assemblySharedConfig.Config;
 
+                // The telemetry frames with the compact headers have no type hash, the assembly types must be verified.
+                //
+                if (assemblyConfig.DispatchTableHash == 0 &&
+                    mlosContext.GlobalMemoryRegion.TelemetryChannelSynchronization[0].HasCompactFrameHeaders.Load())
+                {
+                    throw new InvalidOperationException($"Settings assembly {assemblyConfig.AssemblyFileName.Value} is registered without the dispatch table hash.");
+                }
+
                 // Start looking for places to find the assembly.
                 //
                 List<string> assemblyDirs = new List<string>();
@@ -192,7 +269,10 @@ namespace Mlos.Agent
 
                 Assembly assembly = Assembly.LoadFrom(assemblyFilePath);
 
-                RegisterAssembly(assembly, dispatchTableBaseIndex: assemblyConfig.DispatchTableBaseIndex);
+                RegisterAssembly(
+                    assembly,
+                    dispatchTableBaseIndex: assemblyConfig.DispatchTableBaseIndex,
+                    dispatchTableHash: assemblyConfig.DispatchTableHash);
             }
         }
 
@@ -247,6 +327,24 @@ namespace Mlos.Agent
             sharedConfigManager.SetMemoryRegion(new MlosProxyInternal.SharedConfigMemoryRegion() { Buffer = sharedConfigMemoryMapView.Buffer });
         }
 
+        /// <summary>
+        /// Register telemetry channel latency memory region.
+        /// </summary>
+        /// <param name="msg"></param>
+        private void RegisterChannelLatencyMemoryRegionRequestMessageCallback(MlosProxyInternal.RegisterChannelLatencyMemoryRegionRequestMessage msg)
+        {
+            SharedMemoryMapView channelLatencyMemoryMapView = memoryRegions[msg.MemoryRegionId];
+
+            TelemetryChannelLatencyStats = new MlosProxyInternal.ChannelLatencyMemoryRegion() { Buffer = channelLatencyMemoryMapView.Buffer };
+
+            // The telemetry channel readers record the latencies of the dispatched messages.
+            //
+            foreach (ISharedChannel telemetryChannelShard in MlosContext.TelemetryChannelShards)
+            {
+                telemetryChannelShard.LatencyStats = TelemetryChannelLatencyStats;
+            }
+        }
+
         /// <summary>
         /// #TODO remove, this is not required.
         /// </summary>
@@ -261,14 +359,62 @@ namespace Mlos.Agent
 
         #endregion
 
+        /// <summary>
+        /// Writes the percentiles of the telemetry channel latencies for each message type.
+        /// </summary>
+        /// <param name="writer"></param>
+        /// <remarks>
+        /// Latencies are in microseconds. The histograms can be read while the target process is running,
+        /// Mlos.Agent.Server --latency-stats prints them on demand from a separate process.
+        /// </remarks>
+        public void WriteTelemetryChannelLatencyStats(TextWriter writer)
+        {
+            if (TelemetryChannelLatencyStats.Buffer == IntPtr.Zero)
+            {
+                return;
+            }
+
+            TelemetryChannelLatencyStats.WriteLatencyStats(writer);
+        }
+
         /// <summary>
         /// Main.
         /// </summary>
         public void RunAgent()
         {
+            // The callbacks might have been set after the assemblies were registered.
+            //
+            UpdateTelemetrySubscriptions();
+
+            // Process the messages from each telemetry channel shard on a dedicated thread,
+            // so the telemetry traffic does not delay the control messages.
+            //
+            var telemetryReaderThreads = new List<Thread>();
+
+            for (int shardIndex = 0; shardIndex < MlosContext.TelemetryChannelShards.Count; shardIndex++)
+            {
+                ISharedChannel telemetryChannelShard = MlosContext.TelemetryChannelShards[shardIndex];
+                telemetryChannelShard.UnregisteredTypeWaitTimeout = TelemetryChannelUnregisteredTypeWaitTimeout;
+
+                var telemetryReaderThread = new Thread(
+                    () => telemetryChannelShard.ProcessMessages(dispatchTable: ref globalDispatchTable, channelSettings: ref TelemetryChannelSettings))
+                {
+                    Name = $"Mlos.Agent.TelemetryChannel.{shardIndex}",
+                    IsBackground = true,
+                };
+
+                telemetryReaderThread.Start();
+                telemetryReaderThreads.Add(telemetryReaderThread);
+            }
+
             // Process the messages from the control channel.
             //
-            MlosContext.ControlChannel.ProcessMessages(dispatchTable: ref globalDispatchTable);
+            MlosContext.ControlChannel.ProcessMessages(dispatchTable: ref globalDispatchTable, channelSettings: ref ControlChannelSettings);
+
+            // The control channel has been terminated, stop the telemetry readers.
+            //
+            mlosContext.TerminateTelemetryChannel();
+            telemetryReaderThreads.ForEach(telemetryReaderThread => telemetryReaderThread.Join());
         }
 
         protected virtual void Dispose(bool disposing)
@@ -0,0 +1,42 @@
+//*********************************************************************
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License. See License.txt in the project root
+// for license information.
+//
+// @File: ChannelLatencyMemoryRegion.cpp
+//
+// Purpose:
+//      <description>
+//
+// Notes:
+//      <special-instructions>
+//
+//*********************************************************************
+
+#include "Mlos.Core.h"
+
+using namespace Mlos::Core;
+
+namespace Mlos
+{
+namespace Core
+{
+//----------------------------------------------------------------------------
+// NAME: SharedMemoryRegionView<ChannelLatencyMemoryRegion>::InitializeMemoryRegion
+//
+// PURPOSE:
+//  Initializes memory region holding the channel latency histograms.
+//
+// RETURNS:
+//  ChannelLatencyMemoryRegion.
+//
+// NOTES:
+//  The histograms are empty in the newly created shared memory.
+//
+template<>
+Internal::ChannelLatencyMemoryRegion& SharedMemoryRegionView<Internal::ChannelLatencyMemoryRegion>::InitializeMemoryRegion()
+{
+    return MemoryRegion();
+}
+}
+}
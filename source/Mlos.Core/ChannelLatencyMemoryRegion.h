@@ -0,0 +1,146 @@
+//*********************************************************************
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License. See License.txt in the project root
+// for license information.
+//
+// @File: ChannelLatencyMemoryRegion.h
+//
+// Purpose:
+//      <description>
+//
+// Notes:
+//      <special-instructions>
+//
+//*********************************************************************
+
+#pragma once
+
+namespace Mlos
+{
+namespace Core
+{
+namespace Internal
+{
+// Number of the histogram buckets per power of two.
+//
+constexpr uint32_t ChannelLatencyHistogramSubBucketCount = 8;
+
+constexpr uint32_t ChannelLatencyHistogramSubBucketBits = 3;
+
+//----------------------------------------------------------------------------
+// NAME: ChannelLatencyHistogramBucketIndex
+//
+// PURPOSE:
+//  Returns the index of the histogram bucket holding the given value.
+//
+// NOTES:
+//  Values below ChannelLatencyHistogramSubBucketCount have their own bucket.
+//  Larger values are bucketed by the most significant bit and the following ChannelLatencyHistogramSubBucketBits bits.
+//  Values beyond the range of the histogram are stored in the last bucket.
+//
+inline uint32_t ChannelLatencyHistogramBucketIndex(uint64_t value, uint32_t bucketCount)
+{
+    if (value < ChannelLatencyHistogramSubBucketCount)
+    {
+        return static_cast<uint32_t>(value);
+    }
+
+#if defined(_MSC_VER)
+    unsigned long mostSignificantBit;
+    _BitScanReverse64(&mostSignificantBit, value);
+#else
+    const uint32_t mostSignificantBit = 63 - __builtin_clzll(value);
+#endif
+
+    const uint32_t shift = static_cast<uint32_t>(mostSignificantBit) - ChannelLatencyHistogramSubBucketBits;
+    const uint32_t bucketIndex = (shift + 1) * ChannelLatencyHistogramSubBucketCount +
+        static_cast<uint32_t>((value >> shift) & (ChannelLatencyHistogramSubBucketCount - 1));
+
+    return std::min(bucketIndex, bucketCount - 1);
+}
+
+//----------------------------------------------------------------------------
+// NAME: ChannelLatencyHistogramBucketLowerBound
+//
+// PURPOSE:
+//  Returns the smallest value stored in the histogram bucket.
+//
+inline uint64_t ChannelLatencyHistogramBucketLowerBound(uint32_t bucketIndex)
+{
+    if (bucketIndex < ChannelLatencyHistogramSubBucketCount)
+    {
+        return bucketIndex;
+    }
+
+    const uint32_t shift = bucketIndex / ChannelLatencyHistogramSubBucketCount - 1;
+    const uint64_t subBucket = ChannelLatencyHistogramSubBucketCount + bucketIndex % ChannelLatencyHistogramSubBucketCount;
+
+    return subBucket << shift;
+}
+
+//----------------------------------------------------------------------------
+// NAME: RecordChannelLatency
+//
+// PURPOSE:
+//  Records the latency in the histogram.
+//
+// NOTES:
+//  Multiple readers might update the same histogram, the counters are updated with relaxed atomics.
+//
+inline void RecordChannelLatency(ChannelLatencyHistogram& histogram, uint64_t latencyInNanoseconds)
+{
+    const uint32_t bucketIndex = ChannelLatencyHistogramBucketIndex(
+        latencyInNanoseconds,
+        static_cast<uint32_t>(histogram.Buckets.size()));
+
+    histogram.Buckets[bucketIndex].fetch_add(1, std::memory_order_relaxed);
+    histogram.TotalInNanoseconds.fetch_add(latencyInNanoseconds, std::memory_order_relaxed);
+    histogram.Count.fetch_add(1, std::memory_order_relaxed);
+}
+
+//----------------------------------------------------------------------------
+// NAME: ChannelLatencyHistogramValueAtPercentile
+//
+// PURPOSE:
+//  Returns the latency at the given percentile (0-100).
+//
+// RETURNS:
+//  The upper bound of the bucket containing the percentile, zero if the histogram is empty.
+//
+// NOTES:
+//  The histogram might be updated concurrently, the result is computed from a snapshot of the buckets.
+//
+inline uint64_t ChannelLatencyHistogramValueAtPercentile(const ChannelLatencyHistogram& histogram, double percentile)
+{
+    uint64_t totalCount = 0;
+    for (const auto& bucket : histogram.Buckets)
+    {
+        totalCount += bucket.load(std::memory_order_relaxed);
+    }
+
+    if (totalCount == 0)
+    {
+        return 0;
+    }
+
+    const double clampedPercentile = std::min(std::max(percentile, 0.0), 100.0);
+    const uint64_t targetCount = std::max(static_cast<uint64_t>(totalCount * clampedPercentile / 100.0 + 0.5), uint64_t { 1 });
+
+    const uint32_t bucketCount = static_cast<uint32_t>(histogram.Buckets.size());
+
+    uint64_t count = 0;
+    for (uint32_t bucketIndex = 0; bucketIndex < bucketCount; bucketIndex++)
+    {
+        count += histogram.Buckets[bucketIndex].load(std::memory_order_relaxed);
+
+        if (count >= targetCount)
+        {
+            return ChannelLatencyHistogramBucketLowerBound(bucketIndex + 1) - 1;
+        }
+    }
+
+    return ChannelLatencyHistogramBucketLowerBound(bucketCount) - 1;
+}
+}
+}
+}
@@ -20,6 +20,7 @@ namespace Mlos
 namespace Core
 {
 class MlosContext;
+class TelemetrySampler;
 
 //----------------------------------------------------------------------------
 // NAME: ComponentConfig
@@ -38,7 +39,8 @@ public:
 
     ComponentConfig(MlosContext& mlosContext) noexcept
       : m_mlosContext(mlosContext),
-        m_sharedConfig(nullptr)
+        m_sharedConfig(nullptr),
+        m_telemetrySampler(nullptr)
     {}
 
     // Binds the component config located in the shared memory to the local component config.
@@ -60,7 +62,24 @@ public:
         return TProxyObjectType(&m_sharedConfig->m_config);
     }
 
+    // Gets the id of the config located in the shared memory.
+    // The agent increments the id when it updates the config.
+    //
+    uint32_t SharedConfigId() const
+    {
+        return m_sharedConfig->m_header.ConfigId.load(std::memory_order_acquire);
+    }
+
+    // Increments the id of the config located in the shared memory,
+    // the components polling the id reload the config.
+    //
+    void NotifySharedConfigUpdated()
+    {
+        m_sharedConfig->m_header.ConfigId.fetch_add(1, std::memory_order_release);
+    }
+
     // Sends the telemetry message.
+    // If a telemetry sampler is registered, the message is sent only if the sampler selects it.
     //
     template<typename TMessage>
     void SendTelemetryMessage(const TMessage& message) const;
@@ -74,6 +93,10 @@ private:
     //
     SharedConfigType* m_sharedConfig;
 
+    // Telemetry sampler selecting the sent telemetry messages, nullptr if all the messages are sent.
+    //
+    TelemetrySampler* m_telemetrySampler;
+
     // Friend classes.
     //
     friend class MlosContext;
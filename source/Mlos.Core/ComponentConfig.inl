@@ -60,11 +60,25 @@ bool ComponentConfig<T>::CompareKey(SharedConfigHeader* sharedConfigHeader)
 // RETURNS:
 //
 // NOTES:
+//  Messages not subscribed by the agent are dropped before they are offered to the telemetry sampler.
+//  The telemetry sampler decides before the message is serialized.
 //
 template<typename T>
 template<typename TMessage>
 void ComponentConfig<T>::SendTelemetryMessage(const TMessage& message) const
 {
+    if (!m_mlosContext.IsTelemetryMessageSubscribed<TMessage>())
+    {
+        return;
+    }
+
+    if (m_telemetrySampler != nullptr && !m_telemetrySampler->ShouldSendMessage(message))
+    {
+        // The message has been rejected or kept by the sampler.
+        //
+        return;
+    }
+
     // #TODO 
     // - add object as parameter
     // - update current configuration id.
@@ -0,0 +1,434 @@
+//*********************************************************************
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License. See License.txt in the project root
+// for license information.
+//
+// @File: DispatchWorkerPool.cpp
+//
+// Purpose:
+//      <description>
+//
+// Notes:
+//      <special-instructions>
+//
+//*********************************************************************
+
+#include "Mlos.Core.h"
+
+namespace Mlos
+{
+namespace Core
+{
+//----------------------------------------------------------------------------
+// NAME: DispatchWorkerPool::Constructor.
+//
+// PURPOSE:
+//  Creates the worker queues, each queue holds at most queueLength messages.
+//
+// NOTES:
+//
+DispatchWorkerPool::DispatchWorkerPool(uint32_t workerCount, uint32_t queueLength)
+  : WorkerCount(std::max<uint32_t>(workerCount, 1)),
+    QueueCount(WorkerCount * QueuesPerWorker),
+    QueueLength(std::max<uint32_t>(queueLength, 1)),
+    m_workerQueues(new WorkerQueue[QueueCount]),
+    m_terminated(false),
+    m_workGeneration(0),
+    m_idleWorkerCount(0),
+    m_invalidMessageCount(0)
+{
+    for (uint32_t queueIndex = 0; queueIndex < QueueCount; queueIndex++)
+    {
+        WorkerQueue& workerQueue = m_workerQueues[queueIndex];
+
+        workerQueue.Items.reset(new WorkItem[QueueLength]());
+        workerQueue.Head = 0;
+        workerQueue.Count = 0;
+        workerQueue.IsDispatching = false;
+    }
+}
+
+//----------------------------------------------------------------------------
+// NAME: DispatchWorkerPool::Destructor.
+//
+// NOTES:
+//  The worker threads must have returned from ProcessWorkItems.
+//
+DispatchWorkerPool::~DispatchWorkerPool()
+{
+    Terminate();
+}
+
+//----------------------------------------------------------------------------
+// NAME: DispatchWorkerPool::ProcessWorkItems
+//
+// PURPOSE:
+//  Worker loop, dispatches the messages from the worker queues.
+//
+// RETURNS:
+//  Nothing.
+//
+// NOTES:
+//  The queue with index q belongs to the worker q % WorkerCount. The worker scans its own queues first,
+//  then the queues of the following workers, and dispatches the head message of the first queue
+//  no other thread is dispatching from.
+//  If there is no such queue, the worker waits until a message is queued or a queue becomes available.
+//  Returns after Terminate, once all the queues are empty.
+//
+void DispatchWorkerPool::ProcessWorkItems(uint32_t workerIndex)
+{
+    workerIndex %= WorkerCount;
+
+    while (true)
+    {
+        // Load the state before the queues are scanned, so the changes made during the scan are not missed.
+        //
+        const uint64_t workGeneration = m_workGeneration.load(std::memory_order_seq_cst);
+        const bool isTerminated = m_terminated.load(std::memory_order_acquire);
+
+        WorkerQueue* claimedQueue = nullptr;
+        bool hasQueuedItems = false;
+
+        for (uint32_t workerOffset = 0; workerOffset < WorkerCount && claimedQueue == nullptr; workerOffset++)
+        {
+            const uint32_t ownerIndex = (workerIndex + workerOffset) % WorkerCount;
+
+            for (uint32_t queueIndex = ownerIndex; queueIndex < QueueCount; queueIndex += WorkerCount)
+            {
+                if (TryClaimHeadItem(m_workerQueues[queueIndex], hasQueuedItems))
+                {
+                    claimedQueue = &m_workerQueues[queueIndex];
+                    break;
+                }
+            }
+        }
+
+        if (claimedQueue != nullptr)
+        {
+            DispatchHeadItem(*claimedQueue);
+            continue;
+        }
+
+        if (isTerminated && !hasQueuedItems)
+        {
+            return;
+        }
+
+        std::unique_lock<std::mutex> lock(m_idleLock);
+
+        m_idleWorkerCount.fetch_add(1, std::memory_order_seq_cst);
+
+        m_workAvailable.wait(
+            lock,
+            [this, workGeneration] { return m_workGeneration.load(std::memory_order_seq_cst) != workGeneration; });
+
+        m_idleWorkerCount.fetch_sub(1, std::memory_order_relaxed);
+    }
+}
+
+//----------------------------------------------------------------------------
+// NAME: DispatchWorkerPool::TryClaimHeadItem
+//
+// PURPOSE:
+//  Claims the head message of the queue.
+//
+// RETURNS:
+//  True if the calling thread dispatches the head message.
+//  False if the queue is empty or another thread is dispatching from it.
+//
+// NOTES:
+//  hasQueuedItems is set if the queue is not empty.
+//
+bool DispatchWorkerPool::TryClaimHeadItem(WorkerQueue& workerQueue, bool& hasQueuedItems)
+{
+    std::lock_guard<std::mutex> lock(workerQueue.Lock);
+
+    if (workerQueue.Count == 0)
+    {
+        return false;
+    }
+
+    hasQueuedItems = true;
+
+    if (workerQueue.IsDispatching)
+    {
+        return false;
+    }
+
+    workerQueue.IsDispatching = true;
+    return true;
+}
+
+//----------------------------------------------------------------------------
+// NAME: DispatchWorkerPool::DispatchHeadItem
+//
+// PURPOSE:
+//  Dispatches the claimed head message and removes it from the queue.
+//
+// RETURNS:
+//  Nothing.
+//
+// NOTES:
+//  The readers only append to the queue, so the claimed message is dispatched without the lock
+//  and the queue slot is released afterwards.
+//  The invalid message is reported to the channel after the slot is released,
+//  the channel policy might throw and the queue stays consistent.
+//
+void DispatchWorkerPool::DispatchHeadItem(WorkerQueue& workerQueue)
+{
+    WorkItem& workItem = workerQueue.Items[workerQueue.Head];
+
+    const uint64_t dispatchTimestamp = (workItem.LatencyStats != nullptr) ? MlosPlatform::TimestampInNanoseconds() : 0;
+
+    const bool isMessageValid = workItem.Entry->Callback(
+        BytePtr(reinterpret_cast<byte*>(workItem.Payload.get())),
+        workItem.FrameLength);
+
+    if (workItem.LatencyStats != nullptr)
+    {
+        Internal::RecordChannelLatency(
+            workItem.LatencyStats->HandlerDuration,
+            MlosPlatform::TimestampInNanoseconds() - dispatchTimestamp);
+    }
+
+    ISharedChannel* sharedChannel = workItem.SharedChannel;
+
+    bool hasQueuedItems;
+
+    {
+        std::lock_guard<std::mutex> lock(workerQueue.Lock);
+
+        workerQueue.Head = (workerQueue.Head + 1) % QueueLength;
+        workerQueue.Count--;
+        workerQueue.IsDispatching = false;
+
+        hasQueuedItems = workerQueue.Count != 0;
+    }
+
+    workerQueue.NotFull.notify_all();
+
+    if (hasQueuedItems)
+    {
+        // The next message of the queue can be claimed.
+        //
+        NotifyWorkers(false /* notifyAll */);
+    }
+    else if (m_terminated.load(std::memory_order_relaxed))
+    {
+        // The terminated workers wait for the queues to be emptied.
+        //
+        NotifyWorkers(true /* notifyAll */);
+    }
+
+    if (!isMessageValid)
+    {
+        // Received invalid message, the channel policy decides how to handle it.
+        //
+        m_invalidMessageCount.fetch_add(1, std::memory_order_relaxed);
+
+        sharedChannel->ReceivedInvalidFrame();
+    }
+}
+
+//----------------------------------------------------------------------------
+// NAME: DispatchWorkerPool::NotifyWorkers
+//
+// PURPOSE:
+//  Wakes up the idle workers.
+//
+// RETURNS:
+//  Nothing.
+//
+// NOTES:
+//  The lock is taken only if there is an idle worker. The worker increments the idle count before it checks
+//  the work generation, so either the worker sees the new generation or the notifier sees the idle worker.
+//
+void DispatchWorkerPool::NotifyWorkers(bool notifyAll)
+{
+    m_workGeneration.fetch_add(1, std::memory_order_seq_cst);
+
+    if (m_idleWorkerCount.load(std::memory_order_seq_cst) == 0)
+    {
+        return;
+    }
+
+    {
+        // Take the lock, so the waiting workers do not miss the notification.
+        //
+        std::lock_guard<std::mutex> lock(m_idleLock);
+    }
+
+    if (notifyAll)
+    {
+        m_workAvailable.notify_all();
+    }
+    else
+    {
+        m_workAvailable.notify_one();
+    }
+}
+
+//----------------------------------------------------------------------------
+// NAME: DispatchWorkerPool::Enqueue
+//
+// PURPOSE:
+//  Copies the message payload to the worker queue.
+//
+// RETURNS:
+//  True if the message has been queued.
+//  False if the pool has been terminated.
+//
+// NOTES:
+//  Called by the channel reader threads.
+//  If the queue is full, the reader waits for a free slot and counts the stall.
+//  If the pool has been terminated, the reader dispatches the messages left in the queue itself,
+//  so the message it dispatches next is not dispatched before the earlier messages of the same type.
+//  It does not depend on the workers, they might have returned or might have never been started.
+//
+bool DispatchWorkerPool::Enqueue(
+    ISharedChannel& sharedChannel,
+    uint32_t codegenTypeIndex,
+    const DispatchEntry& dispatchEntry,
+    BytePtr payload,
+    uint32_t payloadLength,
+    int32_t frameLength,
+    Internal::ChannelLatencyStats* latencyStats,
+    ChannelReaderStats* readerStats)
+{
+    WorkerQueue& workerQueue = m_workerQueues[codegenTypeIndex % QueueCount];
+
+    std::unique_lock<std::mutex> lock(workerQueue.Lock);
+
+    if (workerQueue.Count == QueueLength)
+    {
+        if (readerStats != nullptr)
+        {
+            readerStats->DispatchStallCount++;
+        }
+
+        workerQueue.NotFull.wait(
+            lock,
+            [this, &workerQueue] { return workerQueue.Count != QueueLength || m_terminated.load(std::memory_order_relaxed); });
+    }
+
+    if (m_terminated.load(std::memory_order_relaxed))
+    {
+        while (workerQueue.Count != 0)
+        {
+            if (workerQueue.IsDispatching)
+            {
+                // Another thread is dispatching the head message.
+                //
+                workerQueue.NotFull.wait(lock);
+                continue;
+            }
+
+            workerQueue.IsDispatching = true;
+
+            lock.unlock();
+            DispatchHeadItem(workerQueue);
+            lock.lock();
+        }
+
+        return false;
+    }
+
+    WorkItem& workItem = workerQueue.Items[(workerQueue.Head + workerQueue.Count) % QueueLength];
+
+    const uint32_t payloadCapacity = static_cast<uint32_t>(align<sizeof(uint64_t)>(static_cast<size_t>(payloadLength)));
+
+    if (workItem.PayloadCapacity < payloadCapacity)
+    {
+        workItem.Payload.reset(new uint64_t[payloadCapacity / sizeof(uint64_t)]);
+        workItem.PayloadCapacity = payloadCapacity;
+    }
+
+    memcpy(workItem.Payload.get(), payload.Pointer, payloadLength);
+
+    workItem.SharedChannel = &sharedChannel;
+    workItem.Entry = &dispatchEntry;
+    workItem.LatencyStats = latencyStats;
+    workItem.FrameLength = frameLength;
+
+    workerQueue.Count++;
+
+    lock.unlock();
+
+    NotifyWorkers(false /* notifyAll */);
+
+    return true;
+}
+
+//----------------------------------------------------------------------------
+// NAME: DispatchWorkerPool::WaitForIdle
+//
+// PURPOSE:
+//  Waits until the workers dispatch all the queued messages.
+//
+// RETURNS:
+//  Nothing.
+//
+// NOTES:
+//  Messages queued by the readers in the meantime are also waited for.
+//
+void DispatchWorkerPool::WaitForIdle()
+{
+    for (uint32_t queueIndex = 0; queueIndex < QueueCount; queueIndex++)
+    {
+        WorkerQueue& workerQueue = m_workerQueues[queueIndex];
+
+        std::unique_lock<std::mutex> lock(workerQueue.Lock);
+
+        workerQueue.NotFull.wait(lock, [&workerQueue] { return workerQueue.Count == 0; });
+    }
+}
+
+//----------------------------------------------------------------------------
+// NAME: DispatchWorkerPool::Terminate
+//
+// PURPOSE:
+//  Stops the workers.
+//
+// RETURNS:
+//  Nothing.
+//
+// NOTES:
+//  The flag is set while all the queue locks are held, so a message is either queued before the workers
+//  see the flag, and they dispatch it before they return, or the reader sees the flag and dispatches it itself.
+//  The workers dispatch the messages already queued before they return.
+//  The readers waiting for a free slot dispatch the queued messages and then the message themselves.
+//
+void DispatchWorkerPool::Terminate()
+{
+    for (uint32_t queueIndex = 0; queueIndex < QueueCount; queueIndex++)
+    {
+        m_workerQueues[queueIndex].Lock.lock();
+    }
+
+    m_terminated.store(true, std::memory_order_release);
+
+    for (uint32_t queueIndex = 0; queueIndex < QueueCount; queueIndex++)
+    {
+        m_workerQueues[queueIndex].Lock.unlock();
+        m_workerQueues[queueIndex].NotFull.notify_all();
+    }
+
+    NotifyWorkers(true /* notifyAll */);
+}
+
+//----------------------------------------------------------------------------
+// NAME: DispatchWorkerPool::InvalidMessageCount
+//
+// RETURNS:
+//  Returns the number of messages the callbacks rejected as invalid.
+//
+// NOTES:
+//  The workers also report the invalid messages to the channel, the channel policy handles them
+//  the same way as with the inline dispatch.
+//
+uint64_t DispatchWorkerPool::InvalidMessageCount() const
+{
+    return m_invalidMessageCount.load(std::memory_order_relaxed);
+}
+}
+}
@@ -0,0 +1,171 @@
+//*********************************************************************
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License. See License.txt in the project root
+// for license information.
+//
+// @File: DispatchWorkerPool.h
+//
+// Purpose:
+//      <description>
+//
+// Notes:
+//      <special-instructions>
+//
+//*********************************************************************
+
+#pragma once
+
+namespace Mlos
+{
+namespace Core
+{
+class ISharedChannel;
+
+//----------------------------------------------------------------------------
+// NAME: DispatchWorkerPool
+//
+// PURPOSE:
+//  Dispatches the messages read from the shared channel on the worker threads.
+//  The channel reader copies the frame payload to the worker queue and releases the frame,
+//  so a slow message callback does not keep the writers from reclaiming the channel buffer.
+//
+// NOTES:
+//  The pool does not own the threads. The application runs ProcessWorkItems on each worker thread,
+//  the same way as it runs SharedChannel::ProcessMessages on the reader threads.
+//
+//  The queue is selected by the message type, there are QueuesPerWorker queues for each worker.
+//  A queue dispatches a single message at a time, so the messages of the same type read by the same reader thread
+//  are dispatched in order. Each worker dispatches from its own queues first; once they are empty or busy,
+//  it steals the messages from the queues of the other workers.
+//  The messages of a single type are still dispatched one at a time.
+//
+//  The worker queues are bounded. If the queue is full, the reader waits and keeps the frame,
+//  the writers see the backpressure as with the inline dispatch, and the reader counts the stall
+//  in ChannelReaderStats.DispatchStallCount.
+//
+//  The invalid messages are reported to the channel they were read from, its channel policy handles them.
+//
+class DispatchWorkerPool
+{
+public:
+    DispatchWorkerPool(uint32_t workerCount, uint32_t queueLength);
+
+    ~DispatchWorkerPool();
+
+    DispatchWorkerPool(const DispatchWorkerPool&) = delete;
+
+    DispatchWorkerPool& operator=(const DispatchWorkerPool&) = delete;
+
+    // Worker loop, dispatches the queued messages until the pool is terminated.
+    //
+    void ProcessWorkItems(uint32_t workerIndex);
+
+    // Copies the message payload to the queue selected by the message type.
+    // Returns false if the pool has been terminated, the caller dispatches the messages already queued
+    // and then the message itself.
+    //
+    bool Enqueue(
+        ISharedChannel& sharedChannel,
+        uint32_t codegenTypeIndex,
+        const DispatchEntry& dispatchEntry,
+        BytePtr payload,
+        uint32_t payloadLength,
+        int32_t frameLength,
+        Internal::ChannelLatencyStats* latencyStats,
+        ChannelReaderStats* readerStats);
+
+    // Waits until all the queued messages are dispatched.
+    //
+    void WaitForIdle();
+
+    // Stops the workers once they dispatch the queued messages.
+    // Readers dispatch the messages left in the queues themselves.
+    //
+    void Terminate();
+
+    // Returns the number of messages the callbacks rejected as invalid.
+    // The invalid messages are also reported to the channel policy.
+    //
+    uint64_t InvalidMessageCount() const;
+
+    // Number of queues for each worker.
+    //
+    static constexpr uint32_t QueuesPerWorker = 4;
+
+    const uint32_t WorkerCount;
+
+    const uint32_t QueueCount;
+
+    const uint32_t QueueLength;
+
+private:
+    // Message copied from the channel frame.
+    //
+    struct WorkItem
+    {
+        ISharedChannel* SharedChannel;
+
+        const DispatchEntry* Entry;
+
+        Internal::ChannelLatencyStats* LatencyStats;
+
+        // Length of the frame with the full frame header, as expected by the callbacks.
+        //
+        int32_t FrameLength;
+
+        // Buffer is reused by the following messages, it is reallocated only if it is too small.
+        //
+        std::unique_ptr<uint64_t[]> Payload;
+
+        uint32_t PayloadCapacity;
+    };
+
+    struct WorkerQueue
+    {
+        std::mutex Lock;
+
+        // Notified when a message is removed from the queue.
+        //
+        std::condition_variable NotFull;
+
+        std::unique_ptr<WorkItem[]> Items;
+
+        uint32_t Head;
+
+        uint32_t Count;
+
+        // Set while a thread dispatches the head message, the message stays in the queue until it is dispatched.
+        //
+        bool IsDispatching;
+    };
+
+    // Claims the head message of the queue, unless another thread is dispatching from it.
+    //
+    static bool TryClaimHeadItem(WorkerQueue& workerQueue, bool& hasQueuedItems);
+
+    // Dispatches the claimed head message and removes it from the queue.
+    //
+    void DispatchHeadItem(WorkerQueue& workerQueue);
+
+    // Wakes up an idle worker, a message can be claimed.
+    //
+    void NotifyWorkers(bool notifyAll);
+
+    std::unique_ptr<WorkerQueue[]> m_workerQueues;
+
+    std::atomic<bool> m_terminated;
+
+    // Incremented when a message can be claimed, the idle workers wait for the change.
+    //
+    std::atomic<uint64_t> m_workGeneration;
+
+    std::atomic<uint32_t> m_idleWorkerCount;
+
+    std::mutex m_idleLock;
+
+    std::condition_variable m_workAvailable;
+
+    std::atomic<uint64_t> m_invalidMessageCount;
+};
+}
+}
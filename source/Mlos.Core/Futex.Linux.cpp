@@ -0,0 +1,109 @@
+//*********************************************************************
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License. See License.txt in the project root
+// for license information.
+//
+// @File: Futex.Linux.cpp
+//
+// Purpose:
+//      <description>
+//
+// Notes:
+//      <special-instructions>
+//
+//*********************************************************************
+
+#include "Mlos.Core.h"
+
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+
+namespace Mlos
+{
+namespace Core
+{
+static_assert(sizeof(std::atomic<uint32_t>) == sizeof(uint32_t), "Futex word must be a 32-bit integer");
+
+//----------------------------------------------------------------------------
+// NAME: Futex::Wait
+//
+// PURPOSE:
+//  Waits until the futex word is woken up, if it still contains the expected value.
+//
+// RETURNS:
+//  HRESULT.
+//
+// NOTES:
+//  Returns S_OK when the futex word no longer contains the expected value or the wait has been interrupted,
+//  the caller is expected to check its condition again.
+//
+_Check_return_
+HRESULT Futex::Wait(std::atomic<uint32_t>& futex, uint32_t expectedValue)
+{
+    if (syscall(SYS_futex, reinterpret_cast<uint32_t*>(&futex), FUTEX_WAIT, expectedValue, nullptr, nullptr, 0) == -1)
+    {
+        if (errno != EAGAIN && errno != EINTR)
+        {
+            return HRESULT_FROM_ERRNO(errno);
+        }
+    }
+
+    return S_OK;
+}
+
+//----------------------------------------------------------------------------
+// NAME: Futex::Wait
+//
+// PURPOSE:
+//  Waits until the futex word is woken up or the timeout expires, if it still contains the expected value.
+//
+// RETURNS:
+//  HRESULT.
+//
+// NOTES:
+//  Returns S_OK when the futex word no longer contains the expected value, the wait has been interrupted
+//  or the timeout has expired, the caller is expected to check its condition and the deadline again.
+//
+_Check_return_
+HRESULT Futex::Wait(std::atomic<uint32_t>& futex, uint32_t expectedValue, uint32_t timeoutInMicroseconds)
+{
+    timespec timeout;
+    timeout.tv_sec = timeoutInMicroseconds / 1000000;
+    timeout.tv_nsec = (timeoutInMicroseconds % 1000000) * 1000;
+
+    if (syscall(SYS_futex, reinterpret_cast<uint32_t*>(&futex), FUTEX_WAIT, expectedValue, &timeout, nullptr, 0) == -1)
+    {
+        if (errno != EAGAIN && errno != EINTR && errno != ETIMEDOUT)
+        {
+            return HRESULT_FROM_ERRNO(errno);
+        }
+    }
+
+    return S_OK;
+}
+
+//----------------------------------------------------------------------------
+// NAME: Futex::Wake
+//
+// PURPOSE:
+//  Wakes up at most a given number of the waiters.
+//
+// RETURNS:
+//  HRESULT.
+//
+// NOTES:
+//
+_Check_return_
+HRESULT Futex::Wake(std::atomic<uint32_t>& futex, int32_t wakeCount)
+{
+    if (syscall(SYS_futex, reinterpret_cast<uint32_t*>(&futex), FUTEX_WAKE, wakeCount, nullptr, nullptr, 0) == -1)
+    {
+        return HRESULT_FROM_ERRNO(errno);
+    }
+
+    return S_OK;
+}
+}
+}
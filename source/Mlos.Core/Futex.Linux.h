@@ -0,0 +1,50 @@
+//*********************************************************************
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License. See License.txt in the project root
+// for license information.
+//
+// @File: Futex.Linux.h
+//
+// Purpose:
+//      Futex wait and wake operations on a word located in the shared memory.
+//
+// Notes:
+//      <special-instructions>
+//
+//*********************************************************************
+
+#pragma once
+
+namespace Mlos
+{
+namespace Core
+{
+//----------------------------------------------------------------------------
+// NAME: Futex
+//
+// PURPOSE:
+//  Futex operations.
+//
+// NOTES:
+//  The futex word might be shared between the processes, so the operations are not private.
+//
+class Futex
+{
+public:
+    // Waits until the futex word is woken up, if it still contains the expected value.
+    //
+    _Check_return_
+    static HRESULT Wait(std::atomic<uint32_t>& futex, uint32_t expectedValue);
+
+    // Waits until the futex word is woken up or the timeout expires, if it still contains the expected value.
+    //
+    _Check_return_
+    static HRESULT Wait(std::atomic<uint32_t>& futex, uint32_t expectedValue, uint32_t timeoutInMicroseconds);
+
+    // Wakes up at most a given number of the waiters.
+    //
+    _Check_return_
+    static HRESULT Wake(std::atomic<uint32_t>& futex, int32_t wakeCount);
+};
+}
+}
@@ -43,6 +43,17 @@ Internal::GlobalMemoryRegion& SharedMemoryRegionView<Internal::GlobalMemoryRegio
 
     globalMemoryRegion.RegisteredSettingsAssemblyCount.store(1);
 
+    // All the telemetry messages are sent until the agent updates the subscriptions.
+    //
+    for (std::atomic<uint64_t>& subscriptionBits : globalMemoryRegion.TelemetrySubscriptionBitmap)
+    {
+        subscriptionBits.store(std::numeric_limits<uint64_t>::max(), std::memory_order_relaxed);
+    }
+
+    // The processes which open the region verify their Mlos.Core types against the hash.
+    //
+    globalMemoryRegion.MlosCoreDispatchTableHash = DispatchTableHash(ObjectDeserializationHandler::DispatchTable);
+
     return globalMemoryRegion;
 }
 }
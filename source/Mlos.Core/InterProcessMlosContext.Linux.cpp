@@ -0,0 +1,381 @@
+//*********************************************************************
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License. See License.txt in the project root
+// for license information.
+//
+// @File: InterProcessMlosContext.Linux.cpp
+//
+// Purpose:
+//      Initializes the inter-process MlosContext using the anonymous shared memory
+//      passed over the Unix domain socket.
+//
+// Notes:
+//      <special-instructions>
+//
+//*********************************************************************
+
+#include "Mlos.Core.h"
+#include "Mlos.Core.inl"
+
+#include <unistd.h>
+
+namespace Mlos
+{
+namespace Core
+{
+// Signature of the handshake message ("MLOS").
+//
+constexpr uint32_t AnonymousSharedMemoryHandshakeSignature = 0x534f4c4d;
+
+// Number of the file descriptors passed with the handshake, excluding the telemetry channel events.
+// Global memory, control, feedback and telemetry channel memory, control and feedback channel events.
+//
+constexpr uint32_t AnonymousSharedMemoryFileDescriptorCount = 6;
+
+//----------------------------------------------------------------------------
+// NAME: AnonymousSharedMemoryHandshake
+//
+// PURPOSE:
+//  Message sent by the target process together with the file descriptors.
+//
+// NOTES:
+//  The file descriptors are ordered as follows:
+//   global memory region, control channel, feedback channel, telemetry channel,
+//   control channel event, feedback channel event, telemetry channel shard events.
+//  The agent replies with the HRESULT of attaching to the shared memory.
+//
+struct AnonymousSharedMemoryHandshake
+{
+    uint32_t Signature;
+    uint32_t FileDescriptorCount;
+    uint32_t TelemetryChannelShardCount;
+    char InstanceName[MlosContextOptions::MaxInstanceNameLength + 1];
+};
+
+//----------------------------------------------------------------------------
+// NAME: InterProcessMlosContextInitializer::InitializeAnonymous
+//
+// PURPOSE:
+//  Creates the anonymous shared memory and events used for the communication channels,
+//  and passes them to the agent listening on the Unix domain socket.
+//
+// RETURNS:
+//  HRESULT. Fails if there is no agent listening on the socket, or the agent fails to attach.
+//
+// NOTES:
+//  Shared memory regions are memfds, the notification events are eventfds. They have no names,
+//  so different instances never collide and nothing is left behind if the processes crash.
+//  The handshake completes when the agent has mapped the shared memory.
+//  Memory regions created later by the context (e.g. the shared config) still use the named shared memory.
+//
+_Check_return_
+HRESULT InterProcessMlosContextInitializer::InitializeAnonymous(const char* const socketPath, const MlosContextOptions& options)
+{
+    HRESULT hr = options.Verify();
+    if (FAILED(hr))
+    {
+        return hr;
+    }
+
+    CopyInstanceName(options.InstanceName, m_instanceName);
+
+    m_options = options;
+    m_options.InstanceName = nullptr;
+
+    m_controlChannelMemoryMapView.UseHugePages = options.UseHugePages;
+    m_feedbackChannelMemoryMapView.UseHugePages = options.UseHugePages;
+    m_telemetryChannelMemoryMapView.UseHugePages = options.UseHugePages;
+
+    // Names are only used to identify the memfds in /proc/<pid>/maps.
+    //
+    char sharedObjectName[MaxSharedObjectNameLength];
+
+    hr = FormatSharedObjectName("Host_Mlos.GlobalMemory", m_instanceName, sharedObjectName);
+    if (SUCCEEDED(hr))
+    {
+        hr = m_globalMemoryRegionView.CreateAnonymous(sharedObjectName, options.GlobalMemoryRegionSize);
+    }
+
+    if (SUCCEEDED(hr))
+    {
+        // We created the global memory region, set the telemetry channel shard count and the frame timestamps.
+        //
+        Internal::GlobalMemoryRegion& globalMemoryRegion = m_globalMemoryRegionView.MemoryRegion();
+        globalMemoryRegion.AttachedProcessesCount.fetch_add(1);
+        globalMemoryRegion.TelemetryChannelShardCount.store(options.TelemetryChannelShardCount);
+
+        for (ChannelSynchronization& telemetryChannelSync : globalMemoryRegion.TelemetryChannelSynchronization)
+        {
+            telemetryChannelSync.HasFrameTimestamps.store(options.TelemetryChannelFrameTimestamps);
+            telemetryChannelSync.HasCompactFrameHeaders.store(options.TelemetryChannelCompactFrameHeaders);
+        }
+
+        m_telemetryChannelShardCount = options.TelemetryChannelShardCount;
+    }
+
+    if (SUCCEEDED(hr))
+    {
+        hr = FormatSharedObjectName("Host_Mlos.ControlChannel", m_instanceName, sharedObjectName);
+    }
+
+    if (SUCCEEDED(hr))
+    {
+        hr = m_controlChannelMemoryMapView.CreateAnonymous(sharedObjectName, options.ControlChannelSize);
+    }
+
+    if (SUCCEEDED(hr))
+    {
+        hr = FormatSharedObjectName("Host_Mlos.FeedbackChannel", m_instanceName, sharedObjectName);
+    }
+
+    if (SUCCEEDED(hr))
+    {
+        hr = m_feedbackChannelMemoryMapView.CreateAnonymous(sharedObjectName, options.FeedbackChannelSize);
+    }
+
+    if (SUCCEEDED(hr))
+    {
+        hr = FormatSharedObjectName("Host_Mlos.TelemetryChannel", m_instanceName, sharedObjectName);
+    }
+
+    if (SUCCEEDED(hr))
+    {
+        hr = m_telemetryChannelMemoryMapView.CreateAnonymous(sharedObjectName, options.TelemetryChannelSize);
+    }
+
+    if (SUCCEEDED(hr))
+    {
+        hr = VerifyChannelMemorySize();
+    }
+
+    if (SUCCEEDED(hr))
+    {
+        hr = PrefaultSharedMemory(options);
+    }
+
+    if (SUCCEEDED(hr))
+    {
+        hr = m_controlChannelPolicy.m_notificationEvent.CreateAnonymous();
+    }
+
+    if (SUCCEEDED(hr))
+    {
+        hr = m_feedbackChannelPolicy.m_notificationEvent.CreateAnonymous();
+    }
+
+    for (uint32_t shardIndex = 0; SUCCEEDED(hr) && shardIndex < m_telemetryChannelShardCount; shardIndex++)
+    {
+        hr = m_telemetryChannelPolicies[shardIndex].m_notificationEvent.CreateAnonymous();
+    }
+
+    // Pass the file descriptors to the agent and wait until it attaches.
+    //
+    UnixDomainSocket agentConnection;
+
+    if (SUCCEEDED(hr))
+    {
+        hr = agentConnection.Connect(socketPath);
+    }
+
+    if (SUCCEEDED(hr))
+    {
+        AnonymousSharedMemoryHandshake handshake = { 0 };
+        handshake.Signature = AnonymousSharedMemoryHandshakeSignature;
+        handshake.FileDescriptorCount = AnonymousSharedMemoryFileDescriptorCount + m_telemetryChannelShardCount;
+        handshake.TelemetryChannelShardCount = m_telemetryChannelShardCount;
+        memcpy(handshake.InstanceName, m_instanceName, sizeof(handshake.InstanceName));
+
+        int fileDescriptors[AnonymousSharedMemoryFileDescriptorCount + ShardedSharedChannel::MaxShardCount] =
+        {
+            m_globalMemoryRegionView.FileDescriptor(),
+            m_controlChannelMemoryMapView.FileDescriptor(),
+            m_feedbackChannelMemoryMapView.FileDescriptor(),
+            m_telemetryChannelMemoryMapView.FileDescriptor(),
+            m_controlChannelPolicy.m_notificationEvent.FileDescriptor(),
+            m_feedbackChannelPolicy.m_notificationEvent.FileDescriptor(),
+        };
+
+        for (uint32_t shardIndex = 0; shardIndex < m_telemetryChannelShardCount; shardIndex++)
+        {
+            fileDescriptors[AnonymousSharedMemoryFileDescriptorCount + shardIndex] =
+                m_telemetryChannelPolicies[shardIndex].m_notificationEvent.FileDescriptor();
+        }
+
+        hr = agentConnection.Send(&handshake, sizeof(handshake), fileDescriptors, handshake.FileDescriptorCount);
+    }
+
+    if (SUCCEEDED(hr))
+    {
+        HRESULT agentResult = S_OK;
+        uint32_t fileDescriptorCount = 0;
+
+        hr = agentConnection.Receive(&agentResult, sizeof(agentResult), nullptr, 0, fileDescriptorCount);
+
+        if (SUCCEEDED(hr))
+        {
+            hr = agentResult;
+        }
+    }
+
+    if (FAILED(hr))
+    {
+        Close();
+    }
+
+    return hr;
+}
+
+//----------------------------------------------------------------------------
+// NAME: InterProcessMlosContextInitializer::AcceptAnonymous
+//
+// PURPOSE:
+//  Accepts the anonymous shared memory and events from the target process connecting to the listening socket.
+//
+// RETURNS:
+//  HRESULT. E_INVALIDARG if the handshake is not valid.
+//
+// NOTES:
+//  Used by the agent (or a stand-in agent in the tests), the target process calls InitializeAnonymous.
+//  The instance name, telemetry channel shard count and channel sizes are defined by the target process.
+//  The options only control prefaulting of the shared memory.
+//  The result is sent back to the target process, so it does not wait for an agent which failed to attach.
+//
+_Check_return_
+HRESULT InterProcessMlosContextInitializer::AcceptAnonymous(UnixDomainSocket& listeningSocket, const MlosContextOptions& options)
+{
+    UnixDomainSocket targetConnection;
+
+    HRESULT hr = listeningSocket.Accept(targetConnection);
+    if (FAILED(hr))
+    {
+        return hr;
+    }
+
+    AnonymousSharedMemoryHandshake handshake = { 0 };
+    int fileDescriptors[AnonymousSharedMemoryFileDescriptorCount + ShardedSharedChannel::MaxShardCount];
+    uint32_t fileDescriptorCount = 0;
+
+    hr = targetConnection.Receive(
+        &handshake,
+        sizeof(handshake),
+        fileDescriptors,
+        AnonymousSharedMemoryFileDescriptorCount + ShardedSharedChannel::MaxShardCount,
+        fileDescriptorCount);
+    if (FAILED(hr))
+    {
+        return hr;
+    }
+
+    if (handshake.Signature != AnonymousSharedMemoryHandshakeSignature ||
+        !ShardedSharedChannel::IsValidShardCount(handshake.TelemetryChannelShardCount) ||
+        handshake.FileDescriptorCount != AnonymousSharedMemoryFileDescriptorCount + handshake.TelemetryChannelShardCount ||
+        handshake.FileDescriptorCount != fileDescriptorCount)
+    {
+        hr = E_INVALIDARG;
+    }
+
+    if (SUCCEEDED(hr))
+    {
+        handshake.InstanceName[MlosContextOptions::MaxInstanceNameLength] = '\0';
+        CopyInstanceName(handshake.InstanceName, m_instanceName);
+
+        m_options = options;
+        m_options.InstanceName = nullptr;
+        m_telemetryChannelShardCount = handshake.TelemetryChannelShardCount;
+    }
+
+    // The views and the events take the ownership of the file descriptors.
+    //
+    uint32_t fileDescriptorIndex = 0;
+
+    if (SUCCEEDED(hr))
+    {
+        hr = m_globalMemoryRegionView.OpenFileDescriptor(fileDescriptors[fileDescriptorIndex++]);
+    }
+
+    if (SUCCEEDED(hr))
+    {
+        Internal::GlobalMemoryRegion& globalMemoryRegion = m_globalMemoryRegionView.MemoryRegion();
+
+        if (globalMemoryRegion.TelemetryChannelShardCount.load() != m_telemetryChannelShardCount)
+        {
+            hr = E_INVALIDARG;
+        }
+    }
+
+    if (SUCCEEDED(hr))
+    {
+        hr = m_controlChannelMemoryMapView.OpenFileDescriptor(fileDescriptors[fileDescriptorIndex++]);
+    }
+
+    if (SUCCEEDED(hr))
+    {
+        hr = m_feedbackChannelMemoryMapView.OpenFileDescriptor(fileDescriptors[fileDescriptorIndex++]);
+    }
+
+    if (SUCCEEDED(hr))
+    {
+        hr = m_telemetryChannelMemoryMapView.OpenFileDescriptor(fileDescriptors[fileDescriptorIndex++]);
+    }
+
+    if (SUCCEEDED(hr))
+    {
+        hr = m_controlChannelPolicy.m_notificationEvent.OpenFileDescriptor(fileDescriptors[fileDescriptorIndex++]);
+    }
+
+    if (SUCCEEDED(hr))
+    {
+        hr = m_feedbackChannelPolicy.m_notificationEvent.OpenFileDescriptor(fileDescriptors[fileDescriptorIndex++]);
+    }
+
+    for (uint32_t shardIndex = 0; SUCCEEDED(hr) && shardIndex < m_telemetryChannelShardCount; shardIndex++)
+    {
+        hr = m_telemetryChannelPolicies[shardIndex].m_notificationEvent.OpenFileDescriptor(fileDescriptors[fileDescriptorIndex++]);
+    }
+
+    // Close the file descriptors we did not take the ownership of.
+    //
+    for (; fileDescriptorIndex < fileDescriptorCount; fileDescriptorIndex++)
+    {
+        close(fileDescriptors[fileDescriptorIndex]);
+    }
+
+    if (SUCCEEDED(hr))
+    {
+        hr = VerifyChannelMemorySize();
+    }
+
+    if (SUCCEEDED(hr))
+    {
+        hr = PrefaultSharedMemory(options);
+    }
+
+    // Count the attached process only when the handshake succeeded, before the target process learns the result,
+    // so the target process detaching right after the reply does not see itself as the last attached process.
+    //
+    if (SUCCEEDED(hr))
+    {
+        m_globalMemoryRegionView.MemoryRegion().AttachedProcessesCount.fetch_add(1);
+    }
+
+    // Let the target process know the result.
+    //
+    HRESULT hrReply = targetConnection.Send(&hr, sizeof(hr), nullptr, 0);
+
+    if (SUCCEEDED(hr) && FAILED(hrReply))
+    {
+        // The target process has not received the result, the attach failed.
+        //
+        m_globalMemoryRegionView.MemoryRegion().AttachedProcessesCount.fetch_sub(1);
+        hr = hrReply;
+    }
+
+    if (FAILED(hr))
+    {
+        Close();
+    }
+
+    return hr;
+}
+}
+}
@@ -32,9 +32,16 @@ InterProcessMlosContextInitializer::InterProcessMlosContextInitializer(InterProc
   : m_globalMemoryRegionView(std::move(initializer.m_globalMemoryRegionView)),
     m_controlChannelMemoryMapView(std::move(initializer.m_controlChannelMemoryMapView)),
     m_feedbackChannelMemoryMapView(std::move(initializer.m_feedbackChannelMemoryMapView)),
+    m_telemetryChannelMemoryMapView(std::move(initializer.m_telemetryChannelMemoryMapView)),
     m_controlChannelPolicy(std::move(initializer.m_controlChannelPolicy)),
-    m_feedbackChannelPolicy(std::move(initializer.m_feedbackChannelPolicy))
+    m_feedbackChannelPolicy(std::move(initializer.m_feedbackChannelPolicy)),
+    m_telemetryChannelPolicies(std::move(initializer.m_telemetryChannelPolicies)),
+    m_telemetryChannelShardCount(initializer.m_telemetryChannelShardCount),
+    m_instanceName { 0 },
+    m_options(initializer.m_options),
+    m_prefaultDurationInNanoseconds(initializer.m_prefaultDurationInNanoseconds)
 {
+    memcpy(m_instanceName, initializer.m_instanceName, sizeof(m_instanceName));
 }
 
 //----------------------------------------------------------------------------
@@ -43,19 +50,56 @@ InterProcessMlosContextInitializer::InterProcessMlosContextInitializer(InterProc
 // PURPOSE:
 //  Opens the shared memory and synchronization primitives used for the communication channel.
 //
+// RETURNS:
+//  HRESULT. E_INVALIDARG if the channel sizes are not a power of two or the instance name is not valid.
+//
 // NOTES:
+//  The options define the sizes of the created shared memory regions.
+//  If a shared memory region already exists, its size is used instead.
+//  The instance name from the options is appended to the shared memory and named event names.
+//  The telemetry channel shard count and frame timestamps are set by the process that creates the global memory region.
+//  If requested, the shared memory is prefaulted (and locked), see MlosContext::SharedMemoryPrefaultDurationInNanoseconds.
 //
 _Check_return_
-HRESULT InterProcessMlosContextInitializer::Initialize()
+HRESULT InterProcessMlosContextInitializer::Initialize(const MlosContextOptions& options)
 {
-    // #TODO const as codegen, pass a config struct ?
+    HRESULT hr = options.Verify();
+    if (FAILED(hr))
+    {
+        return hr;
+    }
+
+    // Copy the instance name, the context uses it to name the shared config memory region.
+    //
+    CopyInstanceName(options.InstanceName, m_instanceName);
+
+    // Keep the options, the context uses them to create the memory regions.
+    //
+    m_options = options;
+    m_options.InstanceName = nullptr;
+
+    // The channel buffers use huge pages if requested. The global memory region is small, it uses the regular pages.
     //
-    const size_t SharedMemorySize = 65536;
+    m_controlChannelMemoryMapView.UseHugePages = options.UseHugePages;
+    m_feedbackChannelMemoryMapView.UseHugePages = options.UseHugePages;
+    m_telemetryChannelMemoryMapView.UseHugePages = options.UseHugePages;
 
-    // TODO: Make these config regions configurable to support multiple processes.
+    // Append the instance name to the shared memory and named event names.
     // Note: Shared memory mapping name must start with "Host_" prefix, to be accessible from certain applications.
     //
-    HRESULT hr = m_globalMemoryRegionView.CreateOrOpen("Host_Mlos.GlobalMemory", SharedMemorySize);
+    char sharedObjectName[MaxSharedObjectNameLength];
+
+    hr = FormatSharedObjectName("Host_Mlos.GlobalMemory", m_instanceName, sharedObjectName);
+    if (SUCCEEDED(hr))
+    {
+        hr = m_globalMemoryRegionView.CreateOrOpen(sharedObjectName, options.GlobalMemoryRegionSize);
+    }
+
+    if (SUCCEEDED(hr))
+    {
+        hr = VerifyMlosCoreDispatchTableHash();
+    }
+
     if (SUCCEEDED(hr))
     {
         // Increase the usage counter. When closing global shared memory, we will decrease the counter.
@@ -68,40 +112,231 @@ HRESULT InterProcessMlosContextInitializer::Initialize()
 
     if (SUCCEEDED(hr))
     {
-        hr = m_controlChannelMemoryMapView.CreateOrOpen("Host_Mlos.ControlChannel", SharedMemorySize);
+        // The first process sets the telemetry channel shard count and the frame timestamps,
+        // other processes use the existing ones.
+        //
+        Internal::GlobalMemoryRegion& globalMemoryRegion = m_globalMemoryRegionView.MemoryRegion();
+
+        uint32_t telemetryChannelShardCount = 0;
+        if (globalMemoryRegion.TelemetryChannelShardCount.compare_exchange_strong(
+            telemetryChannelShardCount,
+            options.TelemetryChannelShardCount))
+        {
+            telemetryChannelShardCount = options.TelemetryChannelShardCount;
+
+            for (ChannelSynchronization& telemetryChannelSync : globalMemoryRegion.TelemetryChannelSynchronization)
+            {
+                telemetryChannelSync.HasFrameTimestamps.store(options.TelemetryChannelFrameTimestamps);
+                telemetryChannelSync.HasCompactFrameHeaders.store(options.TelemetryChannelCompactFrameHeaders);
+            }
+        }
+
+        if (!ShardedSharedChannel::IsValidShardCount(telemetryChannelShardCount))
+        {
+            hr = E_INVALIDARG;
+        }
+
+        m_telemetryChannelShardCount = telemetryChannelShardCount;
+    }
+
+    if (SUCCEEDED(hr))
+    {
+        hr = FormatSharedObjectName("Host_Mlos.ControlChannel", m_instanceName, sharedObjectName);
+    }
+
+    if (SUCCEEDED(hr))
+    {
+        hr = m_controlChannelMemoryMapView.CreateOrOpen(sharedObjectName, options.ControlChannelSize);
+    }
+
+    if (SUCCEEDED(hr))
+    {
+        hr = FormatSharedObjectName("Host_Mlos.FeedbackChannel", m_instanceName, sharedObjectName);
+    }
+
+    if (SUCCEEDED(hr))
+    {
+        hr = m_feedbackChannelMemoryMapView.CreateOrOpen(sharedObjectName, options.FeedbackChannelSize);
+    }
+
+    if (SUCCEEDED(hr))
+    {
+        hr = FormatSharedObjectName("Host_Mlos.TelemetryChannel", m_instanceName, sharedObjectName);
     }
 
     if (SUCCEEDED(hr))
     {
-        hr = m_feedbackChannelMemoryMapView.CreateOrOpen("Host_Mlos.FeedbackChannel", SharedMemorySize);
+        hr = m_telemetryChannelMemoryMapView.CreateOrOpen(sharedObjectName, options.TelemetryChannelSize);
+    }
+
+    if (SUCCEEDED(hr))
+    {
+        hr = VerifyChannelMemorySize();
+    }
+
+    if (SUCCEEDED(hr))
+    {
+        hr = PrefaultSharedMemory(options);
     }
 
     // FIXME: Use non-backslashes for Linux environments.
     //
     if (SUCCEEDED(hr))
     {
-        hr = m_controlChannelPolicy.m_notificationEvent.CreateOrOpen("Global\\ControlChannel_Event");
+        hr = FormatSharedObjectName("Global\\ControlChannel_Event", m_instanceName, sharedObjectName);
     }
 
     if (SUCCEEDED(hr))
     {
-        hr = m_feedbackChannelPolicy.m_notificationEvent.CreateOrOpen("Global\\FeedbackChannel_Event");
+        hr = m_controlChannelPolicy.m_notificationEvent.CreateOrOpen(sharedObjectName);
+    }
+
+    if (SUCCEEDED(hr))
+    {
+        hr = FormatSharedObjectName("Global\\FeedbackChannel_Event", m_instanceName, sharedObjectName);
+    }
+
+    if (SUCCEEDED(hr))
+    {
+        hr = m_feedbackChannelPolicy.m_notificationEvent.CreateOrOpen(sharedObjectName);
+    }
+
+    // Each telemetry channel shard has its own event, the first shard uses the same name as the unsharded channel.
+    //
+    for (uint32_t shardIndex = 0; SUCCEEDED(hr) && shardIndex < m_telemetryChannelShardCount; shardIndex++)
+    {
+        char eventName[MaxSharedObjectNameLength] = "Global\\TelemetryChannel_Event";
+
+        if (shardIndex != 0)
+        {
+            snprintf(eventName, sizeof(eventName), "Global\\TelemetryChannel_Event_Shard%u", shardIndex);
+        }
+
+        hr = FormatSharedObjectName(eventName, m_instanceName, sharedObjectName);
+
+        if (SUCCEEDED(hr))
+        {
+            hr = m_telemetryChannelPolicies[shardIndex].m_notificationEvent.CreateOrOpen(sharedObjectName);
+        }
     }
 
     if (FAILED(hr))
     {
         // Close all the shared maps if we fail to create one.
         //
-        m_globalMemoryRegionView.Close();
-        m_controlChannelMemoryMapView.Close();
-        m_feedbackChannelMemoryMapView.Close();
-        m_controlChannelPolicy.m_notificationEvent.Close();
-        m_feedbackChannelPolicy.m_notificationEvent.Close();
+        Close();
     }
 
     return hr;
 }
 
+//----------------------------------------------------------------------------
+// NAME: InterProcessMlosContextInitializer::VerifyChannelMemorySize
+//
+// PURPOSE:
+//  Verifies the channels can use the shared memory.
+//
+// RETURNS:
+//  HRESULT. E_INVALIDARG if a channel buffer size is not a power of two.
+//
+// NOTES:
+//  Shared memory created by another process keeps its size.
+//
+_Check_return_
+HRESULT InterProcessMlosContextInitializer::VerifyChannelMemorySize() const
+{
+    if (!ISharedChannel::IsValidBufferSize(m_controlChannelMemoryMapView.MemSize) ||
+        !ISharedChannel::IsValidBufferSize(m_feedbackChannelMemoryMapView.MemSize) ||
+        !ISharedChannel::IsValidBufferSize(m_telemetryChannelMemoryMapView.MemSize / m_telemetryChannelShardCount))
+    {
+        return E_INVALIDARG;
+    }
+
+    return S_OK;
+}
+
+//----------------------------------------------------------------------------
+// NAME: InterProcessMlosContextInitializer::VerifyMlosCoreDispatchTableHash
+//
+// PURPOSE:
+//  Verifies the Mlos.Core types match the process which created the global memory region.
+//
+// RETURNS:
+//  HRESULT. E_INVALIDARG if the telemetry channel has the compact frame headers and the Mlos.Core dispatch table hashes differ.
+//
+// NOTES:
+//  The compact frame headers have no type hash, the Mlos.Core messages are not registered with a settings assembly config.
+//
+_Check_return_
+HRESULT InterProcessMlosContextInitializer::VerifyMlosCoreDispatchTableHash()
+{
+    Internal::GlobalMemoryRegion& globalMemoryRegion = m_globalMemoryRegionView.MemoryRegion();
+
+    if (globalMemoryRegion.TelemetryChannelSynchronization[0].HasCompactFrameHeaders.load() &&
+        globalMemoryRegion.MlosCoreDispatchTableHash != DispatchTableHash(ObjectDeserializationHandler::DispatchTable))
+    {
+        return E_INVALIDARG;
+    }
+
+    return S_OK;
+}
+
+//----------------------------------------------------------------------------
+// NAME: InterProcessMlosContextInitializer::PrefaultSharedMemory
+//
+// PURPOSE:
+//  Prefaults the shared memory, so the first messages do not page-fault in the latency-critical path.
+//
+// RETURNS:
+//  HRESULT.
+//
+// NOTES:
+//  No-op unless requested by the options.
+//
+_Check_return_
+HRESULT InterProcessMlosContextInitializer::PrefaultSharedMemory(const MlosContextOptions& options)
+{
+    HRESULT hr = Mlos::Core::PrefaultSharedMemory(m_globalMemoryRegionView, options, m_prefaultDurationInNanoseconds);
+
+    if (SUCCEEDED(hr))
+    {
+        hr = Mlos::Core::PrefaultSharedMemory(m_controlChannelMemoryMapView, options, m_prefaultDurationInNanoseconds);
+    }
+
+    if (SUCCEEDED(hr))
+    {
+        hr = Mlos::Core::PrefaultSharedMemory(m_feedbackChannelMemoryMapView, options, m_prefaultDurationInNanoseconds);
+    }
+
+    if (SUCCEEDED(hr))
+    {
+        hr = Mlos::Core::PrefaultSharedMemory(m_telemetryChannelMemoryMapView, options, m_prefaultDurationInNanoseconds);
+    }
+
+    return hr;
+}
+
+//----------------------------------------------------------------------------
+// NAME: InterProcessMlosContextInitializer::Close
+//
+// PURPOSE:
+//  Closes the shared memory and the events.
+//
+void InterProcessMlosContextInitializer::Close()
+{
+    m_globalMemoryRegionView.Close();
+    m_controlChannelMemoryMapView.Close();
+    m_feedbackChannelMemoryMapView.Close();
+    m_telemetryChannelMemoryMapView.Close();
+    m_controlChannelPolicy.m_notificationEvent.Close();
+    m_feedbackChannelPolicy.m_notificationEvent.Close();
+
+    for (InterProcessSharedChannelPolicy& telemetryChannelPolicy : m_telemetryChannelPolicies)
+    {
+        telemetryChannelPolicy.m_notificationEvent.Close();
+    }
+}
+
 //----------------------------------------------------------------------------
 // NAME: InterProcessMlosContext::Constructor
 //
@@ -111,7 +346,14 @@ HRESULT InterProcessMlosContextInitializer::Initialize()
 // NOTES:
 //
 InterProcessMlosContext::InterProcessMlosContext(InterProcessMlosContextInitializer&& initializer) noexcept
-  : MlosContext(initializer.m_globalMemoryRegionView.MemoryRegion(), m_controlChannel, m_controlChannel, m_feedbackChannel),
+  : MlosContext(
+        initializer.m_globalMemoryRegionView.MemoryRegion(),
+        m_controlChannel,
+        m_telemetryChannel,
+        m_feedbackChannel,
+        initializer.m_instanceName,
+        initializer.m_options,
+        initializer.m_prefaultDurationInNanoseconds),
     m_contextInitializer(std::move(initializer)),
     m_controlChannel(
         m_contextInitializer.m_globalMemoryRegionView.MemoryRegion().ControlChannelSynchronization,
@@ -120,8 +362,31 @@ InterProcessMlosContext::InterProcessMlosContext(InterProcessMlosContextInitiali
     m_feedbackChannel(
         m_contextInitializer.m_globalMemoryRegionView.MemoryRegion().FeedbackChannelSynchronization,
         m_contextInitializer.m_feedbackChannelMemoryMapView,
-        std::move(m_contextInitializer.m_feedbackChannelPolicy))
+        std::move(m_contextInitializer.m_feedbackChannelPolicy)),
+    m_telemetryChannel()
 {
+    // Split the telemetry channel memory into the shards.
+    //
+    Internal::GlobalMemoryRegion& globalMemoryRegion = m_contextInitializer.m_globalMemoryRegionView.MemoryRegion();
+    SharedMemoryMapView& telemetryChannelMemoryMapView = m_contextInitializer.m_telemetryChannelMemoryMapView;
+
+    const uint32_t shardCount = m_contextInitializer.m_telemetryChannelShardCount;
+    const uint32_t shardSize = static_cast<uint32_t>(telemetryChannelMemoryMapView.MemSize / shardCount);
+
+    for (uint32_t shardIndex = 0; shardIndex < shardCount; shardIndex++)
+    {
+        bool result = m_telemetryChannelShards.EmplaceBack(
+            globalMemoryRegion.TelemetryChannelSynchronization[shardIndex],
+            BytePtr(telemetryChannelMemoryMapView.Buffer.Pointer + shardIndex * shardSize),
+            shardSize,
+            std::move(m_contextInitializer.m_telemetryChannelPolicies[shardIndex]));
+        RETAIL_ASSERT(result);
+
+        HRESULT hr = m_telemetryChannel.AddShard(m_telemetryChannelShards[shardIndex]);
+        RETAIL_ASSERT(SUCCEEDED(hr));
+    }
+
+    RegisterSharedChannelSpinPolicyConfig();
 }
 
 //----------------------------------------------------------------------------
@@ -131,6 +396,8 @@ InterProcessMlosContext::InterProcessMlosContext(InterProcessMlosContextInitiali
 //  Destroys InterProcessMlosContext object.
 //
 // NOTES:
+//  Anonymous shared memory and events have no names, the cleanup is a no-op for them.
+//  They are released when the last process closes them.
 //
 InterProcessMlosContext::~InterProcessMlosContext()
 {
@@ -144,8 +411,14 @@ InterProcessMlosContext::~InterProcessMlosContext()
         m_contextInitializer.m_globalMemoryRegionView.CleanupOnClose = true;
         m_contextInitializer.m_controlChannelMemoryMapView.CleanupOnClose = true;
         m_contextInitializer.m_feedbackChannelMemoryMapView.CleanupOnClose = true;
+        m_contextInitializer.m_telemetryChannelMemoryMapView.CleanupOnClose = true;
         m_controlChannel.ChannelPolicy.m_notificationEvent.CleanupOnClose = true;
         m_feedbackChannel.ChannelPolicy.m_notificationEvent.CleanupOnClose = true;
+
+        for (uint32_t shardIndex = 0; shardIndex < m_telemetryChannel.ShardCount(); shardIndex++)
+        {
+            m_telemetryChannelShards[shardIndex].ChannelPolicy.m_notificationEvent.CleanupOnClose = true;
+        }
     }
 }
 }
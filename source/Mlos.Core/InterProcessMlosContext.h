@@ -33,7 +33,19 @@ public:
     InterProcessMlosContextInitializer() {}
 
     _Check_return_
-    HRESULT Initialize();
+    HRESULT Initialize(const MlosContextOptions& options = MlosContextOptions());
+
+#ifndef _WIN64
+    // Creates the anonymous shared memory and events, and passes them to the agent listening on the Unix domain socket.
+    //
+    _Check_return_
+    HRESULT InitializeAnonymous(const char* const socketPath, const MlosContextOptions& options = MlosContextOptions());
+
+    // Accepts the anonymous shared memory and events from the target process connecting to the listening socket.
+    //
+    _Check_return_
+    HRESULT AcceptAnonymous(UnixDomainSocket& listeningSocket, const MlosContextOptions& options = MlosContextOptions());
+#endif
 
     InterProcessMlosContextInitializer(InterProcessMlosContextInitializer&& initializer) noexcept;
 
@@ -41,12 +53,32 @@ public:
 
     InterProcessMlosContextInitializer& operator=(const InterProcessMlosContextInitializer&) = delete;
 
+private:
+    // Verifies the channels can use the shared memory, it might have been created by another process.
+    //
+    _Check_return_
+    HRESULT VerifyChannelMemorySize() const;
+
+    // Verifies the Mlos.Core types match the process which created the global memory region.
+    //
+    _Check_return_
+    HRESULT VerifyMlosCoreDispatchTableHash();
+
+    // Prefaults the shared memory if requested by the options.
+    //
+    _Check_return_
+    HRESULT PrefaultSharedMemory(const MlosContextOptions& options);
+
+    // Closes the shared memory and the events.
+    //
+    void Close();
+
 private:
     // Global shared memory region.
     //
     SharedMemoryRegionView<Internal::GlobalMemoryRegion> m_globalMemoryRegionView;
 
-    // Named shared memory for Telemetry and Control Channel.
+    // Named shared memory for Control Channel.
     //
     SharedMemoryMapView m_controlChannelMemoryMapView;
 
@@ -54,6 +86,10 @@ private:
     //
     SharedMemoryMapView m_feedbackChannelMemoryMapView;
 
+    // Named shared memory for Telemetry Channel.
+    //
+    SharedMemoryMapView m_telemetryChannelMemoryMapView;
+
     // Channel policy for control channel.
     //
     InterProcessSharedChannelPolicy m_controlChannelPolicy;
@@ -62,6 +98,27 @@ private:
     //
     InterProcessSharedChannelPolicy m_feedbackChannelPolicy;
 
+    // Channel policies for telemetry channel shards.
+    //
+    std::array<InterProcessSharedChannelPolicy, ShardedSharedChannel::MaxShardCount> m_telemetryChannelPolicies;
+
+    // Number of telemetry channel shards.
+    //
+    uint32_t m_telemetryChannelShardCount = 0;
+
+    // Name of the MlosContext instance, empty for the default instance.
+    //
+    char m_instanceName[MlosContextOptions::MaxInstanceNameLength + 1] = { 0 };
+
+    // Options of the shared memory, the context uses them to create the memory regions.
+    // The instance name is copied to m_instanceName.
+    //
+    MlosContextOptions m_options;
+
+    // Time spent prefaulting the shared memory.
+    //
+    uint64_t m_prefaultDurationInNanoseconds = 0;
+
     friend class InterProcessMlosContext;
 };
 
@@ -85,6 +142,10 @@ private:
 
     InterProcessSharedChannel m_feedbackChannel;
 
+    StaticVector<InterProcessSharedChannel, ShardedSharedChannel::MaxShardCount> m_telemetryChannelShards;
+
+    ShardedSharedChannel m_telemetryChannel;
+
     NamedEvent m_controlChannelNamedEvent;
 
     NamedEvent m_feedbackChannelNamedEvent;
@@ -31,8 +31,14 @@ namespace Core
 InternalMlosContextInitializer::InternalMlosContextInitializer(InternalMlosContextInitializer&& initializer) noexcept
   : m_globalMemoryRegionView(std::move(initializer.m_globalMemoryRegionView)),
     m_controlChannelMemoryMapView(std::move(initializer.m_controlChannelMemoryMapView)),
-    m_feedbackChannelMemoryMapView(std::move(initializer.m_feedbackChannelMemoryMapView))
+    m_feedbackChannelMemoryMapView(std::move(initializer.m_feedbackChannelMemoryMapView)),
+    m_telemetryChannelMemoryMapView(std::move(initializer.m_telemetryChannelMemoryMapView)),
+    m_telemetryChannelShardCount(initializer.m_telemetryChannelShardCount),
+    m_instanceName { 0 },
+    m_options(initializer.m_options),
+    m_prefaultDurationInNanoseconds(initializer.m_prefaultDurationInNanoseconds)
 {
+    memcpy(m_instanceName, initializer.m_instanceName, sizeof(m_instanceName));
 }
 
 //----------------------------------------------------------------------------
@@ -44,25 +50,102 @@ InternalMlosContextInitializer::InternalMlosContextInitializer(InternalMlosConte
 // NOTES:
 //
 _Check_return_
-HRESULT InternalMlosContextInitializer::Initialize()
+HRESULT InternalMlosContextInitializer::Initialize(const MlosContextOptions& options)
 {
-    const size_t SharedMemorySize = 65536;
+    HRESULT hr = options.Verify();
 
-    HRESULT hr = S_OK;
+    if (SUCCEEDED(hr))
+    {
+        CopyInstanceName(options.InstanceName, m_instanceName);
+    }
+
+    // Keep the options, the context uses them to create the memory regions.
+    //
+    m_options = options;
+    m_options.InstanceName = nullptr;
+
+    m_controlChannelMemoryMapView.UseHugePages = options.UseHugePages;
+    m_feedbackChannelMemoryMapView.UseHugePages = options.UseHugePages;
+    m_telemetryChannelMemoryMapView.UseHugePages = options.UseHugePages;
+
+    // Append the instance name to the shared memory names, so the tests can create independent contexts.
+    //
+    char sharedObjectName[MaxSharedObjectNameLength];
+
+    if (SUCCEEDED(hr))
+    {
+        hr = FormatSharedObjectName("Test_Mlos.GlobalMemory", m_instanceName, sharedObjectName);
+    }
+
+    if (SUCCEEDED(hr))
+    {
+        hr = m_globalMemoryRegionView.Create(sharedObjectName, options.GlobalMemoryRegionSize);
+    }
+
+    if (SUCCEEDED(hr))
+    {
+        Internal::GlobalMemoryRegion& globalMemoryRegion = m_globalMemoryRegionView.MemoryRegion();
+
+        globalMemoryRegion.TelemetryChannelShardCount.store(options.TelemetryChannelShardCount);
+        m_telemetryChannelShardCount = options.TelemetryChannelShardCount;
+
+        for (ChannelSynchronization& telemetryChannelSync : globalMemoryRegion.TelemetryChannelSynchronization)
+        {
+            telemetryChannelSync.HasFrameTimestamps.store(options.TelemetryChannelFrameTimestamps);
+            telemetryChannelSync.HasCompactFrameHeaders.store(options.TelemetryChannelCompactFrameHeaders);
+        }
+    }
+
+    if (SUCCEEDED(hr))
+    {
+        hr = FormatSharedObjectName("Test_SharedChannelMemory", m_instanceName, sharedObjectName);
+    }
+
+    if (SUCCEEDED(hr))
+    {
+        hr = m_controlChannelMemoryMapView.Create(sharedObjectName, options.ControlChannelSize);
+    }
+
+    if (SUCCEEDED(hr))
+    {
+        hr = FormatSharedObjectName("Test_FeedbackChannelMemory", m_instanceName, sharedObjectName);
+    }
+
+    if (SUCCEEDED(hr))
+    {
+        hr = m_feedbackChannelMemoryMapView.Create(sharedObjectName, options.FeedbackChannelSize);
+    }
 
     if (SUCCEEDED(hr))
     {
-        hr = m_globalMemoryRegionView.Create("Test_Mlos.GlobalMemory", SharedMemorySize);
+        hr = FormatSharedObjectName("Test_TelemetryChannelMemory", m_instanceName, sharedObjectName);
     }
 
     if (SUCCEEDED(hr))
     {
-        hr = m_controlChannelMemoryMapView.Create("Test_SharedChannelMemory", SharedMemorySize);
+        hr = m_telemetryChannelMemoryMapView.Create(sharedObjectName, options.TelemetryChannelSize);
     }
 
+    // Prefault the shared memory, so the first messages do not page-fault in the latency-critical path.
+    //
     if (SUCCEEDED(hr))
     {
-        hr = m_feedbackChannelMemoryMapView.Create("Test_FeedbackChannelMemory", SharedMemorySize);
+        hr = PrefaultSharedMemory(m_globalMemoryRegionView, options, m_prefaultDurationInNanoseconds);
+    }
+
+    if (SUCCEEDED(hr))
+    {
+        hr = PrefaultSharedMemory(m_controlChannelMemoryMapView, options, m_prefaultDurationInNanoseconds);
+    }
+
+    if (SUCCEEDED(hr))
+    {
+        hr = PrefaultSharedMemory(m_feedbackChannelMemoryMapView, options, m_prefaultDurationInNanoseconds);
+    }
+
+    if (SUCCEEDED(hr))
+    {
+        hr = PrefaultSharedMemory(m_telemetryChannelMemoryMapView, options, m_prefaultDurationInNanoseconds);
     }
 
     if (FAILED(hr))
@@ -72,6 +155,7 @@ HRESULT InternalMlosContextInitializer::Initialize()
         m_globalMemoryRegionView.Close();
         m_controlChannelMemoryMapView.Close();
         m_feedbackChannelMemoryMapView.Close();
+        m_telemetryChannelMemoryMapView.Close();
     }
 
     return hr;
@@ -86,15 +170,44 @@ HRESULT InternalMlosContextInitializer::Initialize()
 // NOTES:
 //
 InternalMlosContext::InternalMlosContext(InternalMlosContextInitializer&& initializer) noexcept
-  : MlosContext(initializer.m_globalMemoryRegionView.MemoryRegion(), m_controlChannel, m_controlChannel, m_feedbackChannel),
+  : MlosContext(
+        initializer.m_globalMemoryRegionView.MemoryRegion(),
+        m_controlChannel,
+        m_telemetryChannel,
+        m_feedbackChannel,
+        initializer.m_instanceName,
+        initializer.m_options,
+        initializer.m_prefaultDurationInNanoseconds),
     m_contextInitializer(std::move(initializer)),
     m_controlChannel(
         m_contextInitializer.m_globalMemoryRegionView.MemoryRegion().ControlChannelSynchronization,
         m_contextInitializer.m_controlChannelMemoryMapView),
     m_feedbackChannel(
         m_contextInitializer.m_globalMemoryRegionView.MemoryRegion().FeedbackChannelSynchronization,
-        m_contextInitializer.m_feedbackChannelMemoryMapView)
+        m_contextInitializer.m_feedbackChannelMemoryMapView),
+    m_telemetryChannel()
 {
+    // Split the telemetry channel memory into the shards.
+    //
+    Internal::GlobalMemoryRegion& globalMemoryRegion = m_contextInitializer.m_globalMemoryRegionView.MemoryRegion();
+    SharedMemoryMapView& telemetryChannelMemoryMapView = m_contextInitializer.m_telemetryChannelMemoryMapView;
+
+    const uint32_t shardCount = m_contextInitializer.m_telemetryChannelShardCount;
+    const uint32_t shardSize = static_cast<uint32_t>(telemetryChannelMemoryMapView.MemSize / shardCount);
+
+    for (uint32_t shardIndex = 0; shardIndex < shardCount; shardIndex++)
+    {
+        bool result = m_telemetryChannelShards.EmplaceBack(
+            globalMemoryRegion.TelemetryChannelSynchronization[shardIndex],
+            BytePtr(telemetryChannelMemoryMapView.Buffer.Pointer + shardIndex * shardSize),
+            shardSize);
+        RETAIL_ASSERT(result);
+
+        HRESULT hr = m_telemetryChannel.AddShard(m_telemetryChannelShards[shardIndex]);
+        RETAIL_ASSERT(SUCCEEDED(hr));
+    }
+
+    RegisterSharedChannelSpinPolicyConfig();
 }
 }
 }
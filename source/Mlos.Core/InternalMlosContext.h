@@ -33,7 +33,7 @@ public:
     InternalMlosContextInitializer() {}
 
     _Check_return_
-    HRESULT Initialize();
+    HRESULT Initialize(const MlosContextOptions& options = MlosContextOptions());
 
     InternalMlosContextInitializer(InternalMlosContextInitializer&& initializer) noexcept;
 
@@ -46,7 +46,7 @@ private:
     //
     SharedMemoryRegionView<Internal::GlobalMemoryRegion> m_globalMemoryRegionView;
 
-    // Named shared memory for Telemetry and Control Channel.
+    // Named shared memory for Control Channel.
     //
     SharedMemoryMapView m_controlChannelMemoryMapView;
 
@@ -54,6 +54,27 @@ private:
     //
     SharedMemoryMapView m_feedbackChannelMemoryMapView;
 
+    // Named shared memory for Telemetry Channel.
+    //
+    SharedMemoryMapView m_telemetryChannelMemoryMapView;
+
+    // Number of telemetry channel shards.
+    //
+    uint32_t m_telemetryChannelShardCount = 0;
+
+    // Name of the MlosContext instance, empty for the default instance.
+    //
+    char m_instanceName[MlosContextOptions::MaxInstanceNameLength + 1] = { 0 };
+
+    // Options of the shared memory, the context uses them to create the memory regions.
+    // The instance name is copied to m_instanceName.
+    //
+    MlosContextOptions m_options;
+
+    // Time spent prefaulting the shared memory.
+    //
+    uint64_t m_prefaultDurationInNanoseconds = 0;
+
     friend class InternalMlosContext;
 };
 
@@ -62,8 +83,7 @@ private:
 //
 // PURPOSE:
 //  Simple implementation of MlosContext.
-//  Single channel used to send control and telemetry messages.
-//  Channel does not use OS synchronization primitive, sender and receiver thread should be running inside the same process.
+//  Channels do not use OS synchronization primitive, sender and receiver thread should be running inside the same process.
 //
 // NOTES:
 //  Intended to use only in the test.
@@ -79,6 +99,10 @@ private:
     TestSharedChannel m_controlChannel;
 
     TestSharedChannel m_feedbackChannel;
+
+    StaticVector<TestSharedChannel, ShardedSharedChannel::MaxShardCount> m_telemetryChannelShards;
+
+    ShardedSharedChannel m_telemetryChannel;
 };
 }
 }
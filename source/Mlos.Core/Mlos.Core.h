@@ -16,13 +16,21 @@
 #pragma once
 
 #include <cstdint>
+#include <cstdio>
 #include <cassert>
 #include <stddef.h>
 #include <limits>
+#include <algorithm>
 #include <atomic>
+#include <chrono>
+#include <condition_variable>
 #include <array>
 #include <functional>
+#include <memory>
+#include <mutex>
+#include <new>
 #include <type_traits>
+#include <utility>
 #include <string.h>
 
 // Undefine MIN MAX macros.
@@ -41,11 +49,20 @@
 #include <sddl.h>
 #include <strsafe.h>
 #include <aclapi.h>
+
+// Windows does not define a timeout HRESULT.
+//
+#define E_TIMEOUT HRESULT_FROM_WIN32(ERROR_TIMEOUT)
+
+// The lossy shared channel dropped the message.
+//
+#define E_MESSAGE_DROPPED HRESULT_FROM_WIN32(ERROR_INSUFFICIENT_BUFFER)
 #else
 
 // Linux.
 //
 #include <errno.h>
+#include <sched.h>
 typedef int32_t HRESULT;
 typedef unsigned char byte;
 
@@ -65,6 +82,10 @@ constexpr int32_t INVALID_FD_VALUE = -1;
 #define S_FALSE 1
 #define E_OUTOFMEMORY (-ENOMEM)
 #define E_NOT_SET (-ENOENT)
+#define E_INVALIDARG (-EINVAL)
+#define E_ABORT (-ECANCELED)
+#define E_TIMEOUT (-ETIMEDOUT)
+#define E_MESSAGE_DROPPED (-ENOBUFS)
 #define HRESULT_FROM_ERRNO(errno) (-errno)
 
 #endif
@@ -83,6 +104,8 @@ constexpr int32_t INVALID_FD_VALUE = -1;
 #else
 #include "SharedMemoryMapView.Linux.h"
 #include "NamedEvent.Linux.h"
+#include "Futex.Linux.h"
+#include "UnixDomainSocket.Linux.h"
 #endif
 
 #include "Hash.h"
@@ -91,7 +114,9 @@ constexpr int32_t INVALID_FD_VALUE = -1;
 #include "ObjectDeserializationCallback.h"
 #include "StringTypes.h"
 #include "ObjectSerialization.h"
+#include "ObjectAggregation.h"
 #include "Utils.h"
+#include "StaticVector.h"
 
 #include "PropertyProxyStringPtr.h"
 
@@ -111,8 +136,11 @@ constexpr int32_t INVALID_FD_VALUE = -1;
 
 // Include shared channel implementation.
 //
+#include "DispatchWorkerPool.h"
 #include "SharedChannel.h"
 #include "SharedChannelPolicies.h"
+#include "SharedChannel64.h"
+#include "ShardedSharedChannel.h"
 
 // Mlos.Core memory regions and Mlos.Core messages.
 //
@@ -120,7 +148,10 @@ constexpr int32_t INVALID_FD_VALUE = -1;
 #include "SharedConfig.h"
 #include "GlobalMemoryRegion.h"
 #include "SharedConfigMemoryRegion.h"
+#include "ChannelLatencyMemoryRegion.h"
 #include "ComponentConfig.h"
+#include "TelemetrySampler.h"
+#include "TelemetryAggregator.h"
 #include "SharedConfigManager.h"
 
 // Include Mlos Client API.
@@ -129,7 +160,6 @@ constexpr int32_t INVALID_FD_VALUE = -1;
 #include "InternalMlosContext.h"
 #include "InterProcessMlosContext.h"
 #include "StaticSingleton.h"
-#include "StaticVector.h"
 
 // Implementation.
 //
@@ -137,7 +167,11 @@ constexpr int32_t INVALID_FD_VALUE = -1;
 #include "MlosContext.inl"
 #include "ComponentConfig.inl"
 #include "SharedChannel.inl"
+#include "SharedChannel64.inl"
+#include "ShardedSharedChannel.inl"
 #include "SharedConfigManager.inl"
+#include "TelemetrySampler.inl"
+#include "TelemetryAggregator.inl"
 
 // Mlos.Core assembly is always registered first.
 //
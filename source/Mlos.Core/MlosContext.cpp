@@ -20,6 +20,169 @@ namespace Mlos
 {
 namespace Core
 {
+//----------------------------------------------------------------------------
+// NAME: MlosContextOptions::Verify
+//
+// PURPOSE:
+//  Verifies the shared memory region sizes, the telemetry channel shard count and the instance name.
+//
+// RETURNS:
+//  S_OK if the options are valid, E_INVALIDARG otherwise.
+//
+// NOTES:
+//
+_Check_return_
+HRESULT MlosContextOptions::Verify() const
+{
+    if (GlobalMemoryRegionSize < sizeof(Internal::GlobalMemoryRegion))
+    {
+        return E_INVALIDARG;
+    }
+
+    if (!ISharedChannel::IsValidBufferSize(ControlChannelSize) ||
+        !ISharedChannel::IsValidBufferSize(FeedbackChannelSize) ||
+        !ISharedChannel::IsValidBufferSize(TelemetryChannelSize))
+    {
+        return E_INVALIDARG;
+    }
+
+    // Each telemetry channel shard must be a valid channel buffer.
+    //
+    if (!ShardedSharedChannel::IsValidShardCount(TelemetryChannelShardCount) ||
+        !ISharedChannel::IsValidBufferSize(TelemetryChannelSize / TelemetryChannelShardCount))
+    {
+        return E_INVALIDARG;
+    }
+
+    if (InstanceName != nullptr)
+    {
+        // The instance name is a part of the shared memory and named event names, do not allow the path separators.
+        //
+        size_t instanceNameLength = 0;
+        for (const char* c = InstanceName; *c != '\0'; c++, instanceNameLength++)
+        {
+            const bool isAllowed = (*c >= 'a' && *c <= 'z') ||
+                (*c >= 'A' && *c <= 'Z') ||
+                (*c >= '0' && *c <= '9') ||
+                *c == '_' ||
+                *c == '-' ||
+                *c == '.';
+            if (!isAllowed)
+            {
+                return E_INVALIDARG;
+            }
+        }
+
+        if (instanceNameLength > MaxInstanceNameLength)
+        {
+            return E_INVALIDARG;
+        }
+    }
+
+    return S_OK;
+}
+
+//----------------------------------------------------------------------------
+// NAME: FormatSharedObjectName
+//
+// PURPOSE:
+//  Creates the name of the shared memory region or named event for the given MlosContext instance.
+//
+// RETURNS:
+//  HRESULT. E_INVALIDARG if the name is too long.
+//
+// NOTES:
+//  The name is "<baseName>.<instanceName>", or the base name if the instance name is not set.
+//
+_Check_return_
+HRESULT FormatSharedObjectName(
+    const char* const baseName,
+    const char* const instanceName,
+    _Out_ char (&name)[MaxSharedObjectNameLength])
+{
+    const size_t baseNameLength = strlen(baseName);
+    const size_t instanceNameLength = (instanceName == nullptr) ? 0 : strlen(instanceName);
+    const size_t nameLength = baseNameLength + ((instanceNameLength == 0) ? 0 : instanceNameLength + 1);
+
+    if (nameLength >= MaxSharedObjectNameLength)
+    {
+        name[0] = '\0';
+        return E_INVALIDARG;
+    }
+
+    memcpy(name, baseName, baseNameLength);
+
+    if (instanceNameLength != 0)
+    {
+        name[baseNameLength] = '.';
+        memcpy(name + baseNameLength + 1, instanceName, instanceNameLength);
+    }
+
+    name[nameLength] = '\0';
+
+    return S_OK;
+}
+
+//----------------------------------------------------------------------------
+// NAME: CopyInstanceName
+//
+// PURPOSE:
+//  Copies the instance name to the fixed size buffer.
+//
+// RETURNS:
+//  Nothing.
+//
+// NOTES:
+//  The name is truncated to MaxInstanceNameLength and always terminated, an empty name is stored if it is not set.
+//
+void CopyInstanceName(
+    const char* const instanceName,
+    _Out_ char (&name)[MlosContextOptions::MaxInstanceNameLength + 1])
+{
+    const size_t instanceNameLength = (instanceName == nullptr)
+        ? 0
+        : strnlen(instanceName, MlosContextOptions::MaxInstanceNameLength);
+
+    if (instanceNameLength != 0)
+    {
+        memcpy(name, instanceName, instanceNameLength);
+    }
+
+    name[instanceNameLength] = '\0';
+}
+
+//----------------------------------------------------------------------------
+// NAME: PrefaultSharedMemory
+//
+// PURPOSE:
+//  Prefaults and optionally locks the shared memory view as requested by the options.
+//
+// RETURNS:
+//  HRESULT.
+//
+// NOTES:
+//  The time spent is added to the given duration.
+//
+_Check_return_
+HRESULT PrefaultSharedMemory(
+    SharedMemoryMapView& sharedMemoryMapView,
+    const MlosContextOptions& options,
+    uint64_t& prefaultDurationInNanoseconds)
+{
+    if (!options.PrefaultSharedMemory && !options.LockSharedMemory)
+    {
+        return S_OK;
+    }
+
+    const uint64_t startTimestamp = MlosPlatform::TimestampInNanoseconds();
+
+    HRESULT hr = sharedMemoryMapView.Prefault(options.LockSharedMemory);
+
+    prefaultDurationInNanoseconds += MlosPlatform::TimestampInNanoseconds() - startTimestamp;
+
+    return hr;
+}
+
 #pragma warning( disable : 4355)
 
 //----------------------------------------------------------------------------
@@ -34,14 +197,23 @@ namespace Core
 MlosContext::MlosContext(
     Internal::GlobalMemoryRegion& globalMemoryRegion,
     ISharedChannel& controlChannel,
-    ISharedChannel& telemetryChannel,
-    ISharedChannel& feedbackChannel) noexcept
+    ShardedSharedChannel& telemetryChannel,
+    ISharedChannel& feedbackChannel,
+    const char* const instanceName,
+    const MlosContextOptions& options,
+    uint64_t prefaultDurationInNanoseconds) noexcept
   : m_sharedConfigManager(*this),
     m_globalMemoryRegion(globalMemoryRegion),
     m_controlChannel(controlChannel),
     m_telemetryChannel(telemetryChannel),
-    m_feedbackChannel(feedbackChannel)
+    m_feedbackChannel(feedbackChannel),
+    m_instanceName { 0 },
+    m_options(options),
+    m_prefaultDurationInNanoseconds(prefaultDurationInNanoseconds),
+    m_sharedChannelSpinPolicyConfig(*this),
+    m_sharedChannelSpinPolicyConfigId(0)
 {
+    CopyInstanceName(instanceName, m_instanceName);
 }
 
 #pragma warning( default : 4355)
@@ -56,11 +228,41 @@ MlosContext::MlosContext(
 //  HRESULT.
 //
 // NOTES:
+//  The dispatch table hash is not provided, Mlos.Agent does not verify the assembly types.
+//  Fails with E_INVALIDARG if the telemetry channel has the compact frame headers.
 //
 HRESULT MlosContext::RegisterSettingsAssembly(
     const char* assemblyFileName,
     uint32_t assemblyDispatchTableBaseIndex)
 {
+    return RegisterSettingsAssembly(assemblyFileName, assemblyDispatchTableBaseIndex, 0);
+}
+
+//----------------------------------------------------------------------------
+// NAME: MlosContext::RegisterSettingsAssembly
+//
+// PURPOSE:
+//  Registers the settings assembly with Mlos.Agent.
+//
+// RETURNS:
+//  HRESULT.
+//
+// NOTES:
+//  Mlos.Agent compares the dispatch table hash with the hash of the loaded assembly types once,
+//  the channels with the compact frame headers rely on it instead of the per frame type hash check.
+//  The hash is required if the telemetry channel has the compact frame headers.
+//
+HRESULT MlosContext::RegisterSettingsAssembly(
+    const char* assemblyFileName,
+    uint32_t assemblyDispatchTableBaseIndex,
+    uint64_t assemblyDispatchTableHash)
+{
+    if (assemblyDispatchTableHash == 0 &&
+        m_globalMemoryRegion.TelemetryChannelSynchronization[0].HasCompactFrameHeaders.load(std::memory_order_relaxed))
+    {
+        return E_INVALIDARG;
+    }
+
 #ifdef _WIN64
     HMODULE hModule = GetModuleHandleW(nullptr);
     if (hModule == nullptr)
@@ -102,6 +304,7 @@ HRESULT MlosContext::RegisterSettingsAssembly(
     // Register assembly information as a config.
     //
     registeredSettingAssembly.DispatchTableBaseIndex = assemblyDispatchTableBaseIndex;
+    registeredSettingAssembly.DispatchTableHash = assemblyDispatchTableHash;
     registeredSettingAssembly.ApplicationFilePath = szApplicationFullPath;
     registeredSettingAssembly.AssemblyFileName = assemblyFileName;
 
@@ -124,6 +327,77 @@ HRESULT MlosContext::RegisterSettingsAssembly(
     return hr;
 }
 
+//----------------------------------------------------------------------------
+// NAME: MlosContext::RegisterSharedChannelSpinPolicyConfig
+//
+// PURPOSE:
+//  Registers the shared channel spin policy config.
+//
+// RETURNS:
+//  Nothing.
+//
+// NOTES:
+//  The config is created with the current thresholds, unless Mlos.Agent has already tuned it.
+//  If the registration fails, the channels keep using the current thresholds.
+//
+void MlosContext::RegisterSharedChannelSpinPolicyConfig()
+{
+    static_cast<SharedChannelSpinPolicyConfig&>(m_sharedChannelSpinPolicyConfig) = SharedChannelSpinPolicy::CurrentConfig();
+
+    HRESULT hr = RegisterComponentConfig(m_sharedChannelSpinPolicyConfig);
+    if (SUCCEEDED(hr))
+    {
+        m_sharedChannelSpinPolicyConfigId.store(
+            m_sharedChannelSpinPolicyConfig.SharedConfigId() - 1,
+            std::memory_order_relaxed);
+
+        RefreshSharedChannelSpinPolicyConfig();
+    }
+}
+
+//----------------------------------------------------------------------------
+// NAME: MlosContext::RefreshSharedChannelSpinPolicyConfig
+//
+// PURPOSE:
+//  Copies the channel spin policy thresholds from the shared config, if Mlos.Agent has updated it.
+//
+// RETURNS:
+//  Nothing.
+//
+// NOTES:
+//  The thresholds are process wide, the context that has seen the last update provides them.
+//  The channels read only the copied thresholds, they never access the component config,
+//  so the context can be destroyed while the channels are in use.
+//  The thresholds are read directly from the shared memory, the local copy of the component config is not updated,
+//  so multiple threads might refresh the config concurrently.
+//
+void MlosContext::RefreshSharedChannelSpinPolicyConfig()
+{
+    if (m_sharedChannelSpinPolicyConfig.m_sharedConfig == nullptr)
+    {
+        // The config has not been registered.
+        //
+        return;
+    }
+
+    const uint32_t configId = m_sharedChannelSpinPolicyConfig.SharedConfigId();
+
+    if (m_sharedChannelSpinPolicyConfigId.exchange(configId, std::memory_order_relaxed) == configId)
+    {
+        return;
+    }
+
+    Proxy::Mlos::Core::SharedChannelSpinPolicyConfig sharedConfig = m_sharedChannelSpinPolicyConfig.Proxy();
+
+    SharedChannelSpinPolicyConfig config;
+    config.PauseSpinCount = sharedConfig.PauseSpinCount();
+    config.MaxBackoffPauseCount = sharedConfig.MaxBackoffPauseCount();
+    config.YieldCount = sharedConfig.YieldCount();
+    config.ParkDurationInMicroseconds = sharedConfig.ParkDurationInMicroseconds();
+
+    SharedChannelSpinPolicy::UpdateConfig(config);
+}
+
 //----------------------------------------------------------------------------
 // NAME: MlosContext::ControlChannel
 //
@@ -154,6 +428,37 @@ Mlos::Core::ISharedChannel& MlosContext::FeedbackChannel() const
     return m_feedbackChannel;
 }
 
+//----------------------------------------------------------------------------
+// NAME: MlosContext::TelemetryChannel
+//
+// PURPOSE:
+//  Returns the telemetry channel shard.
+//
+// RETURNS:
+//
+// NOTES:
+//  The reader threads process each shard separately.
+//
+Mlos::Core::ISharedChannel& MlosContext::TelemetryChannel(uint32_t shardIndex) const
+{
+    return m_telemetryChannel.Shard(shardIndex);
+}
+
+//----------------------------------------------------------------------------
+// NAME: MlosContext::TelemetryChannelShardCount
+//
+// PURPOSE:
+//  Returns the number of the telemetry channel shards.
+//
+// RETURNS:
+//
+// NOTES:
+//
+uint32_t MlosContext::TelemetryChannelShardCount() const
+{
+    return m_telemetryChannel.ShardCount();
+}
+
 //----------------------------------------------------------------------------
 // NAME: MlosContext::TerminateControlChannel
 //
@@ -197,6 +502,65 @@ void MlosContext::TerminateFeedbackChannel()
     }
 }
 
+//----------------------------------------------------------------------------
+// NAME: MlosContext::TerminateTelemetryChannel
+//
+// PURPOSE:
+//  Terminates the reader threads of all telemetry channel shards.
+//
+// RETURNS:
+//
+// NOTES:
+//  The telemetry channel does not use TerminateReaderThreadRequestMessage,
+//  Mlos.Agent handles that message by terminating the control channel.
+//  The readers observe the terminate flag after they are notified.
+//
+void MlosContext::TerminateTelemetryChannel()
+{
+    for (uint32_t shardIndex = 0; shardIndex < m_telemetryChannel.ShardCount(); shardIndex++)
+    {
+        ISharedChannel& telemetryChannelShard = m_telemetryChannel.Shard(shardIndex);
+
+        telemetryChannelShard.Sync.TerminateChannel = true;
+        telemetryChannelShard.NotifyExternalReader();
+    }
+}
+
+//----------------------------------------------------------------------------
+// NAME: MlosContext::SetTelemetryMessageSubscription
+//
+// PURPOSE:
+//  Enables or disables sending the telemetry messages with the given codegen type index.
+//
+// RETURNS:
+//  Nothing.
+//
+// NOTES:
+//  Message types outside of the subscription bitmap are always sent.
+//
+void MlosContext::SetTelemetryMessageSubscription(uint32_t codegenTypeIndex, bool isSubscribed)
+{
+    constexpr uint32_t BitsPerWord = 64;
+
+    const uint32_t wordIndex = codegenTypeIndex / BitsPerWord;
+
+    if (wordIndex >= m_globalMemoryRegion.TelemetrySubscriptionBitmap.size())
+    {
+        return;
+    }
+
+    const uint64_t mask = static_cast<uint64_t>(1) << (codegenTypeIndex % BitsPerWord);
+
+    if (isSubscribed)
+    {
+        m_globalMemoryRegion.TelemetrySubscriptionBitmap[wordIndex].fetch_or(mask, std::memory_order_relaxed);
+    }
+    else
+    {
+        m_globalMemoryRegion.TelemetrySubscriptionBitmap[wordIndex].fetch_and(~mask, std::memory_order_relaxed);
+    }
+}
+
 //----------------------------------------------------------------------------
 // NAME: MlosContext::IsControlChannelActive
 //
@@ -226,5 +590,111 @@ bool MlosContext::IsFeedbackChannelActive()
 {
     return !(m_feedbackChannel.Sync.TerminateChannel);
 }
+
+//----------------------------------------------------------------------------
+// NAME: MlosContext::IsTelemetryChannelActive
+//
+// PURPOSE:
+//  Checks if the telemetry channel is still active.
+//
+// RETURNS:
+//
+// NOTES:
+//
+bool MlosContext::IsTelemetryChannelActive()
+{
+    // All the shards are terminated together.
+    //
+    return !(m_telemetryChannel.Shard(0).Sync.TerminateChannel);
+}
+
+//----------------------------------------------------------------------------
+// NAME: MlosContext::EnableTelemetryChannelLatencyStats
+//
+// PURPOSE:
+//  Creates the telemetry channel latency memory region and registers it with Mlos.Agent.
+//  The telemetry channel readers in this process record the latencies of the dispatched messages.
+//
+// RETURNS:
+//  HRESULT.
+//
+// NOTES:
+//  Must be called before the telemetry channel reader threads start.
+//  All the shards share the same histograms.
+//  The queueing delay is recorded only if the telemetry channel frames have timestamps.
+//
+HRESULT MlosContext::EnableTelemetryChannelLatencyStats()
+{
+    if (m_telemetryChannelLatencyMemoryRegionView.Buffer.Pointer != nullptr)
+    {
+        return S_OK;
+    }
+
+    // The name includes the MlosContext instance name.
+    // See Also: Mlos.Agent/MainAgent.cs
+    //
+    char latencyStatsSharedMemoryName[MaxSharedObjectNameLength];
+
+    HRESULT hr = FormatSharedObjectName("Host_Mlos.TelemetryChannel.Latency", m_instanceName, latencyStatsSharedMemoryName);
+    if (FAILED(hr))
+    {
+        return hr;
+    }
+
+    hr = CreateMemoryRegion(
+        latencyStatsSharedMemoryName,
+        sizeof(Internal::ChannelLatencyMemoryRegion),
+        m_telemetryChannelLatencyMemoryRegionView);
+    if (FAILED(hr))
+    {
+        return hr;
+    }
+
+    Internal::ChannelLatencyMemoryRegion& latencyMemoryRegion = m_telemetryChannelLatencyMemoryRegionView.MemoryRegion();
+
+    // Register the latency memory region.
+    //
+    Internal::RegisterChannelLatencyMemoryRegionRequestMessage msg = { 0 };
+    msg.MemoryRegionId = latencyMemoryRegion.MemoryHeader.MemoryRegionId;
+
+    SendControlMessage(msg);
+
+    for (uint32_t shardIndex = 0; shardIndex < m_telemetryChannel.ShardCount(); shardIndex++)
+    {
+        m_telemetryChannel.Shard(shardIndex).LatencyStats = &latencyMemoryRegion;
+    }
+
+    return S_OK;
+}
+
+//----------------------------------------------------------------------------
+// NAME: MlosContext::TelemetryChannelLatencyStats
+//
+// PURPOSE:
+//  Returns the telemetry channel latency histograms.
+//
+// RETURNS:
+//  nullptr if the latency histograms are not enabled.
+//
+// NOTES:
+//
+Internal::ChannelLatencyMemoryRegion* MlosContext::TelemetryChannelLatencyStats() const
+{
+    return m_telemetryChannel.Shard(0).LatencyStats;
+}
+
+//----------------------------------------------------------------------------
+// NAME: MlosContext::SharedMemoryPrefaultDurationInNanoseconds
+//
+// PURPOSE:
+//  Returns the time spent prefaulting the shared memory.
+//
+// NOTES:
+//  Includes the channels mapped by the initializer and the memory regions created by the context.
+//
+uint64_t MlosContext::SharedMemoryPrefaultDurationInNanoseconds() const
+{
+    return m_prefaultDurationInNanoseconds;
+}
 }
 }
@@ -19,6 +19,105 @@ namespace Mlos
 {
 namespace Core
 {
+//----------------------------------------------------------------------------
+// NAME: MlosContextOptions
+//
+// PURPOSE:
+//  Options of the shared memory regions created by the MlosContext initializers.
+//
+// NOTES:
+//  Channel sizes must be a power of two.
+//  If the shared memory already exists (e.g. Mlos.Agent created it), the existing size is used.
+//  If the instance name is set, it is appended to the names of the shared memory regions and named events,
+//  so the MlosContext instances do not share the channels.
+//  The telemetry channel memory is split into TelemetryChannelShardCount equal shards.
+//  If the telemetry frame timestamps are enabled, the readers can measure how long the frames wait in the channel.
+//  If huge pages are enabled, the sizes of the new channels and memory regions are rounded up to the huge page size.
+//  Prefaulting the shared memory moves the page faults from the first messages to the initialization.
+//
+struct MlosContextOptions
+{
+    // Maximum length of the instance name.
+    //
+    static constexpr size_t MaxInstanceNameLength = 64;
+
+    size_t GlobalMemoryRegionSize = 131072;
+
+    size_t ControlChannelSize = 65536;
+
+    size_t FeedbackChannelSize = 65536;
+
+    size_t TelemetryChannelSize = 262144;
+
+    // Number of the telemetry channel shards, must be a power of two.
+    // If the global memory region already exists, the existing shard count is used.
+    //
+    uint32_t TelemetryChannelShardCount = 1;
+
+    // If true, the telemetry channel writers append the send timestamp to each frame.
+    // If the global memory region already exists, the existing setting is used.
+    //
+    bool TelemetryChannelFrameTimestamps = false;
+
+    // If true, the telemetry channel frames have the compact header without the type hash.
+    // The settings assemblies must be registered with their dispatch table hashes, so Mlos.Agent verifies the types once.
+    // If the global memory region already exists, the existing setting is used.
+    //
+    bool TelemetryChannelCompactFrameHeaders = false;
+
+    // If true, the new channel buffers and the memory regions created by the context (e.g. the shared config)
+    // are backed by huge pages. See SharedMemoryMapView::UseHugePages.
+    //
+    bool UseHugePages = false;
+
+    // If true, the initializer and the context touch all the pages of the shared memory they map,
+    // so the first messages sent to the channels do not page-fault.
+    //
+    bool PrefaultSharedMemory = false;
+
+    // If true, the shared memory is also locked in the memory (implies PrefaultSharedMemory).
+    // Locking fails if the process exceeds its locked memory limit.
+    //
+    bool LockSharedMemory = false;
+
+    // Name of the MlosContext instance (e.g. a component name or a process id).
+    // Allowed characters are letters, digits, '_', '-' and '.'.
+    // If not set, the MlosContext uses the default names.
+    //
+    const char* InstanceName = nullptr;
+
+    // Verifies the sizes and the instance name.
+    //
+    _Check_return_
+    HRESULT Verify() const;
+};
+
+// Maximum length of the shared memory region and named event names.
+//
+constexpr size_t MaxSharedObjectNameLength = 256;
+
+// Creates the name of the shared memory region or named event for the given MlosContext instance.
+//
+_Check_return_
+HRESULT FormatSharedObjectName(
+    const char* const baseName,
+    const char* const instanceName,
+    _Out_ char (&name)[MaxSharedObjectNameLength]);
+
+// Copies the instance name, truncated to MaxInstanceNameLength, and terminates it.
+//
+void CopyInstanceName(
+    const char* const instanceName,
+    _Out_ char (&name)[MlosContextOptions::MaxInstanceNameLength + 1]);
+
+// Prefaults and optionally locks the shared memory view as requested by the options.
+//
+_Check_return_
+HRESULT PrefaultSharedMemory(
+    SharedMemoryMapView& sharedMemoryMapView,
+    const MlosContextOptions& options,
+    uint64_t& prefaultDurationInNanoseconds);
+
 //----------------------------------------------------------------------------
 // NAME: MlosContext
 //
@@ -39,8 +138,11 @@ protected:
     MlosContext(
         Internal::GlobalMemoryRegion& globalMemoryRegion,
         ISharedChannel& controlChannel,
-        ISharedChannel& telemetryChannel,
-        ISharedChannel& feedbackChannel) noexcept;
+        ShardedSharedChannel& telemetryChannel,
+        ISharedChannel& feedbackChannel,
+        const char* const instanceName,
+        const MlosContextOptions& options,
+        uint64_t prefaultDurationInNanoseconds) noexcept;
 
 public:
     // Registers the settings assembly.
@@ -49,15 +151,33 @@ public:
         const char* assemblyFileName,
         uint32_t assemblyDispatchTableBaseIndex);
 
+    // Registers the settings assembly with the hash of its dispatch table (see DispatchTableHash).
+    // Mlos.Agent fails to load the assembly if its dispatch table has a different hash.
+    // The hash is required if the telemetry channel has the compact frame headers.
+    //
+    HRESULT RegisterSettingsAssembly(
+        const char* assemblyFileName,
+        uint32_t assemblyDispatchTableBaseIndex,
+        uint64_t assemblyDispatchTableHash);
+
     // Registers the component config.
     //
     template<typename T>
     HRESULT RegisterComponentConfig(ComponentConfig<T>& componentConfig);
 
+    // Registers the telemetry sampler of the component config.
+    //
+    template<typename T>
+    HRESULT RegisterTelemetrySampler(ComponentConfig<T>& componentConfig, TelemetrySampler& telemetrySampler);
+
     ISharedChannel& ControlChannel() const;
 
     ISharedChannel& FeedbackChannel() const;
 
+    ISharedChannel& TelemetryChannel(uint32_t shardIndex = 0) const;
+
+    uint32_t TelemetryChannelShardCount() const;
+
     template<typename TMessage>
     void SendControlMessage(TMessage& message);
 
@@ -67,15 +187,52 @@ public:
     template<typename TMessage>
     void SendTelemetryMessage(const TMessage& message) const;
 
+    // Returns true if the agent processes the telemetry messages of the given type.
+    // Components can check it before they build an expensive message.
+    //
+    template<typename TMessage>
+    bool IsTelemetryMessageSubscribed() const;
+
+    // Enables or disables sending the telemetry messages with the given codegen type index.
+    // Mlos.Agent updates the subscriptions when the message handlers change, in-process readers might update them directly.
+    //
+    void SetTelemetryMessageSubscription(uint32_t codegenTypeIndex, bool isSubscribed);
+
     void TerminateControlChannel();
 
     void TerminateFeedbackChannel();
 
+    void TerminateTelemetryChannel();
+
     bool IsControlChannelActive();
 
     bool IsFeedbackChannelActive();
 
+    bool IsTelemetryChannelActive();
+
+    // Copies the channel spin policy thresholds from the shared config, if Mlos.Agent has updated it.
+    // Components call it when they receive SharedConfigUpdatedFeedbackMessage.
+    //
+    void RefreshSharedChannelSpinPolicyConfig();
+
+    // Creates the telemetry channel latency memory region and registers it with Mlos.Agent.
+    //
+    HRESULT EnableTelemetryChannelLatencyStats();
+
+    // Returns the telemetry channel latency histograms, nullptr if they are not enabled.
+    //
+    Internal::ChannelLatencyMemoryRegion* TelemetryChannelLatencyStats() const;
+
+    // Returns the time spent prefaulting the shared memory, zero if MlosContextOptions::PrefaultSharedMemory is not set.
+    //
+    uint64_t SharedMemoryPrefaultDurationInNanoseconds() const;
+
 protected:
+    // Registers the shared channel spin policy config and loads the thresholds from it.
+    // Called by the derived contexts once the channels are created.
+    //
+    void RegisterSharedChannelSpinPolicyConfig();
+
     // Creates a shared memory view and registers it with Mlos Agent.
     //
     template<typename T>
@@ -96,14 +253,39 @@ protected:
     //
     ISharedChannel& m_controlChannel;
 
-    // Channel used to send the telemetry messages.
+    // Channel used to send the telemetry messages, the writers select the shard by the current processor.
     //
-    ISharedChannel& m_telemetryChannel;
+    ShardedSharedChannel& m_telemetryChannel;
 
     // Feedback channel used to receive messages from the Mlos.Agent.
     //
     ISharedChannel& m_feedbackChannel;
 
+    // Name of the MlosContext instance, empty for the default instance.
+    //
+    char m_instanceName[MlosContextOptions::MaxInstanceNameLength + 1];
+
+    // Options of the memory regions created by the context (huge pages, prefault).
+    // The instance name is copied to m_instanceName.
+    //
+    MlosContextOptions m_options;
+
+    // Time spent prefaulting the shared memory, including the initializer.
+    //
+    uint64_t m_prefaultDurationInNanoseconds;
+
+    // Memory region with the telemetry channel latency histograms.
+    //
+    SharedMemoryRegionView<Internal::ChannelLatencyMemoryRegion> m_telemetryChannelLatencyMemoryRegionView;
+
+    // Thresholds of the channel spin policy, tuned by Mlos.Agent.
+    //
+    ComponentConfig<SharedChannelSpinPolicyConfig> m_sharedChannelSpinPolicyConfig;
+
+    // Id of the spin policy shared config copied to the channel spin policy.
+    //
+    std::atomic<uint32_t> m_sharedChannelSpinPolicyConfigId;
+
     // Friend classes.
     //
     friend class SharedConfigManager;
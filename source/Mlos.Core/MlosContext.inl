@@ -37,12 +37,20 @@ HRESULT MlosContext::CreateMemoryRegion(const char* const sharedMemoryName, size
 {
     // Create region view, initialize it on create.
     //
+    sharedMemoryRegionView.UseHugePages = m_options.UseHugePages;
+
     HRESULT hr = sharedMemoryRegionView.CreateOrOpen(sharedMemoryName, memoryRegionSize);
     if (FAILED(hr))
     {
         return hr;
     }
 
+    HRESULT hrPrefault = PrefaultSharedMemory(sharedMemoryRegionView, m_options, m_prefaultDurationInNanoseconds);
+    if (FAILED(hrPrefault))
+    {
+        return hrPrefault;
+    }
+
     // Initialize memory region if we created a new mapping, Otherwise assume Mlos.Agent has initialized it.
     //
     auto& memoryRegion = sharedMemoryRegionView.MemoryRegion();
@@ -86,6 +94,43 @@ HRESULT MlosContext::RegisterComponentConfig(ComponentConfig<T>& componentConfig
     return hr;
 }
 
+//----------------------------------------------------------------------------
+// NAME: MlosContext::RegisterTelemetrySampler
+//
+// PURPOSE:
+//  Registers the telemetry sampler of the component config.
+//  The component config sends only the telemetry messages selected by the sampler.
+//
+// RETURNS:
+//  HRESULT.
+//
+// NOTES:
+//  The sampling config is a shared config keyed by the component config type and key.
+//  If the agent has already created the sampling config, it replaces the initial values of the sampler.
+//  The component config must be registered first and the sampler must outlive the component config.
+//
+template<typename T>
+HRESULT MlosContext::RegisterTelemetrySampler(ComponentConfig<T>& componentConfig, TelemetrySampler& telemetrySampler)
+{
+    telemetrySampler.m_componentTypeIndex = TypeMetadataInfo::CodegenTypeIndex<T>();
+    telemetrySampler.m_componentKeyHash = TypeMetadataInfo::GetKeyHashValue<Collections::FNVHash<uint32_t>>(static_cast<const T&>(componentConfig));
+
+    telemetrySampler.SamplingConfig.ComponentTypeIndex = telemetrySampler.m_componentTypeIndex;
+    telemetrySampler.SamplingConfig.ComponentKeyHash = telemetrySampler.m_componentKeyHash;
+
+    HRESULT hr = m_sharedConfigManager.CreateOrUpdateFrom(telemetrySampler.SamplingConfig);
+    if (FAILED(hr))
+    {
+        return hr;
+    }
+
+    telemetrySampler.Refresh();
+
+    componentConfig.m_telemetrySampler = &telemetrySampler;
+
+    return S_OK;
+}
+
 //----------------------------------------------------------------------------
 // NAME: MlosContext::SendControlMessage
 //
@@ -122,7 +167,7 @@ void MlosContext::SendFeedbackMessage(TMessage& message)
 // NAME: MlosContext::SendTelemetryMessage
 //
 // PURPOSE:
-//  Sends the message using telemetry channel.
+//  Sends the message using the telemetry channel shard of the current processor.
 //
 // RETURNS:
 //
@@ -131,8 +176,46 @@ void MlosContext::SendFeedbackMessage(TMessage& message)
 template<typename TMessage>
 void MlosContext::SendTelemetryMessage(const TMessage& message) const
 {
+    if (!IsTelemetryMessageSubscribed<TMessage>())
+    {
+        // The agent does not process the message, skip the serialization.
+        //
+        return;
+    }
+
     m_telemetryChannel.SendMessage(message);
 }
 
+//----------------------------------------------------------------------------
+// NAME: MlosContext::IsTelemetryMessageSubscribed
+//
+// PURPOSE:
+//  Checks if the agent processes the telemetry messages of the given type.
+//
+// RETURNS:
+//  True if the message type is subscribed or outside of the subscription bitmap.
+//
+// NOTES:
+//  A single relaxed load of the subscription bitmap stored in the global memory region.
+//  The agent updates the bitmap when the message handlers are registered or removed.
+//
+template<typename TMessage>
+bool MlosContext::IsTelemetryMessageSubscribed() const
+{
+    constexpr uint32_t BitsPerWord = 64;
+
+    const uint32_t codegenTypeIndex = TypeMetadataInfo::CodegenTypeIndex<TMessage>();
+    const uint32_t wordIndex = codegenTypeIndex / BitsPerWord;
+
+    if (wordIndex >= m_globalMemoryRegion.TelemetrySubscriptionBitmap.size())
+    {
+        return true;
+    }
+
+    const uint64_t subscriptionBits = m_globalMemoryRegion.TelemetrySubscriptionBitmap[wordIndex].load(std::memory_order_relaxed);
+
+    return (subscriptionBits & (static_cast<uint64_t>(1) << (codegenTypeIndex % BitsPerWord))) != 0;
+}
+
 }
 }
@@ -55,6 +55,32 @@ void MlosPlatformWait(uint32_t milliseconds)
 {
     std::this_thread::sleep_for(std::chrono::milliseconds(milliseconds));
 }
+
+//----------------------------------------------------------------------------
+// NAME: MlosPlatformWaitMicroseconds
+//
+// PURPOSE:
+//  Suspends the execution of the current thread for microsecond intervals.
+//
+// NOTES:
+//
+void MlosPlatformWaitMicroseconds(uint32_t microseconds)
+{
+    std::this_thread::sleep_for(std::chrono::microseconds(microseconds));
+}
+
+//----------------------------------------------------------------------------
+// NAME: MlosPlatformYield
+//
+// PURPOSE:
+//  Yields the processor to another thread.
+//
+// NOTES:
+//
+void MlosPlatformYield()
+{
+    std::this_thread::yield();
+}
 }
 }
 }
@@ -34,6 +34,8 @@ namespace Internal
 //
 extern void MlosPlatformTerminateProcess();
 extern void MlosPlatformWait(uint32_t milliseconds);
+extern void MlosPlatformWaitMicroseconds(uint32_t microseconds);
+extern void MlosPlatformYield();
 }
 //----------------------------------------------------------------------------
 // NAME: MlosPlatform
@@ -58,6 +60,58 @@ public:
     {
         Mlos::Core::Internal::MlosPlatformWait(milliseconds);
     }
+
+    // Suspends the execution of the current thread for microsecond intervals.
+    //
+    static inline void SleepMicroseconds(uint32_t microseconds)
+    {
+        Mlos::Core::Internal::MlosPlatformWaitMicroseconds(microseconds);
+    }
+
+    // Yields the processor to another thread.
+    //
+    static inline void YieldThread()
+    {
+        Mlos::Core::Internal::MlosPlatformYield();
+    }
+
+    // Hints the processor that the current thread is spinning.
+    //
+    static inline void Pause()
+    {
+#if defined(_MSC_VER)
+        YieldProcessor();
+#elif defined(__x86_64__) || defined(__i386__)
+        __builtin_ia32_pause();
+#elif defined(__aarch64__)
+        asm volatile("yield" ::: "memory");
+#else
+        std::atomic_signal_fence(std::memory_order_seq_cst);
+#endif
+    }
+
+    // Returns the monotonic timestamp in nanoseconds.
+    // The clock is shared by all the processes on the machine (CLOCK_MONOTONIC on Linux, QueryPerformanceCounter on Windows).
+    //
+    static inline uint64_t TimestampInNanoseconds()
+    {
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count());
+    }
+
+    // Returns the index of the processor the current thread is running on.
+    //
+    static inline uint32_t CurrentProcessorIndex()
+    {
+#if defined(_WIN64)
+        return GetCurrentProcessorNumber();
+#elif defined(__linux__)
+        const int processorIndex = sched_getcpu();
+        return processorIndex < 0 ? 0 : static_cast<uint32_t>(processorIndex);
+#else
+        return 0;
+#endif
+    }
 };
 }
 }
@@ -15,9 +15,11 @@
 
 #include "Mlos.Core.h"
 
+#include <sys/eventfd.h>
 #include <sys/stat.h>
 #include <fcntl.h>
 #include <stdlib.h>
+#include <unistd.h>
 
 using namespace Mlos::Core;
 
@@ -31,6 +33,7 @@ namespace Core
 NamedEvent::NamedEvent() noexcept
   : m_semaphore(SEM_FAILED),
     m_namedEventName(nullptr),
+    m_fdEvent(INVALID_FD_VALUE),
     CleanupOnClose(false)
 {
 }
@@ -44,6 +47,7 @@ NamedEvent::NamedEvent() noexcept
 NamedEvent::NamedEvent(NamedEvent&& namedEvent) noexcept
   : m_semaphore(std::exchange(namedEvent.m_semaphore, SEM_FAILED)),
     m_namedEventName(std::exchange(namedEvent.m_namedEventName, nullptr)),
+    m_fdEvent(std::exchange(namedEvent.m_fdEvent, INVALID_FD_VALUE)),
     CleanupOnClose(std::exchange(namedEvent.CleanupOnClose, false))
 {
 }
@@ -92,6 +96,56 @@ HRESULT NamedEvent::Open(const char* const namedEventName) noexcept
     return CreateOrOpen(namedEventName);
 }
 
+//----------------------------------------------------------------------------
+// NAME: NamedEvent::CreateAnonymous
+//
+// PURPOSE:
+//  Creates an anonymous event object.
+//
+// RETURNS:
+//  HRESULT.
+//
+// NOTES:
+//  The event is an eventfd with the semaphore semantics, each Wait consumes a single Signal, same as the named event.
+//  The event has no name, it is released when the last process closes its file descriptor.
+//
+_Check_return_
+HRESULT NamedEvent::CreateAnonymous() noexcept
+{
+    m_fdEvent = eventfd(0, EFD_CLOEXEC | EFD_SEMAPHORE);
+    if (m_fdEvent == INVALID_FD_VALUE)
+    {
+        return HRESULT_FROM_ERRNO(errno);
+    }
+
+    return S_OK;
+}
+
+//----------------------------------------------------------------------------
+// NAME: NamedEvent::OpenFileDescriptor
+//
+// PURPOSE:
+//  Opens an anonymous event object from the file descriptor received from another process.
+//
+// RETURNS:
+//  HRESULT.
+//
+// NOTES:
+//  The event object takes the ownership of the file descriptor.
+//
+_Check_return_
+HRESULT NamedEvent::OpenFileDescriptor(int fdEvent) noexcept
+{
+    if (fdEvent == INVALID_FD_VALUE)
+    {
+        return E_INVALIDARG;
+    }
+
+    m_fdEvent = fdEvent;
+
+    return S_OK;
+}
+
 //----------------------------------------------------------------------------
 // NAME: NamedEvent::Destructor.
 //
@@ -108,6 +162,12 @@ NamedEvent::~NamedEvent()
 //
 void NamedEvent::Close()
 {
+    if (m_fdEvent != INVALID_FD_VALUE)
+    {
+        close(m_fdEvent);
+        m_fdEvent = INVALID_FD_VALUE;
+    }
+
     if (m_semaphore != SEM_FAILED)
     {
         sem_close(m_semaphore);
@@ -143,6 +203,17 @@ void NamedEvent::Close()
 _Check_return_
 HRESULT NamedEvent::Signal()
 {
+    if (m_fdEvent != INVALID_FD_VALUE)
+    {
+        const uint64_t value = 1;
+        if (write(m_fdEvent, &value, sizeof(value)) == -1)
+        {
+            return HRESULT_FROM_ERRNO(errno);
+        }
+
+        return S_OK;
+    }
+
     if (sem_post(m_semaphore) == -1)
     {
         return HRESULT_FROM_ERRNO(errno);
@@ -163,6 +234,17 @@ HRESULT NamedEvent::Signal()
 _Check_return_
 HRESULT NamedEvent::Wait()
 {
+    if (m_fdEvent != INVALID_FD_VALUE)
+    {
+        uint64_t value;
+        if (read(m_fdEvent, &value, sizeof(value)) == -1)
+        {
+            return HRESULT_FROM_ERRNO(errno);
+        }
+
+        return S_OK;
+    }
+
     if (sem_wait(m_semaphore) == -1)
     {
         return HRESULT_FROM_ERRNO(errno);
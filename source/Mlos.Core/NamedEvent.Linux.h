@@ -41,6 +41,16 @@ public:
     _Check_return_
     HRESULT Open(const char* const namedEventName) noexcept;
 
+    // Creates an anonymous event object, the event is shared by passing its file descriptor to another process.
+    //
+    _Check_return_
+    HRESULT CreateAnonymous() noexcept;
+
+    // Opens an anonymous event object from the file descriptor received from another process.
+    //
+    _Check_return_
+    HRESULT OpenFileDescriptor(int fdEvent) noexcept;
+
     // Closes a named event object.
     //
     void Close();
@@ -55,6 +65,10 @@ public:
     _Check_return_
     HRESULT Wait();
 
+    // Returns the file descriptor of an anonymous event object, INVALID_FD_VALUE for a named event object.
+    //
+    int FileDescriptor() const { return m_fdEvent; }
+
 public:
     // Indicates if we should cleanup OS resources when closing the shared memory map view.
     //
@@ -63,6 +77,10 @@ public:
 private:
     sem_t* m_semaphore;
     char* m_namedEventName;
+
+    // Anonymous event object (eventfd).
+    //
+    int m_fdEvent;
 };
 
 }
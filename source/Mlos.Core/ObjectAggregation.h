@@ -0,0 +1,124 @@
+//*********************************************************************
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License. See License.txt in the project root
+// for license information.
+//
+// @File: ObjectAggregation.h
+//
+// Purpose:
+//      <description>
+//
+// Notes:
+//      <special-instructions>
+//
+//*********************************************************************
+
+#pragma once
+
+// Telemetry summary aggregation methods.
+// CodeGen will create specialized function templates for the types marked with TelemetrySummary attribute.
+//
+namespace ObjectAggregation
+{
+// Initializes the summary of a new aggregation window.
+//
+template<typename TSummary>
+inline void Initialize(TSummary& summary, uint32_t configId);
+
+// Adds the message to the summary.
+//
+template<typename TSummary, typename TMessage>
+inline void Accumulate(TSummary& summary, const TMessage& message);
+
+// Adds the other summary of the same window to the summary.
+//
+template<typename TSummary>
+inline void Merge(TSummary& summary, const TSummary& other);
+
+//----------------------------------------------------------------------------
+// NAME: InitializeMin
+//
+// PURPOSE:
+//  Initializes the minimum, so any value replaces it.
+//
+template<typename T>
+inline void InitializeMin(T& min)
+{
+    min = std::numeric_limits<T>::max();
+}
+
+//----------------------------------------------------------------------------
+// NAME: InitializeMax
+//
+// PURPOSE:
+//  Initializes the maximum, so any value replaces it.
+//
+template<typename T>
+inline void InitializeMax(T& max)
+{
+    max = std::numeric_limits<T>::lowest();
+}
+
+template<typename T, typename TValue>
+inline void AddToSum(T& sum, const TValue& value)
+{
+    sum += static_cast<T>(value);
+}
+
+template<typename T, typename TValue>
+inline void AddToMin(T& min, const TValue& value)
+{
+    min = std::min(min, static_cast<T>(value));
+}
+
+template<typename T, typename TValue>
+inline void AddToMax(T& max, const TValue& value)
+{
+    max = std::max(max, static_cast<T>(value));
+}
+
+//----------------------------------------------------------------------------
+// NAME: HistogramBucketIndex
+//
+// PURPOSE:
+//  Returns the index of the histogram bucket holding the given value.
+//
+// NOTES:
+//  Bucket 0 holds zero and negative values, bucket i holds the values in the range [2^(i-1), 2^i).
+//  Values beyond the range of the histogram are stored in the last bucket.
+//
+template<typename TValue>
+inline uint32_t HistogramBucketIndex(const TValue& value, uint32_t bucketCount)
+{
+    if (!(value >= static_cast<TValue>(1)))
+    {
+        return 0;
+    }
+
+    const uint64_t bucketValue = static_cast<uint64_t>(value);
+
+#if defined(_MSC_VER)
+    unsigned long mostSignificantBit;
+    _BitScanReverse64(&mostSignificantBit, bucketValue);
+#else
+    const uint32_t mostSignificantBit = 63 - __builtin_clzll(bucketValue);
+#endif
+
+    return std::min(static_cast<uint32_t>(mostSignificantBit) + 1, bucketCount - 1);
+}
+
+template<typename T, size_t N, typename TValue>
+inline void AddToHistogram(std::array<T, N>& buckets, const TValue& value)
+{
+    buckets[HistogramBucketIndex(value, static_cast<uint32_t>(N))]++;
+}
+
+template<typename T, size_t N>
+inline void MergeHistogram(std::array<T, N>& buckets, const std::array<T, N>& other)
+{
+    for (size_t bucketIndex = 0; bucketIndex < N; bucketIndex++)
+    {
+        buckets[bucketIndex] += other[bucketIndex];
+    }
+}
+}
@@ -66,5 +66,31 @@ public:
         return result;
     }
 };
+
+//----------------------------------------------------------------------------
+// NAME: DispatchTableHash
+//
+// PURPOSE:
+//  Combines the type hashes of the dispatch table entries.
+//
+// RETURNS:
+//  Returns the hash of the dispatch table.
+//
+// NOTES:
+//  Mlos.Agent computes the same hash from the dispatch table of the loaded settings assembly
+//  (SettingsAssemblyManager.DispatchTableHash).
+//
+template<size_t N>
+inline uint64_t DispatchTableHash(const ::Mlos::Core::DispatchEntry (&dispatchTable)[N])
+{
+    uint64_t hash = 0xcbf29ce484222325;
+
+    for (size_t i = 0; i < N; ++i)
+    {
+        hash = (hash ^ dispatchTable[i].CodegenTypeHash) * 0x100000001b3;
+    }
+
+    return hash;
+}
 }
 }
@@ -23,6 +23,16 @@
 //
 namespace ObjectSerialization
 {
+// Returns true if the type has variable length fields.
+// CodeGen specializes it for the types with the variable length fields,
+// the other types have a compile time serialized size and are serialized with a single copy.
+//
+template<typename T>
+constexpr inline bool HasVariableData()
+{
+    return false;
+}
+
 template<typename T>
 constexpr inline size_t GetVariableDataSize(const T&)
 {
@@ -32,7 +42,14 @@ constexpr inline size_t GetVariableDataSize(const T&)
 template<typename T>
 constexpr inline size_t GetSerializedSize(const T& object)
 {
-    return sizeof(object) + GetVariableDataSize(object);
+    if constexpr (HasVariableData<T>())
+    {
+        return sizeof(object) + GetVariableDataSize(object);
+    }
+    else
+    {
+        return sizeof(object);
+    }
 }
 
 template<typename TProxy>
@@ -60,6 +77,8 @@ constexpr inline bool VerifyVariableData(TProxy object, int32_t frameLength)
 
     bool isValid = VerifyVariableData(object, 0, totalDataSize, expectedDataOffset);
 
+    // The channels pass the length of the frame with the full header, also for the compact frame headers.
+    //
     isValid &= (16 /* sizeof(FrameHeader) */ + expectedDataOffset) <= frameLength;
 
     return isValid;
@@ -88,11 +107,26 @@ inline void Serialize(Mlos::Core::BytePtr buffer, const T& object)
     //
     memcpy(buffer.Pointer, &object, sizeof(object));
 
-    // Serialize variable length part of the object.
-    //
-    constexpr uint64_t objectOffset = 0;
-    constexpr uint64_t dataOffset = sizeof(object);
-    SerializeVariableData<T>(buffer, objectOffset, dataOffset, object);
+    if constexpr (HasVariableData<T>())
+    {
+        // Serialize variable length part of the object.
+        //
+        constexpr uint64_t objectOffset = 0;
+        constexpr uint64_t dataOffset = sizeof(object);
+        SerializeVariableData<T>(buffer, objectOffset, dataOffset, object);
+    }
+}
+
+template<>
+constexpr inline bool HasVariableData<Mlos::Core::StringPtr>()
+{
+    return true;
+}
+
+template<>
+constexpr inline bool HasVariableData<Mlos::Core::WideStringPtr>()
+{
+    return true;
 }
 
 template<>
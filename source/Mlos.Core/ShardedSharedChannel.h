@@ -0,0 +1,99 @@
+//*********************************************************************
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License. See License.txt in the project root
+// for license information.
+//
+// @File: ShardedSharedChannel.h
+//
+// Purpose:
+//      <description>
+//
+// Notes:
+//      <special-instructions>
+//
+//*********************************************************************
+
+#pragma once
+
+namespace Mlos
+{
+namespace Core
+{
+//----------------------------------------------------------------------------
+// NAME: ShardedSharedChannel
+//
+// PURPOSE:
+//  A set of shared channels (shards) used as a single channel.
+//  Writers pick the shard by the index of the processor they are running on,
+//  so the writers running on different processors do not contend on the same write position.
+//
+// NOTES:
+//  Each shard is an independent channel with its own synchronization object and reader threads.
+//  Messages are ordered within a shard, there is no ordering between the shards.
+//  A thread that migrates to another processor might send the following messages to a different shard.
+//
+class ShardedSharedChannel
+{
+public:
+    // Maximum number of the shards.
+    // Must match the number of the telemetry channel synchronization objects in the GlobalMemoryRegion.
+    //
+    static constexpr uint32_t MaxShardCount = 16;
+
+    ShardedSharedChannel() noexcept
+      : m_shards { nullptr },
+        m_shardCount(0)
+    {
+    }
+
+    ShardedSharedChannel(const ShardedSharedChannel&) = delete;
+
+    ShardedSharedChannel& operator=(const ShardedSharedChannel&) = delete;
+
+    // Adds the shard, the shards are selected by the order they are added.
+    //
+    _Check_return_
+    inline HRESULT AddShard(ISharedChannel& shard);
+
+    // Returns the number of the shards.
+    //
+    inline uint32_t ShardCount() const;
+
+    // Returns the shard with the given index.
+    //
+    inline ISharedChannel& Shard(uint32_t shardIndex) const;
+
+    // Returns the shard used by the writers running on the current processor.
+    //
+    inline ISharedChannel& CurrentShard() const;
+
+    // Returns true if the shard count is a power of two and does not exceed the maximum number of the shards.
+    //
+    static constexpr bool IsValidShardCount(uint32_t shardCount)
+    {
+        return shardCount != 0 &&
+            shardCount <= MaxShardCount &&
+            (shardCount & (shardCount - 1)) == 0;
+    }
+
+    // Send the message object using the current shard.
+    //
+    template<typename TMessage>
+    inline void SendMessage(const TMessage& object) const;
+
+    // Send the message object using the current shard, if there is not enough free space wait at most the given timeout.
+    //
+    template<typename TMessage>
+    inline HRESULT TrySendMessage(const TMessage& object, uint32_t timeoutInMicroseconds) const;
+
+private:
+    ISharedChannel* m_shards[MaxShardCount];
+
+    uint32_t m_shardCount;
+};
+
+static_assert(
+    std::tuple_size<decltype(Internal::GlobalMemoryRegion::TelemetryChannelSynchronization)>::value == ShardedSharedChannel::MaxShardCount,
+    "GlobalMemoryRegion must have a synchronization object for each telemetry channel shard");
+}
+}
@@ -0,0 +1,122 @@
+//*********************************************************************
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License. See License.txt in the project root
+// for license information.
+//
+// @File: ShardedSharedChannel.inl
+//
+// Purpose:
+//      <description>
+//
+// Notes:
+//      <special-instructions>
+//
+//*********************************************************************
+
+#pragma once
+
+namespace Mlos
+{
+namespace Core
+{
+//----------------------------------------------------------------------------
+// NAME: ShardedSharedChannel::AddShard
+//
+// PURPOSE:
+//  Adds the shard.
+//
+// RETURNS:
+//  HRESULT. E_INVALIDARG if the channel already has the maximum number of the shards.
+//
+// NOTES:
+//
+_Check_return_
+HRESULT ShardedSharedChannel::AddShard(ISharedChannel& shard)
+{
+    if (m_shardCount >= MaxShardCount)
+    {
+        return E_INVALIDARG;
+    }
+
+    m_shards[m_shardCount] = &shard;
+    ++m_shardCount;
+
+    return S_OK;
+}
+
+//----------------------------------------------------------------------------
+// NAME: ShardedSharedChannel::ShardCount
+//
+// PURPOSE:
+//  Returns the number of the shards.
+//
+uint32_t ShardedSharedChannel::ShardCount() const
+{
+    return m_shardCount;
+}
+
+//----------------------------------------------------------------------------
+// NAME: ShardedSharedChannel::Shard
+//
+// PURPOSE:
+//  Returns the shard with the given index.
+//
+ISharedChannel& ShardedSharedChannel::Shard(uint32_t shardIndex) const
+{
+    assert(shardIndex < m_shardCount);
+
+    return *m_shards[shardIndex];
+}
+
+//----------------------------------------------------------------------------
+// NAME: ShardedSharedChannel::CurrentShard
+//
+// PURPOSE:
+//  Returns the shard used by the writers running on the current processor.
+//
+// NOTES:
+//  The shard count is a power of two, the processors are mapped to the shards round robin.
+//
+ISharedChannel& ShardedSharedChannel::CurrentShard() const
+{
+    if (m_shardCount == 1)
+    {
+        return *m_shards[0];
+    }
+
+    return *m_shards[MlosPlatform::CurrentProcessorIndex() & (m_shardCount - 1)];
+}
+
+//----------------------------------------------------------------------------
+// NAME: ShardedSharedChannel::SendMessage
+//
+// PURPOSE:
+//  Sends the message object using the current shard.
+//
+// NOTES:
+//
+template<typename TMessage>
+void ShardedSharedChannel::SendMessage(const TMessage& msg) const
+{
+    CurrentShard().SendMessage(msg);
+}
+
+//----------------------------------------------------------------------------
+// NAME: ShardedSharedChannel::TrySendMessage
+//
+// PURPOSE:
+//  Sends the message object using the current shard.
+//  If there is not enough free space in the shard, waits at most the given timeout.
+//
+// RETURNS:
+//  HRESULT. See ISharedChannel::TrySendMessage.
+//
+// NOTES:
+//
+template<typename TMessage>
+HRESULT ShardedSharedChannel::TrySendMessage(const TMessage& msg, uint32_t timeoutInMicroseconds) const
+{
+    return CurrentShard().TrySendMessage(msg, timeoutInMicroseconds);
+}
+}
+}
@@ -20,38 +20,6 @@ namespace Mlos
 {
 namespace Core
 {
-//----------------------------------------------------------------------------
-// NAME: SignalFrameIsReady
-//
-// PURPOSE:
-//  Signals readers that the frame is available to process.
-//
-// RETURNS:
-//
-// NOTES:
-//
-void SignalFrameIsReady(FrameHeader& frame, int32_t frameLength)
-{
-    frame.Length.store(frameLength, std::memory_order_release);
-}
-
-//----------------------------------------------------------------------------
-// NAME: SignalFrameForCleanup
-//
-// PURPOSE:
-//  Notify the cleanup thread, that the frame has been processed.
-//
-// RETURNS:
-//  Nothing.
-//
-// NOTES:
-//  Reader function.
-//
-void SignalFrameForCleanup(FrameHeader& frame, int32_t frameLength)
-{
-    frame.Length.store(-frameLength, std::memory_order_release);
-}
-
 //----------------------------------------------------------------------------
 // NAME: ISharedChannel::InitializeChannel
 //
@@ -70,15 +38,24 @@ void ISharedChannel::InitializeChannel()
     // Recover from the previous failures.
     //
 
+    // Drop the region acquired by the writer that failed before it published the region.
+    //
+    uint32_t writePosition = Sync.WritePosition.load(std::memory_order_relaxed);
+
+    if ((writePosition & 1) == 1)
+    {
+        writePosition &= ~1u;
+        Sync.WritePosition.store(writePosition, std::memory_order_release);
+    }
+
     // Advance the free region. Follow the free links up to the current read position.
     //
     AdvanceFreePosition();
 
     // We reached first unprocessed frame. Follow the frames untill we reach writePosition.
-    // Clear the partially written frames and convert processed frames into empty ones, so the reader can ignore them.
+    // Convert the partially written frames and processed frames into link frames, so the reader can ignore them.
     //
     uint32_t freePosition = Sync.FreePosition.load(std::memory_order_acquire);
-    uint32_t writePosition = Sync.WritePosition.load(std::memory_order_relaxed);
 
     while (freePosition != writePosition)
     {
@@ -99,7 +76,7 @@ void ISharedChannel::InitializeChannel()
 
             // The frame is partially written. Ignore it.
             //
-            ClearPayload(freeOffset, frameLength);
+            frame.CodegenTypeIndex = 0;
 
             frame.Length.store(frameLength, std::memory_order_release);
         }
@@ -116,6 +93,72 @@ void ISharedChannel::InitializeChannel()
     Sync.ReadPosition.compare_exchange_strong(readPosition, freePosition);
 }
 
+//----------------------------------------------------------------------------
+// NAME: ISharedChannel::AcquireReaderStats
+//
+// PURPOSE:
+//  Acquires the counters slot for the current reader thread.
+//
+// RETURNS:
+//  Returns the acquired slot or nullptr if all the reader slots are in use.
+//
+// NOTES:
+//  The reader thread owns the slot until it releases it, so it updates the counters without the interlocked operations.
+//  A reader without the slot processes the messages without updating the counters.
+//  The slots acquired by the terminated process are not released.
+//
+ChannelReaderStats* ISharedChannel::AcquireReaderStats()
+{
+    ChannelStats& stats = Sync.Stats;
+
+    uint32_t slotMask = stats.ReaderStatsSlotMask.load(std::memory_order_relaxed);
+
+    while (true)
+    {
+        // Find the first free slot.
+        //
+        uint32_t slotIndex = 0;
+        while (slotIndex < stats.ReaderStats.size() && (slotMask & (1u << slotIndex)) != 0)
+        {
+            ++slotIndex;
+        }
+
+        if (slotIndex == stats.ReaderStats.size())
+        {
+            return nullptr;
+        }
+
+        if (stats.ReaderStatsSlotMask.compare_exchange_weak(slotMask, slotMask | (1u << slotIndex)))
+        {
+            return &stats.ReaderStats[slotIndex];
+        }
+    }
+}
+
+//----------------------------------------------------------------------------
+// NAME: ISharedChannel::ReleaseReaderStats
+//
+// PURPOSE:
+//  Releases the counters slot acquired by the reader thread.
+//
+// RETURNS:
+//  Nothing.
+//
+// NOTES:
+//  The counters are preserved, the next reader using the slot continues to increment them.
+//
+void ISharedChannel::ReleaseReaderStats(ChannelReaderStats* readerStats)
+{
+    if (readerStats == nullptr)
+    {
+        return;
+    }
+
+    const uint32_t slotIndex = static_cast<uint32_t>(readerStats - Sync.Stats.ReaderStats.data());
+
+    Sync.Stats.ReaderStatsSlotMask.fetch_and(~(1u << slotIndex));
+}
+
 //----------------------------------------------------------------------------
 // NAME: ISharedChannel::AdvanceFreePosition
 //
@@ -125,18 +168,22 @@ void ISharedChannel::InitializeChannel()
 // RETURNS: None.
 //
 // NOTES:
-//  While we follow the links, the method is not cleaning the memory.
-//  The memory is cleared by the reader after processing the frame.
-//  The whole memory region is clean except locations where negative frame length values are stored
+//  Readers do not clear the processed frames, they only store negative frame length values
 //  to signal that the message has been read and the frame is free-able.
-//  Those locations are always aligned to the size of uint32_t. The current reader continues to spin if it reads negative frame length.
+//  The writer collects all the consecutive processed frames and advances the free position past them
+//  with a single compare and exchange. The reclaimed memory is not cleared, the readers do not read
+//  the frame lengths located after the write position (see PublishWriteRegion).
+//
+//  If other writer has already advanced the free position, the local free position is stale
+//  and the frames might have been overwritten, so the walk stops at the read position
+//  and the compare and exchange fails.
 //
 void ISharedChannel::AdvanceFreePosition()
 {
     // Move free position and allow the writer to advance.
     //
-    uint32_t freePosition = Sync.FreePosition.load(std::memory_order_acquire);
-    uint32_t readPosition = Sync.ReadPosition.load(std::memory_order_relaxed);
+    const uint32_t freePosition = Sync.FreePosition.load(std::memory_order_acquire);
+    const uint32_t readPosition = Sync.ReadPosition.load(std::memory_order_relaxed);
 
     if (freePosition == readPosition)
     {
@@ -145,54 +192,89 @@ void ISharedChannel::AdvanceFreePosition()
         return;
     }
 
-    // For diagnostic purposes, following the free links we should get the same distance.
+    // Load a frame from the beginning of the free region.
     //
-    uint32_t distance = readPosition - freePosition;
+    const uint32_t freeOffset = freePosition % Size;
+    FrameHeader& frame = Frame(freeOffset);
+    const int32_t frameLength = frame.Length.load(std::memory_order_acquire);
 
-    // Follow the free links up to the current read position.
-    // The cleanup is completed when the free position is equal to the read position.
-    // However, by the time this cleanup is completed, the reader threads might process more frames and advance the read position.
-    //
-    while (freePosition != readPosition)
+    if (frameLength >= 0 || (frameLength & 1) == 1)
     {
-        // Load a frame from the beginning of the free region.
-        // However, other writer threads might already advance the free position.
-        // In this case, local free position points to the write region and
-        // we will fail to advance free offset.
+        // Frame is currently processed.
         //
-        const uint32_t freeOffset = freePosition % Size;
-        const FrameHeader& frame = Frame(freeOffset);
-        int32_t frameLength = frame.Length.load(std::memory_order_acquire);
+        return;
+    }
 
-        if (frameLength >= 0)
-        {
-            // Frame is currently processed or has been already cleared.
-            // Other writer thread advanced free position, there is no point to check using compare_exchange_weak.
-            // Local free offset is now the write region.
-            //
-            return;
-        }
+    // Follow the free links up to the current read position.
+    // By the time this cleanup is completed, the reader threads might process more frames and advance the read position.
+    //
+    const uint32_t readLength = readPosition - freePosition;
+    uint32_t nextFreePosition = freePosition - frameLength;
 
-        // Advance free position. The frame length is negative.
-        //
-        uint32_t expectedFreePosition = freePosition;
-        uint32_t nextFreePosition = (freePosition - frameLength);
+    while (nextFreePosition - freePosition < readLength)
+    {
+        const int32_t nextFrameLength = Frame(nextFreePosition % Size).Length.load(std::memory_order_acquire);
 
-        if (!Sync.FreePosition.compare_exchange_weak(expectedFreePosition, nextFreePosition))
+        if (nextFrameLength >= 0 || (nextFrameLength & 1) == 1)
         {
-            // Advanced by another writer, local free offset is now the write region.
+            // Frame is currently processed.
             //
-            return;
+            break;
         }
 
-        freePosition = nextFreePosition;
+        nextFreePosition -= nextFrameLength;
+    }
 
-        // Frame length is negative.
+    if (nextFreePosition - freePosition > readLength)
+    {
+        // The local free position is stale, the frames have been overwritten.
         //
-        distance += frameLength;
+        return;
     }
 
-    assert(distance == 0);
+    // Advance free position, unless other writer thread has already advanced it.
+    //
+    uint32_t expectedFreePosition = freePosition;
+    Sync.FreePosition.compare_exchange_strong(expectedFreePosition, nextFreePosition);
+}
+
+//----------------------------------------------------------------------------
+// NAME: SharedChannelSpinPolicy::CurrentConfig
+//
+// RETURNS:
+//  Returns the thresholds used by the channels in the process.
+//
+// NOTES:
+//
+SharedChannelSpinPolicyConfig SharedChannelSpinPolicy::CurrentConfig()
+{
+    SharedChannelSpinPolicyConfig config;
+    config.PauseSpinCount = s_thresholds.PauseSpinCount.load(std::memory_order_relaxed);
+    config.MaxBackoffPauseCount = s_thresholds.MaxBackoffPauseCount.load(std::memory_order_relaxed);
+    config.YieldCount = s_thresholds.YieldCount.load(std::memory_order_relaxed);
+    config.ParkDurationInMicroseconds = s_thresholds.ParkDurationInMicroseconds.load(std::memory_order_relaxed);
+
+    return config;
+}
+
+//----------------------------------------------------------------------------
+// NAME: SharedChannelSpinPolicy::UpdateConfig
+//
+// PURPOSE:
+//  Sets the thresholds used by the channels in the process.
+//
+// RETURNS:
+//  Nothing.
+//
+// NOTES:
+//  The waits already in progress keep their thresholds.
+//
+void SharedChannelSpinPolicy::UpdateConfig(const SharedChannelSpinPolicyConfig& config)
+{
+    s_thresholds.PauseSpinCount.store(config.PauseSpinCount, std::memory_order_relaxed);
+    s_thresholds.MaxBackoffPauseCount.store(config.MaxBackoffPauseCount, std::memory_order_relaxed);
+    s_thresholds.YieldCount.store(config.YieldCount, std::memory_order_relaxed);
+    s_thresholds.ParkDurationInMicroseconds.store(config.ParkDurationInMicroseconds, std::memory_order_relaxed);
 }
 }
 }
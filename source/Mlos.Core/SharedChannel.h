@@ -21,8 +21,13 @@ namespace Mlos
 {
 namespace Core
 {
-void SignalFrameIsReady(FrameHeader& frame, int32_t frameLength);
-void SignalFrameForCleanup(FrameHeader& frame, int32_t frameLength);
+inline void SignalFrameIsReady(FrameHeader& frame, int32_t frameLength);
+inline void SignalFrameForCleanup(FrameHeader& frame, int32_t frameLength);
+
+template<typename TMessage>
+class EmplacedMessage;
+
+enum class SharedChannelOverflowMode;
 
 //----------------------------------------------------------------------------
 // NAME: ISharedChannel
@@ -38,11 +43,19 @@ void SignalFrameForCleanup(FrameHeader& frame, int32_t frameLength);
 class ISharedChannel
 {
 public:
-    ISharedChannel(Mlos::Core::ChannelSynchronization& sync, Mlos::Core::BytePtr buffer, uint32_t size)
+    ISharedChannel(Mlos::Core::ChannelSynchronization& sync, Mlos::Core::BytePtr buffer, uint32_t size, bool hasSingleWriter = false)
       : Sync(sync),
         Buffer(buffer),
         Size(1 << most_significant_bit(size)),
-        Margin(Size - sizeof(FrameHeader))
+        FrameHeaderLength(sync.HasCompactFrameHeaders.load(std::memory_order_relaxed) ? CompactFrameHeaderLength : sizeof(FrameHeader)),
+        Margin(Size - FrameHeaderLength),
+        HasFrameTimestamps(sync.HasFrameTimestamps.load(std::memory_order_relaxed)),
+        HasCompactFrameHeaders(FrameHeaderLength == CompactFrameHeaderLength),
+        FrameOverheadLength(FrameHeaderLength + (HasFrameTimestamps ? static_cast<uint32_t>(sizeof(uint64_t)) : 0)),
+        HasSingleWriter(hasSingleWriter),
+        LatencyStats(nullptr),
+        m_pendingRegionOccupancy(0),
+        m_pendingRegionStallTimeInMicroseconds(0)
     {
         // Buffer size requirements:
         // - Buffer size must be aligned to sizeof(uint32_t).
@@ -60,22 +73,67 @@ public:
         InitializeChannel();
     }
 
-    virtual uint32_t AcquireWriteRegionForFrame(int32_t& frameLength) = 0;
+    virtual uint32_t AcquireWriteRegionForFrame(int32_t& frameLength, uint32_t timeoutInMicroseconds) = 0;
 
     virtual void ProcessMessages(DispatchEntry* dispatchTable, size_t dispatchEntryCount) = 0;
 
     virtual void NotifyExternalReader() = 0;
 
+    // Called when the channel dropped the messages.
+    //
+    virtual void MessagesDropped(uint32_t codegenTypeIndex, uint32_t messageCount) = 0;
+
+    // Returns how the writer handles the buffer without enough free space.
+    //
+    virtual SharedChannelOverflowMode OverflowMode() const = 0;
+
+    // Called when the worker pool dispatched an invalid message read from the channel.
+    //
+    virtual void ReceivedInvalidFrame() = 0;
+
     // Returns true if there are reader threads waiting for external process.
     //
     inline bool HasReadersInWaitingState() const;
 
+    // Returns true if the channel can use a buffer of the given size.
+    // The size must be a power of two, so the positions wrap around the buffer when they overflow.
+    //
+    static constexpr bool IsValidBufferSize(size_t size)
+    {
+        return size > sizeof(FrameHeader) &&
+            size <= (static_cast<size_t>(1) << 31) &&
+            (size & (size - 1)) == 0;
+    }
+
     // Send the message object.
     //
     template<typename TMessage>
     inline void SendMessage(const TMessage& object);
 
-    // Follows free links until we reach read position.
+    // Send the message object, if there is not enough free space wait at most the given timeout.
+    //
+    template<typename TMessage>
+    inline HRESULT TrySendMessage(const TMessage& object, uint32_t timeoutInMicroseconds);
+
+    // Send a batch of message objects.
+    // Frames are written in regions of at most a quarter of the buffer, the reader is notified at most once per region.
+    //
+    template<typename... TMessages>
+    inline void SendBatch(const TMessages&... objects);
+
+    // Send an array of message objects.
+    // Frames are written in batches, each batch uses a single acquired region.
+    //
+    template<typename TMessage>
+    inline void SendMessages(const TMessage* objects, size_t count);
+
+    // Reserve the frame for the message object, the writer fills the message in place.
+    // The message is sent when the writer commits it.
+    //
+    template<typename TMessage>
+    inline EmplacedMessage<TMessage> Emplace();
+
+    // Follows free links until we reach read position and reclaims the processed frames.
     //
     void AdvanceFreePosition();
 
@@ -83,46 +141,188 @@ public:
     //
     void InitializeChannel();
 
+    // Acquires the counters slot for the current reader thread.
+    //
+    ChannelReaderStats* AcquireReaderStats();
+
+    // Releases the counters slot acquired by the reader thread.
+    //
+    void ReleaseReaderStats(ChannelReaderStats* readerStats);
+
 protected:
+    // Returns the counters slot assigned to the current writer thread.
+    //
+    inline ChannelWriterStats& CurrentWriterStats();
+
     inline FrameHeader& Frame(uint32_t offset);
 
     inline BytePtr Payload(uint32_t writeOffset);
 
-    inline void ClearPayload(uint32_t writeOffset, uint32_t frameLength)
-    {
-        memset(Buffer.Pointer + writeOffset + sizeof(uint32_t), 0, frameLength - sizeof(uint32_t));
-    }
+    // Acquires a region to write the frame.
+    // Takes the inline fast path if there is free space and the frame ends before the buffer margin,
+    // otherwise calls AcquireWriteRegionForFrame.
+    // The region is not visible to the readers until the writer publishes it.
+    //
+    inline uint32_t AcquireWriteRegion(int32_t& frameLength, uint32_t timeoutInMicroseconds);
 
-    inline void ClearLinkPayload(uint32_t writeOffset, uint32_t frameLength, uint32_t bufferSize)
-    {
-        writeOffset += sizeof(uint32_t);
-        frameLength -= sizeof(uint32_t);
-
-        if (writeOffset + frameLength > bufferSize)
-        {
-            // Overlapped link.
-            //
-            memset(Buffer.Pointer + writeOffset, 0, bufferSize - writeOffset);
-            memset(Buffer.Pointer, 0, frameLength + (writeOffset - bufferSize));
-        }
-        else
-        {
-            memset(Buffer.Pointer + writeOffset, 0, frameLength);
-        }
-    }
+    // Publishes the acquired region, the lengths of all the frames in the region must be already stored.
+    // Updates the writer stats of the region after it is published.
+    //
+    inline void PublishWriteRegion(int32_t regionLength);
+
+    // Keeps the stats of the acquired region until the region is published.
+    //
+    inline void SetPendingRegionStats(uint32_t occupancy, uint64_t stallTimeInMicroseconds);
+
+    template<typename TMessage>
+    inline int32_t CalculateFrameLength(const TMessage& msg) const;
+
+    template<typename TMessage>
+    inline int32_t CalculateFixedFrameLength() const;
+
+    // Returns the payload length of the message without variable length fields, aligned to sizeof(int32_t).
+    //
+    template<typename TMessage>
+    static constexpr int32_t FixedPayloadLength();
+
+    template<typename TMessage>
+    inline void WriteFrame(uint32_t writeOffset, int32_t frameLength, const TMessage& msg);
+
+    // Completes the frame reserved by Emplace and notifies the readers.
+    //
+    inline void CommitFrame(uint32_t writeOffset, int32_t frameLength);
+
+    // Turns the frame reserved by Emplace into an empty frame, the readers skip it.
+    //
+    inline void AbortFrame(uint32_t writeOffset, int32_t frameLength);
+
+    template<typename TMessage>
+    friend class EmplacedMessage;
 
 public:
+    // Timeout value for the writer to wait until the readers release the frames.
+    //
+    static constexpr uint32_t InfiniteTimeout = std::numeric_limits<uint32_t>::max();
+
+    // Length of the compact frame header, the frame header without the type hash.
+    //
+    static constexpr uint32_t CompactFrameHeaderLength = sizeof(FrameHeader) - sizeof(uint64_t);
+
+    static_assert(
+        sizeof(FrameHeader) % sizeof(int32_t) == 0 && CompactFrameHeaderLength % sizeof(int32_t) == 0,
+        "Frame header lengths must be aligned to sizeof(int32_t)");
+
     ChannelSynchronization& Sync;
 
     // Size of the buffer.
     //
     uint32_t Size;
 
-    // Size of the buffer - sizeof(FrameHeader);
+    // Length of the frame header, sizeof(FrameHeader) or CompactFrameHeaderLength.
+    //
+    const uint32_t FrameHeaderLength;
+
+    // Size of the buffer - FrameHeaderLength;
     //
     uint32_t Margin;
 
     BytePtr Buffer;
+
+    // If true, the writers append the send timestamp to each frame.
+    // Read from the synchronization object when the channel is created.
+    //
+    const bool HasFrameTimestamps;
+
+    // If true, the frames have the compact header, the writers do not store and the readers do not verify the type hash.
+    // Read from the synchronization object when the channel is created.
+    //
+    const bool HasCompactFrameHeaders;
+
+    // Length of the frame header and the timestamp, the frame length of the fixed size message adds only the payload length.
+    //
+    const uint32_t FrameOverheadLength;
+
+    // If true, the channel has a single writer, the writers publish the write position without the interlocked operation.
+    //
+    const bool HasSingleWriter;
+
+    // Latency histograms updated by the readers, nullptr if the latencies are not recorded.
+    // Must be set before the reader threads start.
+    //
+    Internal::ChannelLatencyMemoryRegion* LatencyStats;
+
+private:
+    // Stats of the pending region, the writer stats are updated after the region is published.
+    // Only the writer owning the pending write position accesses them.
+    //
+    uint32_t m_pendingRegionOccupancy;
+    uint64_t m_pendingRegionStallTimeInMicroseconds;
+};
+
+//----------------------------------------------------------------------------
+// NAME: EmplacedMessage<TMessage>
+//
+// PURPOSE:
+//  Message frame reserved in the channel buffer by ISharedChannel::Emplace.
+//  The writer fills the message fields in place using the codegen proxy and commits the message.
+//
+// NOTES:
+//  The readers process the frames in order, they wait until the reserved frame is committed or aborted.
+//  If the message is neither committed nor aborted, the destructor aborts it.
+//  The message is cleared in the frame, the fields that are not set are zero.
+//
+template<typename TMessage>
+class EmplacedMessage
+{
+public:
+    EmplacedMessage(ISharedChannel& sharedChannel, uint32_t writeOffset, int32_t frameLength) noexcept
+      : m_sharedChannel(&sharedChannel),
+        m_writeOffset(writeOffset),
+        m_frameLength(frameLength)
+    {
+    }
+
+    EmplacedMessage(EmplacedMessage&& other) noexcept
+      : m_sharedChannel(std::exchange(other.m_sharedChannel, nullptr)),
+        m_writeOffset(other.m_writeOffset),
+        m_frameLength(other.m_frameLength)
+    {
+    }
+
+    EmplacedMessage(const EmplacedMessage&) = delete;
+
+    EmplacedMessage& operator=(const EmplacedMessage&) = delete;
+
+    EmplacedMessage& operator=(EmplacedMessage&&) = delete;
+
+    ~EmplacedMessage()
+    {
+        Abort();
+    }
+
+    // Returns true if the frame is reserved and not yet committed or aborted.
+    // The frame is not reserved if the channel has been terminated or the channel dropped the message.
+    //
+    inline bool IsReserved() const;
+
+    // Returns the proxy to the message stored in the frame.
+    //
+    inline typename TMessage::ProxyObjectType Message();
+
+    // Sends the message to the readers.
+    //
+    inline void Commit();
+
+    // Releases the frame without sending the message.
+    //
+    inline void Abort();
+
+private:
+    ISharedChannel* m_sharedChannel;
+
+    uint32_t m_writeOffset;
+
+    int32_t m_frameLength;
 };
 
 //----------------------------------------------------------------------------
@@ -142,7 +342,7 @@ public:
         Mlos::Core::BytePtr buffer,
         uint32_t size,
         TChannelPolicy channelPolicy = TChannelPolicy()) noexcept
-      : ISharedChannel(sync, buffer, size),
+      : ISharedChannel(sync, buffer, size, TChannelPolicy::IsSingleProducerSingleConsumer),
         ChannelPolicy(std::move(channelPolicy))
     {
     }
@@ -162,19 +362,65 @@ public:
 public:
     void ProcessMessages(DispatchEntry* dispatchTable, size_t dispatchEntryCount) override;
 
-    bool WaitAndDispatchFrame(DispatchEntry* dispatchTable, size_t dispatchEntryCount);
+    // Reader loop, claims multiple frames at once as configured by the channel settings.
+    //
+    void ProcessMessages(DispatchEntry* dispatchTable, size_t dispatchEntryCount, const ChannelSettings& channelSettings);
+
+    // Reader loop, the messages are dispatched by the worker pool.
+    // The reader claims the frames as configured by the channel settings, copies them to the worker queues
+    // and releases them without waiting for the callbacks.
+    //
+    void ProcessMessages(
+        DispatchEntry* dispatchTable,
+        size_t dispatchEntryCount,
+        const ChannelSettings& channelSettings,
+        DispatchWorkerPool& workerPool);
+
+    bool WaitAndDispatchFrame(
+        DispatchEntry* dispatchTable,
+        size_t dispatchEntryCount,
+        ChannelReaderStats* readerStats = nullptr);
+
+    bool WaitAndDispatchFrames(
+        DispatchEntry* dispatchTable,
+        size_t dispatchEntryCount,
+        uint32_t maxFrameCount,
+        uint32_t maxBatchLength,
+        ChannelReaderStats* readerStats = nullptr,
+        DispatchWorkerPool* workerPool = nullptr);
 
 public:
     TChannelPolicy ChannelPolicy;
 
 private:
-    virtual uint32_t AcquireWriteRegionForFrame(int32_t& frameLength) override;
+    virtual uint32_t AcquireWriteRegionForFrame(int32_t& frameLength, uint32_t timeoutInMicroseconds) override final;
+
+    virtual void NotifyExternalReader() override final;
+
+    virtual void MessagesDropped(uint32_t codegenTypeIndex, uint32_t messageCount) override final;
+
+    virtual SharedChannelOverflowMode OverflowMode() const override final;
+
+    virtual void ReceivedInvalidFrame() override final;
+
+    uint32_t AcquireRegionForWrite(int32_t& frameLength, uint32_t timeoutInMicroseconds);
+
+    void WaitForFreeSpace(uint32_t freePosition, uint32_t timeoutInMicroseconds);
 
-    virtual void NotifyExternalReader() override;
+    bool DiscardOldestFrame(uint32_t freePosition);
 
-    uint32_t AcquireRegionForWrite(int32_t& frameLength);
+    uint32_t WaitForFrames(
+        uint32_t maxFrameCount,
+        uint32_t maxBatchLength,
+        uint32_t& frameCount,
+        ChannelReaderStats* readerStats);
 
-    uint32_t WaitForFrame();
+    int32_t DispatchFrame(
+        uint32_t readOffset,
+        DispatchEntry* dispatchTable,
+        size_t dispatchEntryCount,
+        ChannelReaderStats* readerStats,
+        DispatchWorkerPool* workerPool);
 };
 }
 }
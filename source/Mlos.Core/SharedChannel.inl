@@ -20,6 +20,38 @@ namespace Mlos
 namespace Core
 {
 
+//----------------------------------------------------------------------------
+// NAME: SignalFrameIsReady
+//
+// PURPOSE:
+//  Signals readers that the frame is available to process.
+//
+// RETURNS:
+//
+// NOTES:
+//
+inline void SignalFrameIsReady(FrameHeader& frame, int32_t frameLength)
+{
+    frame.Length.store(frameLength, std::memory_order_release);
+}
+
+//----------------------------------------------------------------------------
+// NAME: SignalFrameForCleanup
+//
+// PURPOSE:
+//  Notify the cleanup thread, that the frame has been processed.
+//
+// RETURNS:
+//  Nothing.
+//
+// NOTES:
+//  Reader function.
+//
+inline void SignalFrameForCleanup(FrameHeader& frame, int32_t frameLength)
+{
+    frame.Length.store(-frameLength, std::memory_order_release);
+}
+
 //----------------------------------------------------------------------------
 // NAME: ISharedChannel::HasReadersInWaitingState
 //
@@ -32,54 +64,714 @@ bool ISharedChannel::HasReadersInWaitingState() const
 }
 
 //----------------------------------------------------------------------------
-// NAME: ISharedChannel::SendMessage
+// NAME: ISharedChannel::CurrentWriterStats
+//
+// PURPOSE:
+//  Returns the counters slot assigned to the current writer thread.
+//
+// NOTES:
+//  The threads are assigned to the slots round robin when they write to any channel for the first time.
+//  If there are more threads than slots, the threads share the slot, therefore the counters are atomic.
+//
+ChannelWriterStats& ISharedChannel::CurrentWriterStats()
+{
+    static std::atomic<uint32_t> s_writerThreadCount(0);
+    static thread_local const uint32_t t_writerStatsIndex = s_writerThreadCount.fetch_add(1, std::memory_order_relaxed);
+
+    return Sync.Stats.WriterStats[t_writerStatsIndex % Sync.Stats.WriterStats.size()];
+}
+
+//----------------------------------------------------------------------------
+// NAME: ISharedChannel::AcquireWriteRegion
+//
+// PURPOSE:
+//  Acquires a region to write the frame.
+//
+// RETURNS:
+//  Returns an offset to acquired memory region that can hold a full frame.
+//  If the channel has been terminated, the channel dropped the message or the timeout expired, returns uint32_t::max.
+//
+// NOTES:
+//  Writer fast path, all the send functions call it without the virtual call.
+//  If there is enough free space and the frame ends before the buffer margin,
+//  the region needs neither the link frame nor the length adjustment and it is acquired inline.
+//  Otherwise, or if another writer moved the write position, calls AcquireWriteRegionForFrame,
+//  which reclaims the free space, applies the overflow mode and waits.
+//  The acquired region is pending, the caller stores the frame lengths and calls PublishWriteRegion.
+//
+uint32_t ISharedChannel::AcquireWriteRegion(int32_t& frameLength, uint32_t timeoutInMicroseconds)
+{
+    // Read FreePosition first, same as AcquireRegionForWrite.
+    //
+    const uint32_t freePosition = Sync.FreePosition.load(std::memory_order_acquire);
+    uint32_t writePosition = Sync.WritePosition.load(std::memory_order_relaxed);
+
+    const uint32_t writeOffset = writePosition % Size;
+
+    if ((writePosition & 1) == 0 &&
+        writePosition - freePosition < Margin - frameLength &&
+        writeOffset + frameLength < Margin)
+    {
+        const uint32_t occupancy = writePosition + frameLength - freePosition;
+
+        bool isAcquired = true;
+
+        if (!HasSingleWriter)
+        {
+            // Set the pending bit, other writers wait until the region is published.
+            //
+            isAcquired = Sync.WritePosition.compare_exchange_weak(writePosition, writePosition | 1);
+        }
+
+        if (isAcquired)
+        {
+            SetPendingRegionStats(occupancy, 0);
+
+            return writeOffset;
+        }
+    }
+
+    return AcquireWriteRegionForFrame(frameLength, timeoutInMicroseconds);
+}
+
+//----------------------------------------------------------------------------
+// NAME: ISharedChannel::PublishWriteRegion
+//
+// PURPOSE:
+//  Publishes the region acquired by AcquireWriteRegion to the readers.
+//
+// RETURNS:
+//  Nothing.
+//
+// NOTES:
+//  The readers never read the frame lengths located at or after the write position,
+//  so the reclaimed memory does not have to be cleared. Before the writer publishes the region,
+//  it must store the lengths of all the frames in the region (with the incomplete bit if the frame is not written yet).
+//  Only the writer owning the pending write position updates it, the relaxed load returns its own value.
+//  The writer stats are updated after the region is published, the other writers do not wait for them.
+//
+void ISharedChannel::PublishWriteRegion(int32_t regionLength)
+{
+    const uint32_t writePosition = Sync.WritePosition.load(std::memory_order_relaxed) & ~1u;
+
+    // Read the pending stats before the next writer can acquire a region.
+    //
+    const uint32_t occupancy = m_pendingRegionOccupancy;
+    const uint64_t stallTimeInMicroseconds = m_pendingRegionStallTimeInMicroseconds;
+
+    Sync.WritePosition.store(writePosition + regionLength, std::memory_order_release);
+
+    ChannelWriterStats& writerStats = CurrentWriterStats();
+
+    if (stallTimeInMicroseconds != 0)
+    {
+        writerStats.FullBufferStallTimeInMicroseconds.fetch_add(stallTimeInMicroseconds, std::memory_order_relaxed);
+    }
+
+    // Update the occupancy high-water mark.
+    //
+    uint32_t maxOccupancy = writerStats.MaxOccupancy.load(std::memory_order_relaxed);
+
+    while (occupancy > maxOccupancy &&
+        !writerStats.MaxOccupancy.compare_exchange_weak(maxOccupancy, occupancy, std::memory_order_relaxed))
+    {
+    }
+}
+
+//----------------------------------------------------------------------------
+// NAME: ISharedChannel::SetPendingRegionStats
+//
+// PURPOSE:
+//  Keeps the stats of the acquired region until the region is published.
+//
+// RETURNS:
+//  Nothing.
+//
+// NOTES:
+//  The stats are calculated before the write position is acquired, only the plain stores are done
+//  while the other writers wait for the pending region.
+//
+void ISharedChannel::SetPendingRegionStats(uint32_t occupancy, uint64_t stallTimeInMicroseconds)
+{
+    m_pendingRegionOccupancy = occupancy;
+    m_pendingRegionStallTimeInMicroseconds = stallTimeInMicroseconds;
+}
+
+//----------------------------------------------------------------------------
+// NAME: ISharedChannel::SendMessage
+//
+// PURPOSE:
+//  Sends the message object.
+//
+// NOTES:
+//
+template<typename TMessage>
+void ISharedChannel::SendMessage(const TMessage& msg)
+{
+    // Calculate frame size.
+    //
+    int32_t frameLength = CalculateFrameLength(msg);
+
+    // Acquire a write region to write the frame.
+    //
+    uint32_t writeOffset = AcquireWriteRegion(frameLength, InfiniteTimeout);
+
+    if (writeOffset == std::numeric_limits<uint32_t>::max())
+    {
+        // The write has been terminated or the channel dropped the message, ignore the send.
+        //
+        if (!Sync.TerminateChannel.load(std::memory_order_relaxed))
+        {
+            MessagesDropped(TypeMetadataInfo::CodegenTypeIndex<TMessage>(), 1);
+        }
+
+        return;
+    }
+
+    // Store the frame length with incomplete bit and publish the region.
+    //
+    Frame(writeOffset).Length.store(frameLength | 1, std::memory_order_relaxed);
+    PublishWriteRegion(frameLength);
+
+    WriteFrame(writeOffset, frameLength, msg);
+
+    // If there are readers in the waiting state, we need to notify them.
+    //
+    if (HasReadersInWaitingState())
+    {
+        NotifyExternalReader();
+    }
+}
+
+//----------------------------------------------------------------------------
+// NAME: ISharedChannel::TrySendMessage
+//
+// PURPOSE:
+//  Sends the message object, if there is not enough free space waits at most the given timeout.
+//
+// RETURNS:
+//  S_OK if the message has been sent.
+//  E_TIMEOUT if the readers have not released enough space before the timeout expired.
+//  E_MESSAGE_DROPPED if the lossy channel dropped the message.
+//  E_ABORT if the channel has been terminated.
+//
+// NOTES:
+//  Zero timeout does not wait, the message is sent only if there is free space in the buffer.
+//  The channel dropping the newest messages never waits for the free space, the dropped message is counted
+//  in the drop stats, same as in SendMessage.
+//
+template<typename TMessage>
+HRESULT ISharedChannel::TrySendMessage(const TMessage& msg, uint32_t timeoutInMicroseconds)
+{
+    // Calculate frame size.
+    //
+    int32_t frameLength = CalculateFrameLength(msg);
+
+    // Acquire a write region to write the frame.
+    //
+    uint32_t writeOffset = AcquireWriteRegion(frameLength, timeoutInMicroseconds);
+
+    if (writeOffset == std::numeric_limits<uint32_t>::max())
+    {
+        if (Sync.TerminateChannel.load(std::memory_order_relaxed))
+        {
+            // The write has been terminated.
+            //
+            return E_ABORT;
+        }
+
+        if (OverflowMode() == SharedChannelOverflowMode::DropNewest)
+        {
+            // The channel dropped the message.
+            //
+            MessagesDropped(TypeMetadataInfo::CodegenTypeIndex<TMessage>(), 1);
+            return E_MESSAGE_DROPPED;
+        }
+
+        // The timeout expired.
+        //
+        return E_TIMEOUT;
+    }
+
+    // Store the frame length with incomplete bit and publish the region.
+    //
+    Frame(writeOffset).Length.store(frameLength | 1, std::memory_order_relaxed);
+    PublishWriteRegion(frameLength);
+
+    WriteFrame(writeOffset, frameLength, msg);
+
+    // If there are readers in the waiting state, we need to notify them.
+    //
+    if (HasReadersInWaitingState())
+    {
+        NotifyExternalReader();
+    }
+
+    return S_OK;
+}
+
+//----------------------------------------------------------------------------
+// NAME: ISharedChannel::SendBatch
+//
+// PURPOSE:
+//  Sends a batch of message objects.
+//
+// NOTES:
+//  Frames are stored one after another in regions acquired with one update of the write position each.
+//  As in SendMessages, a single region never exceeds a quarter of the buffer, a larger batch is split
+//  into several regions, so a batch larger than the buffer does not wait forever for the free space.
+//  Each frame is signaled as ready as soon as it is written, so the reader can start processing
+//  the batch before the writer completes it.
+//  The reader is notified at most once per region, after all the frames of the region are written.
+//
+template<typename... TMessages>
+void ISharedChannel::SendBatch(const TMessages&... msgs)
+{
+    static_assert(sizeof...(TMessages) > 0, "Batch must contain at least one message");
+
+    constexpr size_t frameCount = sizeof...(TMessages);
+
+    const int32_t maxBatchLength = static_cast<int32_t>(Size / 4);
+
+    // Calculate frame sizes.
+    //
+    const int32_t frameLengths[] = { CalculateFrameLength(msgs)... };
+    const uint32_t codegenTypeIndices[] = { TypeMetadataInfo::CodegenTypeIndex<TMessages>()... };
+
+    size_t batchEnd = 0;
+    int32_t batchLength = 0;
+    int32_t expectedBatchLength = 0;
+    uint32_t writeOffset = 0;
+    bool isDropped = false;
+
+    // Returns the length of the frame in the current region.
+    // If the acquired region has been extended, the last frame of the region includes the extra bytes.
+    //
+    auto batchFrameLength = [&](size_t index)
+        {
+            int32_t frameLength = frameLengths[index];
+            if (index == batchEnd - 1)
+            {
+                frameLength += batchLength - expectedBatchLength;
+            }
+
+            return frameLength;
+        };
+
+    // Acquires and publishes the region for the frames starting at the given index.
+    //
+    auto acquireNextRegion = [&](size_t batchStart)
+        {
+            // Collect the frames that fit in a single region.
+            // The first frame is always included.
+            //
+            batchLength = frameLengths[batchStart];
+            batchEnd = batchStart + 1;
+
+            while (batchEnd < frameCount && batchLength + frameLengths[batchEnd] <= maxBatchLength)
+            {
+                batchLength += frameLengths[batchEnd];
+                ++batchEnd;
+            }
+
+            expectedBatchLength = batchLength;
+
+            // Acquire a write region to write the frames.
+            //
+            writeOffset = AcquireWriteRegion(batchLength, InfiniteTimeout);
+
+            if (writeOffset == std::numeric_limits<uint32_t>::max())
+            {
+                // The write has been terminated or the channel dropped the batch, ignore the remaining messages.
+                //
+                if (!Sync.TerminateChannel.load(std::memory_order_relaxed))
+                {
+                    for (size_t index = batchStart; index < frameCount; ++index)
+                    {
+                        MessagesDropped(codegenTypeIndices[index], 1);
+                    }
+                }
+
+                isDropped = true;
+                return;
+            }
+
+            // Store the frame lengths with incomplete bit and publish the region.
+            //
+            uint32_t frameOffset = writeOffset;
+            for (size_t index = batchStart; index < batchEnd; ++index)
+            {
+                const int32_t frameLength = batchFrameLength(index);
+
+                Frame(frameOffset).Length.store(frameLength | 1, std::memory_order_relaxed);
+                frameOffset += frameLength;
+            }
+
+            PublishWriteRegion(batchLength);
+        };
+
+    // Write the frames, acquire the next region when the current one is filled.
+    //
+    size_t frameIndex = 0;
+
+    auto writeNextFrame = [&](const auto& msg)
+        {
+            if (isDropped)
+            {
+                return;
+            }
+
+            if (frameIndex == batchEnd)
+            {
+                acquireNextRegion(frameIndex);
+
+                if (isDropped)
+                {
+                    return;
+                }
+            }
+
+            const int32_t frameLength = batchFrameLength(frameIndex);
+
+            WriteFrame(writeOffset, frameLength, msg);
+
+            writeOffset += frameLength;
+            ++frameIndex;
+
+            // If there are readers in the waiting state, we need to notify them.
+            //
+            if (frameIndex == batchEnd && HasReadersInWaitingState())
+            {
+                NotifyExternalReader();
+            }
+        };
+
+    (writeNextFrame(msgs), ...);
+}
+
+//----------------------------------------------------------------------------
+// NAME: ISharedChannel::SendMessages
+//
+// PURPOSE:
+//  Sends an array of message objects.
+//
+// NOTES:
+//  Messages are split into batches, so a single acquired region never exceeds a quarter of the buffer.
+//  Otherwise a large batch would have to wait until the reader frees most of the buffer.
+//  The reader is notified at most once per batch, a writer blocked on the next batch
+//  must not wait for a reader that has not been notified.
+//
+template<typename TMessage>
+void ISharedChannel::SendMessages(const TMessage* msgs, size_t count)
+{
+    const int32_t maxBatchLength = static_cast<int32_t>(Size / 4);
+
+    size_t batchStart = 0;
+    while (batchStart < count)
+    {
+        // Collect the frames that fit in a single region.
+        // The first frame is always included.
+        //
+        int32_t batchLength = CalculateFrameLength(msgs[batchStart]);
+        size_t batchEnd = batchStart + 1;
+
+        while (batchEnd < count)
+        {
+            const int32_t frameLength = CalculateFrameLength(msgs[batchEnd]);
+            if (batchLength + frameLength > maxBatchLength)
+            {
+                break;
+            }
+
+            batchLength += frameLength;
+            ++batchEnd;
+        }
+
+        const int32_t expectedBatchLength = batchLength;
+
+        // Acquire a write region to write the frames.
+        //
+        uint32_t writeOffset = AcquireWriteRegion(batchLength, InfiniteTimeout);
+
+        if (writeOffset == std::numeric_limits<uint32_t>::max())
+        {
+            // The write has been terminated or the channel dropped the batch, ignore the remaining messages.
+            //
+            if (!Sync.TerminateChannel.load(std::memory_order_relaxed))
+            {
+                MessagesDropped(TypeMetadataInfo::CodegenTypeIndex<TMessage>(), static_cast<uint32_t>(count - batchStart));
+            }
+
+            return;
+        }
+
+        // Store the frame lengths with incomplete bit and publish the region.
+        // If the acquired region has been extended, the last frame includes the extra bytes.
+        //
+        auto batchFrameLength = [&](size_t index)
+            {
+                int32_t frameLength = CalculateFrameLength(msgs[index]);
+                if (index == batchEnd - 1)
+                {
+                    frameLength += batchLength - expectedBatchLength;
+                }
+
+                return frameLength;
+            };
+
+        uint32_t frameOffset = writeOffset;
+        for (size_t index = batchStart; index < batchEnd; ++index)
+        {
+            const int32_t frameLength = batchFrameLength(index);
+
+            Frame(frameOffset).Length.store(frameLength | 1, std::memory_order_relaxed);
+            frameOffset += frameLength;
+        }
+
+        PublishWriteRegion(batchLength);
+
+        // Write the frames.
+        //
+        for (size_t index = batchStart; index < batchEnd; ++index)
+        {
+            const int32_t frameLength = batchFrameLength(index);
+
+            WriteFrame(writeOffset, frameLength, msgs[index]);
+
+            writeOffset += frameLength;
+        }
+
+        // If there are readers in the waiting state, we need to notify them.
+        //
+        if (HasReadersInWaitingState())
+        {
+            NotifyExternalReader();
+        }
+
+        batchStart = batchEnd;
+    }
+}
+
+//----------------------------------------------------------------------------
+// NAME: ISharedChannel::Emplace
+//
+// PURPOSE:
+//  Reserves the frame for the message object, the writer fills the message in place.
+//
+// RETURNS:
+//  The reserved message, not reserved if the channel has been terminated or the channel dropped the message.
+//
+// NOTES:
+//  Avoids the copy of the message built on the stack, useful for the large messages.
+//  Only the messages without variable length fields have a known frame length before they are filled.
+//
+template<typename TMessage>
+EmplacedMessage<TMessage> ISharedChannel::Emplace()
+{
+    static_assert(
+        !ObjectSerialization::HasVariableData<TMessage>(),
+        "Messages with variable length fields cannot be emplaced");
+    static_assert(
+        std::is_trivially_copyable<TMessage>::value,
+        "Emplaced messages are cleared in the frame instead of constructed");
+
+    // Calculate frame size.
+    //
+    int32_t frameLength = CalculateFixedFrameLength<TMessage>();
+
+    // Acquire a write region to write the frame.
+    //
+    uint32_t writeOffset = AcquireWriteRegion(frameLength, InfiniteTimeout);
+
+    if (writeOffset == std::numeric_limits<uint32_t>::max())
+    {
+        // The write has been terminated or the channel dropped the message.
+        //
+        if (!Sync.TerminateChannel.load(std::memory_order_relaxed))
+        {
+            MessagesDropped(TypeMetadataInfo::CodegenTypeIndex<TMessage>(), 1);
+        }
+
+        return EmplacedMessage<TMessage>(*this, writeOffset, 0);
+    }
+
+    FrameHeader& frame = Frame(writeOffset);
+
+    // Store the frame length with incomplete bit and publish the region, the readers wait until the message is committed.
+    //
+    frame.Length.store(frameLength | 1, std::memory_order_relaxed);
+    PublishWriteRegion(frameLength);
+
+    // Store type index and hash.
+    //
+    frame.CodegenTypeIndex = TypeMetadataInfo::CodegenTypeIndex<TMessage>();
+
+    if (!HasCompactFrameHeaders)
+    {
+        frame.CodegenTypeHash = TypeMetadataInfo::CodegenTypeHash<TMessage>();
+    }
+
+    // Clear the message in the frame.
+    // The acquired region is not guaranteed to be clear, the fields not set by the writer must be zero.
+    // The payload is aligned only to sizeof(int32_t), so the message (e.g. with double fields) is not constructed in place,
+    // the writer accesses it through the proxy, same as the serialized messages.
+    //
+    memset(Payload(writeOffset).Pointer, 0, sizeof(TMessage));
+
+    return EmplacedMessage<TMessage>(*this, writeOffset, frameLength);
+}
+
+//----------------------------------------------------------------------------
+// NAME: ISharedChannel::CalculateFrameLength
+//
+// RETURNS:
+//  Returns the length of the frame required to store the message, aligned to sizeof(int32_t).
+//
+// NOTES:
+//  If the channel uses the frame timestamps, the frame includes the space for the timestamp.
+//  If the channel uses the compact frame headers, the frame does not include the type hash.
+//  The payload length of the messages without variable length fields is a compile time constant.
+//  Both frame header lengths are aligned to sizeof(int32_t), so only the payload length is aligned.
+//
+template<typename TMessage>
+int32_t ISharedChannel::CalculateFrameLength(const TMessage& msg) const
+{
+    if constexpr (!ObjectSerialization::HasVariableData<TMessage>())
+    {
+        (void)msg;
+
+        return CalculateFixedFrameLength<TMessage>();
+    }
+    else
+    {
+        const int32_t frameLength = static_cast<int32_t>(FrameHeaderLength + ObjectSerialization::GetSerializedSize(msg));
+        const int32_t timestampLength = HasFrameTimestamps ? static_cast<int32_t>(sizeof(uint64_t)) : 0;
+
+        return align<sizeof(int32_t)>(frameLength) + timestampLength;
+    }
+}
+
+//----------------------------------------------------------------------------
+// NAME: ISharedChannel::CalculateFixedFrameLength
+//
+// RETURNS:
+//  Returns the length of the frame required to store the message without variable length fields.
+//
+// NOTES:
+//  The payload length is a compile time constant, the frame header and timestamp lengths
+//  are added once, the channel computes them when it is created.
+//
+template<typename TMessage>
+int32_t ISharedChannel::CalculateFixedFrameLength() const
+{
+    return static_cast<int32_t>(FrameOverheadLength) + FixedPayloadLength<TMessage>();
+}
+
+//----------------------------------------------------------------------------
+// NAME: ISharedChannel::FixedPayloadLength
+//
+// RETURNS:
+//  Returns the payload length of the message without variable length fields, aligned to sizeof(int32_t).
+//
+// NOTES:
+//
+template<typename TMessage>
+constexpr int32_t ISharedChannel::FixedPayloadLength()
+{
+    static_assert(!ObjectSerialization::HasVariableData<TMessage>(), "Message has variable length fields");
+
+    return align<sizeof(int32_t)>(static_cast<int32_t>(sizeof(TMessage)));
+}
+
+//----------------------------------------------------------------------------
+// NAME: ISharedChannel::WriteFrame
+//
+// PURPOSE:
+//  Writes the message to the frame located at the given offset and signals the frame is ready.
+//
+// NOTES:
+//  The region for the frame must be already acquired and published by the writer,
+//  the frame length with incomplete bit has been stored before the region was published.
+//  If the channel uses the frame timestamps, the timestamp is stored in the last 8 bytes of the frame.
+//  The frame is aligned to sizeof(int32_t) only, the timestamp is copied.
+//  The compact frame header has no type hash, the payload is stored in its place.
+//
+template<typename TMessage>
+void ISharedChannel::WriteFrame(uint32_t writeOffset, int32_t frameLength, const TMessage& msg)
+{
+    FrameHeader& frame = Frame(writeOffset);
+
+    // Store type index and hash.
+    //
+    frame.CodegenTypeIndex = TypeMetadataInfo::CodegenTypeIndex<TMessage>();
+
+    if (!HasCompactFrameHeaders)
+    {
+        frame.CodegenTypeHash = TypeMetadataInfo::CodegenTypeHash<TMessage>();
+    }
+
+    // Copy the structure to the buffer.
+    //
+    BytePtr payload = Payload(writeOffset);
+    ObjectSerialization::Serialize(payload, msg);
+
+    if (HasFrameTimestamps)
+    {
+        const uint64_t timestamp = MlosPlatform::TimestampInNanoseconds();
+        memcpy(Buffer.Pointer + writeOffset + frameLength - sizeof(uint64_t), &timestamp, sizeof(uint64_t));
+    }
+
+    // Frame is ready for the reader.
+    //
+    SignalFrameIsReady(frame, frameLength);
+}
+
+//----------------------------------------------------------------------------
+// NAME: ISharedChannel::CommitFrame
 //
 // PURPOSE:
-//  Sends the message object.
+//  Signals the frame reserved by Emplace is ready and notifies the waiting readers.
 //
 // NOTES:
+//  If the channel uses the frame timestamps, the timestamp is the commit time.
 //
-template<typename TMessage>
-void ISharedChannel::SendMessage(const TMessage& msg)
+void ISharedChannel::CommitFrame(uint32_t writeOffset, int32_t frameLength)
 {
-    // Calculate frame size.
-    //
-    int32_t frameLength = static_cast<int32_t>(sizeof(FrameHeader) + ObjectSerialization::GetSerializedSize(msg));
-    frameLength = align<sizeof(int32_t)>(frameLength);
-
-    // Acquire a write region to write the frame.
-    //
-    uint32_t writeOffset = AcquireWriteRegionForFrame(frameLength);
-
-    if (writeOffset == std::numeric_limits<uint32_t>::max())
+    if (HasFrameTimestamps)
     {
-        // The write has been terminated, ignore the send.
-        //
-        return;
+        const uint64_t timestamp = MlosPlatform::TimestampInNanoseconds();
+        memcpy(Buffer.Pointer + writeOffset + frameLength - sizeof(uint64_t), &timestamp, sizeof(uint64_t));
     }
 
-    FrameHeader& frame = Frame(writeOffset);
-
-    // Optimization. Store the frame length with incomplete bit.
+    // Frame is ready for the reader.
     //
-    frame.Length.store(frameLength | 1, std::memory_order_release);
+    SignalFrameIsReady(Frame(writeOffset), frameLength);
 
-    // Store type index and hash.
+    // If there are readers in the waiting state, we need to notify them.
     //
-    frame.CodegenTypeIndex = TypeMetadataInfo::CodegenTypeIndex<TMessage>();
-    frame.CodegenTypeHash = TypeMetadataInfo::CodegenTypeHash<TMessage>();
+    if (HasReadersInWaitingState())
+    {
+        NotifyExternalReader();
+    }
+}
 
-    // Copy the structure to the buffer.
-    //
-    BytePtr payload = Payload(writeOffset);
-    ObjectSerialization::Serialize(payload, msg);
+//----------------------------------------------------------------------------
+// NAME: ISharedChannel::AbortFrame
+//
+// PURPOSE:
+//  Turns the frame reserved by Emplace into an empty frame.
+//
+// NOTES:
+//  The frame has already been acquired, so it cannot be returned to the buffer.
+//  The readers skip the empty frame the same way as the link to the beginning of the buffer.
+//
+void ISharedChannel::AbortFrame(uint32_t writeOffset, int32_t frameLength)
+{
+    FrameHeader& frame = Frame(writeOffset);
+    frame.CodegenTypeIndex = 0;
 
-    // Frame is ready for the reader.
-    //
     SignalFrameIsReady(frame, frameLength);
 
-    // If there are readers in the waiting state, we need to notify them.
-    //
     if (HasReadersInWaitingState())
     {
         NotifyExternalReader();
@@ -93,7 +785,71 @@ FrameHeader& ISharedChannel::Frame(uint32_t offset)
 
 BytePtr ISharedChannel::Payload(uint32_t writeOffset)
 {
-    return BytePtr(Buffer.Pointer + writeOffset + sizeof(FrameHeader));
+    return BytePtr(Buffer.Pointer + writeOffset + FrameHeaderLength);
+}
+
+//----------------------------------------------------------------------------
+// NAME: EmplacedMessage<TMessage>::IsReserved
+//
+template<typename TMessage>
+bool EmplacedMessage<TMessage>::IsReserved() const
+{
+    return m_sharedChannel != nullptr && m_writeOffset != std::numeric_limits<uint32_t>::max();
+}
+
+//----------------------------------------------------------------------------
+// NAME: EmplacedMessage<TMessage>::Message
+//
+// RETURNS:
+//  Returns the proxy to the message stored in the reserved frame.
+//
+// NOTES:
+//  The frame must be reserved.
+//
+template<typename TMessage>
+typename TMessage::ProxyObjectType EmplacedMessage<TMessage>::Message()
+{
+    assert(IsReserved());
+
+    return typename TMessage::ProxyObjectType(m_sharedChannel->Payload(m_writeOffset));
+}
+
+//----------------------------------------------------------------------------
+// NAME: EmplacedMessage<TMessage>::Commit
+//
+// PURPOSE:
+//  Sends the message filled in the reserved frame.
+//
+// NOTES:
+//  No-op if the frame is not reserved.
+//
+template<typename TMessage>
+void EmplacedMessage<TMessage>::Commit()
+{
+    if (IsReserved())
+    {
+        m_sharedChannel->CommitFrame(m_writeOffset, m_frameLength);
+        m_sharedChannel = nullptr;
+    }
+}
+
+//----------------------------------------------------------------------------
+// NAME: EmplacedMessage<TMessage>::Abort
+//
+// PURPOSE:
+//  Releases the reserved frame without sending the message.
+//
+// NOTES:
+//  No-op if the frame is not reserved.
+//
+template<typename TMessage>
+void EmplacedMessage<TMessage>::Abort()
+{
+    if (IsReserved())
+    {
+        m_sharedChannel->AbortFrame(m_writeOffset, m_frameLength);
+        m_sharedChannel = nullptr;
+    }
 }
 
 //----------------------------------------------------------------------------
@@ -104,12 +860,15 @@ BytePtr ISharedChannel::Payload(uint32_t writeOffset)
 //
 // RETURNS:
 //  Returns an offset to acquired memory region that can hold a full frame.
+//  If the channel has been terminated or the timeout expired, returns uint32_t::max.
 //
 // NOTES:
 //  The acquired region is contiguous.
 //
 template <typename TChannelPolicy, typename TChannelSpinPolicy>
-uint32_t SharedChannel<TChannelPolicy, TChannelSpinPolicy>::AcquireWriteRegionForFrame(int32_t& frameLength)
+uint32_t SharedChannel<TChannelPolicy, TChannelSpinPolicy>::AcquireWriteRegionForFrame(
+    int32_t& frameLength,
+    uint32_t timeoutInMicroseconds)
 {
     const uint32_t expectedFrameLength = frameLength;
 
@@ -126,11 +885,11 @@ uint32_t SharedChannel<TChannelPolicy, TChannelSpinPolicy>::AcquireWriteRegionFo
 
         // Acquire region for writes. Function might adjust frame length.
         //
-        const uint32_t writeOffset = AcquireRegionForWrite(frameLength);
+        const uint32_t writeOffset = AcquireRegionForWrite(frameLength, timeoutInMicroseconds);
 
         if (writeOffset == std::numeric_limits<uint32_t>::max())
         {
-            // The reader has terminated, abandon the write.
+            // The reader has terminated or the timeout expired, abandon the write.
             //
             return writeOffset;
         }
@@ -146,7 +905,10 @@ uint32_t SharedChannel<TChannelPolicy, TChannelSpinPolicy>::AcquireWriteRegionFo
             //
             FrameHeader& frame = Frame(writeOffset);
             frame.CodegenTypeIndex = 0;
-            SignalFrameIsReady(frame, frameLength);
+            frame.Length.store(frameLength, std::memory_order_relaxed);
+            PublishWriteRegion(frameLength);
+
+            CurrentWriterStats().LinkFrameCount.fetch_add(1, std::memory_order_relaxed);
             continue;
         }
 
@@ -171,6 +933,55 @@ void SharedChannel<TChannelPolicy, TChannelSpinPolicy>::NotifyExternalReader()
     ChannelPolicy.NotifyExternalReader();
 }
 
+//----------------------------------------------------------------------------
+// NAME: SharedChannel<TChannelPolicy, TChannelSpinPolicy>::MessagesDropped
+//
+// PURPOSE:
+//  Called when the channel dropped the messages, the channel policy counts them.
+//
+// RETURNS:
+//
+// NOTES:
+//
+template <typename TChannelPolicy, typename TChannelSpinPolicy>
+void SharedChannel<TChannelPolicy, TChannelSpinPolicy>::MessagesDropped(uint32_t codegenTypeIndex, uint32_t messageCount)
+{
+    ChannelPolicy.MessagesDropped(codegenTypeIndex, messageCount);
+}
+
+//----------------------------------------------------------------------------
+// NAME: SharedChannel<TChannelPolicy, TChannelSpinPolicy>::OverflowMode
+//
+// PURPOSE:
+//  Returns how the writer handles the buffer without enough free space, provided by the channel policy.
+//
+// RETURNS:
+//
+// NOTES:
+//
+template <typename TChannelPolicy, typename TChannelSpinPolicy>
+SharedChannelOverflowMode SharedChannel<TChannelPolicy, TChannelSpinPolicy>::OverflowMode() const
+{
+    return ChannelPolicy.OverflowMode();
+}
+
+//----------------------------------------------------------------------------
+// NAME: SharedChannel<TChannelPolicy, TChannelSpinPolicy>::ReceivedInvalidFrame
+//
+// PURPOSE:
+//  Called when the worker pool dispatched an invalid message, the channel policy handles it.
+//
+// RETURNS:
+//
+// NOTES:
+//  Called on the worker threads.
+//
+template <typename TChannelPolicy, typename TChannelSpinPolicy>
+void SharedChannel<TChannelPolicy, TChannelSpinPolicy>::ReceivedInvalidFrame()
+{
+    ChannelPolicy.ReceivedInvalidFrame();
+}
+
 //----------------------------------------------------------------------------
 // NAME: SharedChannel<TChannelPolicy, TChannelSpinPolicy>::AcquireRegionForWrite
 //
@@ -179,16 +990,62 @@ void SharedChannel<TChannelPolicy, TChannelSpinPolicy>::NotifyExternalReader()
 //
 // RETURNS:
 //  An offset to the acquired region.
-//  If reader has been aborted, return uint32_t::max.
+//  If reader has been aborted or the timeout expired, return uint32_t::max.
 //
 // NOTES:
 //  There is no guarantee that the acquired region is contiguous (it might be overlapping).
 //  However it ensures that the next write offset will not be greater than the buffer margin,
 //  so the next writer can write an empty FrameHeader.
+//  The writer sets the lowest bit of the write position (pending) instead of advancing it,
+//  other writers wait until the region is published by PublishWriteRegion.
+//  The single writer does not update the write position until it publishes the region.
+//  If the buffer is full, the writer spins as long as the spin policy allows,
+//  then it waits until the readers release the processed frames.
+//  The writer counters are updated only on the slow paths (retries and stalls),
+//  except for the occupancy high-water mark, which is written only when it increases.
+//  The stats of the acquired region are calculated before the write position is acquired
+//  and updated by PublishWriteRegion, so the other writers do not wait for them.
 //
 template <typename TChannelPolicy, typename TChannelSpinPolicy>
-uint32_t SharedChannel<TChannelPolicy, TChannelSpinPolicy>::AcquireRegionForWrite(int32_t& frameLength)
+uint32_t SharedChannel<TChannelPolicy, TChannelSpinPolicy>::AcquireRegionForWrite(
+    int32_t& frameLength,
+    uint32_t timeoutInMicroseconds)
 {
+    TChannelSpinPolicy channelSpinPolicy;
+
+    ChannelWriterStats& writerStats = CurrentWriterStats();
+
+    // The deadline is calculated when the writer finds the buffer full for the first time.
+    //
+    std::chrono::steady_clock::time_point deadline;
+    bool hasDeadline = false;
+
+    // The stall starts when the writer waits for the free space for the first time.
+    //
+    std::chrono::steady_clock::time_point stallStartTime;
+    bool hasStalled = false;
+
+    auto stallTime = [&stallStartTime, &hasStalled]() -> uint64_t
+        {
+            if (!hasStalled)
+            {
+                return 0;
+            }
+
+            return std::chrono::duration_cast<std::chrono::microseconds>(
+                std::chrono::steady_clock::now() - stallStartTime).count();
+        };
+
+    auto recordStallTime = [&writerStats, &stallTime]()
+        {
+            const uint64_t stallTimeInMicroseconds = stallTime();
+
+            if (stallTimeInMicroseconds != 0)
+            {
+                writerStats.FullBufferStallTimeInMicroseconds.fetch_add(stallTimeInMicroseconds, std::memory_order_relaxed);
+            }
+        };
+
     while (true)
     {
         // FreePosition is expected to be less than WritePosition unless WritePosition has overflow.
@@ -197,6 +1054,19 @@ uint32_t SharedChannel<TChannelPolicy, TChannelSpinPolicy>::AcquireRegionForWrit
         const uint32_t freePosition = Sync.FreePosition.load(std::memory_order_acquire);
         uint32_t writePosition = Sync.WritePosition.load(std::memory_order_relaxed);
 
+        if constexpr (!TChannelPolicy::IsSingleProducerSingleConsumer)
+        {
+            if ((writePosition & 1) == 1)
+            {
+                // Other writer is storing the frame lengths of its region.
+                //
+                writerStats.WriteRegionAcquireRetryCount.fetch_add(1, std::memory_order_relaxed);
+
+                channelSpinPolicy.FailedToAcquireWriteRegion();
+                continue;
+            }
+        }
+
         // Check if there is enough bytes to write frame (full frame or a link).
         // Always keep the distance to free offset, at least a size of FrameHeader.
         // If WritePosition overflown, then (writePosition - freePosition) is still positive value.
@@ -210,78 +1080,283 @@ uint32_t SharedChannel<TChannelPolicy, TChannelSpinPolicy>::AcquireRegionForWrit
             //
             if (Sync.TerminateChannel.load(std::memory_order_relaxed))
             {
+                recordStallTime();
+                return std::numeric_limits<uint32_t>::max();
+            }
+
+            // Not enough free space to acquire region.
+            // Advance free position to reclaim memory for writes.
+            // Retry after that, as another writer might acquire just the released region.
+            //
+            AdvanceFreePosition();
+
+            if (Sync.FreePosition.load(std::memory_order_acquire) != freePosition)
+            {
+                continue;
+            }
+
+            // The readers have not released any frame yet.
+            //
+            const SharedChannelOverflowMode overflowMode = ChannelPolicy.OverflowMode();
+
+            if (overflowMode == SharedChannelOverflowMode::DropNewest)
+            {
+                // Drop the new message.
+                //
                 return std::numeric_limits<uint32_t>::max();
             }
 
-            // Not enough free space to acquire region.
-            // Advance free position to reclaim memory for writes.
-            // Retry after that, as another writer might acquire just the released region.
-            //
-            AdvanceFreePosition();
-            continue;
-        }
+            // Single producer single consumer channel can not overwrite the frames, the reader owns the read position.
+            //
+            assert(!TChannelPolicy::IsSingleProducerSingleConsumer || overflowMode != SharedChannelOverflowMode::OverwriteOldest);
+
+            if (overflowMode == SharedChannelOverflowMode::OverwriteOldest && DiscardOldestFrame(freePosition))
+            {
+                // Reclaim the discarded frame.
+                //
+                continue;
+            }
+
+            uint32_t remainingTimeoutInMicroseconds = InfiniteTimeout;
+
+            if (timeoutInMicroseconds != InfiniteTimeout)
+            {
+                const std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+
+                if (!hasDeadline)
+                {
+                    deadline = now + std::chrono::microseconds(timeoutInMicroseconds);
+                    hasDeadline = true;
+                }
+
+                if (now >= deadline)
+                {
+                    // The timeout expired.
+                    //
+                    recordStallTime();
+                    return std::numeric_limits<uint32_t>::max();
+                }
+
+                remainingTimeoutInMicroseconds = static_cast<uint32_t>(
+                    std::chrono::duration_cast<std::chrono::microseconds>(deadline - now).count());
+            }
+
+            if (!hasStalled)
+            {
+                stallStartTime = std::chrono::steady_clock::now();
+                hasStalled = true;
+
+                writerStats.FullBufferStallCount.fetch_add(1, std::memory_order_relaxed);
+            }
+
+            // Spin for a while, then wait for the notification from the readers.
+            //
+            if (!channelSpinPolicy.WaitForFreeSpace())
+            {
+                WaitForFreeSpace(freePosition, remainingTimeoutInMicroseconds);
+            }
+
+            continue;
+        }
+
+        // If the end of the requested frame is located in the buffer margin, extend the acquired region.
+        //
+        int32_t frameLengthAdj = 0;
+
+        // NextWritePosition is at the frame end.
+        // NextWriteOffset (calculated from NextWritePosition) must be aligned to sizeof(uint32_t)
+        // therefore frame length must be also aligned.
+        //
+        uint32_t nextWritePosition = writePosition + frameLength;
+
+        // Ensure that after a full frame there is enough space for the next frame header.
+        // Otherwise, we will not be able to store next frame, because the frame header will not fit in the buffer.
+        //
+        uint32_t nextWriteOffset = nextWritePosition % Size;
+        if (nextWriteOffset >= Margin)
+        {
+            // Update frameLength, as we acquired more than requested.
+            //
+            frameLengthAdj = Size - nextWriteOffset;
+
+            nextWritePosition += frameLengthAdj;
+        }
+
+        // Calculate the stats before acquiring the region, the other writers wait until the region is published.
+        //
+        const uint32_t occupancy = nextWritePosition - freePosition;
+        const uint64_t stallTimeInMicroseconds = stallTime();
+
+        if constexpr (!TChannelPolicy::IsSingleProducerSingleConsumer)
+        {
+            // There is no other writer in the single producer channel, the region is acquired without the interlocked operation.
+            //
+            uint32_t expectedWritePosition = writePosition;
+            if (!Sync.WritePosition.compare_exchange_weak(expectedWritePosition, writePosition | 1))
+            {
+                // Failed to advance write offset, other writer acquired this region.
+                //
+                writerStats.WriteRegionAcquireRetryCount.fetch_add(1, std::memory_order_relaxed);
+
+                channelSpinPolicy.FailedToAcquireWriteRegion();
+                continue;
+            }
+        }
+
+        frameLength += frameLengthAdj;
+
+        // The stats are updated when the region is published.
+        //
+        SetPendingRegionStats(occupancy, stallTimeInMicroseconds);
+
+        // The region contains the stale frames, the readers do not read it until the region is published.
+        // Frame links are always stored in offset aligned to sizeof int.
+        //
+        const uint32_t writeOffset = writePosition % Size;
+        return writeOffset;
+    }
+}
+
+//----------------------------------------------------------------------------
+// NAME: SharedChannel<TChannelPolicy, TChannelSpinPolicy>::WaitForFreeSpace
+//
+// PURPOSE:
+//  Waits until the readers release the processed frames located at the free position.
+//
+// RETURNS:
+//  Nothing.
+//
+// NOTES:
+//  Writer function.
+//  Before the writer waits, it checks the free space for the last time.
+//  The readers notify the writers after they signal the frames for cleanup,
+//  so either the writer finds the released frames or the readers wake it up.
+//  The wait might return before the frames are released or the timeout expired, the caller checks again.
+//
+template <typename TChannelPolicy, typename TChannelSpinPolicy>
+void SharedChannel<TChannelPolicy, TChannelSpinPolicy>::WaitForFreeSpace(
+    uint32_t freePosition,
+    uint32_t timeoutInMicroseconds)
+{
+    const uint32_t waitToken = ChannelPolicy.PrepareWaitForFreeSpace();
+
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+
+    if (Sync.TerminateChannel.load(std::memory_order_relaxed))
+    {
+        return;
+    }
+
+    AdvanceFreePosition();
+
+    if (Sync.FreePosition.load(std::memory_order_acquire) != freePosition)
+    {
+        return;
+    }
+
+    ChannelPolicy.WaitForFreeSpace(waitToken, timeoutInMicroseconds);
+}
+
+//----------------------------------------------------------------------------
+// NAME: SharedChannel<TChannelPolicy, TChannelSpinPolicy>::DiscardOldestFrame
+//
+// PURPOSE:
+//  Discards the oldest unread frame to make space for the new frames.
+//
+// RETURNS:
+//  Returns true if the writer discarded the frame.
+//
+// NOTES:
+//  Writer function.
+//  The writer acquires the frame located at the read position the same way as the reader,
+//  then it signals the frame for cleanup without dispatching it.
+//  If the frame is still being written or other reader acquired it first, the writer does not discard it.
+//  The writer discards the frame only if it is located at the free position.
+//  Otherwise the free region is blocked by a frame being processed by the reader,
+//  and discarding the unread frames would not release any space.
+//
+template <typename TChannelPolicy, typename TChannelSpinPolicy>
+bool SharedChannel<TChannelPolicy, TChannelSpinPolicy>::DiscardOldestFrame(uint32_t freePosition)
+{
+    const uint32_t readPosition = Sync.ReadPosition.load(std::memory_order_acquire);
 
-        // If the end of the requested frame is located in the buffer margin, extend the acquired region.
+    if (readPosition != freePosition)
+    {
+        // The frames located before the read position are being processed.
         //
-        int32_t frameLengthAdj = 0;
+        return false;
+    }
 
-        // NextWritePosition is at the frame end.
-        // NextWriteOffset (calculated from NextWritePosition) must be aligned to sizeof(uint32_t)
-        // therefore frame length must be also aligned.
+    if (readPosition == (Sync.WritePosition.load(std::memory_order_acquire) & ~1u))
+    {
+        // There is no published frame.
         //
-        uint32_t nextWritePosition = writePosition + frameLength;
+        return false;
+    }
 
-        // Ensure that after a full frame there is enough space for the next frame header.
-        // Otherwise, we will not be able to store next frame, because the frame header will not fit in the buffer.
-        //
-        uint32_t nextWriteOffset = nextWritePosition % Size;
-        if (nextWriteOffset >= Margin)
-        {
-            // Update frameLength, as we acquired more than requested.
-            //
-            frameLengthAdj = Size - nextWriteOffset;
+    FrameHeader& frame = Frame(readPosition % Size);
+    const int32_t frameLength = frame.Length.load(std::memory_order_acquire);
 
-            nextWritePosition += frameLengthAdj;
-        }
+    if (frameLength <= 0 || (frameLength & 1) == 1)
+    {
+        // There is no completed frame to discard.
+        //
+        return false;
+    }
 
-        uint32_t expectedWritePosition = writePosition;
-        if (!Sync.WritePosition.compare_exchange_weak(expectedWritePosition, nextWritePosition))
-        {
-            // Failed to advance write offset, other writer acquired this region.
-            //
-            continue;
-        }
+    uint32_t expectedReadPosition = readPosition;
+    if (!Sync.ReadPosition.compare_exchange_strong(expectedReadPosition, readPosition + frameLength))
+    {
+        // Other reader acquired the frame.
+        //
+        return false;
+    }
 
-        frameLength += frameLengthAdj;
+    const uint32_t codegenTypeIndex = frame.CodegenTypeIndex;
 
-        // The region should be empty except for free links.
-        // Frame links are always stored in offset aligned to sizeof int.
-        //
-        const uint32_t writeOffset = writePosition % Size;
-        return writeOffset;
+    if (codegenTypeIndex != 0)
+    {
+        ChannelPolicy.MessagesDropped(codegenTypeIndex, 1);
     }
+
+    SignalFrameForCleanup(frame, frameLength);
+
+    return true;
 }
 
 //----------------------------------------------------------------------------
-// NAME: SharedChannel<TChannelControlPolicy, TChannelSpinPolicy, TChannelWaitPolicy>::WaitForFrame
+// NAME: SharedChannel<TChannelPolicy, TChannelSpinPolicy>::WaitForFrames
 //
 // PURPOSE:
-//  Wait for the frame become available.
+//  Wait for the frames become available.
 //
 // RETURNS:
-//  Returns an offset to the frame buffer.
+//  Returns an offset to the first acquired frame and the number of acquired frames.
 //
 // NOTES:
 //  Reader function.
 //  If the wait has been aborted, it returns uint32_t::max.
+//  The reader acquires all the consecutive completed frames (up to maxFrameCount frames
+//  and maxBatchLength bytes) with a single update of the read position.
+//  If the first frame is still being written, the reader acquires only that frame.
+//  Zero maxBatchLength does not limit the total length of acquired frames.
+//  The spins and the waits are counted locally and added to the reader counters (if provided) before returning.
 //
 template <typename TChannelPolicy, typename TChannelSpinPolicy>
-uint32_t SharedChannel<TChannelPolicy, TChannelSpinPolicy>::WaitForFrame()
+uint32_t SharedChannel<TChannelPolicy, TChannelSpinPolicy>::WaitForFrames(
+    uint32_t maxFrameCount,
+    uint32_t maxBatchLength,
+    uint32_t& frameCount,
+    ChannelReaderStats* readerStats)
 {
     uint32_t readPosition;
     TChannelSpinPolicy channelSpinPolicy;
 
     bool shouldWait = false;
+    uint32_t waitToken = 0;
+
+    uint64_t spinCount = 0;
+    uint64_t waitCount = 0;
 
     while (true)
     {
@@ -290,31 +1365,77 @@ uint32_t SharedChannel<TChannelPolicy, TChannelSpinPolicy>::WaitForFrame()
         //
         readPosition = Sync.ReadPosition.load(std::memory_order_acquire);
 
+        // The frame lengths are valid only before the published write position, the memory after it is not cleared.
+        //
+        const uint32_t writePosition = Sync.WritePosition.load(std::memory_order_acquire) & ~1u;
+        const uint32_t writtenLength = writePosition - readPosition;
+
         const uint32_t readOffset = readPosition % Size;
         FrameHeader& frame = Frame(readOffset);
 
-        int32_t frameLength = frame.Length.load(std::memory_order_relaxed);
+        int32_t frameLength = (writtenLength != 0) ? frame.Length.load(std::memory_order_relaxed) : 0;
         if (frameLength > 0)
         {
             // Writer had updated the length.
             // Frame is ready and available for the reader.
             // Advance ReadIndex to end of the frame, and allow other reads to process next frame.
             //
-            uint32_t expectedReadPosition = readPosition;
             uint32_t nextReadPosition = (readPosition + (frameLength & (~1)));
 
-            if (!Sync.ReadPosition.compare_exchange_weak(expectedReadPosition, nextReadPosition))
+            frameCount = 1;
+
+            if ((frameLength & 1) == 0)
             {
-                // Other reader advanced ReadPosition therefore it will process the frame.
+                // The first frame is complete, extend the acquired region by the following completed frames.
+                // The reader stops at the write position.
                 //
-                channelSpinPolicy.FailedToAcquireReadRegion();
-                continue;
+                while (frameCount < maxFrameCount && nextReadPosition - readPosition < writtenLength)
+                {
+                    const int32_t nextFrameLength = Frame(nextReadPosition % Size).Length.load(std::memory_order_acquire);
+
+                    if (nextFrameLength <= 0 || (nextFrameLength & 1) == 1)
+                    {
+                        // The next frame is not ready.
+                        //
+                        break;
+                    }
+
+                    if (maxBatchLength != 0 && nextReadPosition + nextFrameLength - readPosition > maxBatchLength)
+                    {
+                        // Acquired frames would exceed the batch length.
+                        //
+                        break;
+                    }
+
+                    nextReadPosition += nextFrameLength;
+                    ++frameCount;
+                }
+            }
+
+            if constexpr (TChannelPolicy::IsSingleProducerSingleConsumer)
+            {
+                // There is no other reader, publish the read position for the whole batch with a single store.
+                //
+                Sync.ReadPosition.store(nextReadPosition, std::memory_order_release);
+            }
+            else
+            {
+                uint32_t expectedReadPosition = readPosition;
+                if (!Sync.ReadPosition.compare_exchange_weak(expectedReadPosition, nextReadPosition))
+                {
+                    // Other reader advanced ReadPosition therefore it will process the frame.
+                    //
+                    ++spinCount;
+                    channelSpinPolicy.FailedToAcquireReadRegion();
+                    continue;
+                }
             }
 
             // Current reader owns the frame. Wait untill the reader completes the write.
             //
             while ((frameLength & 1) == 1)
             {
+                ++spinCount;
                 channelSpinPolicy.WaitForFrameCompletion();
                 frameLength = frame.Length.load(std::memory_order_acquire);
             }
@@ -322,12 +1443,19 @@ uint32_t SharedChannel<TChannelPolicy, TChannelSpinPolicy>::WaitForFrame()
             break;
         }
 
+        ++spinCount;
         channelSpinPolicy.WaitForNewFrame();
 
         // No frame yet, spin if the channel is still active.
         //
         if (Sync.TerminateChannel.load(std::memory_order_relaxed))
         {
+            if (readerStats != nullptr)
+            {
+                readerStats->SpinCount += spinCount;
+                readerStats->WaitCount += waitCount;
+            }
+
             return std::numeric_limits<uint32_t>::max();
         }
 
@@ -335,7 +1463,8 @@ uint32_t SharedChannel<TChannelPolicy, TChannelSpinPolicy>::WaitForFrame()
         //
         if (shouldWait)
         {
-            ChannelPolicy.WaitForFrame();
+            ++waitCount;
+            ChannelPolicy.WaitForFrame(waitToken);
             Sync.ReaderInWaitingStateCount.fetch_sub((uint32_t)shouldWait);
             shouldWait = false;
         }
@@ -345,6 +1474,8 @@ uint32_t SharedChannel<TChannelPolicy, TChannelSpinPolicy>::WaitForFrame()
             //
             shouldWait = true;
             Sync.ReaderInWaitingStateCount.fetch_add((uint32_t)shouldWait);
+
+            waitToken = ChannelPolicy.PrepareWaitForFrame();
         }
 
         // If (frameLength < 0) There is active cleaning up on this frame by the writer.
@@ -360,41 +1491,46 @@ uint32_t SharedChannel<TChannelPolicy, TChannelSpinPolicy>::WaitForFrame()
     //
     Sync.ReaderInWaitingStateCount.fetch_sub((uint32_t)shouldWait);
 
+    if (readerStats != nullptr)
+    {
+        readerStats->SpinCount += spinCount;
+        readerStats->WaitCount += waitCount;
+    }
+
     return readOffset;
 }
 
 //----------------------------------------------------------------------------
-// NAME: SharedChannel<TChannelPolicy>::WaitAndDispatchFrame
+// NAME: SharedChannel<TChannelPolicy, TChannelSpinPolicy>::DispatchFrame
 //
 // PURPOSE:
-//  Waits for a new frame then call proper dispatcher.
+//  Verifies the acquired frame and calls proper dispatcher.
 //
 // RETURNS:
-//  Returns true if reader successfully processed the frame.
-//  If the wait has been aborted, it returns false.
+//  Returns the length of the frame.
 //
 // NOTES:
-//  To interrupt wait, set Sync.TerminateReader to true.
+//  Reader function.
+//  The frame is not released, the caller signals the frame for cleanup.
+//  If the latency histograms are set, records the queueing delay (when the frames have timestamps)
+//  and the duration of the callback.
+//  The compact frame headers have no type hash, the types are verified when the settings assemblies are registered,
+//  the registration fails without the dispatch table hash (see MlosContext::RegisterSettingsAssembly).
+//  If the worker pool is provided, the payload is copied to the worker queue and the worker calls the dispatcher
+//  and records the duration of the callback.
 //
 template <typename TChannelPolicy, typename TChannelSpinPolicy>
-bool SharedChannel<TChannelPolicy, TChannelSpinPolicy>::WaitAndDispatchFrame(
+int32_t SharedChannel<TChannelPolicy, TChannelSpinPolicy>::DispatchFrame(
+    uint32_t readOffset,
     DispatchEntry* dispatchTable,
-    size_t dispatchEntryCount)
+    size_t dispatchEntryCount,
+    ChannelReaderStats* readerStats,
+    DispatchWorkerPool* workerPool)
 {
-    const uint32_t readOffset = WaitForFrame();
-
-    if (readOffset == std::numeric_limits<uint32_t>::max())
-    {
-        // Invalid offset, the wait was interrupted.
-        //
-        return false;
-    }
-
     // Verify frame and call dispatcher.
     //
     FrameHeader& frame = Frame(readOffset);
     uint32_t codegenTypeIndex = frame.CodegenTypeIndex;
-    uint64_t codegenTypeHash = frame.CodegenTypeHash;
 
     int32_t frameLength = frame.Length.load(std::memory_order_acquire);
 
@@ -402,15 +1538,62 @@ bool SharedChannel<TChannelPolicy, TChannelSpinPolicy>::WaitAndDispatchFrame(
     //
     if (codegenTypeIndex != 0 && codegenTypeIndex <= dispatchEntryCount)
     {
-        uint64_t expectedCodegenTypeHash = dispatchTable[codegenTypeIndex - 1].CodegenTypeHash;
-
-        bool isMessageValid = (static_cast<uint32_t>(frameLength) < Size) && (expectedCodegenTypeHash == codegenTypeHash);
+        bool isMessageValid = (static_cast<uint32_t>(frameLength) < Size) &&
+            (HasCompactFrameHeaders || dispatchTable[codegenTypeIndex - 1].CodegenTypeHash == frame.CodegenTypeHash);
 
         if (isMessageValid)
         {
+            // Latencies are recorded only for the types with the histograms.
+            //
+            Internal::ChannelLatencyStats* latencyStats =
+                (LatencyStats != nullptr && codegenTypeIndex < LatencyStats->LatencyStatsByType.size())
+                    ? &LatencyStats->LatencyStatsByType[codegenTypeIndex]
+                    : nullptr;
+
+            const uint64_t dispatchTimestamp = (latencyStats != nullptr) ? MlosPlatform::TimestampInNanoseconds() : 0;
+
+            if (latencyStats != nullptr &&
+                HasFrameTimestamps &&
+                static_cast<uint32_t>(frameLength) >= FrameHeaderLength + sizeof(uint64_t))
+            {
+                uint64_t sendTimestamp;
+                memcpy(&sendTimestamp, Buffer.Pointer + readOffset + frameLength - sizeof(uint64_t), sizeof(uint64_t));
+
+                // Do not record a negative delay if the timestamp is not valid.
+                //
+                const uint64_t queueingDelay = (dispatchTimestamp > sendTimestamp) ? dispatchTimestamp - sendTimestamp : 0;
+                Internal::RecordChannelLatency(latencyStats->QueueingDelay, queueingDelay);
+            }
+
             // Call dispatcher only if type hash is correct.
+            // The callbacks verify the payload against the length of the frame with the full header.
             //
-            isMessageValid = dispatchTable[codegenTypeIndex - 1].Callback(std::move(Payload(readOffset)), frameLength);
+            const int32_t dispatchFrameLength = frameLength + static_cast<int32_t>(sizeof(FrameHeader) - FrameHeaderLength);
+
+            if (workerPool != nullptr &&
+                workerPool->Enqueue(
+                    *this,
+                    codegenTypeIndex,
+                    dispatchTable[codegenTypeIndex - 1],
+                    Payload(readOffset),
+                    frameLength - FrameHeaderLength,
+                    dispatchFrameLength,
+                    latencyStats,
+                    readerStats))
+            {
+                // The worker dispatches the message.
+                //
+                return frameLength;
+            }
+
+            isMessageValid = dispatchTable[codegenTypeIndex - 1].Callback(std::move(Payload(readOffset)), dispatchFrameLength);
+
+            if (latencyStats != nullptr)
+            {
+                Internal::RecordChannelLatency(
+                    latencyStats->HandlerDuration,
+                    MlosPlatform::TimestampInNanoseconds() - dispatchTimestamp);
+            }
         }
 
         if (!isMessageValid)
@@ -419,33 +1602,119 @@ bool SharedChannel<TChannelPolicy, TChannelSpinPolicy>::WaitAndDispatchFrame(
             //
             ChannelPolicy.ReceivedInvalidFrame();
         }
+    }
+    else if (codegenTypeIndex != 0)
+    {
+        // Received invalid frame, channel policy decides what how to handle it.
+        //
+        ChannelPolicy.ReceivedInvalidFrame();
+    }
+
+    // Reader does not clear the frame.
+    // The processed frames are reclaimed without clearing the memory, the stale content is never read.
+    // The readers do not read past the published write position, and the writer stores the lengths (with the incomplete bit)
+    // of all the frames in the region before it publishes the region.
+    //
+    return frameLength;
+}
+
+//----------------------------------------------------------------------------
+// NAME: SharedChannel<TChannelPolicy>::WaitAndDispatchFrame
+//
+// PURPOSE:
+//  Waits for a new frame then call proper dispatcher.
+//
+// RETURNS:
+//  Returns true if reader successfully processed the frame.
+//  If the wait has been aborted, it returns false.
+//
+// NOTES:
+//  To interrupt wait, set Sync.TerminateReader to true.
+//  If the reader counters are provided, they must be owned by the calling thread.
+//
+template <typename TChannelPolicy, typename TChannelSpinPolicy>
+bool SharedChannel<TChannelPolicy, TChannelSpinPolicy>::WaitAndDispatchFrame(
+    DispatchEntry* dispatchTable,
+    size_t dispatchEntryCount,
+    ChannelReaderStats* readerStats)
+{
+    return WaitAndDispatchFrames(dispatchTable, dispatchEntryCount, 1, 0, readerStats);
+}
+
+//----------------------------------------------------------------------------
+// NAME: SharedChannel<TChannelPolicy>::WaitAndDispatchFrames
+//
+// PURPOSE:
+//  Waits for new frames then call proper dispatchers.
+//
+// RETURNS:
+//  Returns true if reader successfully processed the frames.
+//  If the wait has been aborted, it returns false.
+//
+// NOTES:
+//  To interrupt wait, set Sync.TerminateReader to true.
+//  Frames are dispatched in order, then all of them are signaled for cleanup.
+//  If the reader counters are provided, they must be owned by the calling thread.
+//
+template <typename TChannelPolicy, typename TChannelSpinPolicy>
+bool SharedChannel<TChannelPolicy, TChannelSpinPolicy>::WaitAndDispatchFrames(
+    DispatchEntry* dispatchTable,
+    size_t dispatchEntryCount,
+    uint32_t maxFrameCount,
+    uint32_t maxBatchLength,
+    ChannelReaderStats* readerStats,
+    DispatchWorkerPool* workerPool)
+{
+    uint32_t frameCount = 0;
+    const uint32_t readOffset = WaitForFrames(maxFrameCount, maxBatchLength, frameCount, readerStats);
 
-        // Cleanup. Writer requires clean memory buffer (frameLength != 0).
-        // Clear the whole frame except the length.
+    if (readOffset == std::numeric_limits<uint32_t>::max())
+    {
+        // Invalid offset, the wait was interrupted.
         //
-        ClearPayload(readOffset, frameLength);
+        return false;
     }
-    else
+
+    // Dispatch acquired frames.
+    //
+    uint32_t frameOffset = readOffset;
+
+    for (uint32_t frameIndex = 0; frameIndex < frameCount; ++frameIndex)
     {
-        if (codegenTypeIndex == 0)
-        {
-            // Just a link frame, clear the circular region.
-            //
-            ClearLinkPayload(readOffset, frameLength, Size);
-        }
-        else
-        {
-            // Received invalid frame, channel policy decides what how to handle it.
-            //
-            ChannelPolicy.ReceivedInvalidFrame();
+        const int32_t frameLength = DispatchFrame(frameOffset, dispatchTable, dispatchEntryCount, readerStats, workerPool);
 
-            ClearPayload(readOffset, frameLength);
-        }
+        frameOffset = (frameOffset + frameLength) % Size;
     }
 
-    // Mark frame that processing is completed (negative length).
+    // Mark frames that processing is completed (negative length).
     //
-    SignalFrameForCleanup(frame, frameLength);
+    frameOffset = readOffset;
+
+    uint32_t batchLength = 0;
+
+    for (uint32_t frameIndex = 0; frameIndex < frameCount; ++frameIndex)
+    {
+        FrameHeader& frame = Frame(frameOffset);
+        const int32_t frameLength = frame.Length.load(std::memory_order_relaxed);
+
+        SignalFrameForCleanup(frame, frameLength);
+
+        frameOffset = (frameOffset + frameLength) % Size;
+        batchLength += frameLength;
+    }
+
+    if (readerStats != nullptr)
+    {
+        readerStats->MessagesRead += frameCount;
+        readerStats->BytesRead += batchLength;
+    }
+
+    // Notify the writers waiting for the free space.
+    //
+    if constexpr (TChannelPolicy::HasFreeSpaceNotification)
+    {
+        ChannelPolicy.NotifyExternalWriter();
+    }
 
     return true;
 }
@@ -467,15 +1736,124 @@ void SharedChannel<TChannelPolicy, TChannelSpinPolicy>::ProcessMessages(
 {
     Sync.ActiveReaderCount.fetch_add(1);
 
+    ChannelReaderStats* readerStats = AcquireReaderStats();
+
+    // Receiver thread.
+    //
+    bool result = true;
+    while (result)
+    {
+        result = WaitAndDispatchFrame(dispatchTable, dispatchEntryCount, readerStats);
+    }
+
+    ReleaseReaderStats(readerStats);
+
+    Sync.ActiveReaderCount.fetch_sub(1);
+
+    // The channel has been terminated, wake up the writers waiting for the free space.
+    //
+    if constexpr (TChannelPolicy::HasFreeSpaceNotification)
+    {
+        ChannelPolicy.NotifyExternalWriter();
+    }
+}
+
+//----------------------------------------------------------------------------
+// NAME: SharedChannel<TChannelPolicy, TChannelSpinPolicy>::ProcessMessages
+//
+// PURPOSE:
+//  Reader loop, process received messages.
+//
+// RETURNS:
+//
+// NOTES:
+//  The number of frames the reader acquires at once is limited by
+//  ChannelSettings.ReaderBatchFrameCount and ChannelSettings.ReaderBatchLength.
+//
+template <typename TChannelPolicy, typename TChannelSpinPolicy>
+void SharedChannel<TChannelPolicy, TChannelSpinPolicy>::ProcessMessages(
+    Mlos::Core::DispatchEntry* dispatchTable,
+    size_t dispatchEntryCount,
+    const ChannelSettings& channelSettings)
+{
+    // Reader always acquires at least one frame.
+    //
+    const uint32_t maxFrameCount = channelSettings.ReaderBatchFrameCount > 1 ? channelSettings.ReaderBatchFrameCount : 1;
+    const uint32_t maxBatchLength = channelSettings.ReaderBatchLength > 0 ? channelSettings.ReaderBatchLength : 0;
+
+    Sync.ActiveReaderCount.fetch_add(1);
+
+    ChannelReaderStats* readerStats = AcquireReaderStats();
+
+    // Receiver thread.
+    //
+    bool result = true;
+    while (result)
+    {
+        result = WaitAndDispatchFrames(dispatchTable, dispatchEntryCount, maxFrameCount, maxBatchLength, readerStats);
+    }
+
+    ReleaseReaderStats(readerStats);
+
+    Sync.ActiveReaderCount.fetch_sub(1);
+
+    // The channel has been terminated, wake up the writers waiting for the free space.
+    //
+    if constexpr (TChannelPolicy::HasFreeSpaceNotification)
+    {
+        ChannelPolicy.NotifyExternalWriter();
+    }
+}
+
+//----------------------------------------------------------------------------
+// NAME: SharedChannel<TChannelPolicy, TChannelSpinPolicy>::ProcessMessages
+//
+// PURPOSE:
+//  Reader loop, the received messages are dispatched by the worker pool.
+//
+// RETURNS:
+//
+// NOTES:
+//  The reader releases the frames as soon as they are copied to the worker queues,
+//  a slow callback stalls the writers only after its worker queue is full.
+//  The number of frames the reader acquires at once is limited by
+//  ChannelSettings.ReaderBatchFrameCount and ChannelSettings.ReaderBatchLength.
+//  The application runs DispatchWorkerPool::ProcessWorkItems on the worker threads.
+//
+template <typename TChannelPolicy, typename TChannelSpinPolicy>
+void SharedChannel<TChannelPolicy, TChannelSpinPolicy>::ProcessMessages(
+    Mlos::Core::DispatchEntry* dispatchTable,
+    size_t dispatchEntryCount,
+    const ChannelSettings& channelSettings,
+    DispatchWorkerPool& workerPool)
+{
+    // Reader always acquires at least one frame.
+    //
+    const uint32_t maxFrameCount = channelSettings.ReaderBatchFrameCount > 1 ? channelSettings.ReaderBatchFrameCount : 1;
+    const uint32_t maxBatchLength = channelSettings.ReaderBatchLength > 0 ? channelSettings.ReaderBatchLength : 0;
+
+    Sync.ActiveReaderCount.fetch_add(1);
+
+    ChannelReaderStats* readerStats = AcquireReaderStats();
+
     // Receiver thread.
     //
     bool result = true;
     while (result)
     {
-        result = WaitAndDispatchFrame(dispatchTable, dispatchEntryCount);
+        result = WaitAndDispatchFrames(dispatchTable, dispatchEntryCount, maxFrameCount, maxBatchLength, readerStats, &workerPool);
     }
 
+    ReleaseReaderStats(readerStats);
+
     Sync.ActiveReaderCount.fetch_sub(1);
+
+    // The channel has been terminated, wake up the writers waiting for the free space.
+    //
+    if constexpr (TChannelPolicy::HasFreeSpaceNotification)
+    {
+        ChannelPolicy.NotifyExternalWriter();
+    }
 }
 
 }
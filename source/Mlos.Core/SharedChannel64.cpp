@@ -0,0 +1,165 @@
+//*********************************************************************
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License. See License.txt in the project root
+// for license information.
+//
+// @File: SharedChannel64.cpp
+//
+// Purpose:
+//  Exchange protocol based on circular buffer, 64-bit positions.
+//
+//
+// Notes:
+//  More details in: Doc/CircularBuffer.md.
+//
+//*********************************************************************
+
+#include "Mlos.Core.h"
+
+namespace Mlos
+{
+namespace Core
+{
+//----------------------------------------------------------------------------
+// NAME: ISharedChannel64::InitializeChannel
+//
+// PURPOSE:
+//  The method handles the failures when one of the processes has terminated unexpectedly.
+//
+// RETURNS:
+//  Nothing.
+//
+// NOTES:
+//  Same recovery as ISharedChannel::InitializeChannel.
+//
+void ISharedChannel64::InitializeChannel()
+{
+    Sync.TerminateChannel.store(false);
+
+    // Recover from the previous failures.
+    //
+
+    // Drop the region acquired by the writer that failed before it published the region.
+    //
+    uint64_t writePosition = Sync.WritePosition.load(std::memory_order_relaxed);
+
+    if ((writePosition & 1) == 1)
+    {
+        writePosition &= ~static_cast<uint64_t>(1);
+        Sync.WritePosition.store(writePosition, std::memory_order_release);
+    }
+
+    // Advance the free region. Follow the free links up to the current read position.
+    //
+    AdvanceFreePosition();
+
+    // We reached first unprocessed frame. Follow the frames until we reach writePosition.
+    // Convert the partially written frames and processed frames into link frames, so the reader can ignore them.
+    //
+    uint64_t freePosition = Sync.FreePosition.load(std::memory_order_acquire);
+
+    while (freePosition != writePosition)
+    {
+        // Check the current state of the frame by inspecting it's length.
+        //
+        FrameHeader64& frame = Frame(Offset(freePosition));
+
+        int64_t frameLength = frame.Length.load(std::memory_order_acquire);
+
+        if (frameLength < 0 || (frameLength & 1) == 1)
+        {
+            // The frame has been processed or the frame has been partially written.
+            //
+            frameLength = frameLength > 0 ? frameLength : -frameLength;
+            frameLength &= ~1;
+
+            // The frame is partially written. Ignore it.
+            //
+            frame.CodegenTypeIndex = 0;
+
+            frame.Length.store(frameLength, std::memory_order_release);
+        }
+
+        // Move to next frame.
+        //
+        freePosition += frameLength;
+    }
+
+    // Set readPosition to freePostion to reprocess the frames.
+    //
+    freePosition = Sync.FreePosition.load(std::memory_order_acquire);
+    uint64_t readPosition = Sync.ReadPosition.load(std::memory_order_acquire);
+    Sync.ReadPosition.compare_exchange_strong(readPosition, freePosition);
+}
+
+//----------------------------------------------------------------------------
+// NAME: ISharedChannel64::AdvanceFreePosition
+//
+// PURPOSE:
+//  Follows the free links until we reach the read position.
+//
+// RETURNS: None.
+//
+// NOTES:
+//  Same reclaim protocol as ISharedChannel::AdvanceFreePosition.
+//  The reclaimed memory is not cleared, so a region longer than 2 GiB is reclaimed in constant time per frame.
+//
+void ISharedChannel64::AdvanceFreePosition()
+{
+    // Move free position and allow the writer to advance.
+    //
+    const uint64_t freePosition = Sync.FreePosition.load(std::memory_order_acquire);
+    const uint64_t readPosition = Sync.ReadPosition.load(std::memory_order_relaxed);
+
+    if (freePosition == readPosition)
+    {
+        // Free position points to the current read position.
+        //
+        return;
+    }
+
+    // Load a frame from the beginning of the free region.
+    //
+    const int64_t frameLength = Frame(Offset(freePosition)).Length.load(std::memory_order_acquire);
+
+    if (frameLength >= 0 || (frameLength & 1) == 1)
+    {
+        // Frame is currently processed.
+        //
+        return;
+    }
+
+    // Follow the free links up to the current read position.
+    // By the time this cleanup is completed, the reader threads might process more frames and advance the read position.
+    //
+    const uint64_t readLength = readPosition - freePosition;
+    uint64_t nextFreePosition = freePosition - frameLength;
+
+    while (nextFreePosition - freePosition < readLength)
+    {
+        const int64_t nextFrameLength = Frame(Offset(nextFreePosition)).Length.load(std::memory_order_acquire);
+
+        if (nextFrameLength >= 0 || (nextFrameLength & 1) == 1)
+        {
+            // Frame is currently processed.
+            //
+            break;
+        }
+
+        nextFreePosition -= nextFrameLength;
+    }
+
+    if (nextFreePosition - freePosition > readLength)
+    {
+        // The local free position is stale, the frames have been overwritten.
+        //
+        return;
+    }
+
+    // Advance free position, unless other writer thread has already advanced it.
+    //
+    uint64_t expectedFreePosition = freePosition;
+    Sync.FreePosition.compare_exchange_strong(expectedFreePosition, nextFreePosition);
+}
+}
+}
@@ -0,0 +1,220 @@
+//*********************************************************************
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License. See License.txt in the project root
+// for license information.
+//
+// @File: SharedChannel64.h
+//
+// Purpose:
+//      <description>
+//
+// Notes:
+//      <special-instructions>
+//
+//*********************************************************************
+
+#pragma once
+
+#include "BytePtr.h"
+
+namespace Mlos
+{
+namespace Core
+{
+inline void SignalFrameIsReady(FrameHeader64& frame, int64_t frameLength);
+inline void SignalFrameForCleanup(FrameHeader64& frame, int64_t frameLength);
+
+//----------------------------------------------------------------------------
+// NAME: ISharedChannel64
+//
+// PURPOSE:
+//  Defines SharedChannel64 interface.
+//  Shared channel with 64-bit positions, it supports the buffers larger than 2 GiB.
+//
+// NOTES:
+//  The exchange protocol is the same as in ISharedChannel, only the positions and the frame lengths are 64-bit.
+//  The positions never overflow, the offset in the buffer is calculated by masking the position.
+//  Frames are aligned to sizeof(int64_t).
+//
+class ISharedChannel64
+{
+public:
+    ISharedChannel64(Mlos::Core::ChannelSynchronization64& sync, Mlos::Core::BytePtr buffer, uint64_t size)
+      : Sync(sync),
+        Buffer(buffer),
+        Size(static_cast<uint64_t>(1) << most_significant_bit(size)),
+        Mask(Size - 1),
+        Margin(Size - sizeof(FrameHeader64))
+    {
+        // Check if user passed optimal buffer size value.
+        //
+        assert(size == Size);
+
+        // Initialize channel.
+        //
+        InitializeChannel();
+    }
+
+    virtual uint64_t AcquireWriteRegionForFrame(int64_t& frameLength, uint32_t timeoutInMicroseconds) = 0;
+
+    virtual void ProcessMessages(DispatchEntry* dispatchTable, size_t dispatchEntryCount) = 0;
+
+    virtual void NotifyExternalReader() = 0;
+
+    // Returns true if there are reader threads waiting for external process.
+    //
+    inline bool HasReadersInWaitingState() const;
+
+    // Returns true if the channel can use a buffer of the given size.
+    // The size must be a power of two, so the offset is calculated with a mask.
+    //
+    static constexpr bool IsValidBufferSize(uint64_t size)
+    {
+        return size > sizeof(FrameHeader64) && (size & (size - 1)) == 0;
+    }
+
+    // Send the message object.
+    //
+    template<typename TMessage>
+    inline void SendMessage(const TMessage& object);
+
+    // Send the message object, if there is not enough free space wait at most the given timeout.
+    //
+    template<typename TMessage>
+    inline HRESULT TrySendMessage(const TMessage& object, uint32_t timeoutInMicroseconds);
+
+    // Follows free links until we reach read position and reclaims the processed frames.
+    //
+    void AdvanceFreePosition();
+
+    // Initializes the channel.
+    //
+    void InitializeChannel();
+
+protected:
+    inline uint64_t Offset(uint64_t position) const
+    {
+        return position & Mask;
+    }
+
+    inline FrameHeader64& Frame(uint64_t offset);
+
+    inline BytePtr Payload(uint64_t writeOffset);
+
+    template<typename TMessage>
+    inline int64_t CalculateFrameLength(const TMessage& msg) const;
+
+    template<typename TMessage>
+    inline void WriteFrame(uint64_t writeOffset, int64_t frameLength, const TMessage& msg);
+
+    // Publishes the acquired region, the frame length must be already stored.
+    //
+    inline void PublishWriteRegion(int64_t regionLength);
+
+public:
+    // Timeout value for the writer to wait until the readers release the frames.
+    //
+    static constexpr uint32_t InfiniteTimeout = std::numeric_limits<uint32_t>::max();
+
+    // Offset returned when the channel has been terminated or the timeout expired.
+    //
+    static constexpr uint64_t InvalidOffset = std::numeric_limits<uint64_t>::max();
+
+    ChannelSynchronization64& Sync;
+
+    BytePtr Buffer;
+
+    // Size of the buffer.
+    //
+    uint64_t Size;
+
+    // Size of the buffer - 1, the offset in the buffer is (position & Mask).
+    //
+    uint64_t Mask;
+
+    // Size of the buffer - sizeof(FrameHeader64);
+    //
+    uint64_t Margin;
+};
+
+//----------------------------------------------------------------------------
+// NAME: SharedChannel64<TChannelPolicy, TChannelSpinPolicy>
+//
+// PURPOSE:
+//  Shared channel implementation with 64-bit positions.
+//
+// NOTES:
+//  The channel policy provides the notifications only, the writers always wait for the free space.
+//  The channel does not update the reader and writer counters, nor records the latencies.
+//
+template<typename TChannelPolicy, typename TChannelSpinPolicy>
+class SharedChannel64 : public ISharedChannel64
+{
+public:
+    SharedChannel64(
+        Mlos::Core::ChannelSynchronization64& sync,
+        Mlos::Core::BytePtr buffer,
+        uint64_t size,
+        TChannelPolicy channelPolicy = TChannelPolicy()) noexcept
+      : ISharedChannel64(sync, buffer, size),
+        ChannelPolicy(std::move(channelPolicy))
+    {
+    }
+
+    SharedChannel64(
+        Mlos::Core::ChannelSynchronization64& sync,
+        Mlos::Core::SharedMemoryMapView& channelMemoryMapView,
+        TChannelPolicy channelPolicy = TChannelPolicy()) noexcept
+      : SharedChannel64(
+            sync,
+            channelMemoryMapView.Buffer,
+            static_cast<uint64_t>(channelMemoryMapView.MemSize),
+            std::move(channelPolicy))
+    {
+    }
+
+public:
+    void ProcessMessages(DispatchEntry* dispatchTable, size_t dispatchEntryCount) override;
+
+    bool WaitAndDispatchFrame(DispatchEntry* dispatchTable, size_t dispatchEntryCount);
+
+public:
+    TChannelPolicy ChannelPolicy;
+
+private:
+    virtual uint64_t AcquireWriteRegionForFrame(int64_t& frameLength, uint32_t timeoutInMicroseconds) override;
+
+    virtual void NotifyExternalReader() override;
+
+    uint64_t AcquireRegionForWrite(int64_t& frameLength, uint32_t timeoutInMicroseconds);
+
+    void WaitForFreeSpace(uint64_t freePosition, uint32_t timeoutInMicroseconds);
+
+    uint64_t WaitForFrame();
+
+    int64_t DispatchFrame(uint64_t readOffset, DispatchEntry* dispatchTable, size_t dispatchEntryCount);
+};
+
+//----------------------------------------------------------------------------
+// NAME: TestSharedChannel64
+//
+// PURPOSE:
+//  Test shared channel with 64-bit positions. Shared channel with default policies.
+//
+// NOTES:
+//  Suitable for testing purposes only.
+//
+using TestSharedChannel64 = Mlos::Core::SharedChannel64<InternalSharedChannelPolicy, SharedChannelSpinPolicy>;
+
+//----------------------------------------------------------------------------
+// NAME: InterProcessSharedChannel64
+//
+// PURPOSE:
+//  Inter-process shared channel with 64-bit positions.
+//
+// NOTES:
+//  Suitable for the bulk telemetry capture with the buffers larger than 2 GiB.
+//
+using InterProcessSharedChannel64 = Mlos::Core::SharedChannel64<InterProcessSharedChannelPolicy, SharedChannelSpinPolicy>;
+}
+}
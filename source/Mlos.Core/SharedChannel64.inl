@@ -0,0 +1,744 @@
+//*********************************************************************
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License. See License.txt in the project root
+// for license information.
+//
+// @File: SharedChannel64.inl
+//
+// Purpose:
+//      <description>
+//
+// Notes:
+//      <special-instructions>
+//
+//*********************************************************************
+
+#pragma once
+
+namespace Mlos
+{
+namespace Core
+{
+//----------------------------------------------------------------------------
+// NAME: SignalFrameIsReady
+//
+// PURPOSE:
+//  Signals readers that the frame is available to process.
+//
+// RETURNS:
+//
+// NOTES:
+//
+inline void SignalFrameIsReady(FrameHeader64& frame, int64_t frameLength)
+{
+    frame.Length.store(frameLength, std::memory_order_release);
+}
+
+//----------------------------------------------------------------------------
+// NAME: SignalFrameForCleanup
+//
+// PURPOSE:
+//  Notify the cleanup thread, that the frame has been processed.
+//
+// RETURNS:
+//  Nothing.
+//
+// NOTES:
+//  Reader function.
+//
+inline void SignalFrameForCleanup(FrameHeader64& frame, int64_t frameLength)
+{
+    frame.Length.store(-frameLength, std::memory_order_release);
+}
+
+//----------------------------------------------------------------------------
+// NAME: ISharedChannel64::HasReadersInWaitingState
+//
+// RETURNS:
+//  Returns true if channel has readers in waiting state.
+//
+bool ISharedChannel64::HasReadersInWaitingState() const
+{
+    return Sync.ReaderInWaitingStateCount.load(std::memory_order_acquire);
+}
+
+//----------------------------------------------------------------------------
+// NAME: ISharedChannel64::SendMessage
+//
+// PURPOSE:
+//  Sends the message object.
+//
+// NOTES:
+//
+template<typename TMessage>
+void ISharedChannel64::SendMessage(const TMessage& msg)
+{
+    // Calculate frame size.
+    //
+    int64_t frameLength = CalculateFrameLength(msg);
+
+    // Acquire a write region to write the frame.
+    //
+    uint64_t writeOffset = AcquireWriteRegionForFrame(frameLength, InfiniteTimeout);
+
+    if (writeOffset == InvalidOffset)
+    {
+        // The write has been terminated, ignore the send.
+        //
+        return;
+    }
+
+    WriteFrame(writeOffset, frameLength, msg);
+
+    // If there are readers in the waiting state, we need to notify them.
+    //
+    if (HasReadersInWaitingState())
+    {
+        NotifyExternalReader();
+    }
+}
+
+//----------------------------------------------------------------------------
+// NAME: ISharedChannel64::TrySendMessage
+//
+// PURPOSE:
+//  Sends the message object, if there is not enough free space waits at most the given timeout.
+//
+// RETURNS:
+//  S_OK if the message has been sent.
+//  E_TIMEOUT if the readers have not released enough space before the timeout expired.
+//  E_ABORT if the channel has been terminated.
+//
+// NOTES:
+//  Zero timeout does not wait, the message is sent only if there is free space in the buffer.
+//
+template<typename TMessage>
+HRESULT ISharedChannel64::TrySendMessage(const TMessage& msg, uint32_t timeoutInMicroseconds)
+{
+    // Calculate frame size.
+    //
+    int64_t frameLength = CalculateFrameLength(msg);
+
+    // Acquire a write region to write the frame.
+    //
+    uint64_t writeOffset = AcquireWriteRegionForFrame(frameLength, timeoutInMicroseconds);
+
+    if (writeOffset == InvalidOffset)
+    {
+        // The write has been terminated or the timeout expired.
+        //
+        return Sync.TerminateChannel.load(std::memory_order_relaxed) ? E_ABORT : E_TIMEOUT;
+    }
+
+    WriteFrame(writeOffset, frameLength, msg);
+
+    // If there are readers in the waiting state, we need to notify them.
+    //
+    if (HasReadersInWaitingState())
+    {
+        NotifyExternalReader();
+    }
+
+    return S_OK;
+}
+
+//----------------------------------------------------------------------------
+// NAME: ISharedChannel64::CalculateFrameLength
+//
+// RETURNS:
+//  Returns the length of the frame required to store the message, aligned to sizeof(int64_t).
+//
+// NOTES:
+//  The frame length is aligned, so the Length field of the next frame is aligned for the 64-bit atomic operations.
+//
+template<typename TMessage>
+int64_t ISharedChannel64::CalculateFrameLength(const TMessage& msg) const
+{
+    const size_t frameLength = sizeof(FrameHeader64) + ObjectSerialization::GetSerializedSize(msg);
+
+    return static_cast<int64_t>(align<sizeof(int64_t)>(frameLength));
+}
+
+//----------------------------------------------------------------------------
+// NAME: ISharedChannel64::WriteFrame
+//
+// PURPOSE:
+//  Writes the message to the frame located at the given offset and signals the frame is ready.
+//
+// NOTES:
+//  The region for the frame must be already acquired and published by the writer,
+//  the frame length with incomplete bit has been stored before the region was published.
+//
+template<typename TMessage>
+void ISharedChannel64::WriteFrame(uint64_t writeOffset, int64_t frameLength, const TMessage& msg)
+{
+    FrameHeader64& frame = Frame(writeOffset);
+
+    // Store type index and hash.
+    //
+    frame.CodegenTypeIndex = TypeMetadataInfo::CodegenTypeIndex<TMessage>();
+    frame.CodegenTypeHash = TypeMetadataInfo::CodegenTypeHash<TMessage>();
+
+    // Copy the structure to the buffer.
+    //
+    BytePtr payload = Payload(writeOffset);
+    ObjectSerialization::Serialize(payload, msg);
+
+    // Frame is ready for the reader.
+    //
+    SignalFrameIsReady(frame, frameLength);
+}
+
+FrameHeader64& ISharedChannel64::Frame(uint64_t offset)
+{
+    return *reinterpret_cast<FrameHeader64*>(Buffer.Pointer + offset);
+}
+
+BytePtr ISharedChannel64::Payload(uint64_t writeOffset)
+{
+    return BytePtr(Buffer.Pointer + writeOffset + sizeof(FrameHeader64));
+}
+
+//----------------------------------------------------------------------------
+// NAME: ISharedChannel64::PublishWriteRegion
+//
+// PURPOSE:
+//  Publishes the region acquired by AcquireRegionForWrite to the readers.
+//
+// RETURNS:
+//  Nothing.
+//
+// NOTES:
+//  Same as the 32-bit channel, the readers never read the frame lengths located at or after the write position.
+//
+void ISharedChannel64::PublishWriteRegion(int64_t regionLength)
+{
+    const uint64_t writePosition = Sync.WritePosition.load(std::memory_order_relaxed) & ~static_cast<uint64_t>(1);
+
+    Sync.WritePosition.store(writePosition + regionLength, std::memory_order_release);
+}
+
+//----------------------------------------------------------------------------
+// NAME: SharedChannel64<TChannelPolicy, TChannelSpinPolicy>::AcquireWriteRegionForFrame
+//
+// PURPOSE:
+//  Acquire a region to write the frame.
+//
+// RETURNS:
+//  Returns an offset to acquired memory region that can hold a full frame.
+//  If the channel has been terminated or the timeout expired, returns InvalidOffset.
+//
+// NOTES:
+//  The acquired region is contiguous.
+//  The frame length is stored with incomplete bit and the region is published before the function returns.
+//
+template <typename TChannelPolicy, typename TChannelSpinPolicy>
+uint64_t SharedChannel64<TChannelPolicy, TChannelSpinPolicy>::AcquireWriteRegionForFrame(
+    int64_t& frameLength,
+    uint32_t timeoutInMicroseconds)
+{
+    const int64_t expectedFrameLength = frameLength;
+
+    assert(static_cast<uint64_t>(expectedFrameLength) < Size);
+
+    // Acquire writing region in the buffer.
+    //
+    while (true)
+    {
+        frameLength = expectedFrameLength;
+
+        // Acquire region for writes. Function might adjust frame length.
+        //
+        const uint64_t writeOffset = AcquireRegionForWrite(frameLength, timeoutInMicroseconds);
+
+        if (writeOffset == InvalidOffset)
+        {
+            // The reader has terminated or the timeout expired, abandon the write.
+            //
+            return writeOffset;
+        }
+
+        // We might acquired a circular region,
+        // check if we can store a full frame without overlapping the buffer.
+        //
+        if (writeOffset + frameLength > Size)
+        {
+            // There is not enough space in the buffer to write the full frame.
+            // Create an empty frame to adjust the write offset to the beginning of the buffer.
+            // Retry the whole operation until we write a full frame.
+            //
+            FrameHeader64& frame = Frame(writeOffset);
+            frame.CodegenTypeIndex = 0;
+            frame.Length.store(frameLength, std::memory_order_relaxed);
+            PublishWriteRegion(frameLength);
+            continue;
+        }
+
+        // Acquired a region that we can write a full frame.
+        // Store the frame length with incomplete bit and publish the region.
+        //
+        Frame(writeOffset).Length.store(frameLength | 1, std::memory_order_relaxed);
+        PublishWriteRegion(frameLength);
+
+        return writeOffset;
+    }
+}
+
+//----------------------------------------------------------------------------
+// NAME: SharedChannel64<TChannelPolicy, TChannelSpinPolicy>::NotifyExternalReader
+//
+// PURPOSE:
+//
+// RETURNS:
+//
+// NOTES:
+//
+template <typename TChannelPolicy, typename TChannelSpinPolicy>
+void SharedChannel64<TChannelPolicy, TChannelSpinPolicy>::NotifyExternalReader()
+{
+    ChannelPolicy.NotifyExternalReader();
+}
+
+//----------------------------------------------------------------------------
+// NAME: SharedChannel64<TChannelPolicy, TChannelSpinPolicy>::AcquireRegionForWrite
+//
+// PURPOSE:
+//  Function returns an offset to the acquired region that can we safely use for write operation.
+//
+// RETURNS:
+//  An offset to the acquired region.
+//  If reader has been aborted or the timeout expired, return InvalidOffset.
+//
+// NOTES:
+//  There is no guarantee that the acquired region is contiguous (it might be overlapping).
+//  However it ensures that the next write offset will not be greater than the buffer margin,
+//  so the next writer can write an empty FrameHeader64.
+//  The positions do not overflow, so the write position is always greater or equal to the free position.
+//  Same as the 32-bit channel, the writer sets the pending bit of the write position instead of advancing it,
+//  the region is published by PublishWriteRegion.
+//
+template <typename TChannelPolicy, typename TChannelSpinPolicy>
+uint64_t SharedChannel64<TChannelPolicy, TChannelSpinPolicy>::AcquireRegionForWrite(
+    int64_t& frameLength,
+    uint32_t timeoutInMicroseconds)
+{
+    TChannelSpinPolicy channelSpinPolicy;
+
+    // The deadline is calculated when the writer finds the buffer full for the first time.
+    //
+    std::chrono::steady_clock::time_point deadline;
+    bool hasDeadline = false;
+
+    while (true)
+    {
+        // Read FreePosition first. Otherwise, it might advance if we had read WritePosition first.
+        //
+        const uint64_t freePosition = Sync.FreePosition.load(std::memory_order_acquire);
+        const uint64_t writePosition = Sync.WritePosition.load(std::memory_order_relaxed);
+
+        if constexpr (!TChannelPolicy::IsSingleProducerSingleConsumer)
+        {
+            if ((writePosition & 1) == 1)
+            {
+                // Other writer is storing the frame length of its region.
+                //
+                channelSpinPolicy.FailedToAcquireWriteRegion();
+                continue;
+            }
+        }
+
+        // Check if there is enough bytes to write frame (full frame or a link).
+        // Always keep the distance to free offset, at least a size of FrameHeader64.
+        //
+        if (!(writePosition - freePosition < Margin - frameLength))
+        {
+            // Not enough free space to acquire region.
+            //
+
+            // Check if the channel is still active.
+            //
+            if (Sync.TerminateChannel.load(std::memory_order_relaxed))
+            {
+                return InvalidOffset;
+            }
+
+            // Advance free position to reclaim memory for writes.
+            // Retry after that, as another writer might acquire just the released region.
+            //
+            AdvanceFreePosition();
+
+            if (Sync.FreePosition.load(std::memory_order_acquire) != freePosition)
+            {
+                continue;
+            }
+
+            // The readers have not released any frame yet.
+            //
+            uint32_t remainingTimeoutInMicroseconds = InfiniteTimeout;
+
+            if (timeoutInMicroseconds != InfiniteTimeout)
+            {
+                const std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+
+                if (!hasDeadline)
+                {
+                    deadline = now + std::chrono::microseconds(timeoutInMicroseconds);
+                    hasDeadline = true;
+                }
+
+                if (now >= deadline)
+                {
+                    // The timeout expired.
+                    //
+                    return InvalidOffset;
+                }
+
+                remainingTimeoutInMicroseconds = static_cast<uint32_t>(
+                    std::chrono::duration_cast<std::chrono::microseconds>(deadline - now).count());
+            }
+
+            // Spin for a while, then wait for the notification from the readers.
+            //
+            if (!channelSpinPolicy.WaitForFreeSpace())
+            {
+                WaitForFreeSpace(freePosition, remainingTimeoutInMicroseconds);
+            }
+
+            continue;
+        }
+
+        // If the end of the requested frame is located in the buffer margin, extend the acquired region.
+        //
+        int64_t frameLengthAdj = 0;
+
+        // NextWriteOffset is at the frame end.
+        // Ensure that after a full frame there is enough space for the next frame header.
+        // Otherwise, we will not be able to store next frame, because the frame header will not fit in the buffer.
+        //
+        const uint64_t nextWriteOffset = Offset(writePosition + frameLength);
+        if (nextWriteOffset >= Margin)
+        {
+            // Update frameLength, as we acquired more than requested.
+            //
+            frameLengthAdj = static_cast<int64_t>(Size - nextWriteOffset);
+        }
+
+        if constexpr (!TChannelPolicy::IsSingleProducerSingleConsumer)
+        {
+            // There is no other writer in the single producer channel, the region is acquired without the interlocked operation.
+            //
+            uint64_t expectedWritePosition = writePosition;
+            if (!Sync.WritePosition.compare_exchange_weak(expectedWritePosition, writePosition | 1))
+            {
+                // Failed to advance write offset, other writer acquired this region.
+                //
+                channelSpinPolicy.FailedToAcquireWriteRegion();
+                continue;
+            }
+        }
+
+        frameLength += frameLengthAdj;
+
+        // The region contains the stale frames, the readers do not read it until the region is published.
+        //
+        return Offset(writePosition);
+    }
+}
+
+//----------------------------------------------------------------------------
+// NAME: SharedChannel64<TChannelPolicy, TChannelSpinPolicy>::WaitForFreeSpace
+//
+// PURPOSE:
+//  Waits until the readers release the processed frames located at the free position.
+//
+// RETURNS:
+//  Nothing.
+//
+// NOTES:
+//  Writer function.
+//  Before the writer waits, it checks the free space for the last time.
+//  The wait might return before the frames are released or the timeout expired, the caller checks again.
+//
+template <typename TChannelPolicy, typename TChannelSpinPolicy>
+void SharedChannel64<TChannelPolicy, TChannelSpinPolicy>::WaitForFreeSpace(
+    uint64_t freePosition,
+    uint32_t timeoutInMicroseconds)
+{
+    const uint32_t waitToken = ChannelPolicy.PrepareWaitForFreeSpace();
+
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+
+    if (Sync.TerminateChannel.load(std::memory_order_relaxed))
+    {
+        return;
+    }
+
+    AdvanceFreePosition();
+
+    if (Sync.FreePosition.load(std::memory_order_acquire) != freePosition)
+    {
+        return;
+    }
+
+    ChannelPolicy.WaitForFreeSpace(waitToken, timeoutInMicroseconds);
+}
+
+//----------------------------------------------------------------------------
+// NAME: SharedChannel64<TChannelPolicy, TChannelSpinPolicy>::WaitForFrame
+//
+// PURPOSE:
+//  Wait for the frame become available.
+//
+// RETURNS:
+//  Returns an offset to the acquired frame.
+//
+// NOTES:
+//  Reader function.
+//  If the wait has been aborted, it returns InvalidOffset.
+//
+template <typename TChannelPolicy, typename TChannelSpinPolicy>
+uint64_t SharedChannel64<TChannelPolicy, TChannelSpinPolicy>::WaitForFrame()
+{
+    uint64_t readPosition;
+    TChannelSpinPolicy channelSpinPolicy;
+
+    bool shouldWait = false;
+    uint32_t waitToken = 0;
+
+    while (true)
+    {
+        // Wait for the frame become available.
+        // Spin on current frame (ReadOffset).
+        //
+        readPosition = Sync.ReadPosition.load(std::memory_order_acquire);
+
+        // The frame lengths are valid only before the published write position, the memory after it is not cleared.
+        //
+        const uint64_t writePosition = Sync.WritePosition.load(std::memory_order_acquire) & ~static_cast<uint64_t>(1);
+
+        FrameHeader64& frame = Frame(Offset(readPosition));
+
+        int64_t frameLength = (readPosition != writePosition) ? frame.Length.load(std::memory_order_relaxed) : 0;
+        if (frameLength > 0)
+        {
+            // Writer had updated the length.
+            // Frame is ready and available for the reader.
+            // Advance ReadIndex to end of the frame, and allow other reads to process next frame.
+            //
+            const uint64_t nextReadPosition = readPosition + (frameLength & (~1));
+
+            if constexpr (TChannelPolicy::IsSingleProducerSingleConsumer)
+            {
+                // There is no other reader, publish the read position with a plain store.
+                //
+                Sync.ReadPosition.store(nextReadPosition, std::memory_order_release);
+            }
+            else
+            {
+                uint64_t expectedReadPosition = readPosition;
+                if (!Sync.ReadPosition.compare_exchange_weak(expectedReadPosition, nextReadPosition))
+                {
+                    // Other reader advanced ReadPosition therefore it will process the frame.
+                    //
+                    channelSpinPolicy.FailedToAcquireReadRegion();
+                    continue;
+                }
+            }
+
+            // Current reader owns the frame. Wait until the writer completes the write.
+            //
+            while ((frameLength & 1) == 1)
+            {
+                channelSpinPolicy.WaitForFrameCompletion();
+                frameLength = frame.Length.load(std::memory_order_acquire);
+            }
+
+            break;
+        }
+
+        channelSpinPolicy.WaitForNewFrame();
+
+        // No frame yet, spin if the channel is still active.
+        //
+        if (Sync.TerminateChannel.load(std::memory_order_relaxed))
+        {
+            Sync.ReaderInWaitingStateCount.fetch_sub((uint32_t)shouldWait);
+            return InvalidOffset;
+        }
+
+        // Wait for the synchronization primitive.
+        //
+        if (shouldWait)
+        {
+            ChannelPolicy.WaitForFrame(waitToken);
+            Sync.ReaderInWaitingStateCount.fetch_sub((uint32_t)shouldWait);
+            shouldWait = false;
+        }
+        else
+        {
+            // Before reader enters wait state it will increase the in wait state count and then check if are there any messages in the channel.
+            //
+            shouldWait = true;
+            Sync.ReaderInWaitingStateCount.fetch_add((uint32_t)shouldWait);
+
+            waitToken = ChannelPolicy.PrepareWaitForFrame();
+        }
+    }
+
+    // Reset the in wait state counter.
+    //
+    Sync.ReaderInWaitingStateCount.fetch_sub((uint32_t)shouldWait);
+
+    // Reader acquired read region, frame is ready.
+    //
+    return Offset(readPosition);
+}
+
+//----------------------------------------------------------------------------
+// NAME: SharedChannel64<TChannelPolicy, TChannelSpinPolicy>::DispatchFrame
+//
+// PURPOSE:
+//  Verifies the acquired frame and calls proper dispatcher.
+//
+// RETURNS:
+//  Returns the length of the frame.
+//
+// NOTES:
+//  Reader function.
+//  The frame is not released, the caller signals the frame for cleanup.
+//  Only the link frames might be longer than 2 GiB, the message frames are passed to the dispatcher.
+//
+template <typename TChannelPolicy, typename TChannelSpinPolicy>
+int64_t SharedChannel64<TChannelPolicy, TChannelSpinPolicy>::DispatchFrame(
+    uint64_t readOffset,
+    DispatchEntry* dispatchTable,
+    size_t dispatchEntryCount)
+{
+    // Verify frame and call dispatcher.
+    //
+    FrameHeader64& frame = Frame(readOffset);
+    uint32_t codegenTypeIndex = frame.CodegenTypeIndex;
+    uint64_t codegenTypeHash = frame.CodegenTypeHash;
+
+    int64_t frameLength = frame.Length.load(std::memory_order_acquire);
+
+    // Check if this is valid frame or just the link to the beginning of the buffer.
+    //
+    if (codegenTypeIndex != 0 && codegenTypeIndex <= dispatchEntryCount)
+    {
+        uint64_t expectedCodegenTypeHash = dispatchTable[codegenTypeIndex - 1].CodegenTypeHash;
+
+        bool isMessageValid = (static_cast<uint64_t>(frameLength) < Size) &&
+            (frameLength <= std::numeric_limits<int32_t>::max()) &&
+            (expectedCodegenTypeHash == codegenTypeHash);
+
+        if (isMessageValid)
+        {
+            // Call dispatcher only if type hash is correct.
+            //
+            isMessageValid = dispatchTable[codegenTypeIndex - 1].Callback(
+                std::move(Payload(readOffset)),
+                static_cast<int32_t>(frameLength));
+        }
+
+        if (!isMessageValid)
+        {
+            // Received invalid frame, channel policy decides what how to handle it.
+            //
+            ChannelPolicy.ReceivedInvalidFrame();
+        }
+    }
+    else if (codegenTypeIndex != 0)
+    {
+        // Received invalid frame, channel policy decides what how to handle it.
+        //
+        ChannelPolicy.ReceivedInvalidFrame();
+    }
+
+    // Reader does not clear the frame.
+    // The processed frames are reclaimed without clearing the memory, the stale content is never read.
+    // The readers do not read past the published write position, and the writer stores the lengths (with the incomplete bit)
+    // of all the frames in the region before it publishes the region.
+    //
+    return frameLength;
+}
+
+//----------------------------------------------------------------------------
+// NAME: SharedChannel64<TChannelPolicy, TChannelSpinPolicy>::WaitAndDispatchFrame
+//
+// PURPOSE:
+//  Waits for a new frame then call proper dispatcher.
+//
+// RETURNS:
+//  Returns true if reader successfully processed the frame.
+//  If the wait has been aborted, it returns false.
+//
+// NOTES:
+//  To interrupt wait, set Sync.TerminateChannel to true.
+//
+template <typename TChannelPolicy, typename TChannelSpinPolicy>
+bool SharedChannel64<TChannelPolicy, TChannelSpinPolicy>::WaitAndDispatchFrame(
+    DispatchEntry* dispatchTable,
+    size_t dispatchEntryCount)
+{
+    const uint64_t readOffset = WaitForFrame();
+
+    if (readOffset == InvalidOffset)
+    {
+        // Invalid offset, the wait was interrupted.
+        //
+        return false;
+    }
+
+    const int64_t frameLength = DispatchFrame(readOffset, dispatchTable, dispatchEntryCount);
+
+    // Mark frame that processing is completed (negative length).
+    //
+    SignalFrameForCleanup(Frame(readOffset), frameLength);
+
+    // Notify the writers waiting for the free space.
+    //
+    if constexpr (TChannelPolicy::HasFreeSpaceNotification)
+    {
+        ChannelPolicy.NotifyExternalWriter();
+    }
+
+    return true;
+}
+
+//----------------------------------------------------------------------------
+// NAME: SharedChannel64<TChannelPolicy, TChannelSpinPolicy>::ProcessMessages
+//
+// PURPOSE:
+//  Reader loop, process received messages.
+//
+// RETURNS:
+//
+// NOTES:
+//
+template <typename TChannelPolicy, typename TChannelSpinPolicy>
+void SharedChannel64<TChannelPolicy, TChannelSpinPolicy>::ProcessMessages(
+    Mlos::Core::DispatchEntry* dispatchTable,
+    size_t dispatchEntryCount)
+{
+    Sync.ActiveReaderCount.fetch_add(1);
+
+    // Receiver thread.
+    //
+    bool result = true;
+    while (result)
+    {
+        result = WaitAndDispatchFrame(dispatchTable, dispatchEntryCount);
+    }
+
+    Sync.ActiveReaderCount.fetch_sub(1);
+
+    // The channel has been terminated, wake up the writers waiting for the free space.
+    //
+    if constexpr (TChannelPolicy::HasFreeSpaceNotification)
+    {
+        ChannelPolicy.NotifyExternalWriter();
+    }
+}
+}
+}
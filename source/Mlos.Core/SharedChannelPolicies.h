@@ -19,6 +19,29 @@ namespace Mlos
 {
 namespace Core
 {
+//----------------------------------------------------------------------------
+// NAME: SharedChannelOverflowMode
+//
+// PURPOSE:
+//  Defines how the writer handles the buffer without enough free space.
+//
+// NOTES:
+//
+enum class SharedChannelOverflowMode
+{
+    // Writer waits until the readers release the processed frames.
+    //
+    Block,
+
+    // Writer drops the new message.
+    //
+    DropNewest,
+
+    // Writer discards the oldest unread frames to make space for the new message.
+    //
+    OverwriteOldest,
+};
+
 //----------------------------------------------------------------------------
 // NAME: InternalSharedChannelPolicy
 //
@@ -28,6 +51,7 @@ namespace Core
 // NOTES:
 //  Should be used within a single process only.
 //  The policy does not provide OS notification. Therefore it is not able to signal the external process.
+//  A writer waiting for the free space polls for it, the readers do not call NotifyExternalWriter.
 //
 struct InternalSharedChannelPolicy
 {
@@ -38,16 +62,76 @@ struct InternalSharedChannelPolicy
         throw std::exception();
     }
 
+    // Multiple writers and readers might use the channel concurrently.
+    //
+    static constexpr bool IsSingleProducerSingleConsumer = false;
+
+    // Writers wait for the free space when the buffer is full.
+    //
+    inline SharedChannelOverflowMode OverflowMode() const
+    {
+        return SharedChannelOverflowMode::Block;
+    }
+
+    // Called when the messages have been dropped.
+    //
+    inline void MessagesDropped(uint32_t codegenTypeIndex, uint32_t messageCount)
+    {
+        UNUSED(codegenTypeIndex);
+        UNUSED(messageCount);
+    }
+
     /// <summary>
     /// Notify reader that there is a frame to process.
     /// </summary>
     inline void NotifyExternalReader()
     {}
 
+    // Called when reader thread enters the waiting state, before it checks the frames for the last time.
+    // Returns a token passed to WaitForFrame.
+    //
+    inline uint32_t PrepareWaitForFrame()
+    {
+        return 0;
+    }
+
     // Called when reader thread is no longer processing the messages.
     //
-    inline void WaitForFrame()
+    inline void WaitForFrame(uint32_t waitToken)
+    {
+        UNUSED(waitToken);
+    }
+
+    // The writers poll for the free space, the readers do not notify them.
+    //
+    static constexpr bool HasFreeSpaceNotification = false;
+
+    // Notify writers that the readers released the processed frames.
+    //
+    inline void NotifyExternalWriter()
     {}
+
+    // Called when writer thread enters the waiting state, before it checks the free space for the last time.
+    // Returns a token passed to WaitForFreeSpace.
+    //
+    inline uint32_t PrepareWaitForFreeSpace()
+    {
+        return 0;
+    }
+
+    // Called when writer thread is waiting for the readers to release the processed frames.
+    // The policy does not provide notification, the writer polls for the free space.
+    //
+    inline void WaitForFreeSpace(uint32_t waitToken, uint32_t timeoutInMicroseconds)
+    {
+        UNUSED(waitToken);
+
+        MlosPlatform::SleepMicroseconds(std::min(timeoutInMicroseconds, FreeSpacePollIntervalInMicroseconds));
+    }
+
+    // Interval between the free space checks of the waiting writer.
+    //
+    static constexpr uint32_t FreeSpacePollIntervalInMicroseconds = 100;
 };
 
 //----------------------------------------------------------------------------
@@ -57,6 +141,12 @@ struct InternalSharedChannelPolicy
 //  Shared channel policy to communicate with Mlos.Agent.
 //
 // NOTES:
+//  The named event wakes up the readers only. A writer waiting for the free space polls for it
+//  (FreeSpacePollIntervalInMicroseconds). This is intended: the writers wait only after the spin policy
+//  has been exhausted, which requires the readers (Mlos.Agent) to fall behind, and a second named event per channel
+//  would have to be created, shared and cleaned up by both processes. Use FutexSharedChannelPolicy,
+//  if the writers should be notified.
+//  The readers do not call NotifyExternalWriter (HasFreeSpaceNotification is false).
 //
 struct InterProcessSharedChannelPolicy
 {
@@ -73,25 +163,336 @@ struct InterProcessSharedChannelPolicy
     inline void ReceivedInvalidFrame()
     {}
 
+    // Multiple writers and readers might use the channel concurrently.
+    //
+    static constexpr bool IsSingleProducerSingleConsumer = false;
+
+    // Writers wait for the free space when the buffer is full.
+    //
+    inline SharedChannelOverflowMode OverflowMode() const
+    {
+        return SharedChannelOverflowMode::Block;
+    }
+
+    // Called when the messages have been dropped.
+    //
+    inline void MessagesDropped(uint32_t codegenTypeIndex, uint32_t messageCount)
+    {
+        UNUSED(codegenTypeIndex);
+        UNUSED(messageCount);
+    }
+
     inline void NotifyExternalReader()
     {
         m_notificationEvent.Signal();
     }
 
+    // Called when reader thread enters the waiting state, before it checks the frames for the last time.
+    // The named event keeps the signaled state, the policy does not need a token.
+    //
+    inline uint32_t PrepareWaitForFrame()
+    {
+        return 0;
+    }
+
     // Called when reader thread is no longer processing the messages.
     // We will wait until the writer thread (residing in the external process) signals there is a new message available.
     //
-    inline void WaitForFrame()
+    inline void WaitForFrame(uint32_t waitToken)
     {
+        UNUSED(waitToken);
+
         m_notificationEvent.Wait();
     }
 
+    // The writers poll for the free space, the readers do not notify them.
+    //
+    static constexpr bool HasFreeSpaceNotification = false;
+
+    // Notify writers that the readers released the processed frames.
+    // The named event is used only to wake up the readers.
+    //
+    inline void NotifyExternalWriter()
+    {}
+
+    // Called when writer thread enters the waiting state, before it checks the free space for the last time.
+    //
+    inline uint32_t PrepareWaitForFreeSpace()
+    {
+        return 0;
+    }
+
+    // Called when writer thread is waiting for the readers (residing in the external process) to release the processed frames.
+    // The policy does not provide notification, the writer polls for the free space.
+    //
+    inline void WaitForFreeSpace(uint32_t waitToken, uint32_t timeoutInMicroseconds)
+    {
+        UNUSED(waitToken);
+
+        MlosPlatform::SleepMicroseconds(std::min(timeoutInMicroseconds, FreeSpacePollIntervalInMicroseconds));
+    }
+
+    // Interval between the free space checks of the waiting writer.
+    //
+    static constexpr uint32_t FreeSpacePollIntervalInMicroseconds = 100;
+
 public:
     // External notification.
     //
     NamedEvent m_notificationEvent;
 };
 
+#ifndef _WIN64
+//----------------------------------------------------------------------------
+// NAME: FutexSharedChannelPolicy
+//
+// PURPOSE:
+//  Shared channel policy to communicate with Mlos.Agent, readers wait on the futex word.
+//
+// NOTES:
+//  Linux only.
+//  The futex word (ReaderWakeupSequence) is located in the channel synchronization object in the shared memory,
+//  the policy does not require any named OS object.
+//  The lowest bit of the futex word indicates there is a reader going to sleep, the remaining bits are the wakeup sequence.
+//  Before the reader checks the frames for the last time, it sets the lowest bit.
+//  The reader sleeps only if the futex word has not changed since, so it cannot miss the wakeup.
+//  The writer wakes up a reader only on the transition, when it clears the lowest bit and advances the sequence.
+//  Then it wakes up exactly one reader. While the woken reader is running, the notification is a single load.
+//  When the channel is terminating, the notification wakes up all the readers.
+//  Writers waiting for the free space use the same protocol with the WriterWakeupSequence futex word,
+//  the readers wake them up after they release the processed frames.
+//
+struct FutexSharedChannelPolicy
+{
+    FutexSharedChannelPolicy(ChannelSynchronization& sync) noexcept
+      : m_sync(&sync)
+    {}
+
+    // Received a frame with mismatch codegen type metadata.
+    //
+    inline void ReceivedInvalidFrame()
+    {}
+
+    // Multiple writers and readers might use the channel concurrently.
+    //
+    static constexpr bool IsSingleProducerSingleConsumer = false;
+
+    // Writers wait for the free space when the buffer is full.
+    //
+    inline SharedChannelOverflowMode OverflowMode() const
+    {
+        return SharedChannelOverflowMode::Block;
+    }
+
+    // Called when the messages have been dropped.
+    //
+    inline void MessagesDropped(uint32_t codegenTypeIndex, uint32_t messageCount)
+    {
+        UNUSED(codegenTypeIndex);
+        UNUSED(messageCount);
+    }
+
+    inline void NotifyExternalReader()
+    {
+        std::atomic<uint32_t>& wakeupSequence = m_sync->ReaderWakeupSequence;
+
+        if (m_sync->TerminateChannel.load(std::memory_order_relaxed))
+        {
+            // Wake up all the readers.
+            //
+            wakeupSequence.fetch_add(2);
+
+            HRESULT hr = Futex::Wake(wakeupSequence, std::numeric_limits<int32_t>::max());
+            UNUSED(hr);
+            return;
+        }
+
+        uint32_t currentWakeupSequence = wakeupSequence.load(std::memory_order_relaxed);
+
+        if ((currentWakeupSequence & 1) == 0)
+        {
+            // There is no reader going to sleep.
+            //
+            return;
+        }
+
+        if (!wakeupSequence.compare_exchange_strong(currentWakeupSequence, (currentWakeupSequence + 2) & ~1U))
+        {
+            // Another writer woke up the reader.
+            //
+            return;
+        }
+
+        HRESULT hr = Futex::Wake(wakeupSequence, 1);
+        UNUSED(hr);
+    }
+
+    // Called when reader thread enters the waiting state, before it checks the frames for the last time.
+    //
+    inline uint32_t PrepareWaitForFrame()
+    {
+        return m_sync->ReaderWakeupSequence.fetch_or(1) | 1;
+    }
+
+    // Called when reader thread is no longer processing the messages.
+    // The reader sleeps until a writer advances the wakeup sequence.
+    //
+    inline void WaitForFrame(uint32_t waitToken)
+    {
+        HRESULT hr = Futex::Wait(m_sync->ReaderWakeupSequence, waitToken);
+        UNUSED(hr);
+    }
+
+    // The readers wake up the writers waiting for the free space.
+    //
+    static constexpr bool HasFreeSpaceNotification = true;
+
+    // Notify writers that the readers released the processed frames.
+    //
+    inline void NotifyExternalWriter()
+    {
+        std::atomic<uint32_t>& wakeupSequence = m_sync->WriterWakeupSequence;
+
+        // Order the released frames before the check of the waiting writers.
+        //
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+
+        if (m_sync->TerminateChannel.load(std::memory_order_relaxed))
+        {
+            // Wake up all the writers.
+            //
+            wakeupSequence.fetch_add(2);
+
+            HRESULT hr = Futex::Wake(wakeupSequence, std::numeric_limits<int32_t>::max());
+            UNUSED(hr);
+            return;
+        }
+
+        uint32_t currentWakeupSequence = wakeupSequence.load(std::memory_order_relaxed);
+
+        if ((currentWakeupSequence & 1) == 0)
+        {
+            // There is no writer going to sleep.
+            //
+            return;
+        }
+
+        if (!wakeupSequence.compare_exchange_strong(currentWakeupSequence, (currentWakeupSequence + 2) & ~1U))
+        {
+            // Another reader woke up the writers.
+            //
+            return;
+        }
+
+        // All the waiting writers compete for the released space.
+        //
+        HRESULT hr = Futex::Wake(wakeupSequence, std::numeric_limits<int32_t>::max());
+        UNUSED(hr);
+    }
+
+    // Called when writer thread enters the waiting state, before it checks the free space for the last time.
+    //
+    inline uint32_t PrepareWaitForFreeSpace()
+    {
+        return m_sync->WriterWakeupSequence.fetch_or(1) | 1;
+    }
+
+    // Called when writer thread is waiting for the readers to release the processed frames.
+    //
+    inline void WaitForFreeSpace(uint32_t waitToken, uint32_t timeoutInMicroseconds)
+    {
+        HRESULT hr = (timeoutInMicroseconds == ISharedChannel::InfiniteTimeout)
+            ? Futex::Wait(m_sync->WriterWakeupSequence, waitToken)
+            : Futex::Wait(m_sync->WriterWakeupSequence, waitToken, timeoutInMicroseconds);
+        UNUSED(hr);
+    }
+
+private:
+    ChannelSynchronization* m_sync;
+};
+#endif
+
+//----------------------------------------------------------------------------
+// NAME: LossySharedChannelPolicy<TChannelPolicy>
+//
+// PURPOSE:
+//  Shared channel policy for the telemetry channels, writers never wait for the readers.
+//
+// NOTES:
+//  The notification is provided by TChannelPolicy.
+//  When the buffer is full, the writer either drops the new message or discards the oldest unread frames.
+//  The dropped messages are counted per codegen type index in the channel synchronization object,
+//  so the agent can find out its view of the telemetry is sampled.
+//  Messages with codegen type index outside of the counter array are counted only in the total.
+//
+template<typename TChannelPolicy>
+struct LossySharedChannelPolicy : public TChannelPolicy
+{
+    LossySharedChannelPolicy(
+        ChannelSynchronization& sync,
+        SharedChannelOverflowMode overflowMode,
+        TChannelPolicy&& channelPolicy = TChannelPolicy()) noexcept
+      : TChannelPolicy(std::move(channelPolicy)),
+        m_dropStats(&sync.DropStats),
+        m_overflowMode(overflowMode)
+    {}
+
+    LossySharedChannelPolicy(LossySharedChannelPolicy&& channelPolicy) noexcept = default;
+
+    inline SharedChannelOverflowMode OverflowMode() const
+    {
+        return m_overflowMode;
+    }
+
+    // Called when the messages have been dropped.
+    //
+    inline void MessagesDropped(uint32_t codegenTypeIndex, uint32_t messageCount)
+    {
+        m_dropStats->DroppedMessageCount.fetch_add(messageCount, std::memory_order_relaxed);
+
+        if (codegenTypeIndex < m_dropStats->DroppedMessageCountByType.size())
+        {
+            m_dropStats->DroppedMessageCountByType[codegenTypeIndex].fetch_add(messageCount, std::memory_order_relaxed);
+        }
+    }
+
+private:
+    ChannelDropStats* m_dropStats;
+
+    SharedChannelOverflowMode m_overflowMode;
+};
+
+//----------------------------------------------------------------------------
+// NAME: SingleProducerSingleConsumerSharedChannelPolicy<TChannelPolicy>
+//
+// PURPOSE:
+//  Shared channel policy for the channels with exactly one writer thread and one reader thread.
+//
+// NOTES:
+//  The notification is provided by TChannelPolicy.
+//  The writer publishes the write position and the reader publishes the read position with a plain release store,
+//  as there is no other thread competing for the same position.
+//  Only the reader publishes its position once per batch of frames. The writer publishes the write position
+//  once per frame, unless it sends the messages with SendBatch or SendMessages.
+//  The frame format is the same as for the other channels, the reader still waits for the incomplete frames,
+//  so the peer might use a regular channel (for example Mlos.Agent reader).
+//  Overwriting the oldest frames requires the writer to compete with the reader for the read position,
+//  this policy cannot be combined with SharedChannelOverflowMode::OverwriteOldest.
+//
+template<typename TChannelPolicy>
+struct SingleProducerSingleConsumerSharedChannelPolicy : public TChannelPolicy
+{
+    SingleProducerSingleConsumerSharedChannelPolicy(TChannelPolicy&& channelPolicy = TChannelPolicy()) noexcept
+      : TChannelPolicy(std::move(channelPolicy))
+    {}
+
+    SingleProducerSingleConsumerSharedChannelPolicy(SingleProducerSingleConsumerSharedChannelPolicy&& channelPolicy) noexcept = default;
+
+    // Single writer thread and single reader thread.
+    //
+    static constexpr bool IsSingleProducerSingleConsumer = true;
+};
+
 //----------------------------------------------------------------------------
 // NAME: SharedChannelSpinPolicy
 //
@@ -99,29 +500,185 @@ public:
 //  Default shared channel policy.
 //
 // NOTES:
+//  Adaptive spin policy. The waiting thread spins with a single pause instruction first,
+//  then backs off exponentially, then yields the processor and finally parks for a short period.
+//  The channel creates a new policy instance for every wait, so every wait starts with spinning.
+//  A writer that lost the write position to another writer spins and backs off exponentially.
+//  Once the backoff reaches the maximum, it yields the processor and restarts the backoff, it never parks.
+//
+//  The thresholds are shared by all the channels in the process and stored in atomic variables.
+//  MlosContext registers the SharedChannelSpinPolicyConfig component config and copies the thresholds
+//  from the shared config when the agent updates it (see MlosContext::RefreshSharedChannelSpinPolicyConfig).
+//  The policy never reads the component config.
+//  The policy instance reads the thresholds once, on its first wait iteration.
 //
 struct SharedChannelSpinPolicy
 {
 public:
+    SharedChannelSpinPolicy() noexcept
+      : m_spinCount(0),
+        m_backoffPauseCount(1),
+        m_yieldCount(0),
+        m_isConfigLoaded(false)
+    {}
+
     // Called when there is no frame in the buffer.
     //
     inline void WaitForNewFrame()
-    {}
+    {
+        SpinOnce();
+    }
 
     // Called when reader acquire the frame but the frame is not yet completed.
     //
     inline void WaitForFrameCompletion()
-    {}
+    {
+        SpinOnce();
+    }
 
     // There is a frame in the buffer however other thread acquire the read first.
+    // The next frame might be already available, retry immediately.
     //
     inline void FailedToAcquireReadRegion()
-    {}
+    {
+        MlosPlatform::Pause();
+    }
 
     // Another writer acquired the write region.
+    // The write position has already advanced, retry after a short backoff.
     //
     inline void FailedToAcquireWriteRegion()
-    {}
+    {
+        LoadConfig();
+
+        if (!SpinOrBackoff())
+        {
+            // The backoff is exhausted, yield and start the backoff again with a single pause.
+            //
+            MlosPlatform::YieldThread();
+            m_backoffPauseCount = 1;
+        }
+    }
+
+    // Called when there is not enough free space in the buffer.
+    // Returns false when the writer exhausted the spin and yield phases, and should wait for the notification instead.
+    //
+    inline bool WaitForFreeSpace()
+    {
+        LoadConfig();
+
+        if (m_spinCount >= m_config.PauseSpinCount &&
+            m_backoffPauseCount >= m_config.MaxBackoffPauseCount &&
+            m_yieldCount >= m_config.YieldCount)
+        {
+            return false;
+        }
+
+        SpinOnce();
+        return true;
+    }
+
+    // Returns the thresholds used by the channels in the process.
+    //
+    static SharedChannelSpinPolicyConfig CurrentConfig();
+
+    // Sets the thresholds used by the channels in the process.
+    // The thresholds are replaced again when the agent updates the shared config registered by MlosContext.
+    //
+    static void UpdateConfig(const SharedChannelSpinPolicyConfig& config);
+
+private:
+    inline void SpinOnce()
+    {
+        LoadConfig();
+
+        if (SpinOrBackoff())
+        {
+            return;
+        }
+
+        if (m_yieldCount < m_config.YieldCount)
+        {
+            // Yield.
+            //
+            ++m_yieldCount;
+            MlosPlatform::YieldThread();
+        }
+        else
+        {
+            // Park.
+            //
+            MlosPlatform::SleepMicroseconds(m_config.ParkDurationInMicroseconds);
+        }
+    }
+
+    // Spins or backs off exponentially.
+    // Returns false if both phases have been exhausted.
+    //
+    inline bool SpinOrBackoff()
+    {
+        if (m_spinCount < m_config.PauseSpinCount)
+        {
+            // Spin.
+            //
+            ++m_spinCount;
+            MlosPlatform::Pause();
+            return true;
+        }
+
+        if (m_backoffPauseCount < m_config.MaxBackoffPauseCount)
+        {
+            // Exponential backoff.
+            //
+            m_backoffPauseCount *= 2;
+
+            for (int32_t i = 0; i < m_backoffPauseCount; ++i)
+            {
+                MlosPlatform::Pause();
+            }
+
+            return true;
+        }
+
+        return false;
+    }
+
+    // Reads the thresholds on the first wait iteration.
+    //
+    inline void LoadConfig()
+    {
+        if (!m_isConfigLoaded)
+        {
+            m_config = CurrentConfig();
+            m_isConfigLoaded = true;
+        }
+    }
+
+    // Thresholds shared by the channels in the process.
+    //
+    struct Thresholds
+    {
+        std::atomic<int32_t> PauseSpinCount;
+        std::atomic<int32_t> MaxBackoffPauseCount;
+        std::atomic<int32_t> YieldCount;
+        std::atomic<int32_t> ParkDurationInMicroseconds;
+    };
+
+    static inline Thresholds s_thresholds =
+    {
+        64 /* PauseSpinCount */,
+        1024 /* MaxBackoffPauseCount */,
+        16 /* YieldCount */,
+        100 /* ParkDurationInMicroseconds */,
+    };
+
+private:
+    int32_t m_spinCount;
+    int32_t m_backoffPauseCount;
+    int32_t m_yieldCount;
+
+    bool m_isConfigLoaded;
+    SharedChannelSpinPolicyConfig m_config;
 };
 
 //----------------------------------------------------------------------------
@@ -145,5 +702,56 @@ using TestSharedChannel = Mlos::Core::SharedChannel<InternalSharedChannelPolicy,
 //  Shared channel to communicate with Mlos.Agent.
 //
 using InterProcessSharedChannel = Mlos::Core::SharedChannel<InterProcessSharedChannelPolicy, SharedChannelSpinPolicy>;
+
+//----------------------------------------------------------------------------
+// NAME: LossyInterProcessSharedChannel
+//
+// PURPOSE:
+//  Inter-process shared channel, writers drop or overwrite the messages instead of waiting for the readers.
+//
+// NOTES:
+//  Suitable for the telemetry, the messages might be lost.
+//
+using LossyInterProcessSharedChannel = Mlos::Core::SharedChannel<LossySharedChannelPolicy<InterProcessSharedChannelPolicy>, SharedChannelSpinPolicy>;
+
+//----------------------------------------------------------------------------
+// NAME: SingleProducerSingleConsumerTestSharedChannel
+//
+// PURPOSE:
+//  Test shared channel with a single writer thread and a single reader thread.
+//
+// NOTES:
+//  Suitable for testing purposes only.
+//
+using SingleProducerSingleConsumerTestSharedChannel = Mlos::Core::SharedChannel<
+    SingleProducerSingleConsumerSharedChannelPolicy<InternalSharedChannelPolicy>,
+    SharedChannelSpinPolicy>;
+
+//----------------------------------------------------------------------------
+// NAME: SingleProducerSingleConsumerInterProcessSharedChannel
+//
+// PURPOSE:
+//  Inter-process shared channel with a single writer thread and a single reader thread.
+//
+// NOTES:
+//  The application must not send the messages from more than one thread,
+//  and Mlos.Agent must use a single reader thread for the channel.
+//
+using SingleProducerSingleConsumerInterProcessSharedChannel = Mlos::Core::SharedChannel<
+    SingleProducerSingleConsumerSharedChannelPolicy<InterProcessSharedChannelPolicy>,
+    SharedChannelSpinPolicy>;
+
+#ifndef _WIN64
+//----------------------------------------------------------------------------
+// NAME: FutexInterProcessSharedChannel
+//
+// PURPOSE:
+//  Inter-process shared channel, readers wait on the futex word.
+//
+// NOTES:
+//  Both processes must use the futex policy for the channel.
+//
+using FutexInterProcessSharedChannel = Mlos::Core::SharedChannel<FutexSharedChannelPolicy, SharedChannelSpinPolicy>;
+#endif
 }
 }
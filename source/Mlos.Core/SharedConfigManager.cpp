@@ -47,13 +47,20 @@ SharedConfigManager::SharedConfigManager(MlosContext& mlosContext) noexcept
 HRESULT SharedConfigManager::RegisterSharedConfigMemoryRegion()
 {
     // Create (allocate and register) shared config memory region.
+    // The name includes the MlosContext instance name.
     // See Also: Mlos.Agent/MainAgent.cs
     //
-    const char* const appConfigSharedMemoryName = "Host_Mlos.Config.SharedMemory";
+    char appConfigSharedMemoryName[MaxSharedObjectNameLength];
+
+    HRESULT hr = FormatSharedObjectName("Host_Mlos.Config.SharedMemory", m_mlosContext.m_instanceName, appConfigSharedMemoryName);
+    if (FAILED(hr))
+    {
+        return hr;
+    }
 
     const size_t SharedMemorySize = 65536;
 
-    HRESULT hr = m_mlosContext.CreateMemoryRegion(appConfigSharedMemoryName, SharedMemorySize, m_sharedConfigMemRegionView);
+    hr = m_mlosContext.CreateMemoryRegion(appConfigSharedMemoryName, SharedMemorySize, m_sharedConfigMemRegionView);
     if (FAILED(hr))
     {
         return hr;
@@ -83,6 +83,7 @@ namespace Internal
 //
 // NOTES:
 //  Dummy allocator. Not thread safe.
+//  The allocated memory is aligned to 64 bytes, the allocation entry is placed right before it.
 //
 //  #TODO revisit thread safety
 //
@@ -95,18 +96,23 @@ HRESULT AllocateInSharedConfigMemoryRegion(
 
     Internal::ArenaAllocator& allocator = sharedConfigMemoryRegion.Allocator;
 
-    if (allocator.FreeOffset + size >= sharedConfigMemoryRegion.MemoryHeader.MemoryRegionSize)
+    // Place the allocation entry so the allocated memory is aligned (configs with Align(64) attribute).
+    //
+    const uint64_t entryOffset =
+        align<64>(static_cast<size_t>(allocator.FreeOffset + sizeof(Internal::AllocationEntry))) - sizeof(Internal::AllocationEntry);
+
+    if (entryOffset + size >= sharedConfigMemoryRegion.MemoryHeader.MemoryRegionSize)
     {
         return E_OUTOFMEMORY;
     }
 
     // Update the address.
     //
-    offset = allocator.FreeOffset;
+    offset = static_cast<uint32_t>(entryOffset);
 
     // Update memory region properties.
     //
-    allocator.FreeOffset += static_cast<uint32_t>(align<64>(size));
+    allocator.FreeOffset = static_cast<uint32_t>(align<64>(static_cast<size_t>(entryOffset + size)));
     allocator.AllocationCount++;
 
     // Update last allocated entry.
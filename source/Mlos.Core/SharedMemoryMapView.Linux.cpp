@@ -15,9 +15,11 @@
 
 #include "Mlos.Core.h"
 
+#include <linux/magic.h>
 #include <sys/mman.h>
 #include <sys/stat.h>
 #include <sys/types.h>
+#include <sys/vfs.h>
 #include <fcntl.h>
 #include <unistd.h>
 
@@ -25,6 +27,76 @@ namespace Mlos
 {
 namespace Core
 {
+// Mount point of hugetlbfs.
+//
+constexpr char HugeTlbFsMountPath[] = "/dev/hugepages";
+
+// Size of the transparent huge page (PMD size with 4KB base pages).
+//
+constexpr size_t TransparentHugePageSize = 2 * 1024 * 1024;
+
+//----------------------------------------------------------------------------
+// NAME: FormatHugeTlbFsFileName
+//
+// PURPOSE:
+//  Creates the name of the hugetlbfs file backing the shared memory.
+//
+// RETURNS:
+//  True if the name fits into the buffer.
+//
+template<size_t Size>
+static bool FormatHugeTlbFsFileName(const char* const sharedMemoryMapName, char (&fileName)[Size])
+{
+    const int length = snprintf(fileName, Size, "%s/%s", HugeTlbFsMountPath, sharedMemoryMapName);
+
+    return length > 0 && static_cast<size_t>(length) < Size;
+}
+
+//----------------------------------------------------------------------------
+// NAME: OpenHugeTlbFsFile
+//
+// PURPOSE:
+//  Opens or creates the hugetlbfs file backing the shared memory.
+//
+// RETURNS:
+//  File descriptor, INVALID_FD_VALUE if hugetlbfs is not mounted or the file does not exist.
+//
+// NOTES:
+//  Verifies the mount point is hugetlbfs, so we never create the files on a different file system.
+//
+static int OpenHugeTlbFsFile(const char* const sharedMemoryMapName, int openFlags)
+{
+    char fileName[sizeof(HugeTlbFsMountPath) + MaxSharedObjectNameLength];
+    if (!FormatHugeTlbFsFileName(sharedMemoryMapName, fileName))
+    {
+        return INVALID_FD_VALUE;
+    }
+
+    struct statfs statFsBuffer = { 0 };
+    if (statfs(HugeTlbFsMountPath, &statFsBuffer) == -1 ||
+        statFsBuffer.f_type != HUGETLBFS_MAGIC)
+    {
+        return INVALID_FD_VALUE;
+    }
+
+    return open(fileName, openFlags, S_IRUSR | S_IWUSR);
+}
+
+//----------------------------------------------------------------------------
+// NAME: UnlinkHugeTlbFsFile
+//
+// PURPOSE:
+//  Removes the hugetlbfs file backing the shared memory.
+//
+static void UnlinkHugeTlbFsFile(const char* const sharedMemoryMapName)
+{
+    char fileName[sizeof(HugeTlbFsMountPath) + MaxSharedObjectNameLength];
+    if (FormatHugeTlbFsFileName(sharedMemoryMapName, fileName))
+    {
+        unlink(fileName);
+    }
+}
+
 //----------------------------------------------------------------------------
 // NAME: SharedMemoryMapView::Constructor.
 //
@@ -33,7 +105,10 @@ SharedMemoryMapView::SharedMemoryMapView() noexcept
     m_fdSharedMemory(INVALID_FD_VALUE),
     m_sharedMemoryMapName(nullptr),
     Buffer(nullptr),
-    CleanupOnClose(false)
+    CleanupOnClose(false),
+    UseHugePages(false),
+    m_isHugeTlbFsFile(false),
+    m_isAnonymous(false)
 {
 }
 
@@ -56,7 +131,10 @@ SharedMemoryMapView::SharedMemoryMapView(SharedMemoryMapView&& sharedMemoryMapVi
     m_fdSharedMemory(std::exchange(sharedMemoryMapView.m_fdSharedMemory, INVALID_FD_VALUE)),
     m_sharedMemoryMapName(std::exchange(sharedMemoryMapView.m_sharedMemoryMapName, nullptr)),
     Buffer(std::exchange(sharedMemoryMapView.Buffer, nullptr)),
-    CleanupOnClose(std::exchange(sharedMemoryMapView.CleanupOnClose, 0))
+    CleanupOnClose(std::exchange(sharedMemoryMapView.CleanupOnClose, 0)),
+    UseHugePages(sharedMemoryMapView.UseHugePages),
+    m_isHugeTlbFsFile(std::exchange(sharedMemoryMapView.m_isHugeTlbFsFile, false)),
+    m_isAnonymous(std::exchange(sharedMemoryMapView.m_isAnonymous, false))
 {
 }
 
@@ -70,10 +148,12 @@ SharedMemoryMapView::SharedMemoryMapView(SharedMemoryMapView&& sharedMemoryMapVi
 //  HRESULT.
 //
 // NOTES:
+//  Removes the existing shared memory, both the POSIX shared memory object and the hugetlbfs file.
 //
 HRESULT SharedMemoryMapView::Create(const char* const sharedMemoryMapName, size_t memSize) noexcept
 {
     shm_unlink(sharedMemoryMapName);
+    UnlinkHugeTlbFsFile(sharedMemoryMapName);
 
     m_sharedMemoryMapName = strdup(sharedMemoryMapName);
     if (m_sharedMemoryMapName == nullptr)
@@ -81,7 +161,7 @@ HRESULT SharedMemoryMapView::Create(const char* const sharedMemoryMapName, size_
         return E_OUTOFMEMORY;
     }
 
-    m_fdSharedMemory = shm_open(sharedMemoryMapName, O_EXCL | O_CREAT | O_RDWR, S_IRUSR | S_IWUSR);
+    CreateSharedMemory(O_EXCL | O_CREAT | O_RDWR);
 
     return MapMemoryView(memSize);
 }
@@ -93,9 +173,13 @@ HRESULT SharedMemoryMapView::Create(const char* const sharedMemoryMapName, size_
 //  Creates or opens a shared memory map view.
 //
 // RETURNS:
-//  HRESULT.
+//  S_OK if created a new shared memory view.
+//  S_FALSE if we open existing shared memory view.
 //
 // NOTES:
+//  If the shared memory already exists, the view uses its current size.
+//  Resizing the shared memory would invalidate the views mapped by other processes.
+//  The existing shared memory is used regardless of UseHugePages, so all the processes map the same memory.
 //
 HRESULT SharedMemoryMapView::CreateOrOpen(const char* const sharedMemoryMapName, size_t memSize) noexcept
 {
@@ -105,9 +189,33 @@ HRESULT SharedMemoryMapView::CreateOrOpen(const char* const sharedMemoryMapName,
         return E_OUTOFMEMORY;
     }
 
-    m_fdSharedMemory = shm_open(sharedMemoryMapName, O_CREAT | O_RDWR, S_IRUSR | S_IWUSR);
+    OpenExistingSharedMemory();
 
-    return MapMemoryView(memSize);
+    if (m_fdSharedMemory == INVALID_FD_VALUE)
+    {
+        CreateSharedMemory(O_CREAT | O_RDWR);
+    }
+
+    struct stat statBuffer = { 0 };
+    if (m_fdSharedMemory != INVALID_FD_VALUE &&
+        fstat(m_fdSharedMemory, &statBuffer) != -1 &&
+        statBuffer.st_size != 0)
+    {
+        // Use the size of the existing shared memory.
+        //
+        memSize = 0;
+    }
+
+    HRESULT hr = MapMemoryView(memSize);
+
+    if (SUCCEEDED(hr) && memSize == 0)
+    {
+        // Return S_FALSE, we opened existing shared memory view.
+        //
+        hr = S_FALSE;
+    }
+
+    return hr;
 }
 
 //----------------------------------------------------------------------------
@@ -129,24 +237,156 @@ HRESULT SharedMemoryMapView::Open(const char* const sharedMemoryMapName) noexcep
         return E_OUTOFMEMORY;
     }
 
-    m_fdSharedMemory = shm_open(sharedMemoryMapName, O_CREAT | O_RDWR, S_IRUSR | S_IWUSR);
+    OpenExistingSharedMemory();
+
+    return MapMemoryView(0 /* memSize */);
+}
+
+//----------------------------------------------------------------------------
+// NAME: SharedMemoryMapView::CreateAnonymous
+//
+// PURPOSE:
+//  Creates an anonymous shared memory map view.
+//
+// RETURNS:
+//  HRESULT.
+//
+// NOTES:
+//  The shared memory is a memfd, the name is only visible in /proc/<pid>/fd and /proc/<pid>/maps.
+//  Another process maps the memory using the file descriptor (see OpenFileDescriptor).
+//  The memory is released when the last process closes the file descriptor and unmaps the view,
+//  there is nothing to unlink, even if the process crashes.
+//  If huge pages are requested, the memfd is created on the internal hugetlbfs mount,
+//  if there are not enough free huge pages, the view falls back to the regular memfd with transparent huge pages.
+//
+HRESULT SharedMemoryMapView::CreateAnonymous(const char* const sharedMemoryMapName, size_t memSize) noexcept
+{
+    m_sharedMemoryMapName = strdup(sharedMemoryMapName);
+    if (m_sharedMemoryMapName == nullptr)
+    {
+        return E_OUTOFMEMORY;
+    }
+
+    m_isAnonymous = true;
+
+    if (UseHugePages)
+    {
+        m_fdSharedMemory = memfd_create(m_sharedMemoryMapName, MFD_CLOEXEC | MFD_HUGETLB);
+        m_isHugeTlbFsFile = (m_fdSharedMemory != INVALID_FD_VALUE);
+    }
+
     if (m_fdSharedMemory == INVALID_FD_VALUE)
     {
-        return HRESULT_FROM_ERRNO(errno);
+        m_fdSharedMemory = memfd_create(m_sharedMemoryMapName, MFD_CLOEXEC);
     }
 
+    return MapMemoryView(memSize);
+}
+
+//----------------------------------------------------------------------------
+// NAME: SharedMemoryMapView::OpenFileDescriptor
+//
+// PURPOSE:
+//  Opens an anonymous shared memory map view from the file descriptor received from another process.
+//
+// RETURNS:
+//  HRESULT.
+//
+// NOTES:
+//  The view takes the ownership of the file descriptor and maps the whole shared memory.
+//
+HRESULT SharedMemoryMapView::OpenFileDescriptor(int fdSharedMemory) noexcept
+{
+    if (fdSharedMemory == INVALID_FD_VALUE)
+    {
+        return E_INVALIDARG;
+    }
+
+    m_fdSharedMemory = fdSharedMemory;
+    m_isAnonymous = true;
+
+    struct statfs statFsBuffer = { 0 };
+    m_isHugeTlbFsFile = fstatfs(m_fdSharedMemory, &statFsBuffer) != -1 && statFsBuffer.f_type == HUGETLBFS_MAGIC;
+
     return MapMemoryView(0 /* memSize */);
 }
 
+//----------------------------------------------------------------------------
+// NAME: SharedMemoryMapView::OpenExistingSharedMemory
+//
+// PURPOSE:
+//  Opens an existing shared memory.
+//
+// NOTES:
+//  A file on hugetlbfs takes precedence over the POSIX shared memory object,
+//  the process which created the shared memory decided whether to use huge pages.
+//
+void SharedMemoryMapView::OpenExistingSharedMemory() noexcept
+{
+    m_fdSharedMemory = OpenHugeTlbFsFile(m_sharedMemoryMapName, O_RDWR);
+    if (m_fdSharedMemory != INVALID_FD_VALUE)
+    {
+        m_isHugeTlbFsFile = true;
+        return;
+    }
+
+    m_fdSharedMemory = shm_open(m_sharedMemoryMapName, O_RDWR, S_IRUSR | S_IWUSR);
+}
+
+//----------------------------------------------------------------------------
+// NAME: SharedMemoryMapView::CreateSharedMemory
+//
+// PURPOSE:
+//  Creates a new shared memory.
+//
+// NOTES:
+//  If huge pages are requested, tries to create the file on hugetlbfs first.
+//  Otherwise (or if hugetlbfs is not mounted) creates the POSIX shared memory object.
+//
+void SharedMemoryMapView::CreateSharedMemory(int openFlags) noexcept
+{
+    if (UseHugePages)
+    {
+        m_fdSharedMemory = OpenHugeTlbFsFile(m_sharedMemoryMapName, openFlags);
+        if (m_fdSharedMemory != INVALID_FD_VALUE)
+        {
+            m_isHugeTlbFsFile = true;
+            return;
+        }
+    }
+
+    m_fdSharedMemory = shm_open(m_sharedMemoryMapName, openFlags, S_IRUSR | S_IWUSR);
+}
+
+//----------------------------------------------------------------------------
+// NAME: SharedMemoryMapView::MapMemoryView
+//
+// PURPOSE:
+//  Maps the shared memory into the process address space.
+//
+// RETURNS:
+//  HRESULT.
+//
+// NOTES:
+//  If memSize is zero, maps the existing shared memory, otherwise sets the size of the new shared memory.
+//  The new size is rounded up to the page size, the huge page size if huge pages are requested.
+//  If the hugetlbfs file cannot be mapped (there are not enough free huge pages),
+//  falls back to the POSIX shared memory object with transparent huge pages.
+//
 HRESULT SharedMemoryMapView::MapMemoryView(size_t memSize) noexcept
 {
     if (m_fdSharedMemory == INVALID_FD_VALUE)
     {
-        return HRESULT_FROM_ERRNO(errno);
+        HRESULT hr = HRESULT_FROM_ERRNO(errno);
+        Close();
+
+        return hr;
     }
 
     HRESULT hr = S_OK;
 
+    const size_t requestedMemSize = memSize;
+
     if (memSize == 0)
     {
         // Obtain the size of the shared map.
@@ -161,6 +401,24 @@ HRESULT SharedMemoryMapView::MapMemoryView(size_t memSize) noexcept
             hr = HRESULT_FROM_ERRNO(errno);
         }
     }
+    else
+    {
+        // Round the size up to the page size. The block size of hugetlbfs file is the huge page size.
+        //
+        size_t pageSize = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+
+        struct stat statBuffer = { 0 };
+        if (m_isHugeTlbFsFile && fstat(m_fdSharedMemory, &statBuffer) != -1)
+        {
+            pageSize = static_cast<size_t>(statBuffer.st_blksize);
+        }
+        else if (UseHugePages)
+        {
+            pageSize = TransparentHugePageSize;
+        }
+
+        memSize = (memSize + pageSize - 1) / pageSize * pageSize;
+    }
 
     if (SUCCEEDED(hr))
     {
@@ -177,6 +435,14 @@ HRESULT SharedMemoryMapView::MapMemoryView(size_t memSize) noexcept
         {
             Buffer.Pointer = reinterpret_cast<byte*>(pointer);
             MemSize = memSize;
+
+            if (UseHugePages && !m_isHugeTlbFsFile)
+            {
+                // Request transparent huge pages, fails if they are disabled for the shared memory.
+                // The view remains usable with the regular pages.
+                //
+                madvise(pointer, memSize, MADV_HUGEPAGE);
+            }
         }
         else
         {
@@ -184,6 +450,28 @@ HRESULT SharedMemoryMapView::MapMemoryView(size_t memSize) noexcept
         }
     }
 
+    if (FAILED(hr) && m_isHugeTlbFsFile && requestedMemSize != 0)
+    {
+        // We created the hugetlbfs file, but there are not enough free huge pages.
+        // Remove the file and use the POSIX shared memory object (or the regular memfd) instead.
+        //
+        close(m_fdSharedMemory);
+        m_isHugeTlbFsFile = false;
+
+        if (m_isAnonymous)
+        {
+            m_fdSharedMemory = memfd_create(m_sharedMemoryMapName, MFD_CLOEXEC);
+        }
+        else
+        {
+            UnlinkHugeTlbFsFile(m_sharedMemoryMapName);
+
+            m_fdSharedMemory = shm_open(m_sharedMemoryMapName, O_CREAT | O_RDWR, S_IRUSR | S_IWUSR);
+        }
+
+        return MapMemoryView(requestedMemSize);
+    }
+
     if (FAILED(hr))
     {
         Close();
@@ -192,6 +480,45 @@ HRESULT SharedMemoryMapView::MapMemoryView(size_t memSize) noexcept
     return hr;
 }
 
+//----------------------------------------------------------------------------
+// NAME: SharedMemoryMapView::Prefault
+//
+// PURPOSE:
+//  Touches all the pages of the view and optionally locks them in the memory.
+//
+// RETURNS:
+//  HRESULT.
+//
+// NOTES:
+//  Avoids the page faults on the first access to the shared memory (e.g. the first message sent to the channel).
+//  Locking fails if the locked memory exceeds RLIMIT_MEMLOCK (see ulimit -l), unless the process has CAP_IPC_LOCK.
+//  The memory is unlocked when the view is unmapped.
+//
+HRESULT SharedMemoryMapView::Prefault(bool lockMemory) noexcept
+{
+    if (Buffer.Pointer == nullptr)
+    {
+        return E_NOT_SET;
+    }
+
+    const size_t pageSize = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+
+    // Touch every page with an atomic no-op write, so the pages are mapped writable
+    // without changing the content other processes might be using.
+    //
+    for (size_t offset = 0; offset < MemSize; offset += pageSize)
+    {
+        reinterpret_cast<std::atomic<uint32_t>*>(Buffer.Pointer + offset)->fetch_or(0, std::memory_order_relaxed);
+    }
+
+    if (lockMemory && mlock(Buffer.Pointer, MemSize) == -1)
+    {
+        return HRESULT_FROM_ERRNO(errno);
+    }
+
+    return S_OK;
+}
+
 //----------------------------------------------------------------------------
 // NAME: SharedMemoryMapView::Close
 //
@@ -215,15 +542,25 @@ void SharedMemoryMapView::Close()
 
         if (CleanupOnClose)
         {
-            if (m_sharedMemoryMapName != nullptr)
+            if (m_sharedMemoryMapName != nullptr && !m_isAnonymous)
             {
-                shm_unlink(m_sharedMemoryMapName);
+                if (m_isHugeTlbFsFile)
+                {
+                    UnlinkHugeTlbFsFile(m_sharedMemoryMapName);
+                }
+                else
+                {
+                    shm_unlink(m_sharedMemoryMapName);
+                }
             }
 
             CleanupOnClose = false;
         }
     }
 
+    m_isHugeTlbFsFile = false;
+    m_isAnonymous = false;
+
     if (m_sharedMemoryMapName != nullptr)
     {
         free(m_sharedMemoryMapName);
@@ -43,11 +43,42 @@ public:
     _Check_return_
     HRESULT CreateOrOpen(const char* const sharedMemoryMapName, size_t memSize) noexcept;
 
+    // Creates an anonymous shared memory view, the memory is shared by passing its file descriptor to another process.
+    //
+    _Check_return_
+    HRESULT CreateAnonymous(const char* const sharedMemoryMapName, size_t memSize) noexcept;
+
+    // Opens an anonymous shared memory view from the file descriptor received from another process.
+    //
+    _Check_return_
+    HRESULT OpenFileDescriptor(int fdSharedMemory) noexcept;
+
+    // Touches all the pages of the view and optionally locks them in the memory.
+    //
+    _Check_return_
+    HRESULT Prefault(bool lockMemory) noexcept;
+
     // Closes a shared memory view.
     //
     void Close();
 
+    // Returns true if the shared memory is a file on hugetlbfs.
+    //
+    bool IsHugeTlbFsFile() const { return m_isHugeTlbFsFile; }
+
+    // Returns the file descriptor of the shared memory.
+    //
+    int FileDescriptor() const { return m_fdSharedMemory; }
+
 private:
+    // Opens an existing shared memory, a file on hugetlbfs takes precedence over the POSIX shared memory object.
+    //
+    void OpenExistingSharedMemory() noexcept;
+
+    // Creates a new shared memory, on hugetlbfs if huge pages are requested.
+    //
+    void CreateSharedMemory(int openFlags) noexcept;
+
     _Check_return_
     HRESULT MapMemoryView(size_t memSize) noexcept;
 
@@ -59,9 +90,21 @@ public:
     //
     bool CleanupOnClose;
 
+    // Indicates if the new shared memory should be backed by huge pages.
+    // Set before creating the view. The shared memory is created on hugetlbfs if it is mounted and has free huge pages,
+    // otherwise the view requests transparent huge pages with madvise(MADV_HUGEPAGE).
+    // The size of the new shared memory is rounded up to the huge page size.
+    //
+    bool UseHugePages;
+
 private:
     int m_fdSharedMemory;
     char* m_sharedMemoryMapName;
+    bool m_isHugeTlbFsFile;
+
+    // Anonymous shared memory (memfd) has no name to unlink.
+    //
+    bool m_isAnonymous;
 };
 
 }
@@ -29,7 +29,8 @@ SharedMemoryMapView::SharedMemoryMapView() noexcept
   : MemSize(0),
     m_hMapFile(nullptr),
     Buffer(nullptr),
-    CleanupOnClose(false)
+    CleanupOnClose(false),
+    UseHugePages(false)
 {
 }
 
@@ -43,7 +44,8 @@ SharedMemoryMapView::SharedMemoryMapView(SharedMemoryMapView&& sharedMemoryMapVi
   : MemSize(std::exchange(sharedMemoryMapView.MemSize, 0)),
     m_hMapFile(std::exchange(sharedMemoryMapView.m_hMapFile, nullptr)),
     Buffer(std::exchange(sharedMemoryMapView.Buffer, nullptr)),
-    CleanupOnClose(std::exchange(sharedMemoryMapView.CleanupOnClose, 0))
+    CleanupOnClose(std::exchange(sharedMemoryMapView.CleanupOnClose, 0)),
+    UseHugePages(sharedMemoryMapView.UseHugePages)
 {
 }
 
@@ -239,6 +241,48 @@ HRESULT SharedMemoryMapView::MapMemoryView(size_t memSize) noexcept
     return hr;
 }
 
+//----------------------------------------------------------------------------
+// NAME: SharedMemoryMapView::Prefault
+//
+// PURPOSE:
+//  Touches all the pages of the view and optionally locks them in the memory.
+//
+// RETURNS:
+//  HRESULT.
+//
+// NOTES:
+//  Avoids the page faults on the first access to the shared memory (e.g. the first message sent to the channel).
+//  Locking fails if the locked memory exceeds the minimum working set size of the process.
+//  The memory is unlocked when the view is unmapped.
+//
+HRESULT SharedMemoryMapView::Prefault(bool lockMemory) noexcept
+{
+    if (Buffer.Pointer == nullptr)
+    {
+        return E_NOT_SET;
+    }
+
+    SYSTEM_INFO systemInfo;
+    GetSystemInfo(&systemInfo);
+
+    const size_t pageSize = systemInfo.dwPageSize;
+
+    // Touch every page with an atomic no-op write, so the pages are mapped writable
+    // without changing the content other processes might be using.
+    //
+    for (size_t offset = 0; offset < MemSize; offset += pageSize)
+    {
+        reinterpret_cast<std::atomic<uint32_t>*>(Buffer.Pointer + offset)->fetch_or(0, std::memory_order_relaxed);
+    }
+
+    if (lockMemory && !VirtualLock(Buffer.Pointer, MemSize))
+    {
+        return HRESULT_FROM_WIN32(GetLastError());
+    }
+
+    return S_OK;
+}
+
 //----------------------------------------------------------------------------
 // NAME: SharedMemoryMapView::Close
 //
@@ -52,6 +52,11 @@ public:
     _Check_return_
     HRESULT CreateOrOpen(const char* const sharedMemoryMapName, size_t memSize) noexcept;
 
+    // Touches all the pages of the view and optionally locks them in the memory.
+    //
+    _Check_return_
+    HRESULT Prefault(bool lockMemory) noexcept;
+
     // Closes a shared memory handle.
     //
     void Close();
@@ -69,6 +74,11 @@ public:
     //
     bool CleanupOnClose;
 
+    // Indicates if the new shared memory should be backed by huge pages.
+    // Not supported on Windows, the large pages require SeLockMemoryPrivilege.
+    //
+    bool UseHugePages;
+
 private:
     HANDLE m_hMapFile;
 };
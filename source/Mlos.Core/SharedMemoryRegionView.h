@@ -45,6 +45,13 @@ public:
     _Check_return_
     HRESULT Open(const char* const sharedMemoryMapName) noexcept;
 
+#ifndef _WIN64
+    // Creates an anonymous shared memory view.
+    //
+    _Check_return_
+    HRESULT CreateAnonymous(const char* const sharedMemoryMapName, size_t memSize) noexcept;
+#endif
+
     T& MemoryRegion()
     {
         return *(reinterpret_cast<T*>(Buffer.Pointer));
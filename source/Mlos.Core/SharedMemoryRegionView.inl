@@ -54,6 +54,22 @@ HRESULT SharedMemoryRegionView<T>::CreateOrOpen(const char* const sharedMemoryMa
     return hr;
 }
 
+#ifndef _WIN64
+template<typename T>
+HRESULT SharedMemoryRegionView<T>::CreateAnonymous(const char* const sharedMemoryMapName, size_t memSize) noexcept
+{
+    HRESULT hr = SharedMemoryMapView::CreateAnonymous(sharedMemoryMapName, memSize);
+    if (FAILED(hr))
+    {
+        return hr;
+    }
+
+    InitializeMemoryRegionView();
+
+    return hr;
+}
+#endif
+
 template<typename T>
 HRESULT SharedMemoryRegionView<T>::Open(const char* const sharedMemoryMapName) noexcept
 {
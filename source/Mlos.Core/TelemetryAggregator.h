@@ -0,0 +1,151 @@
+//*********************************************************************
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License. See License.txt in the project root
+// for license information.
+//
+// @File: TelemetryAggregator.h
+//
+// Purpose:
+//      <description>
+//
+// Notes:
+//      <special-instructions>
+//
+//*********************************************************************
+
+#pragma once
+
+namespace Mlos
+{
+namespace Core
+{
+class MlosContext;
+
+//----------------------------------------------------------------------------
+// NAME: TelemetryAggregator
+//
+// PURPOSE:
+//  Aggregates the telemetry messages of a component config into summary messages.
+//  Instead of every message, the agent receives one summary per config id per window.
+//
+// NOTES:
+//  TSummary is a codegen message marked with TelemetrySummary attribute, codegen creates the functions
+//  initializing, accumulating and merging the summaries (ObjectAggregation namespace).
+//
+//  The messages are accumulated in per processor slots, so the threads running on different processors
+//  do not share a cache line. Each slot keeps the summary of a single config id; when the agent updates
+//  the component config, the summary of the previous config id is sent first.
+//
+//  The window ends after the given time or the given number of messages, whichever comes first (zero disables the limit).
+//  The window is checked when a message is accumulated, so the component should call Flush before it stops
+//  sending telemetry.
+//
+template<typename TMessage, typename TSummary>
+class TelemetryAggregator
+{
+public:
+    // Number of the accumulator slots, must be a power of two.
+    //
+    static constexpr uint32_t SlotCount = 16;
+
+    // Maximum number of messages a slot accumulates before it updates the window message count.
+    //
+    static constexpr uint32_t WindowCountBatchSize = 64;
+
+    template<typename T>
+    TelemetryAggregator(
+        MlosContext& mlosContext,
+        const ComponentConfig<T>& componentConfig,
+        uint32_t windowLengthInMilliseconds,
+        uint32_t windowMessageCount) noexcept;
+
+    // Adds the message to the summary of the current window.
+    //
+    inline void Accumulate(const TMessage& message);
+
+    // Sends the summaries of the current window and starts a new window.
+    //
+    inline void Flush();
+
+    // Returns the number of messages in the sent summaries.
+    //
+    uint64_t AggregatedMessageCount() const
+    {
+        return m_aggregatedCount.load(std::memory_order_relaxed);
+    }
+
+    uint64_t SentSummaryCount() const
+    {
+        return m_sentCount.load(std::memory_order_relaxed);
+    }
+
+private:
+    // Accumulator slot, protected by its own lock.
+    //
+    struct alignas(64) AggregationSlot
+    {
+        std::atomic<bool> Lock;
+        uint32_t ConfigId;
+        uint32_t MessageCount;
+        uint32_t UncountedMessageCount;
+        TSummary Summary;
+    };
+
+    // Returns the id of the component config located in the shared memory.
+    //
+    template<typename T>
+    static uint32_t GetSharedConfigId(const void* componentConfig);
+
+    // Returns true if the current window has ended.
+    //
+    inline bool IsWindowCompleted() const;
+
+    // Sends the summaries if no other thread is sending them.
+    //
+    inline void TryFlush();
+
+    inline void FlushSlots();
+
+    inline void SendSummary(const TSummary& summary);
+
+    static inline void AcquireLock(std::atomic<bool>& lock);
+
+    static inline void ReleaseLock(std::atomic<bool>& lock);
+
+private:
+    MlosContext& m_mlosContext;
+
+    // Component config the messages are aggregated with.
+    //
+    const void* m_componentConfig;
+    uint32_t (*m_getSharedConfigId)(const void* componentConfig);
+
+    // Window limits.
+    //
+    const uint64_t m_windowLengthInNanoseconds;
+    const uint32_t m_maxWindowMessageCount;
+    const uint32_t m_windowCountBatchSize;
+
+    // Current window state.
+    //
+    std::atomic<uint64_t> m_windowEnd;
+    std::atomic<uint64_t> m_windowMessageCount;
+
+    // Number of messages in the sent summaries and number of sent summaries.
+    //
+    std::atomic<uint64_t> m_aggregatedCount;
+    std::atomic<uint64_t> m_sentCount;
+
+    // Held by the thread sending the summaries.
+    //
+    std::atomic<bool> m_flushLock;
+
+    AggregationSlot m_slots[SlotCount];
+
+    // Summaries merged by config id, protected by the flush lock.
+    //
+    uint32_t m_flushConfigIds[SlotCount];
+    TSummary m_flushSummaries[SlotCount];
+};
+}
+}
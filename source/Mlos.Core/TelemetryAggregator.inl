@@ -0,0 +1,343 @@
+//*********************************************************************
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License. See License.txt in the project root
+// for license information.
+//
+// @File: TelemetryAggregator.inl
+//
+// Purpose:
+//      <description>
+//
+// Notes:
+//      <special-instructions>
+//
+//*********************************************************************
+
+#pragma once
+
+namespace Mlos
+{
+namespace Core
+{
+//----------------------------------------------------------------------------
+// NAME: TelemetryAggregator::Constructor.
+//
+// PURPOSE:
+//  Creates the aggregator of the telemetry messages of the component config.
+//
+// NOTES:
+//  The component config must be registered first and must outlive the aggregator.
+//
+template<typename TMessage, typename TSummary>
+template<typename T>
+TelemetryAggregator<TMessage, TSummary>::TelemetryAggregator(
+    MlosContext& mlosContext,
+    const ComponentConfig<T>& componentConfig,
+    uint32_t windowLengthInMilliseconds,
+    uint32_t windowMessageCount) noexcept
+  : m_mlosContext(mlosContext),
+    m_componentConfig(&componentConfig),
+    m_getSharedConfigId(&TelemetryAggregator::GetSharedConfigId<T>),
+    m_windowLengthInNanoseconds(static_cast<uint64_t>(windowLengthInMilliseconds) * 1000000),
+    m_maxWindowMessageCount(windowMessageCount),
+    m_windowCountBatchSize(std::max<uint32_t>(std::min(windowMessageCount / SlotCount, WindowCountBatchSize), 1)),
+    m_windowEnd(MlosPlatform::TimestampInNanoseconds() + m_windowLengthInNanoseconds),
+    m_windowMessageCount(0),
+    m_aggregatedCount(0),
+    m_sentCount(0),
+    m_flushLock(false)
+{
+    for (AggregationSlot& slot : m_slots)
+    {
+        slot.Lock.store(false, std::memory_order_relaxed);
+        slot.ConfigId = 0;
+        slot.MessageCount = 0;
+        slot.UncountedMessageCount = 0;
+    }
+}
+
+//----------------------------------------------------------------------------
+// NAME: TelemetryAggregator::Accumulate
+//
+// PURPOSE:
+//  Adds the message to the summary of the current window.
+//
+// RETURNS:
+//  Nothing.
+//
+// NOTES:
+//  Nothing is accumulated if the agent has not subscribed the summary message.
+//  The message is added to the slot of the current processor. If the slot holds the summary of another config id,
+//  the summary is copied out and sent after the slot lock is released.
+//  The slots update the shared window message count in batches, so the count based window might include
+//  up to SlotCount * WindowCountBatchSize more messages.
+//
+template<typename TMessage, typename TSummary>
+inline void TelemetryAggregator<TMessage, TSummary>::Accumulate(const TMessage& message)
+{
+    if (!m_mlosContext.IsTelemetryMessageSubscribed<TSummary>())
+    {
+        // The agent does not process the summaries.
+        //
+        return;
+    }
+
+    const uint32_t configId = m_getSharedConfigId(m_componentConfig);
+
+    AggregationSlot& slot = m_slots[MlosPlatform::CurrentProcessorIndex() & (SlotCount - 1)];
+
+    bool hasPreviousSummary = false;
+    TSummary previousSummary;
+
+    AcquireLock(slot.Lock);
+
+    if (slot.MessageCount != 0 && slot.ConfigId != configId)
+    {
+        // The agent has updated the component config, take the summary of the previous config.
+        //
+        previousSummary = slot.Summary;
+        hasPreviousSummary = true;
+        m_aggregatedCount.fetch_add(slot.MessageCount, std::memory_order_relaxed);
+        slot.MessageCount = 0;
+    }
+
+    if (slot.MessageCount == 0)
+    {
+        ObjectAggregation::Initialize(slot.Summary, configId);
+        slot.ConfigId = configId;
+    }
+
+    ObjectAggregation::Accumulate(slot.Summary, message);
+    slot.MessageCount++;
+
+    if (m_maxWindowMessageCount != 0 && ++slot.UncountedMessageCount == m_windowCountBatchSize)
+    {
+        m_windowMessageCount.fetch_add(slot.UncountedMessageCount, std::memory_order_relaxed);
+        slot.UncountedMessageCount = 0;
+    }
+
+    ReleaseLock(slot.Lock);
+
+    if (hasPreviousSummary)
+    {
+        SendSummary(previousSummary);
+    }
+
+    if (IsWindowCompleted())
+    {
+        TryFlush();
+    }
+}
+
+//----------------------------------------------------------------------------
+// NAME: TelemetryAggregator::Flush
+//
+// PURPOSE:
+//  Sends the summaries of the current window and starts a new window.
+//
+// RETURNS:
+//  Nothing.
+//
+// NOTES:
+//  Components call it before they stop sending telemetry, otherwise the summaries are sent at the end of the window.
+//
+template<typename TMessage, typename TSummary>
+inline void TelemetryAggregator<TMessage, TSummary>::Flush()
+{
+    AcquireLock(m_flushLock);
+    FlushSlots();
+    ReleaseLock(m_flushLock);
+}
+
+//----------------------------------------------------------------------------
+// NAME: TelemetryAggregator::TryFlush
+//
+// PURPOSE:
+//  Sends the summaries of the completed window.
+//
+// RETURNS:
+//  Nothing.
+//
+// NOTES:
+//  If another thread is already sending the summaries, returns immediately.
+//
+template<typename TMessage, typename TSummary>
+inline void TelemetryAggregator<TMessage, TSummary>::TryFlush()
+{
+    if (m_flushLock.exchange(true, std::memory_order_acquire))
+    {
+        return;
+    }
+
+    // Another thread might have started a new window.
+    //
+    if (IsWindowCompleted())
+    {
+        FlushSlots();
+    }
+
+    ReleaseLock(m_flushLock);
+}
+
+//----------------------------------------------------------------------------
+// NAME: TelemetryAggregator::FlushSlots
+//
+// PURPOSE:
+//  Takes the summaries from the slots, merges the summaries of the same config id and sends them.
+//
+// RETURNS:
+//  Nothing.
+//
+// NOTES:
+//  The caller holds the flush lock.
+//
+template<typename TMessage, typename TSummary>
+inline void TelemetryAggregator<TMessage, TSummary>::FlushSlots()
+{
+    // Start a new window.
+    //
+    m_windowMessageCount.store(0, std::memory_order_relaxed);
+    m_windowEnd.store(MlosPlatform::TimestampInNanoseconds() + m_windowLengthInNanoseconds, std::memory_order_relaxed);
+
+    uint32_t summaryCount = 0;
+
+    for (AggregationSlot& slot : m_slots)
+    {
+        AcquireLock(slot.Lock);
+
+        if (slot.MessageCount != 0)
+        {
+            uint32_t summaryIndex = 0;
+
+            while (summaryIndex < summaryCount && m_flushConfigIds[summaryIndex] != slot.ConfigId)
+            {
+                summaryIndex++;
+            }
+
+            if (summaryIndex < summaryCount)
+            {
+                ObjectAggregation::Merge(m_flushSummaries[summaryIndex], slot.Summary);
+            }
+            else
+            {
+                m_flushConfigIds[summaryCount] = slot.ConfigId;
+                m_flushSummaries[summaryCount] = slot.Summary;
+                summaryCount++;
+            }
+
+            m_aggregatedCount.fetch_add(slot.MessageCount, std::memory_order_relaxed);
+
+            slot.MessageCount = 0;
+            slot.UncountedMessageCount = 0;
+        }
+
+        ReleaseLock(slot.Lock);
+    }
+
+    for (uint32_t summaryIndex = 0; summaryIndex < summaryCount; summaryIndex++)
+    {
+        SendSummary(m_flushSummaries[summaryIndex]);
+    }
+}
+
+//----------------------------------------------------------------------------
+// NAME: TelemetryAggregator::IsWindowCompleted
+//
+// PURPOSE:
+//  Checks if the current window has ended.
+//
+// RETURNS:
+//  True if the window time or the window message count has been reached.
+//
+// NOTES:
+//
+template<typename TMessage, typename TSummary>
+inline bool TelemetryAggregator<TMessage, TSummary>::IsWindowCompleted() const
+{
+    if (m_maxWindowMessageCount != 0 &&
+        m_windowMessageCount.load(std::memory_order_relaxed) >= m_maxWindowMessageCount)
+    {
+        return true;
+    }
+
+    return m_windowLengthInNanoseconds != 0 &&
+        MlosPlatform::TimestampInNanoseconds() >= m_windowEnd.load(std::memory_order_relaxed);
+}
+
+//----------------------------------------------------------------------------
+// NAME: TelemetryAggregator::SendSummary
+//
+// PURPOSE:
+//  Sends the summary message using telemetry channel.
+//
+// RETURNS:
+//  Nothing.
+//
+// NOTES:
+//  Summaries are not offered to the telemetry sampler of the component config.
+//
+template<typename TMessage, typename TSummary>
+inline void TelemetryAggregator<TMessage, TSummary>::SendSummary(const TSummary& summary)
+{
+    m_mlosContext.SendTelemetryMessage(summary);
+    m_sentCount.fetch_add(1, std::memory_order_relaxed);
+}
+
+//----------------------------------------------------------------------------
+// NAME: TelemetryAggregator::GetSharedConfigId
+//
+// PURPOSE:
+//  Returns the id of the component config located in the shared memory.
+//
+// RETURNS:
+//  Config id.
+//
+// NOTES:
+//
+template<typename TMessage, typename TSummary>
+template<typename T>
+uint32_t TelemetryAggregator<TMessage, TSummary>::GetSharedConfigId(const void* componentConfig)
+{
+    return static_cast<const ComponentConfig<T>*>(componentConfig)->SharedConfigId();
+}
+
+//----------------------------------------------------------------------------
+// NAME: TelemetryAggregator::AcquireLock
+//
+// PURPOSE:
+//  Acquires the slot or the flush lock.
+//
+// RETURNS:
+//  Nothing.
+//
+// NOTES:
+//  The slot locks are contended only by the threads running on the processors sharing the slot and by the flush.
+//
+template<typename TMessage, typename TSummary>
+inline void TelemetryAggregator<TMessage, TSummary>::AcquireLock(std::atomic<bool>& lock)
+{
+    while (lock.exchange(true, std::memory_order_acquire))
+    {
+        while (lock.load(std::memory_order_relaxed))
+        {
+            MlosPlatform::Pause();
+        }
+    }
+}
+
+//----------------------------------------------------------------------------
+// NAME: TelemetryAggregator::ReleaseLock
+//
+// PURPOSE:
+//  Releases the lock.
+//
+// RETURNS:
+//  Nothing.
+//
+template<typename TMessage, typename TSummary>
+inline void TelemetryAggregator<TMessage, TSummary>::ReleaseLock(std::atomic<bool>& lock)
+{
+    lock.store(false, std::memory_order_release);
+}
+}
+}
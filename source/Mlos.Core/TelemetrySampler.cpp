@@ -0,0 +1,540 @@
+//*********************************************************************
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License. See License.txt in the project root
+// for license information.
+//
+// @File: TelemetrySampler.cpp
+//
+// Purpose:
+//      <description>
+//
+// Notes:
+//      <special-instructions>
+//
+//*********************************************************************
+
+#include "Mlos.Core.h"
+
+namespace Mlos
+{
+namespace Core
+{
+//----------------------------------------------------------------------------
+// NAME: TelemetrySampler::Constructor.
+//
+// PURPOSE:
+//  Creates the sampler with the default config, all the messages are sent.
+//
+// NOTES:
+//  The sampler is active once it is registered with MlosContext::RegisterTelemetrySampler.
+//
+TelemetrySampler::TelemetrySampler(MlosContext& mlosContext) noexcept
+  : SamplingConfig(mlosContext),
+    m_mlosContext(mlosContext),
+    m_componentTypeIndex(0),
+    m_componentKeyHash(0),
+    m_configId(0),
+    m_policy(TelemetrySamplingPolicy::None),
+    m_sampleInterval(1),
+    m_reportInterval(0),
+    m_emissionIntervalInNanoseconds(0),
+    m_burstToleranceInNanoseconds(0),
+    m_reservoirSize(0),
+    m_reservoirPeriodInNanoseconds(0),
+    m_theoreticalArrivalTime(0),
+    m_reservoirPeriodEnd(0),
+    m_reservoirGeneration(0),
+    m_lock(false),
+    m_sendLock(false),
+    m_activeReservoirs(nullptr),
+    m_swappedReservoirs(nullptr)
+{
+    m_activeReservoirs.store(m_reservoirs[0], std::memory_order_relaxed);
+    m_swappedReservoirs = m_reservoirs[1];
+
+    for (CounterSlot& counterSlot : m_counterSlots)
+    {
+        counterSlot.OfferedCount.store(0, std::memory_order_relaxed);
+        counterSlot.SentCount.store(0, std::memory_order_relaxed);
+    }
+
+    for (auto& reservoirs : m_reservoirs)
+    {
+        for (Reservoir& reservoir : reservoirs)
+        {
+            reservoir.CodegenTypeIndex.store(0, std::memory_order_relaxed);
+            reservoir.MessageSize = 0;
+            reservoir.SendMessage = nullptr;
+            reservoir.OfferedCount.store(0, std::memory_order_relaxed);
+            reservoir.SlotMask = 0;
+        }
+    }
+
+    SamplingConfig.ComponentTypeIndex = 0;
+    SamplingConfig.ComponentKeyHash = 0;
+    SamplingConfig.Policy = TelemetrySamplingPolicy::None;
+    SamplingConfig.SampleInterval = 1;
+    SamplingConfig.RatePerSecond = 1000;
+    SamplingConfig.BurstSize = 1;
+    SamplingConfig.ReservoirSize = MaxReservoirSize;
+    SamplingConfig.ReservoirPeriodInMilliseconds = 1000;
+    SamplingConfig.ReportInterval = DefaultReportInterval;
+}
+
+//----------------------------------------------------------------------------
+// NAME: TelemetrySampler::Refresh
+//
+// PURPOSE:
+//  Reloads the sampling config from the shared memory.
+//
+// RETURNS:
+//  Nothing.
+//
+// NOTES:
+//  Before the new config is applied, the reservoirs are swapped out and the counts are captured,
+//  they are sent after the lock is released, so the agent can attribute them to the previous config id.
+//  If another thread is sending the reservoirs, the config is not reloaded, it is reloaded on the next offered message.
+//
+void TelemetrySampler::Refresh()
+{
+    if (!TryAcquireLock(m_sendLock))
+    {
+        return;
+    }
+
+    AcquireLock(m_lock);
+
+    const uint32_t configId = SamplingConfig.SharedConfigId();
+
+    bool hasPreviousConfig = false;
+    TelemetrySamplingReportMessage previousConfigReport = { 0 };
+
+    if (configId != m_configId.load(std::memory_order_relaxed))
+    {
+        if (m_configId.load(std::memory_order_relaxed) != 0)
+        {
+            SwapReservoirs();
+            previousConfigReport = CreateSamplingReport();
+            hasPreviousConfig = true;
+        }
+
+        SamplingConfig.Update();
+
+        const TelemetrySamplingConfig& config = SamplingConfig;
+
+        const uint64_t emissionIntervalInNanoseconds = (config.RatePerSecond != 0)
+            ? std::max<uint64_t>(1000000000ull / config.RatePerSecond, 1)
+            : 0;
+
+        m_sampleInterval.store(config.SampleInterval, std::memory_order_relaxed);
+        m_reportInterval.store(config.ReportInterval, std::memory_order_relaxed);
+        m_emissionIntervalInNanoseconds.store(emissionIntervalInNanoseconds, std::memory_order_relaxed);
+        m_burstToleranceInNanoseconds.store(
+            emissionIntervalInNanoseconds * (std::max<uint32_t>(config.BurstSize, 1) - 1),
+            std::memory_order_relaxed);
+        m_theoreticalArrivalTime.store(0, std::memory_order_relaxed);
+        m_reservoirSize.store(std::min(config.ReservoirSize, MaxReservoirSize), std::memory_order_relaxed);
+        m_reservoirPeriodInNanoseconds.store(
+            static_cast<uint64_t>(config.ReservoirPeriodInMilliseconds) * 1000000,
+            std::memory_order_relaxed);
+
+        StartReservoirPeriod(MlosPlatform::TimestampInNanoseconds());
+
+        m_policy.store(config.Policy, std::memory_order_relaxed);
+        m_configId.store(configId, std::memory_order_release);
+    }
+
+    ReleaseLock(m_lock);
+
+    if (hasPreviousConfig)
+    {
+        SendSwappedReservoirs();
+        m_mlosContext.SendTelemetryMessage(previousConfigReport);
+    }
+
+    ReleaseLock(m_sendLock);
+}
+
+//----------------------------------------------------------------------------
+// NAME: TelemetrySampler::TryAcquireToken
+//
+// PURPOSE:
+//  Takes a token from the token bucket.
+//
+// RETURNS:
+//  True if the message can be sent.
+//
+// NOTES:
+//  Implemented as the generic cell rate algorithm, the bucket state is a single theoretical arrival time.
+//  The message is sent if the theoretical arrival time is at most the burst tolerance ahead of the current time.
+//
+bool TelemetrySampler::TryAcquireToken()
+{
+    const uint64_t emissionIntervalInNanoseconds = m_emissionIntervalInNanoseconds.load(std::memory_order_relaxed);
+    if (emissionIntervalInNanoseconds == 0)
+    {
+        return false;
+    }
+
+    const uint64_t burstToleranceInNanoseconds = m_burstToleranceInNanoseconds.load(std::memory_order_relaxed);
+    const uint64_t timestamp = MlosPlatform::TimestampInNanoseconds();
+
+    uint64_t theoreticalArrivalTime = m_theoreticalArrivalTime.load(std::memory_order_relaxed);
+
+    while (true)
+    {
+        const uint64_t arrivalTime = std::max(theoreticalArrivalTime, timestamp);
+
+        if (arrivalTime - timestamp > burstToleranceInNanoseconds)
+        {
+            // The bucket is empty.
+            //
+            return false;
+        }
+
+        if (m_theoreticalArrivalTime.compare_exchange_weak(
+            theoreticalArrivalTime,
+            arrivalTime + emissionIntervalInNanoseconds,
+            std::memory_order_relaxed))
+        {
+            return true;
+        }
+    }
+}
+
+//----------------------------------------------------------------------------
+// NAME: TelemetrySampler::Flush
+//
+// PURPOSE:
+//  Sends the messages kept in the reservoirs.
+//
+// RETURNS:
+//  Nothing.
+//
+// NOTES:
+//  Components call it before they stop sending telemetry, otherwise the messages are sent at the end of the period.
+//  Waits for the thread sending the reservoirs of the previous period.
+//
+void TelemetrySampler::Flush()
+{
+    AcquireLock(m_sendLock);
+
+    AcquireLock(m_lock);
+    SwapReservoirs();
+    ReleaseLock(m_lock);
+
+    SendSwappedReservoirs();
+
+    ReleaseLock(m_sendLock);
+}
+
+//----------------------------------------------------------------------------
+// NAME: TelemetrySampler::FindReservoir
+//
+// PURPOSE:
+//  Finds the reservoir of the message type, or assigns a free reservoir to the type.
+//
+// RETURNS:
+//  Reservoir of the message type, nullptr if all the reservoirs are used by other types.
+//
+// NOTES:
+//  The reservoirs of the type are found without the lock, a free reservoir is assigned under the lock.
+//
+TelemetrySampler::Reservoir* TelemetrySampler::FindReservoir(
+    uint32_t codegenTypeIndex,
+    uint32_t messageSize,
+    SendReservoirMessageFunc sendMessage)
+{
+    Reservoir* reservoirs = m_activeReservoirs.load(std::memory_order_acquire);
+
+    for (uint32_t reservoirIndex = 0; reservoirIndex < MaxReservoirTypeCount; reservoirIndex++)
+    {
+        if (reservoirs[reservoirIndex].CodegenTypeIndex.load(std::memory_order_acquire) == codegenTypeIndex)
+        {
+            return &reservoirs[reservoirIndex];
+        }
+    }
+
+    AcquireLock(m_lock);
+
+    reservoirs = m_activeReservoirs.load(std::memory_order_relaxed);
+
+    Reservoir* reservoir = nullptr;
+
+    for (uint32_t reservoirIndex = 0; reservoirIndex < MaxReservoirTypeCount; reservoirIndex++)
+    {
+        const uint32_t reservoirCodegenTypeIndex = reservoirs[reservoirIndex].CodegenTypeIndex.load(std::memory_order_relaxed);
+
+        if (reservoirCodegenTypeIndex == codegenTypeIndex)
+        {
+            reservoir = &reservoirs[reservoirIndex];
+            break;
+        }
+
+        if (reservoirCodegenTypeIndex == 0)
+        {
+            // Assign the free reservoir to the message type.
+            //
+            reservoir = &reservoirs[reservoirIndex];
+            reservoir->MessageSize = messageSize;
+            reservoir->SendMessage = sendMessage;
+            reservoir->CodegenTypeIndex.store(codegenTypeIndex, std::memory_order_release);
+            break;
+        }
+    }
+
+    ReleaseLock(m_lock);
+
+    return reservoir;
+}
+
+//----------------------------------------------------------------------------
+// NAME: TelemetrySampler::SwapReservoirs
+//
+// PURPOSE:
+//  Swaps out the reservoirs of the current period and starts a new generation with empty reservoirs.
+//
+// RETURNS:
+//  Nothing.
+//
+// NOTES:
+//  The caller holds the send lock and the lock, the swapped out reservoirs are sent by SendSwappedReservoirs
+//  after the lock is released. The messages are counted as sent when they are swapped out.
+//
+void TelemetrySampler::SwapReservoirs()
+{
+    Reservoir* swappedReservoirs = m_activeReservoirs.load(std::memory_order_relaxed);
+    Reservoir* activeReservoirs = m_swappedReservoirs;
+
+    uint64_t sentCount = 0;
+
+    for (uint32_t reservoirIndex = 0; reservoirIndex < MaxReservoirTypeCount; reservoirIndex++)
+    {
+        for (uint64_t slotMask = swappedReservoirs[reservoirIndex].SlotMask; slotMask != 0; slotMask &= slotMask - 1)
+        {
+            sentCount++;
+        }
+
+        Reservoir& reservoir = activeReservoirs[reservoirIndex];
+        reservoir.CodegenTypeIndex.store(0, std::memory_order_relaxed);
+        reservoir.OfferedCount.store(0, std::memory_order_relaxed);
+        reservoir.SlotMask = 0;
+    }
+
+    CurrentCounterSlot().SentCount.fetch_add(sentCount, std::memory_order_relaxed);
+
+    m_swappedReservoirs = swappedReservoirs;
+    m_activeReservoirs.store(activeReservoirs, std::memory_order_release);
+    m_reservoirGeneration.fetch_add(1, std::memory_order_release);
+}
+
+//----------------------------------------------------------------------------
+// NAME: TelemetrySampler::SendSwappedReservoirs
+//
+// PURPOSE:
+//  Sends the messages kept in the swapped out reservoirs.
+//
+// RETURNS:
+//  Nothing.
+//
+// NOTES:
+//  The caller holds the send lock, but not the lock. The messages of the new period are kept meanwhile.
+//  The threads offering messages never wait for the send lock.
+//
+void TelemetrySampler::SendSwappedReservoirs()
+{
+    for (uint32_t reservoirIndex = 0; reservoirIndex < MaxReservoirTypeCount; reservoirIndex++)
+    {
+        Reservoir& reservoir = m_swappedReservoirs[reservoirIndex];
+
+        for (uint32_t slotIndex = 0; slotIndex < MaxReservoirSize; slotIndex++)
+        {
+            if ((reservoir.SlotMask & (static_cast<uint64_t>(1) << slotIndex)) != 0)
+            {
+                reservoir.SendMessage(m_mlosContext, reservoir.Buffer + slotIndex * reservoir.MessageSize);
+            }
+        }
+
+        reservoir.SlotMask = 0;
+    }
+}
+
+//----------------------------------------------------------------------------
+// NAME: TelemetrySampler::StartReservoirPeriod
+//
+// PURPOSE:
+//  Sets the end of the reservoir period.
+//
+// RETURNS:
+//  Nothing.
+//
+// NOTES:
+//  The caller holds the lock.
+//
+void TelemetrySampler::StartReservoirPeriod(uint64_t timestamp)
+{
+    m_reservoirPeriodEnd.store(
+        timestamp + m_reservoirPeriodInNanoseconds.load(std::memory_order_relaxed),
+        std::memory_order_release);
+}
+
+//----------------------------------------------------------------------------
+// NAME: TelemetrySampler::SendSamplingReport
+//
+// PURPOSE:
+//  Sends the number of offered and sent messages to the agent.
+//
+// RETURNS:
+//  Nothing.
+//
+// NOTES:
+//  The report is not counted as an offered message.
+//
+void TelemetrySampler::SendSamplingReport()
+{
+    m_mlosContext.SendTelemetryMessage(CreateSamplingReport());
+}
+
+//----------------------------------------------------------------------------
+// NAME: TelemetrySampler::CreateSamplingReport
+//
+// PURPOSE:
+//  Captures the number of offered and sent messages.
+//
+// RETURNS:
+//  Sampling report message.
+//
+TelemetrySamplingReportMessage TelemetrySampler::CreateSamplingReport() const
+{
+    TelemetrySamplingReportMessage msg = { 0 };
+    msg.ComponentTypeIndex = m_componentTypeIndex;
+    msg.ComponentKeyHash = m_componentKeyHash;
+    msg.ConfigId = m_configId.load(std::memory_order_relaxed);
+    msg.Policy = m_policy.load(std::memory_order_relaxed);
+    msg.SentCount = SentMessageCount();
+    msg.OfferedCount = OfferedMessageCount();
+
+    return msg;
+}
+
+//----------------------------------------------------------------------------
+// NAME: TelemetrySampler::EffectiveSamplingRate
+//
+// PURPOSE:
+//  Returns the ratio of the sent messages to the offered messages.
+//
+// RETURNS:
+//  Sampling rate, 1 if no messages have been offered.
+//
+// NOTES:
+//  Messages kept in the reservoirs are counted when they are swapped out to be sent.
+//
+double TelemetrySampler::EffectiveSamplingRate() const
+{
+    const uint64_t sentCount = SentMessageCount();
+    const uint64_t offeredCount = OfferedMessageCount();
+
+    return (offeredCount == 0) ? 1.0 : static_cast<double>(sentCount) / static_cast<double>(offeredCount);
+}
+
+//----------------------------------------------------------------------------
+// NAME: TelemetrySampler::OfferedMessageCount
+//
+// PURPOSE:
+//  Returns the number of the offered messages.
+//
+// RETURNS:
+//  Sum of the offered counts of all the counter slots.
+//
+// NOTES:
+//  The slots are not read atomically, the messages offered meanwhile might not be included.
+//
+uint64_t TelemetrySampler::OfferedMessageCount() const
+{
+    uint64_t offeredCount = 0;
+
+    for (const CounterSlot& counterSlot : m_counterSlots)
+    {
+        offeredCount += counterSlot.OfferedCount.load(std::memory_order_relaxed);
+    }
+
+    return offeredCount;
+}
+
+//----------------------------------------------------------------------------
+// NAME: TelemetrySampler::SentMessageCount
+//
+// PURPOSE:
+//  Returns the number of the sent messages.
+//
+// RETURNS:
+//  Sum of the sent counts of all the counter slots.
+//
+// NOTES:
+//  The callers read the sent count before the offered count, the messages offered meanwhile are not counted as sent.
+//
+uint64_t TelemetrySampler::SentMessageCount() const
+{
+    uint64_t sentCount = 0;
+
+    for (const CounterSlot& counterSlot : m_counterSlots)
+    {
+        sentCount += counterSlot.SentCount.load(std::memory_order_relaxed);
+    }
+
+    return sentCount;
+}
+
+//----------------------------------------------------------------------------
+// NAME: TelemetrySampler::AcquireLock
+//
+// PURPOSE:
+//  Acquires the spinlock.
+//
+// RETURNS:
+//  Nothing.
+//
+// NOTES:
+//  The lock protecting the reservoir buffers and the config reload is taken only by the selected reservoir messages,
+//  the reservoir swaps and the config updates. Messages are never sent while it is held.
+//
+void TelemetrySampler::AcquireLock(std::atomic<bool>& lock)
+{
+    while (lock.exchange(true, std::memory_order_acquire))
+    {
+        while (lock.load(std::memory_order_relaxed))
+        {
+            MlosPlatform::YieldThread();
+        }
+    }
+}
+
+//----------------------------------------------------------------------------
+// NAME: TelemetrySampler::TryAcquireLock
+//
+// PURPOSE:
+//  Acquires the spinlock if it is not held.
+//
+// RETURNS:
+//  True if the lock has been acquired.
+//
+bool TelemetrySampler::TryAcquireLock(std::atomic<bool>& lock)
+{
+    return !lock.load(std::memory_order_relaxed) && !lock.exchange(true, std::memory_order_acquire);
+}
+
+//----------------------------------------------------------------------------
+// NAME: TelemetrySampler::ReleaseLock
+//
+// PURPOSE:
+//  Releases the lock.
+//
+// RETURNS:
+//  Nothing.
+//
+void TelemetrySampler::ReleaseLock(std::atomic<bool>& lock)
+{
+    lock.store(false, std::memory_order_release);
+}
+}
+}
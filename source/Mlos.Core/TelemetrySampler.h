@@ -0,0 +1,228 @@
+//*********************************************************************
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License. See License.txt in the project root
+// for license information.
+//
+// @File: TelemetrySampler.h
+//
+// Purpose:
+//      <description>
+//
+// Notes:
+//      <special-instructions>
+//
+//*********************************************************************
+
+#pragma once
+
+namespace Mlos
+{
+namespace Core
+{
+class MlosContext;
+
+//----------------------------------------------------------------------------
+// NAME: TelemetrySampler
+//
+// PURPOSE:
+//  Selects the telemetry messages sent by a component config.
+//
+// NOTES:
+//  The sampling config is stored in the shared memory, the agent tunes it and increments the config id.
+//  The sampler checks the config id on every offered message and reloads the config when it changes.
+//  Rejected messages are not serialized.
+//  The sampler counts the offered and sent messages and periodically reports them with TelemetrySamplingReportMessage,
+//  so the agent can rescale the counts aggregated from the sampled messages.
+//  The messages are counted in per thread slots, so the threads offering messages do not share a cache line.
+//  The slot counts are summed when the counts are read.
+//
+//  In the reservoir mode, the sampler keeps a reservoir per message type with copies of the selected messages
+//  and sends them at the end of the period (or on Flush). The reservoirs are swapped out under the lock
+//  and sent after the lock is released, by a single thread. The other threads do not wait for the send.
+//  Messages with variable length data, too large for the reservoir buffer, or of more than MaxReservoirTypeCount types
+//  in a period, are sampled one in SampleInterval instead.
+//
+class TelemetrySampler
+{
+public:
+    // Maximum number of messages kept in the reservoir.
+    //
+    static constexpr uint32_t MaxReservoirSize = 64;
+
+    // Maximum number of message types kept in the reservoirs in a period.
+    //
+    static constexpr uint32_t MaxReservoirTypeCount = 4;
+
+    // Size of the reservoir buffer of a single message type.
+    //
+    static constexpr uint32_t ReservoirBufferSize = 4096;
+
+    // Default number of offered messages between the sampling reports.
+    //
+    static constexpr uint32_t DefaultReportInterval = 65536;
+
+    // Number of the counter slots, must be a power of two.
+    //
+    static constexpr uint32_t CounterSlotCount = 16;
+
+    TelemetrySampler(MlosContext& mlosContext) noexcept;
+
+    // Sends the messages kept in the reservoir.
+    //
+    void Flush();
+
+    // Sends the sampling report.
+    //
+    void SendSamplingReport();
+
+    // Returns the ratio of the sent messages to the offered messages.
+    //
+    double EffectiveSamplingRate() const;
+
+    uint64_t OfferedMessageCount() const;
+
+    uint64_t SentMessageCount() const;
+
+    // Reloads the sampling config from the shared memory.
+    //
+    void Refresh();
+
+public:
+    // Sampling config. The initial values are used if the agent has not created the shared config.
+    //
+    ComponentConfig<TelemetrySamplingConfig> SamplingConfig;
+
+private:
+    typedef void (*SendReservoirMessageFunc)(MlosContext& mlosContext, const byte* message);
+
+    // Number of the messages offered and sent by the threads assigned to the slot.
+    //
+    struct alignas(64) CounterSlot
+    {
+        std::atomic<uint64_t> OfferedCount;
+        std::atomic<uint64_t> SentCount;
+    };
+
+    // Copies of the selected messages of a single type.
+    //
+    struct Reservoir
+    {
+        // Type of the kept messages, zero if the reservoir is not used in the current period.
+        //
+        std::atomic<uint32_t> CodegenTypeIndex;
+        uint32_t MessageSize;
+        SendReservoirMessageFunc SendMessage;
+
+        // Number of the messages of the type offered in the current period.
+        //
+        std::atomic<uint64_t> OfferedCount;
+
+        // Occupied slots, protected by the lock.
+        //
+        uint64_t SlotMask;
+        alignas(64) byte Buffer[ReservoirBufferSize];
+    };
+
+    // Returns true if the message should be sent now.
+    //
+    template<typename TMessage>
+    inline bool ShouldSendMessage(const TMessage& message);
+
+    // Returns the counter slot assigned to the current thread.
+    //
+    inline CounterSlot& CurrentCounterSlot();
+
+    bool TryAcquireToken();
+
+    // Returns false if there is no reservoir left for the message type.
+    //
+    template<typename TMessage>
+    inline bool AddToReservoir(const TMessage& message);
+
+    template<typename TMessage>
+    static void SendReservoirMessage(MlosContext& mlosContext, const byte* message);
+
+    static void AcquireLock(std::atomic<bool>& lock);
+
+    static bool TryAcquireLock(std::atomic<bool>& lock);
+
+    static void ReleaseLock(std::atomic<bool>& lock);
+
+    Reservoir* FindReservoir(uint32_t codegenTypeIndex, uint32_t messageSize, SendReservoirMessageFunc sendMessage);
+
+    void SwapReservoirs();
+
+    void SendSwappedReservoirs();
+
+    TelemetrySamplingReportMessage CreateSamplingReport() const;
+
+    void StartReservoirPeriod(uint64_t timestamp);
+
+    // Returns a pseudo random value used to select the reservoir slot (SplitMix64 finalizer).
+    //
+    static inline uint64_t MixBits(uint64_t value)
+    {
+        value = (value ^ (value >> 30)) * 0xbf58476d1ce4e5b9ull;
+        value = (value ^ (value >> 27)) * 0x94d049bb133111ebull;
+        return value ^ (value >> 31);
+    }
+
+private:
+    MlosContext& m_mlosContext;
+
+    // Key of the component config, set when the sampler is registered.
+    //
+    uint32_t m_componentTypeIndex;
+    uint32_t m_componentKeyHash;
+
+    // Id of the loaded sampling config.
+    //
+    std::atomic<uint32_t> m_configId;
+
+    // Sampling parameters, loaded from the sampling config.
+    //
+    std::atomic<TelemetrySamplingPolicy> m_policy;
+    std::atomic<uint32_t> m_sampleInterval;
+    std::atomic<uint32_t> m_reportInterval;
+    std::atomic<uint64_t> m_emissionIntervalInNanoseconds;
+    std::atomic<uint64_t> m_burstToleranceInNanoseconds;
+    std::atomic<uint32_t> m_reservoirSize;
+    std::atomic<uint64_t> m_reservoirPeriodInNanoseconds;
+
+    // Number of offered and sent messages.
+    //
+    CounterSlot m_counterSlots[CounterSlotCount];
+
+    // Token bucket state, the time when the bucket is full again (generic cell rate algorithm).
+    //
+    std::atomic<uint64_t> m_theoreticalArrivalTime;
+
+    // Reservoir state.
+    //
+    std::atomic<uint64_t> m_reservoirPeriodEnd;
+    std::atomic<uint32_t> m_reservoirGeneration;
+
+    // Protects the reservoir buffers and the config reload.
+    //
+    std::atomic<bool> m_lock;
+
+    // Serializes sending of the swapped out reservoirs, taken before the lock.
+    // The threads offering messages only try to acquire it.
+    //
+    std::atomic<bool> m_sendLock;
+
+    // Reservoirs of the current period and the reservoirs swapped out to be sent.
+    //
+    std::atomic<Reservoir*> m_activeReservoirs;
+    Reservoir* m_swappedReservoirs;
+    Reservoir m_reservoirs[2][MaxReservoirTypeCount];
+
+    // Friend classes.
+    //
+    friend class MlosContext;
+
+    template<typename>
+    friend class ComponentConfig;
+};
+}
+}
@@ -0,0 +1,226 @@
+//*********************************************************************
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License. See License.txt in the project root
+// for license information.
+//
+// @File: TelemetrySampler.inl
+//
+// Purpose:
+//      <description>
+//
+// Notes:
+//      <special-instructions>
+//
+//*********************************************************************
+
+#pragma once
+
+namespace Mlos
+{
+namespace Core
+{
+//----------------------------------------------------------------------------
+// NAME: TelemetrySampler::ShouldSendMessage
+//
+// PURPOSE:
+//  Applies the sampling policy to the offered message.
+//
+// RETURNS:
+//  True if the caller should send the message now.
+//  False if the message has been rejected or kept in the reservoir.
+//
+// NOTES:
+//  The decision is made before the message is serialized.
+//  The messages are counted in the slot of the current thread, the sample interval and the report interval
+//  apply to the messages offered by the threads sharing the slot.
+//
+template<typename TMessage>
+inline bool TelemetrySampler::ShouldSendMessage(const TMessage& message)
+{
+    // Reload the config if the agent has updated it.
+    //
+    if (SamplingConfig.SharedConfigId() != m_configId.load(std::memory_order_relaxed))
+    {
+        Refresh();
+    }
+
+    CounterSlot& counterSlot = CurrentCounterSlot();
+
+    const uint64_t offeredCount = counterSlot.OfferedCount.fetch_add(1, std::memory_order_relaxed) + 1;
+
+    bool shouldSendMessage = true;
+
+    switch (m_policy.load(std::memory_order_relaxed))
+    {
+        case TelemetrySamplingPolicy::OneInN:
+        {
+            const uint32_t sampleInterval = m_sampleInterval.load(std::memory_order_relaxed);
+            shouldSendMessage = (sampleInterval != 0) && (offeredCount % sampleInterval == 0);
+            break;
+        }
+        case TelemetrySamplingPolicy::TokenBucket:
+            shouldSendMessage = TryAcquireToken();
+            break;
+        case TelemetrySamplingPolicy::Reservoir:
+            if constexpr (sizeof(TMessage) <= ReservoirBufferSize)
+            {
+                if (ObjectSerialization::GetVariableDataSize(message) == 0 && AddToReservoir(message))
+                {
+                    shouldSendMessage = false;
+                    break;
+                }
+            }
+
+            // The reservoirs can not keep the message, sample it one in SampleInterval.
+            //
+            {
+                const uint32_t sampleInterval = m_sampleInterval.load(std::memory_order_relaxed);
+                shouldSendMessage = (sampleInterval != 0) && (offeredCount % sampleInterval == 0);
+            }
+            break;
+        default:
+            break;
+    }
+
+    if (shouldSendMessage)
+    {
+        counterSlot.SentCount.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    const uint32_t reportInterval = m_reportInterval.load(std::memory_order_relaxed);
+    if (reportInterval != 0 && offeredCount % reportInterval == 0)
+    {
+        SendSamplingReport();
+    }
+
+    return shouldSendMessage;
+}
+
+//----------------------------------------------------------------------------
+// NAME: TelemetrySampler::CurrentCounterSlot
+//
+// PURPOSE:
+//  Returns the counter slot assigned to the current thread.
+//
+// NOTES:
+//  The threads are assigned to the slots round robin when they offer a message to any sampler for the first time.
+//  If there are more threads than slots, the threads share the slot, therefore the counters are atomic.
+//
+inline TelemetrySampler::CounterSlot& TelemetrySampler::CurrentCounterSlot()
+{
+    static std::atomic<uint32_t> s_samplerThreadCount(0);
+    static thread_local const uint32_t t_counterSlotIndex = s_samplerThreadCount.fetch_add(1, std::memory_order_relaxed);
+
+    return m_counterSlots[t_counterSlotIndex & (CounterSlotCount - 1)];
+}
+
+//----------------------------------------------------------------------------
+// NAME: TelemetrySampler::AddToReservoir
+//
+// PURPOSE:
+//  Offers the message to the reservoir of its type.
+//
+// RETURNS:
+//  True if the message has been offered to the reservoir.
+//  False if the reservoirs of the period are used by other message types.
+//
+// NOTES:
+//  Algorithm R, the i-th message of the type in the period replaces a random slot with the probability ReservoirSize / i.
+//  The slot is selected without the lock, only the selected messages are copied under the lock.
+//  A message selected in the previous period (generation) is dropped.
+//  At the end of the period, the thread that acquires the send lock swaps out the reservoirs and sends them.
+//  The other threads do not wait for it, they keep offering the messages to the active reservoirs.
+//
+template<typename TMessage>
+inline bool TelemetrySampler::AddToReservoir(const TMessage& message)
+{
+    const uint64_t timestamp = MlosPlatform::TimestampInNanoseconds();
+
+    if (timestamp >= m_reservoirPeriodEnd.load(std::memory_order_acquire) &&
+        TryAcquireLock(m_sendLock))
+    {
+        // The period has ended, send the selected messages and start a new period.
+        // The reservoirs are swapped only by the send lock owner, so the period end is checked again without the lock.
+        //
+        const bool isPeriodEnd = timestamp >= m_reservoirPeriodEnd.load(std::memory_order_acquire);
+
+        if (isPeriodEnd)
+        {
+            AcquireLock(m_lock);
+            SwapReservoirs();
+            StartReservoirPeriod(timestamp);
+            ReleaseLock(m_lock);
+
+            SendSwappedReservoirs();
+        }
+
+        ReleaseLock(m_sendLock);
+
+        if (isPeriodEnd)
+        {
+            SendSamplingReport();
+        }
+    }
+
+    // Load the generation before the reservoirs, the reservoirs are swapped before the generation is incremented.
+    //
+    const uint32_t generation = m_reservoirGeneration.load(std::memory_order_acquire);
+
+    Reservoir* reservoir = FindReservoir(
+        TypeMetadataInfo::CodegenTypeIndex<TMessage>(),
+        sizeof(TMessage),
+        &TelemetrySampler::SendReservoirMessage<TMessage>);
+    if (reservoir == nullptr)
+    {
+        return false;
+    }
+
+    const uint64_t index = reservoir->OfferedCount.fetch_add(1, std::memory_order_relaxed);
+
+    const uint64_t capacity = std::min(
+        m_reservoirSize.load(std::memory_order_relaxed),
+        static_cast<uint32_t>(ReservoirBufferSize / sizeof(TMessage)));
+
+    uint64_t slotIndex = index;
+
+    if (index >= capacity)
+    {
+        slotIndex = MixBits(index + (static_cast<uint64_t>(generation) << 32)) % (index + 1);
+
+        if (slotIndex >= capacity)
+        {
+            return true;
+        }
+    }
+
+    AcquireLock(m_lock);
+
+    if (generation == m_reservoirGeneration.load(std::memory_order_relaxed))
+    {
+        memcpy(reservoir->Buffer + slotIndex * sizeof(TMessage), &message, sizeof(TMessage));
+        reservoir->SlotMask |= static_cast<uint64_t>(1) << slotIndex;
+    }
+
+    ReleaseLock(m_lock);
+
+    return true;
+}
+
+//----------------------------------------------------------------------------
+// NAME: TelemetrySampler::SendReservoirMessage
+//
+// PURPOSE:
+//  Sends the message kept in the reservoir.
+//
+// RETURNS:
+//  Nothing.
+//
+// NOTES:
+//
+template<typename TMessage>
+void TelemetrySampler::SendReservoirMessage(MlosContext& mlosContext, const byte* message)
+{
+    mlosContext.SendTelemetryMessage(*reinterpret_cast<const TMessage*>(message));
+}
+}
+}
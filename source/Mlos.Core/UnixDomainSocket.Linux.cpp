@@ -0,0 +1,417 @@
+//*********************************************************************
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License. See License.txt in the project root
+// for license information.
+//
+// @File: UnixDomainSocket.Linux.cpp
+//
+// Purpose:
+//      <description>
+//
+// Notes:
+//      <special-instructions>
+//
+//*********************************************************************
+
+#include "Mlos.Core.h"
+
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+namespace Mlos
+{
+namespace Core
+{
+//----------------------------------------------------------------------------
+// NAME: FormatSocketAddress
+//
+// PURPOSE:
+//  Creates the socket address from the socket path.
+//
+// RETURNS:
+//  HRESULT. E_INVALIDARG if the path does not fit into the socket address.
+//
+// NOTES:
+//  A path starting with '@' is an abstract socket address, the '@' is replaced with the null character.
+//
+static HRESULT FormatSocketAddress(
+    const char* const socketPath,
+    _Out_ struct sockaddr_un& socketAddress,
+    _Out_ socklen_t& socketAddressLength)
+{
+    const size_t socketPathLength = strlen(socketPath);
+
+    memset(&socketAddress, 0, sizeof(socketAddress));
+    socketAddress.sun_family = AF_UNIX;
+
+    if (socketPathLength == 0 || socketPathLength >= sizeof(socketAddress.sun_path))
+    {
+        return E_INVALIDARG;
+    }
+
+    memcpy(socketAddress.sun_path, socketPath, socketPathLength);
+
+    if (socketPath[0] == '@')
+    {
+        socketAddress.sun_path[0] = '\0';
+    }
+
+    socketAddressLength = static_cast<socklen_t>(offsetof(struct sockaddr_un, sun_path) + socketPathLength);
+
+    return S_OK;
+}
+
+//----------------------------------------------------------------------------
+// NAME: UnixDomainSocket::Constructor.
+//
+UnixDomainSocket::UnixDomainSocket() noexcept
+  : m_fdSocket(INVALID_FD_VALUE),
+    m_socketFileName(nullptr)
+{
+}
+
+//----------------------------------------------------------------------------
+// NAME: UnixDomainSocket::Constructor.
+//
+// PURPOSE:
+//  Move constructor.
+//
+UnixDomainSocket::UnixDomainSocket(UnixDomainSocket&& unixDomainSocket) noexcept
+  : m_fdSocket(std::exchange(unixDomainSocket.m_fdSocket, INVALID_FD_VALUE)),
+    m_socketFileName(std::exchange(unixDomainSocket.m_socketFileName, nullptr))
+{
+}
+
+//----------------------------------------------------------------------------
+// NAME: UnixDomainSocket::Destructor.
+//
+UnixDomainSocket::~UnixDomainSocket()
+{
+    Close();
+}
+
+//----------------------------------------------------------------------------
+// NAME: UnixDomainSocket::Listen
+//
+// PURPOSE:
+//  Creates a socket listening on the given path.
+//
+// RETURNS:
+//  HRESULT.
+//
+// NOTES:
+//  Removes a stale socket file left by a process which did not close the socket.
+//
+_Check_return_
+HRESULT UnixDomainSocket::Listen(const char* const socketPath) noexcept
+{
+    struct sockaddr_un socketAddress;
+    socklen_t socketAddressLength;
+
+    HRESULT hr = FormatSocketAddress(socketPath, socketAddress, socketAddressLength);
+    if (FAILED(hr))
+    {
+        return hr;
+    }
+
+    if (socketPath[0] != '@')
+    {
+        unlink(socketPath);
+
+        m_socketFileName = strdup(socketPath);
+        if (m_socketFileName == nullptr)
+        {
+            return E_OUTOFMEMORY;
+        }
+    }
+
+    m_fdSocket = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (m_fdSocket == INVALID_FD_VALUE)
+    {
+        hr = HRESULT_FROM_ERRNO(errno);
+    }
+
+    if (SUCCEEDED(hr))
+    {
+        if (bind(m_fdSocket, reinterpret_cast<struct sockaddr*>(&socketAddress), socketAddressLength) == -1)
+        {
+            hr = HRESULT_FROM_ERRNO(errno);
+        }
+    }
+
+    if (SUCCEEDED(hr))
+    {
+        if (listen(m_fdSocket, SOMAXCONN) == -1)
+        {
+            hr = HRESULT_FROM_ERRNO(errno);
+        }
+    }
+
+    if (FAILED(hr))
+    {
+        Close();
+    }
+
+    return hr;
+}
+
+//----------------------------------------------------------------------------
+// NAME: UnixDomainSocket::Accept
+//
+// PURPOSE:
+//  Waits for a connection on the listening socket.
+//
+// RETURNS:
+//  HRESULT.
+//
+_Check_return_
+HRESULT UnixDomainSocket::Accept(_Out_ UnixDomainSocket& connection) noexcept
+{
+    int fdConnection;
+
+    do
+    {
+        fdConnection = accept4(m_fdSocket, nullptr, nullptr, SOCK_CLOEXEC);
+    }
+    while (fdConnection == INVALID_FD_VALUE && errno == EINTR);
+
+    if (fdConnection == INVALID_FD_VALUE)
+    {
+        return HRESULT_FROM_ERRNO(errno);
+    }
+
+    connection.Close();
+    connection.m_fdSocket = fdConnection;
+
+    return S_OK;
+}
+
+//----------------------------------------------------------------------------
+// NAME: UnixDomainSocket::Connect
+//
+// PURPOSE:
+//  Connects to the socket listening on the given path.
+//
+// RETURNS:
+//  HRESULT.
+//
+_Check_return_
+HRESULT UnixDomainSocket::Connect(const char* const socketPath) noexcept
+{
+    struct sockaddr_un socketAddress;
+    socklen_t socketAddressLength;
+
+    HRESULT hr = FormatSocketAddress(socketPath, socketAddress, socketAddressLength);
+    if (FAILED(hr))
+    {
+        return hr;
+    }
+
+    m_fdSocket = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (m_fdSocket == INVALID_FD_VALUE)
+    {
+        return HRESULT_FROM_ERRNO(errno);
+    }
+
+    if (connect(m_fdSocket, reinterpret_cast<struct sockaddr*>(&socketAddress), socketAddressLength) == -1)
+    {
+        hr = HRESULT_FROM_ERRNO(errno);
+        Close();
+    }
+
+    return hr;
+}
+
+//----------------------------------------------------------------------------
+// NAME: UnixDomainSocket::Send
+//
+// PURPOSE:
+//  Sends the buffer together with the file descriptors.
+//
+// RETURNS:
+//  HRESULT.
+//
+// NOTES:
+//  The file descriptors are passed as SCM_RIGHTS ancillary data, the receiving process gets its own duplicates.
+//
+_Check_return_
+HRESULT UnixDomainSocket::Send(const void* buffer, size_t bufferSize, const int* fileDescriptors, uint32_t fileDescriptorCount) noexcept
+{
+    if (fileDescriptorCount > MaxFileDescriptorCount)
+    {
+        return E_INVALIDARG;
+    }
+
+    struct iovec ioVector;
+    ioVector.iov_base = const_cast<void*>(buffer);
+    ioVector.iov_len = bufferSize;
+
+    alignas(struct cmsghdr) char controlBuffer[CMSG_SPACE(sizeof(int) * MaxFileDescriptorCount)] = { 0 };
+
+    struct msghdr message = { 0 };
+    message.msg_iov = &ioVector;
+    message.msg_iovlen = 1;
+
+    if (fileDescriptorCount != 0)
+    {
+        message.msg_control = controlBuffer;
+        message.msg_controllen = CMSG_SPACE(sizeof(int) * fileDescriptorCount);
+
+        struct cmsghdr* controlMessage = CMSG_FIRSTHDR(&message);
+        controlMessage->cmsg_level = SOL_SOCKET;
+        controlMessage->cmsg_type = SCM_RIGHTS;
+        controlMessage->cmsg_len = CMSG_LEN(sizeof(int) * fileDescriptorCount);
+        memcpy(CMSG_DATA(controlMessage), fileDescriptors, sizeof(int) * fileDescriptorCount);
+    }
+
+    ssize_t sentSize;
+
+    do
+    {
+        sentSize = sendmsg(m_fdSocket, &message, MSG_NOSIGNAL);
+    }
+    while (sentSize == -1 && errno == EINTR);
+
+    if (sentSize == -1)
+    {
+        return HRESULT_FROM_ERRNO(errno);
+    }
+
+    if (static_cast<size_t>(sentSize) != bufferSize)
+    {
+        return HRESULT_FROM_ERRNO(EMSGSIZE);
+    }
+
+    return S_OK;
+}
+
+//----------------------------------------------------------------------------
+// NAME: UnixDomainSocket::Receive
+//
+// PURPOSE:
+//  Receives the buffer together with the file descriptors.
+//
+// RETURNS:
+//  HRESULT. E_ABORT if the peer closed the connection.
+//
+// NOTES:
+//  The caller owns the received file descriptors.
+//  If the message does not match the expected size or carries more file descriptors than expected,
+//  the received file descriptors are closed.
+//
+_Check_return_
+HRESULT UnixDomainSocket::Receive(
+    void* buffer,
+    size_t bufferSize,
+    int* fileDescriptors,
+    uint32_t maxFileDescriptorCount,
+    _Out_ uint32_t& fileDescriptorCount) noexcept
+{
+    fileDescriptorCount = 0;
+
+    struct iovec ioVector;
+    ioVector.iov_base = buffer;
+    ioVector.iov_len = bufferSize;
+
+    alignas(struct cmsghdr) char controlBuffer[CMSG_SPACE(sizeof(int) * MaxFileDescriptorCount)] = { 0 };
+
+    struct msghdr message = { 0 };
+    message.msg_iov = &ioVector;
+    message.msg_iovlen = 1;
+    message.msg_control = controlBuffer;
+    message.msg_controllen = sizeof(controlBuffer);
+
+    ssize_t receivedSize;
+
+    do
+    {
+        receivedSize = recvmsg(m_fdSocket, &message, MSG_WAITALL | MSG_CMSG_CLOEXEC);
+    }
+    while (receivedSize == -1 && errno == EINTR);
+
+    if (receivedSize == -1)
+    {
+        return HRESULT_FROM_ERRNO(errno);
+    }
+
+    HRESULT hr = S_OK;
+
+    if (receivedSize == 0)
+    {
+        hr = E_ABORT;
+    }
+    else if (static_cast<size_t>(receivedSize) != bufferSize || (message.msg_flags & MSG_CTRUNC) != 0)
+    {
+        hr = E_INVALIDARG;
+    }
+
+    // Collect the received file descriptors.
+    //
+    int receivedFileDescriptors[MaxFileDescriptorCount];
+    uint32_t receivedFileDescriptorCount = 0;
+
+    for (struct cmsghdr* controlMessage = CMSG_FIRSTHDR(&message);
+        controlMessage != nullptr;
+        controlMessage = CMSG_NXTHDR(&message, controlMessage))
+    {
+        if (controlMessage->cmsg_level == SOL_SOCKET && controlMessage->cmsg_type == SCM_RIGHTS)
+        {
+            const uint32_t count = static_cast<uint32_t>((controlMessage->cmsg_len - CMSG_LEN(0)) / sizeof(int));
+            const uint32_t copyCount = std::min(count, MaxFileDescriptorCount - receivedFileDescriptorCount);
+
+            memcpy(&receivedFileDescriptors[receivedFileDescriptorCount], CMSG_DATA(controlMessage), sizeof(int) * copyCount);
+            receivedFileDescriptorCount += copyCount;
+        }
+    }
+
+    if (receivedFileDescriptorCount > maxFileDescriptorCount)
+    {
+        hr = E_INVALIDARG;
+    }
+
+    if (FAILED(hr))
+    {
+        for (uint32_t index = 0; index < receivedFileDescriptorCount; index++)
+        {
+            close(receivedFileDescriptors[index]);
+        }
+
+        return hr;
+    }
+
+    if (receivedFileDescriptorCount != 0)
+    {
+        memcpy(fileDescriptors, receivedFileDescriptors, sizeof(int) * receivedFileDescriptorCount);
+    }
+
+    fileDescriptorCount = receivedFileDescriptorCount;
+
+    return S_OK;
+}
+
+//----------------------------------------------------------------------------
+// NAME: UnixDomainSocket::Close
+//
+// PURPOSE:
+//  Closes the socket.
+//
+void UnixDomainSocket::Close()
+{
+    if (m_fdSocket != INVALID_FD_VALUE)
+    {
+        close(m_fdSocket);
+        m_fdSocket = INVALID_FD_VALUE;
+    }
+
+    if (m_socketFileName != nullptr)
+    {
+        unlink(m_socketFileName);
+
+        free(m_socketFileName);
+        m_socketFileName = nullptr;
+    }
+}
+}
+}
@@ -0,0 +1,91 @@
+//*********************************************************************
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License. See License.txt in the project root
+// for license information.
+//
+// @File: UnixDomainSocket.Linux.h
+//
+// Purpose:
+//      <description>
+//
+// Notes:
+//      <special-instructions>
+//
+//*********************************************************************
+
+#pragma once
+
+namespace Mlos
+{
+namespace Core
+{
+//----------------------------------------------------------------------------
+// NAME: UnixDomainSocket
+//
+// PURPOSE:
+//  Local stream socket used to pass the file descriptors between the processes.
+//
+// NOTES:
+//  A socket path starting with '@' is bound in the abstract namespace, it does not create a file
+//  and disappears when the listening socket is closed.
+//
+class UnixDomainSocket
+{
+public:
+    UnixDomainSocket() noexcept;
+
+    UnixDomainSocket(UnixDomainSocket&& unixDomainSocket) noexcept;
+
+    ~UnixDomainSocket();
+
+    UnixDomainSocket(const UnixDomainSocket&) = delete;
+
+    UnixDomainSocket& operator=(const UnixDomainSocket&) = delete;
+
+    // Creates a socket listening on the given path.
+    //
+    _Check_return_
+    HRESULT Listen(const char* const socketPath) noexcept;
+
+    // Waits for a connection on the listening socket.
+    //
+    _Check_return_
+    HRESULT Accept(_Out_ UnixDomainSocket& connection) noexcept;
+
+    // Connects to the socket listening on the given path.
+    //
+    _Check_return_
+    HRESULT Connect(const char* const socketPath) noexcept;
+
+    // Sends the buffer together with the file descriptors.
+    //
+    _Check_return_
+    HRESULT Send(const void* buffer, size_t bufferSize, const int* fileDescriptors, uint32_t fileDescriptorCount) noexcept;
+
+    // Receives the buffer together with the file descriptors.
+    //
+    _Check_return_
+    HRESULT Receive(
+        void* buffer,
+        size_t bufferSize,
+        int* fileDescriptors,
+        uint32_t maxFileDescriptorCount,
+        _Out_ uint32_t& fileDescriptorCount) noexcept;
+
+    // Closes the socket.
+    //
+    void Close();
+
+    // Maximum number of the file descriptors passed in a single message.
+    //
+    static constexpr uint32_t MaxFileDescriptorCount = 32;
+
+private:
+    int m_fdSocket;
+
+    // Listening socket bound to a file, the file is removed on close.
+    //
+    char* m_socketFileName;
+};
+}
+}
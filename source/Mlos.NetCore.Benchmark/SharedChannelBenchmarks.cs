@@ -35,6 +35,7 @@ public class BaseSharedChannelBenchmark : IDisposable
 
     private const string GlobalMemoryMapName = "Mlos.NetCore.Global.UnitTest";
     private const string SharedChannelMemoryMapName = "Mlos.NetCore.SharedChannelTests.UnitTest";
+    private const int GlobalMemoryRegionSize = 131072;
     private const int SharedMemorySize = 65536;
 
     private readonly SettingsAssemblyManager settingsAssemblyManager = new SettingsAssemblyManager();
@@ -51,7 +52,7 @@ public class BaseSharedChannelBenchmark : IDisposable
 
     public BaseSharedChannelBenchmark()
     {
-        globalChannelMemoryRegionView = SharedMemoryRegionView.Create<MlosProxyInternal.GlobalMemoryRegion>(GlobalMemoryMapName, SharedMemorySize);
+        globalChannelMemoryRegionView = SharedMemoryRegionView.Create<MlosProxyInternal.GlobalMemoryRegion>(GlobalMemoryMapName, GlobalMemoryRegionSize);
         sharedChannelMemoryMapView = SharedMemoryMapView.Create(SharedChannelMemoryMapName, SharedMemorySize);
 
         MlosProxyInternal.GlobalMemoryRegion globalMemoryRegion = globalChannelMemoryRegionView.MemoryRegion();
@@ -83,6 +84,23 @@ public class BaseSharedChannelBenchmark : IDisposable
         pointMessage.Y = 5;
     }
 
+    /// <summary>
+    /// Gets the average number of the channel bytes used per message in the last run.
+    /// </summary>
+    public double BytesPerMessage { get; private set; }
+
+    /// <summary>
+    /// Recreates the shared channel with the full or the compact frame headers.
+    /// </summary>
+    /// <param name="compactFrameHeaders"></param>
+    protected void CreateSharedChannel(bool compactFrameHeaders)
+    {
+        MlosProxyInternal.GlobalMemoryRegion globalMemoryRegion = globalChannelMemoryRegionView.MemoryRegion();
+        globalMemoryRegion.ControlChannelSynchronization.HasCompactFrameHeaders.Store(compactFrameHeaders);
+
+        sharedChannel = new TestSharedChannel(sharedChannelMemoryMapView, globalMemoryRegion.ControlChannelSynchronization);
+    }
+
     public void Dispose()
     {
         this.Dispose(true);
@@ -101,7 +119,7 @@ public class BaseSharedChannelBenchmark : IDisposable
         isDisposed = true;
     }
 
-    public void Run(ulong messageCount, int readerCount)
+    public void Run(ulong messageCount, int readerCount, bool sendPointsOnly = false)
     {
         // Create a receiver threads.
         //
@@ -154,14 +172,25 @@ public class BaseSharedChannelBenchmark : IDisposable
         UIntPtr affinityMask = new UIntPtr(1ul);
         SetThreadAffinityMask(GetCurrentThread(), affinityMask);
 
+        uint startWritePosition = sharedChannel.Sync.WritePosition.Load();
+
         ulong index = 0;
         while (index++ < messageCount)
         {
-            sharedChannel.SendMessage(ref stringViewArray);
-            sharedChannel.SendMessage(ref wideStringMultiMessage);
+            if (!sendPointsOnly)
+            {
+                sharedChannel.SendMessage(ref stringViewArray);
+                sharedChannel.SendMessage(ref wideStringMultiMessage);
+            }
+
             sharedChannel.SendMessage(ref pointMessage);
         }
 
+        // The write position overflows, the difference is correct as long as the run writes less than 4 GiB.
+        //
+        ulong sentMessageCount = sendPointsOnly ? messageCount : messageCount * 3;
+        BytesPerMessage = (double)(sharedChannel.Sync.WritePosition.Load() - startWritePosition) / sentMessageCount;
+
         // Stop the test.
         //
         sharedChannel.Sync.TerminateChannel.Store(true);
@@ -247,3 +276,40 @@ public class SharedChannelReaderScaleOutBenchmarks : BaseSharedChannelBenchmark
         Run(messageCount: 1000000, readerCount: Math.Min(ReaderCount, Environment.ProcessorCount - 1));
     }
 }
+
+/// <summary>
+/// Benchmark the full and the compact frame headers.
+/// </summary>
+/// <remarks>
+/// Sends the small fixed size messages (8 bytes Point), the compact frame header saves 8 bytes per message.
+/// </remarks>
+[SimpleJob(RuntimeMoniker.NetCoreApp31)]
+[PlainExporter]
+[HtmlExporter]
+[MarkdownExporter]
+[RPlotExporter]
+[MemoryDiagnoser]
+public class SharedChannelFrameHeaderBenchmarks : BaseSharedChannelBenchmark
+{
+    [Params(false, true)]
+    public bool CompactFrameHeaders;
+
+    [GlobalSetup]
+    public void Setup()
+    {
+        CreateSharedChannel(CompactFrameHeaders);
+    }
+
+    [GlobalCleanup]
+    public void Cleanup()
+    {
+        Console.WriteLine($"CompactFrameHeaders: {CompactFrameHeaders}, bytes per message: {BytesPerMessage}");
+        Dispose();
+    }
+
+    [Benchmark]
+    public void SendReceivePoints()
+    {
+        Run(messageCount: 1000000, readerCount: 1, sendPointsOnly: true);
+    }
+}
@@ -0,0 +1,45 @@
+// -----------------------------------------------------------------------
+// <copyright file="SettingsAssemblyManagerTests.cs" company="Microsoft Corporation">
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License. See LICENSE in the project root
+// for license information.
+// </copyright>
+// -----------------------------------------------------------------------
+
+using System;
+
+using Mlos.Core;
+using Mlos.UnitTest;
+using Xunit;
+
+namespace Mlos.NetCore.UnitTest
+{
+    public class SettingsAssemblyManagerTests
+    {
+        /// <summary>
+        /// Verify the settings assembly is not registered if its dispatch table hash differs from the application.
+        /// </summary>
+        [Fact]
+        public void VerifyDispatchTableHashMismatch()
+        {
+            var settingsAssemblyManager = new SettingsAssemblyManager();
+
+            ulong mlosCoreDispatchTableHash = SettingsAssemblyManager.DispatchTableHash(Mlos.Core.ObjectDeserializeHandler.DispatchTable);
+            ulong unitTestDispatchTableHash = SettingsAssemblyManager.DispatchTableHash(Mlos.UnitTest.ObjectDeserializeHandler.DispatchTable);
+
+            Assert.Throws<InvalidOperationException>(
+                () => settingsAssemblyManager.RegisterAssembly(typeof(MlosContext).Assembly, dispatchTableBaseIndex: 0, mlosCoreDispatchTableHash ^ 1));
+            Assert.Equal(0U, settingsAssemblyManager.CodegenTypeCount);
+
+            settingsAssemblyManager.RegisterAssembly(typeof(MlosContext).Assembly, dispatchTableBaseIndex: 0, mlosCoreDispatchTableHash);
+            uint dispatchTableBaseIndex = settingsAssemblyManager.CodegenTypeCount;
+
+            Assert.Throws<InvalidOperationException>(
+                () => settingsAssemblyManager.RegisterAssembly(typeof(AssemblyInitializer).Assembly, dispatchTableBaseIndex, unitTestDispatchTableHash + 1));
+            Assert.Equal(dispatchTableBaseIndex, settingsAssemblyManager.CodegenTypeCount);
+
+            settingsAssemblyManager.RegisterAssembly(typeof(AssemblyInitializer).Assembly, dispatchTableBaseIndex, unitTestDispatchTableHash);
+            Assert.Equal(2, settingsAssemblyManager.RegisteredAssemblies.Count);
+        }
+    }
+}
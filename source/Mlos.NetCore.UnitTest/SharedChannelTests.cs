@@ -7,6 +7,7 @@
 // -----------------------------------------------------------------------
 
 using System;
+using System.Threading;
 using System.Threading.Tasks;
 
 using Mlos.Core;
@@ -23,6 +24,7 @@ namespace Mlos.NetCore.UnitTest
     {
         private const string GlobalMemoryMapName = "Mlos.NetCore.Global.UnitTest";
         private const string SharedChannelMemoryMapName = "Mlos.NetCore.SharedChannelTests.UnitTest";
+        private const int GlobalMemoryRegionSize = 131072;
         private const int SharedMemorySize = 65536;
 
         private readonly SharedMemoryRegionView<MlosProxyInternal.GlobalMemoryRegion> globalChannelMemoryRegionView;
@@ -39,7 +41,7 @@ namespace Mlos.NetCore.UnitTest
 
             // Initialize shared channel.
             //
-            globalChannelMemoryRegionView = SharedMemoryRegionView.Create<MlosProxyInternal.GlobalMemoryRegion>(GlobalMemoryMapName, SharedMemorySize);
+            globalChannelMemoryRegionView = SharedMemoryRegionView.Create<MlosProxyInternal.GlobalMemoryRegion>(GlobalMemoryMapName, GlobalMemoryRegionSize);
             globalChannelMemoryRegionView.CleanupOnClose = true;
             sharedChannelMemoryMapView = SharedMemoryMapView.Create(SharedChannelMemoryMapName, SharedMemorySize);
             sharedChannelMemoryMapView.CleanupOnClose = true;
@@ -67,8 +69,10 @@ namespace Mlos.NetCore.UnitTest
             isDisposed = true;
         }
 
-        [Fact]
-        public void SendReceiveMessages()
+        [Theory]
+        [InlineData(1u)]
+        [InlineData(16u)]
+        public void SendReceiveMessages(uint readerBatchFrameCount)
         {
             // Create a receiver task.
             //
@@ -79,7 +83,7 @@ namespace Mlos.NetCore.UnitTest
                 bool result = true;
                 while (result)
                 {
-                    result = sharedChannel.WaitAndDispatchFrame(globalDispatchTable);
+                    result = sharedChannel.WaitAndDispatchFrames(globalDispatchTable, readerBatchFrameCount, maxBatchLength: 0);
                 }
             }
 
@@ -164,5 +168,59 @@ namespace Mlos.NetCore.UnitTest
             receiverTask1.Wait();
             receiverTask2.Wait();
         }
+
+        [Fact]
+        public void DispatchMessagesSentBeforeAssemblyRegistration()
+        {
+            const int MessageCount = 16;
+
+            // The reader starts with the dispatch table without the unit test settings assembly,
+            // as the agent telemetry readers do before the control channel reader registers the assembly.
+            //
+            var mlosCoreAssemblyManager = new SettingsAssemblyManager();
+            mlosCoreAssemblyManager.RegisterAssembly(typeof(MlosContext).Assembly);
+
+            DispatchEntry[] dispatchTable = mlosCoreAssemblyManager.GetGlobalDispatchTable();
+            var channelSettings = new ChannelSettings { ReaderBatchFrameCount = MessageCount };
+
+            sharedChannel.UnregisteredTypeWaitTimeout = TimeSpan.FromSeconds(10);
+
+            int receivedCount = 0;
+
+            UnitTestProxy.StringViewArray.Callback =
+                msg =>
+                {
+                    Assert.Equal("cba", msg.Strings[3].Value);
+                    Interlocked.Increment(ref receivedCount);
+                };
+
+            using Task receiverTask = Task.Factory.StartNew(
+                () => sharedChannel.ProcessMessages(ref dispatchTable, ref channelSettings),
+                TaskCreationOptions.LongRunning);
+
+            for (int i = 0; i < MessageCount; i++)
+            {
+                var msg = new StringViewArray();
+                msg.Id = i;
+                msg.Strings[3].Value = "cba";
+
+                sharedChannel.SendMessage(ref msg);
+            }
+
+            // Register the assembly after the reader received the messages.
+            //
+            Thread.Sleep(100);
+            Assert.Equal(0, Volatile.Read(ref receivedCount));
+
+            Volatile.Write(ref dispatchTable, SettingsAssemblyInitializer.GetGlobalDispatchTable());
+
+            Assert.True(SpinWait.SpinUntil(() => Volatile.Read(ref receivedCount) == MessageCount, TimeSpan.FromSeconds(10)));
+
+            sharedChannel.Sync.TerminateChannel.Store(true);
+
+            receiverTask.Wait();
+
+            UnitTestProxy.StringViewArray.Callback = null;
+        }
     }
 }
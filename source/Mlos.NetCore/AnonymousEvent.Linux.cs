@@ -0,0 +1,76 @@
+// -----------------------------------------------------------------------
+// <copyright file="AnonymousEvent.Linux.cs" company="Microsoft Corporation">
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License. See LICENSE in the project root
+// for license information.
+// </copyright>
+// -----------------------------------------------------------------------
+
+using System;
+
+namespace Mlos.Core.Linux
+{
+    /// <summary>
+    /// Anonymous event (eventfd) passed by another process.
+    /// </summary>
+    /// <remarks>
+    /// The event is created with EFD_SEMAPHORE, each wait consumes one signal.
+    /// See Also: Mlos.Core/NamedEvent.Linux.cpp.
+    /// </remarks>
+    public class AnonymousEvent : Mlos.Core.NamedEvent
+    {
+        /// <summary>
+        /// Opens the event file descriptor, the event takes the ownership of the file descriptor.
+        /// </summary>
+        /// <param name="fileDescriptor"></param>
+        /// <returns></returns>
+        public static AnonymousEvent OpenFileDescriptor(int fileDescriptor)
+        {
+            return new AnonymousEvent(fileDescriptor);
+        }
+
+        private AnonymousEvent(int fileDescriptor)
+        {
+            eventHandle = new EventSafeHandle((IntPtr)fileDescriptor);
+        }
+
+        /// <inheritdoc/>
+        public override bool Signal()
+        {
+            ulong value = 1;
+
+            return Native.EventWrite(eventHandle, ref value, sizeof(ulong)) == sizeof(ulong);
+        }
+
+        /// <inheritdoc/>
+        public override bool Wait()
+        {
+            ulong value = 0;
+
+            return Native.EventRead(eventHandle, ref value, sizeof(ulong)) == sizeof(ulong);
+        }
+
+        /// <summary>
+        /// Protected implementation of Dispose pattern.
+        /// </summary>
+        /// <param name="disposing"></param>
+        /// <remarks>
+        /// The event has no name, there is nothing to clean up when the last process closes it.
+        /// </remarks>
+        protected override void Dispose(bool disposing)
+        {
+            if (isDisposed || !disposing)
+            {
+                return;
+            }
+
+            eventHandle?.Dispose();
+
+            CleanupOnClose = false;
+
+            isDisposed = true;
+        }
+
+        private readonly EventSafeHandle eventHandle;
+    }
+}
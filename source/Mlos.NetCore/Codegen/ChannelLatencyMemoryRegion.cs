@@ -0,0 +1,94 @@
+// -----------------------------------------------------------------------
+// <copyright file="ChannelLatencyMemoryRegion.cs" company="Microsoft Corporation">
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License. See LICENSE in the project root
+// for license information.
+// </copyright>
+// -----------------------------------------------------------------------
+
+using Mlos.SettingsSystem.Attributes;
+using Mlos.SettingsSystem.StdTypes;
+
+namespace Mlos.Core.Internal
+{
+    /// <summary>
+    /// Log-linear histogram of the latencies in nanoseconds.
+    /// </summary>
+    /// <remarks>
+    /// Values below 8 have their own bucket.
+    /// Every following power of two range is split into 8 equal buckets, so the bucket width is at most 1/8 of its lower bound.
+    /// Values larger than the range of the last bucket (about 17 seconds) are counted in the last bucket.
+    /// </remarks>
+    [CodegenType]
+    internal partial class ChannelLatencyHistogram
+    {
+        /// <summary>
+        /// Number of recorded values.
+        /// </summary>
+        internal AtomicUInt64 Count;
+
+        /// <summary>
+        /// Sum of recorded values in nanoseconds.
+        /// </summary>
+        internal AtomicUInt64 TotalInNanoseconds;
+
+        /// <summary>
+        /// Number of recorded values in each bucket.
+        /// </summary>
+        [FixedSizeArray(length: 256)]
+        internal readonly AtomicUInt64[] Buckets;
+    }
+
+    /// <summary>
+    /// Latencies of the messages of a single type.
+    /// </summary>
+    [CodegenType]
+    internal partial struct ChannelLatencyStats
+    {
+        /// <summary>
+        /// Time between the writer sending the frame and the reader dispatching it.
+        /// </summary>
+        /// <remarks>
+        /// Recorded only if the channel writers append the send timestamp to the frames.
+        /// </remarks>
+        internal ChannelLatencyHistogram QueueingDelay;
+
+        /// <summary>
+        /// Time spent in the message callback.
+        /// </summary>
+        internal ChannelLatencyHistogram HandlerDuration;
+    }
+
+    /// <summary>
+    /// Memory region holding the channel latency histograms.
+    /// </summary>
+    /// <remarks>
+    /// Histograms are updated by the channel readers, external processes can read them at any time.
+    /// </remarks>
+    [CodegenType]
+    internal partial class ChannelLatencyMemoryRegion
+    {
+        /// <summary>
+        /// Memory region header.
+        /// </summary>
+        internal MemoryRegion MemoryHeader;
+
+        /// <summary>
+        /// Latency histograms indexed by the codegen type index.
+        /// </summary>
+        /// <remarks>
+        /// Messages with codegen type index outside of the array are not recorded.
+        /// </remarks>
+        [FixedSizeArray(length: 256)]
+        internal readonly ChannelLatencyStats[] LatencyStatsByType;
+    }
+
+    /// <summary>
+    /// Request message to register the telemetry channel latency memory region.
+    /// </summary>
+    [CodegenMessage]
+    internal partial struct RegisterChannelLatencyMemoryRegionRequestMessage
+    {
+        internal uint MemoryRegionId;
+    }
+}
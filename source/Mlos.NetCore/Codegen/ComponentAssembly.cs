@@ -34,6 +34,15 @@ namespace Mlos.Core.Internal
         /// </summary>
         [ScalarSetting]
         internal uint DispatchTableBaseIndex;
+
+        /// <summary>
+        /// Combined hash of the assembly dispatch table types, zero if the application does not provide it.
+        /// </summary>
+        /// <remarks>
+        /// Mlos.Agent verifies it once when it loads the assembly, the channels with the compact frame headers do not check the type hash per frame.
+        /// </remarks>
+        [ScalarSetting]
+        internal ulong DispatchTableHash;
     }
 
     /// <summary>
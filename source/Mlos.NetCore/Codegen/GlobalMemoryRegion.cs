@@ -12,7 +12,7 @@ using Mlos.SettingsSystem.StdTypes;
 namespace Mlos.Core.Internal
 {
     [CodegenType]
-    internal partial struct GlobalMemoryRegion
+    internal partial class GlobalMemoryRegion
     {
         /// <summary>
         /// Memory region header.
@@ -25,10 +25,24 @@ namespace Mlos.Core.Internal
         internal ChannelSynchronization ControlChannelSynchronization;
 
         /// <summary>
-        /// Control channel synchronization object.
+        /// Feedback channel synchronization object.
         /// </summary>
         internal ChannelSynchronization FeedbackChannelSynchronization;
 
+        /// <summary>
+        /// Telemetry channel synchronization objects, one for each telemetry channel shard.
+        /// </summary>
+        /// <remarks>
+        /// See Also: Mlos.Core/ShardedSharedChannel.h MaxShardCount.
+        /// </remarks>
+        [FixedSizeArray(length: 16)]
+        internal readonly ChannelSynchronization[] TelemetryChannelSynchronization;
+
+        /// <summary>
+        /// Number of the telemetry channel shards, set by the first process that opens the global memory region.
+        /// </summary>
+        internal AtomicUInt32 TelemetryChannelShardCount;
+
         /// <summary>
         /// Gets or sets information how many processes are using the global memory region.
         /// </summary>
@@ -43,5 +57,25 @@ namespace Mlos.Core.Internal
         /// Number of registered settings assembly.
         /// </summary>
         internal AtomicUInt32 RegisteredSettingsAssemblyCount;
+
+        /// <summary>
+        /// Telemetry message subscription bitmap, bit i is set if the agent processes the messages with codegen type index i.
+        /// </summary>
+        /// <remarks>
+        /// All the bits are set when the region is created, the agent clears the bits of the message types without a handler.
+        /// Messages with codegen type index outside of the bitmap are always sent.
+        /// See Also: Mlos.Core/MlosContext.inl IsTelemetryMessageSubscribed.
+        /// </remarks>
+        [FixedSizeArray(length: 64)]
+        internal readonly AtomicUInt64[] TelemetrySubscriptionBitmap;
+
+        /// <summary>
+        /// Hash of the Mlos.Core dispatch table of the process that created the region.
+        /// </summary>
+        /// <remarks>
+        /// Mlos.Core is registered without a settings assembly config, the agent and the processes which open the region
+        /// verify their Mlos.Core types against it, the channels with the compact frame headers do not verify the type hash per frame.
+        /// </remarks>
+        internal ulong MlosCoreDispatchTableHash;
     }
 }
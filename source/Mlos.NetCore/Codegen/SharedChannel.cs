@@ -14,6 +14,27 @@ using Mlos.SettingsSystem.StdTypes;
 
 namespace Mlos.Core
 {
+    /// <summary>
+    /// Counters of the messages dropped by the lossy shared channel policies.
+    /// </summary>
+    /// <remarks>
+    /// Messages with codegen type index outside of the array are counted only in the total.
+    /// </remarks>
+    [CodegenType]
+    internal partial class ChannelDropStats
+    {
+        /// <summary>
+        /// Total number of dropped messages.
+        /// </summary>
+        internal AtomicUInt64 DroppedMessageCount;
+
+        /// <summary>
+        /// Number of dropped messages indexed by the codegen type index.
+        /// </summary>
+        [FixedSizeArray(length: 256)]
+        internal readonly AtomicUInt64[] DroppedMessageCountByType;
+    }
+
     /// <summary>
     /// Communication channel synchronization object.
     /// </summary>
@@ -53,6 +74,86 @@ namespace Mlos.Core
         [Align(32)]
         internal AtomicUInt32 ActiveReaderCount;
 
+        /// <summary>
+        /// Futex word used to wake up the waiting readers (FutexSharedChannelPolicy).
+        /// The lowest bit is set when a reader is going to sleep, writers advance the sequence before they wake up a reader.
+        /// </summary>
+        [Align(32)]
+        internal AtomicUInt32 ReaderWakeupSequence;
+
+        /// <summary>
+        /// Futex word used to wake up the writers waiting for the free space (FutexSharedChannelPolicy).
+        /// The lowest bit is set when a writer is going to sleep, readers advance the sequence before they wake up the writers.
+        /// </summary>
+        [Align(32)]
+        internal AtomicUInt32 WriterWakeupSequence;
+
+        /// <summary>
+        /// If true stop reading/processing messages.
+        /// </summary>
+        [Align(4)]
+        internal AtomicBool TerminateChannel;
+
+        /// <summary>
+        /// If true, writers append the send timestamp (in nanoseconds) to each frame.
+        /// Set when the channel is created, readers use it to measure the queueing delay.
+        /// </summary>
+        [Align(4)]
+        internal AtomicBool HasFrameTimestamps;
+
+        /// <summary>
+        /// If true, the frames have the compact header (length and type index), the type hash is not written.
+        /// Set when the channel is created, the type hashes are verified when the settings assemblies are registered.
+        /// </summary>
+        [Align(4)]
+        internal AtomicBool HasCompactFrameHeaders;
+
+        /// <summary>
+        /// Counters of the dropped messages.
+        /// </summary>
+        [Align(32)]
+        internal ChannelDropStats DropStats;
+
+        /// <summary>
+        /// Reader and writer counters.
+        /// </summary>
+        [Align(64)]
+        internal ChannelStats Stats;
+    }
+
+    /// <summary>
+    /// Communication channel synchronization object with 64-bit positions.
+    /// </summary>
+    /// <remarks>
+    /// Used by the channels with the buffers larger than 2 GiB.
+    /// Positions do not overflow, the buffer size must be a power of two.
+    /// To find the offset in the buffer from the position:
+    /// Offset = Position &amp; (Buffer.Size - 1).
+    /// </remarks>
+    [CodegenType]
+    internal partial struct ChannelSynchronization64
+    {
+        [Align(32)]
+        internal AtomicUInt64 ReadPosition;
+
+        [Align(32)]
+        internal AtomicUInt64 WritePosition;
+
+        [Align(32)]
+        internal AtomicUInt64 FreePosition;
+
+        /// <summary>
+        /// Number of readers waiting for the notification from the external process.
+        /// </summary>
+        [Align(32)]
+        internal AtomicUInt32 ReaderInWaitingStateCount;
+
+        /// <summary>
+        /// Current number of active readers.
+        /// </summary>
+        [Align(32)]
+        internal AtomicUInt32 ActiveReaderCount;
+
         /// <summary>
         /// If true stop reading/processing messages.
         /// </summary>
@@ -69,6 +170,11 @@ namespace Mlos.Core
     {
         public const int TypeSize = 16;
 
+        /// <summary>
+        /// Size of the compact frame header, the frame header without the type hash.
+        /// </summary>
+        public const int CompactTypeSize = 8;
+
         /// <summary>
         /// Operator ==.
         /// </summary>
@@ -100,6 +206,9 @@ namespace Mlos.Core
         /// <summary>
         /// Hash of the type.
         /// </summary>
+        /// <remarks>
+        /// Not present in the compact frame header, the payload starts at its offset.
+        /// </remarks>
         internal ulong CodegenTypeHash;
 
         /// <inheritdoc />
@@ -133,11 +242,85 @@ namespace Mlos.Core
         }
     }
 
+    /// <summary>
+    /// Message frame header used by the channels with 64-bit positions.
+    /// </summary>
+    /// <remarks>
+    /// Frames are aligned to sizeof(long), the link frames might be longer than 2 GiB.
+    /// </remarks>
+    [CodegenType]
+    [StructLayout(LayoutKind.Sequential, Size = FrameHeader64.TypeSize)]
+    public partial struct FrameHeader64 : IEquatable<FrameHeader64>
+    {
+        public const int TypeSize = 24;
+
+        /// <summary>
+        /// Operator ==.
+        /// </summary>
+        /// <param name="left"></param>
+        /// <param name="right"></param>
+        /// <returns></returns>
+        public static bool operator ==(FrameHeader64 left, FrameHeader64 right) => left.Equals(right);
+
+        /// <summary>
+        /// Operator !=.
+        /// </summary>
+        /// <param name="left"></param>
+        /// <param name="right"></param>
+        /// <returns></returns>
+        public static bool operator !=(FrameHeader64 left, FrameHeader64 right) => !(left == right);
+
+        /// <summary>
+        /// Length of the frame.
+        /// </summary>
+        internal AtomicInt64 Length;
+
+        /// <summary>
+        /// Hash of the type.
+        /// </summary>
+        internal ulong CodegenTypeHash;
+
+        /// <summary>
+        /// Index of the type serialized in the message payload.
+        /// </summary>
+        internal uint CodegenTypeIndex;
+
+        /// <inheritdoc />
+        public override bool Equals(object obj)
+        {
+            if (!(obj is FrameHeader64))
+            {
+                return false;
+            }
+
+            return Equals((FrameHeader64)obj);
+        }
+
+        /// <inheritdoc />
+        public bool Equals(FrameHeader64 other) =>
+            Length == other.Length &&
+            CodegenTypeIndex == other.CodegenTypeIndex &&
+            CodegenTypeHash == other.CodegenTypeHash;
+
+        /// <inheritdoc />
+        public override int GetHashCode()
+        {
+            unchecked
+            {
+                int hash = 17;
+                hash = (31 * hash) + Length.GetHashCode();
+                hash = (31 * hash) + (int)CodegenTypeIndex;
+                hash = (31 * hash) + (int)CodegenTypeHash;
+                return hash;
+            }
+        }
+    }
+
     /// <summary>
     /// Shared circular buffer channel settings.
     /// </summary>
     [CodegenConfig]
-    internal partial struct ChannelSettings
+    public partial struct ChannelSettings
     {
         /// <summary>
         /// Size of the buffer. To avoid arithmetic overflow, buffer size must be power of two.
@@ -150,23 +333,153 @@ namespace Mlos.Core
         /// </summary>
         [ScalarSetting]
         internal int ReaderCount;
+
+        /// <summary>
+        /// Maximum number of frames a reader acquires at once.
+        /// Values less than two disable batched reads.
+        /// </summary>
+        [ScalarSetting]
+        public int ReaderBatchFrameCount;
+
+        /// <summary>
+        /// Maximum total length (in bytes) of the frames a reader acquires at once.
+        /// Zero does not limit the length, the first frame is always acquired.
+        /// </summary>
+        [ScalarSetting]
+        public int ReaderBatchLength;
     }
 
+    /// <summary>
+    /// Shared channel spin policy settings.
+    /// </summary>
+    /// <remarks>
+    /// A waiting thread spins with a single pause instruction first, then backs off exponentially,
+    /// then yields the processor and finally parks for a short period.
+    /// </remarks>
     [CodegenConfig]
+    public partial struct SharedChannelSpinPolicyConfig
+    {
+        /// <summary>
+        /// Number of wait iterations spinning with a single pause instruction.
+        /// </summary>
+        [ScalarSetting]
+        public int PauseSpinCount;
+
+        /// <summary>
+        /// Maximum number of pause instructions executed in a single backoff iteration.
+        /// The backoff starts with two pause instructions and doubles them every iteration.
+        /// </summary>
+        [ScalarSetting]
+        public int MaxBackoffPauseCount;
+
+        /// <summary>
+        /// Number of wait iterations yielding the processor before the thread parks.
+        /// </summary>
+        [ScalarSetting]
+        public int YieldCount;
+
+        /// <summary>
+        /// Duration of a single park iteration in microseconds.
+        /// </summary>
+        [ScalarSetting]
+        public int ParkDurationInMicroseconds;
+    }
+
+    /// <summary>
+    /// Shared channel reader and writer counters.
+    /// </summary>
+    /// <remarks>
+    /// Each reader thread owns a single reader slot while it processes the messages.
+    /// Writer threads are assigned to the writer slots round robin, so the slot might be shared by multiple threads.
+    /// Each slot is located in its own cache line.
+    /// </remarks>
+    [CodegenType]
     internal partial class ChannelStats
     {
+        /// <summary>
+        /// Bit mask of the reader slots owned by the active readers.
+        /// </summary>
+        internal AtomicUInt32 ReaderStatsSlotMask;
+
         [FixedSizeArray(length: 16)]
         internal readonly ChannelReaderStats[] ReaderStats;
+
+        [FixedSizeArray(length: 16)]
+        internal readonly ChannelWriterStats[] WriterStats;
     }
 
+    /// <summary>
+    /// Shared channel reader counters.
+    /// </summary>
+    /// <remarks>
+    /// Updated only by the reader thread owning the slot.
+    /// </remarks>
     [CodegenConfig]
+    [Align(64)]
     internal partial struct ChannelReaderStats
     {
+        /// <summary>
+        /// Number of processed frames, including the links.
+        /// </summary>
         [ScalarSetting]
         internal ulong MessagesRead;
 
+        /// <summary>
+        /// Total length of processed frames.
+        /// </summary>
+        [ScalarSetting]
+        internal ulong BytesRead;
+
+        /// <summary>
+        /// Number of spin iterations while waiting for the frames.
+        /// </summary>
         [ScalarSetting]
         internal ulong SpinCount;
+
+        /// <summary>
+        /// Number of waits for the notification from the writers.
+        /// </summary>
+        [ScalarSetting]
+        internal ulong WaitCount;
+
+        /// <summary>
+        /// Number of times the reader waited for a free slot in the queue of the dispatch worker pool.
+        /// </summary>
+        [ScalarSetting]
+        internal ulong DispatchStallCount;
+    }
+
+    /// <summary>
+    /// Shared channel writer counters.
+    /// </summary>
+    [CodegenType]
+    [Align(64)]
+    internal partial struct ChannelWriterStats
+    {
+        /// <summary>
+        /// Number of failed attempts to acquire the write region, because other writer acquired it first.
+        /// </summary>
+        internal AtomicUInt64 WriteRegionAcquireRetryCount;
+
+        /// <summary>
+        /// Number of writes which waited for the free space in the buffer.
+        /// </summary>
+        internal AtomicUInt64 FullBufferStallCount;
+
+        /// <summary>
+        /// Total time the writers waited for the free space in the buffer, in microseconds.
+        /// </summary>
+        internal AtomicUInt64 FullBufferStallTimeInMicroseconds;
+
+        /// <summary>
+        /// Number of link frames written at the end of the buffer.
+        /// </summary>
+        internal AtomicUInt64 LinkFrameCount;
+
+        /// <summary>
+        /// High-water mark of the buffer occupancy (distance between the free position and the write position), in bytes.
+        /// </summary>
+        internal AtomicUInt32 MaxOccupancy;
     }
 
     #region Control Messages
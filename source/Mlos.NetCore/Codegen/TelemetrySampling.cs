@@ -0,0 +1,145 @@
+// -----------------------------------------------------------------------
+// <copyright file="TelemetrySampling.cs" company="Microsoft Corporation">
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License. See LICENSE in the project root
+// for license information.
+// </copyright>
+// -----------------------------------------------------------------------
+
+using Mlos.SettingsSystem.Attributes;
+
+namespace Mlos.Core
+{
+    /// <summary>
+    /// Policy used by the component to select the telemetry messages it sends.
+    /// </summary>
+    public enum TelemetrySamplingPolicy
+    {
+        /// <summary>
+        /// Send all the telemetry messages.
+        /// </summary>
+        None,
+
+        /// <summary>
+        /// Send every SampleInterval-th telemetry message.
+        /// </summary>
+        OneInN,
+
+        /// <summary>
+        /// Send at most RatePerSecond telemetry messages per second, with bursts of up to BurstSize messages.
+        /// </summary>
+        TokenBucket,
+
+        /// <summary>
+        /// Send a uniform random sample of ReservoirSize telemetry messages every ReservoirPeriodInMilliseconds.
+        /// </summary>
+        Reservoir,
+    }
+
+    /// <summary>
+    /// Telemetry sampling settings of a component.
+    /// </summary>
+    /// <remarks>
+    /// The config is keyed by the codegen type index and the key hash of the component config.
+    /// The agent tunes the sampling by updating the shared config and incrementing the config id in its header.
+    /// </remarks>
+    [CodegenConfig]
+    public partial struct TelemetrySamplingConfig
+    {
+        /// <summary>
+        /// Codegen type index of the component config.
+        /// </summary>
+        [ScalarSetting(isPrimaryKey: true)]
+        internal uint ComponentTypeIndex;
+
+        /// <summary>
+        /// Key hash of the component config.
+        /// </summary>
+        [ScalarSetting(isPrimaryKey: true)]
+        internal uint ComponentKeyHash;
+
+        /// <summary>
+        /// Sampling policy.
+        /// </summary>
+        [ScalarSetting]
+        internal TelemetrySamplingPolicy Policy;
+
+        /// <summary>
+        /// OneInN policy, the component sends one in SampleInterval messages. Zero disables the telemetry.
+        /// </summary>
+        [ScalarSetting]
+        internal uint SampleInterval;
+
+        /// <summary>
+        /// TokenBucket policy, the rate of the sent messages. Zero disables the telemetry.
+        /// </summary>
+        [ScalarSetting]
+        internal uint RatePerSecond;
+
+        /// <summary>
+        /// TokenBucket policy, the number of messages sent back to back.
+        /// </summary>
+        [ScalarSetting]
+        internal uint BurstSize;
+
+        /// <summary>
+        /// Reservoir policy, the number of messages sent in each period.
+        /// </summary>
+        [ScalarSetting]
+        internal uint ReservoirSize;
+
+        /// <summary>
+        /// Reservoir policy, the length of the sampling period.
+        /// </summary>
+        [ScalarSetting]
+        internal uint ReservoirPeriodInMilliseconds;
+
+        /// <summary>
+        /// Number of offered messages between the sampling reports. Zero disables the periodic reports.
+        /// </summary>
+        [ScalarSetting]
+        internal uint ReportInterval;
+    }
+
+    /// <summary>
+    /// Telemetry message reporting the number of messages the component offered and sent.
+    /// </summary>
+    /// <remarks>
+    /// The counts are cumulative for the lifetime of the sampler.
+    /// The agent scales the counts aggregated from the sampled messages by OfferedCount / SentCount.
+    /// The component sends a report before it applies a new config id.
+    /// </remarks>
+    [CodegenMessage]
+    public partial struct TelemetrySamplingReportMessage
+    {
+        /// <summary>
+        /// Codegen type index of the component config.
+        /// </summary>
+        internal uint ComponentTypeIndex;
+
+        /// <summary>
+        /// Key hash of the component config.
+        /// </summary>
+        internal uint ComponentKeyHash;
+
+        /// <summary>
+        /// Id of the sampling config used since the previous report.
+        /// </summary>
+        internal uint ConfigId;
+
+        /// <summary>
+        /// Sampling policy used since the previous report.
+        /// </summary>
+        internal TelemetrySamplingPolicy Policy;
+
+        /// <summary>
+        /// Number of telemetry messages offered by the component.
+        /// </summary>
+        internal ulong OfferedCount;
+
+        /// <summary>
+        /// Number of telemetry messages sent to the telemetry channel.
+        /// </summary>
+        internal ulong SentCount;
+    }
+}
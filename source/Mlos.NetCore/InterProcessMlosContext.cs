@@ -6,6 +6,11 @@
 // </copyright>
 // -----------------------------------------------------------------------
 
+using System;
+using System.Collections.Generic;
+using System.Runtime.InteropServices;
+using System.Text;
+
 using MlosProxy = Proxy.Mlos.Core;
 using MlosProxyInternal = Proxy.Mlos.Core.Internal;
 
@@ -18,87 +23,356 @@ namespace Mlos.Core
     {
         /// <remarks>
         /// Shared memory mapping name must start with "Host_" prefix, to be accessible from certain applications.
-        /// TODO: Make these config regions configurable to support multiple processes.
+        /// The instance name from the options is appended to the names, see <see cref="MlosContextOptions.GetSharedObjectName"/>.
         /// </remarks>
         private const string GlobalMemoryMapName = "Host_Mlos.GlobalMemory";
         private const string ControlChannelMemoryMapName = "Host_Mlos.ControlChannel";
         private const string FeedbackChannelMemoryMapName = "Host_Mlos.FeedbackChannel";
+        private const string TelemetryChannelMemoryMapName = "Host_Mlos.TelemetryChannel";
         private const string ControlChannelSemaphoreName = @"Global\ControlChannel_Event"; //// FIXME: Use non-backslashes for Linux environments.
         private const string FeedbackChannelSemaphoreName = @"Global\FeedbackChannel_Event";
+        private const string TelemetryChannelSemaphoreName = @"Global\TelemetryChannel_Event";
+        private const string TelemetryChannelShardSemaphoreNamePrefix = @"Global\TelemetryChannel_Event_Shard";
 
         private const string SharedConfigMemoryMapName = "Host_Mlos.Config.SharedMemory";
+        private const string TelemetryChannelLatencyMemoryMapName = "Host_Mlos.TelemetryChannel.Latency";
+
+        private const int SharedConfigMemorySize = 65536;
+
+        /// <summary>
+        /// Signature of the anonymous shared memory handshake ("MLOS").
+        /// </summary>
+        private const uint AnonymousSharedMemoryHandshakeSignature = 0x534f4c4d;
 
-        private const int SharedMemorySize = 65536;
+        /// <summary>
+        /// Number of the file descriptors passed with the handshake, excluding the telemetry channel events.
+        /// Global memory, control, feedback and telemetry channel memory, control and feedback channel events.
+        /// </summary>
+        private const int AnonymousSharedMemoryFileDescriptorCount = 6;
+
+        /// <summary>
+        /// Size of the handshake message, signature, file descriptor count, telemetry channel shard count
+        /// and the null terminated instance name, padded to the alignment of the struct.
+        /// </summary>
+        private const int AnonymousSharedMemoryHandshakeSize = 80;
+
+        private const int InstanceNameOffset = 12;
+
+        private const int S_OK = 0;
+        private const int E_FAIL = unchecked((int)0x80004005);
 
         /// <summary>
         /// Always create...
         /// </summary>
+        /// <param name="options">Sizes of the shared memory regions and the instance name, uses the default options if null.</param>
         /// <returns>InterProcessMlosContext instance.</returns>
-        public static InterProcessMlosContext Create()
+        public static InterProcessMlosContext Create(MlosContextOptions options = null)
         {
+            options ??= new MlosContextOptions();
+            options.Verify();
+
             // Create or open the memory mapped files.
             //
-            SharedMemoryRegionView<MlosProxyInternal.GlobalMemoryRegion> globalMemoryRegionView = SharedMemoryRegionView.Create<MlosProxyInternal.GlobalMemoryRegion>(GlobalMemoryMapName, SharedMemorySize);
-            SharedMemoryMapView controlChannelMemoryMapView = SharedMemoryMapView.Create(ControlChannelMemoryMapName, SharedMemorySize);
-            SharedMemoryMapView feedbackChannelMemoryMapView = SharedMemoryMapView.Create(FeedbackChannelMemoryMapName, SharedMemorySize);
-            SharedMemoryRegionView<MlosProxyInternal.SharedConfigMemoryRegion> sharedConfigMemoryMapView = SharedMemoryRegionView.Create<MlosProxyInternal.SharedConfigMemoryRegion>(SharedConfigMemoryMapName, SharedMemorySize);
+            SharedMemoryRegionView<MlosProxyInternal.GlobalMemoryRegion> globalMemoryRegionView = SharedMemoryRegionView.Create<MlosProxyInternal.GlobalMemoryRegion>(options.GetSharedObjectName(GlobalMemoryMapName), options.GlobalMemoryRegionSize);
+            SharedMemoryMapView controlChannelMemoryMapView = SharedMemoryMapView.Create(options.GetSharedObjectName(ControlChannelMemoryMapName), options.ControlChannelSize, options.UseHugePages);
+            SharedMemoryMapView feedbackChannelMemoryMapView = SharedMemoryMapView.Create(options.GetSharedObjectName(FeedbackChannelMemoryMapName), options.FeedbackChannelSize, options.UseHugePages);
+            SharedMemoryMapView telemetryChannelMemoryMapView = SharedMemoryMapView.Create(options.GetSharedObjectName(TelemetryChannelMemoryMapName), options.TelemetryChannelSize, options.UseHugePages);
+            SharedMemoryRegionView<MlosProxyInternal.SharedConfigMemoryRegion> sharedConfigMemoryMapView = SharedMemoryRegionView.Create<MlosProxyInternal.SharedConfigMemoryRegion>(options.GetSharedObjectName(SharedConfigMemoryMapName), SharedConfigMemorySize, options.UseHugePages);
 
             // Create channel synchronization primitives.
             //
-            NamedEvent controlChannelNamedEvent = NamedEvent.CreateOrOpen(ControlChannelSemaphoreName);
-            NamedEvent feedbackChannelNamedEvent = NamedEvent.CreateOrOpen(FeedbackChannelSemaphoreName);
+            NamedEvent controlChannelNamedEvent = NamedEvent.CreateOrOpen(options.GetSharedObjectName(ControlChannelSemaphoreName));
+            NamedEvent feedbackChannelNamedEvent = NamedEvent.CreateOrOpen(options.GetSharedObjectName(FeedbackChannelSemaphoreName));
+            NamedEvent[] telemetryChannelNamedEvents = CreateOrOpenTelemetryChannelNamedEvents(globalMemoryRegionView, options);
 
             return new InterProcessMlosContext(
                 globalMemoryRegionView,
                 controlChannelMemoryMapView,
                 feedbackChannelMemoryMapView,
+                telemetryChannelMemoryMapView,
                 sharedConfigMemoryMapView,
                 controlChannelNamedEvent,
-                feedbackChannelNamedEvent);
+                feedbackChannelNamedEvent,
+                telemetryChannelNamedEvents);
         }
 
         /// <summary>
         /// Initializes a new instance of the <see cref="InterProcessMlosContext"/> class.
         /// </summary>
+        /// <param name="options">Sizes of the shared memory regions and the instance name, uses the default options if null.</param>
         /// <returns>InterProcessMlosContext instance.</returns>
-        public static InterProcessMlosContext CreateOrOpen()
+        /// <remarks>
+        /// Existing shared memory regions keep their size, the channels use the size discovered from the mapping.
+        /// </remarks>
+        public static InterProcessMlosContext CreateOrOpen(MlosContextOptions options = null)
         {
+            options ??= new MlosContextOptions();
+            options.Verify();
+
             // Create or open the memory mapped files.
             //
-            SharedMemoryRegionView<MlosProxyInternal.GlobalMemoryRegion> globalMemoryRegionView = SharedMemoryRegionView.CreateOrOpen<MlosProxyInternal.GlobalMemoryRegion>(GlobalMemoryMapName, SharedMemorySize);
-            SharedMemoryMapView controlChannelMemoryMapView = SharedMemoryMapView.CreateOrOpen(ControlChannelMemoryMapName, SharedMemorySize);
-            SharedMemoryMapView feedbackChannelMemoryMapView = SharedMemoryMapView.CreateOrOpen(FeedbackChannelMemoryMapName, SharedMemorySize);
-            SharedMemoryRegionView<MlosProxyInternal.SharedConfigMemoryRegion> sharedConfigMemoryMapView = SharedMemoryRegionView.CreateOrOpen<MlosProxyInternal.SharedConfigMemoryRegion>(SharedConfigMemoryMapName, SharedMemorySize);
+            SharedMemoryRegionView<MlosProxyInternal.GlobalMemoryRegion> globalMemoryRegionView = SharedMemoryRegionView.CreateOrOpen<MlosProxyInternal.GlobalMemoryRegion>(options.GetSharedObjectName(GlobalMemoryMapName), options.GlobalMemoryRegionSize);
+            SharedMemoryMapView controlChannelMemoryMapView = SharedMemoryMapView.CreateOrOpen(options.GetSharedObjectName(ControlChannelMemoryMapName), options.ControlChannelSize, options.UseHugePages);
+            SharedMemoryMapView feedbackChannelMemoryMapView = SharedMemoryMapView.CreateOrOpen(options.GetSharedObjectName(FeedbackChannelMemoryMapName), options.FeedbackChannelSize, options.UseHugePages);
+            SharedMemoryMapView telemetryChannelMemoryMapView = SharedMemoryMapView.CreateOrOpen(options.GetSharedObjectName(TelemetryChannelMemoryMapName), options.TelemetryChannelSize, options.UseHugePages);
+            SharedMemoryRegionView<MlosProxyInternal.SharedConfigMemoryRegion> sharedConfigMemoryMapView = SharedMemoryRegionView.CreateOrOpen<MlosProxyInternal.SharedConfigMemoryRegion>(options.GetSharedObjectName(SharedConfigMemoryMapName), SharedConfigMemorySize, options.UseHugePages);
 
             // Create channel synchronization primitives.
             //
-            NamedEvent controlChannelNamedEvent = NamedEvent.CreateOrOpen(ControlChannelSemaphoreName);
-            NamedEvent feedbackChannelNamedEvent = NamedEvent.CreateOrOpen(FeedbackChannelSemaphoreName);
+            NamedEvent controlChannelNamedEvent = NamedEvent.CreateOrOpen(options.GetSharedObjectName(ControlChannelSemaphoreName));
+            NamedEvent feedbackChannelNamedEvent = NamedEvent.CreateOrOpen(options.GetSharedObjectName(FeedbackChannelSemaphoreName));
+            NamedEvent[] telemetryChannelNamedEvents = CreateOrOpenTelemetryChannelNamedEvents(globalMemoryRegionView, options);
 
             return new InterProcessMlosContext(
                 globalMemoryRegionView,
                 controlChannelMemoryMapView,
                 feedbackChannelMemoryMapView,
+                telemetryChannelMemoryMapView,
                 sharedConfigMemoryMapView,
                 controlChannelNamedEvent,
-                feedbackChannelNamedEvent);
+                feedbackChannelNamedEvent,
+                telemetryChannelNamedEvents);
+        }
+
+        /// <summary>
+        /// Accepts the anonymous shared memory and events from the target process connecting to the listening socket.
+        /// </summary>
+        /// <param name="listeningSocket"></param>
+        /// <returns>InterProcessMlosContext instance.</returns>
+        /// <remarks>
+        /// The target process calls InterProcessMlosContextInitializer::InitializeAnonymous, it defines the instance name,
+        /// the telemetry channel shard count and the channel sizes. The shared config memory still uses the named shared memory.
+        /// The result is sent back to the target process, so it does not wait for an agent which failed to attach.
+        /// See Also: Mlos.Core/InterProcessMlosContext.Linux.cpp.
+        /// </remarks>
+        public static InterProcessMlosContext AcceptAnonymous(Linux.UnixDomainSocket listeningSocket)
+        {
+            if (!RuntimeInformation.IsOSPlatform(OSPlatform.Linux))
+            {
+                throw new InvalidOperationException("Unsupported OS.");
+            }
+
+            using Linux.UnixDomainSocket targetConnection = listeningSocket.Accept();
+
+            var handshake = new byte[AnonymousSharedMemoryHandshakeSize];
+            var fileDescriptors = new int[AnonymousSharedMemoryFileDescriptorCount + (int)MlosContextOptions.MaxTelemetryChannelShardCount];
+
+            int fileDescriptorCount = targetConnection.Receive(handshake, fileDescriptors);
+
+            InterProcessMlosContext mlosContext;
+
+            try
+            {
+                mlosContext = OpenAnonymous(handshake, fileDescriptors, fileDescriptorCount);
+            }
+            catch
+            {
+                // Let the target process know we failed to attach.
+                //
+                targetConnection.Send(BitConverter.GetBytes(E_FAIL));
+                throw;
+            }
+
+            try
+            {
+                targetConnection.Send(BitConverter.GetBytes(S_OK));
+            }
+            catch
+            {
+                mlosContext.Dispose();
+                throw;
+            }
+
+            return mlosContext;
+        }
+
+        /// <summary>
+        /// Opens the anonymous shared memory and events received with the handshake.
+        /// </summary>
+        /// <param name="handshake"></param>
+        /// <param name="fileDescriptors"></param>
+        /// <param name="fileDescriptorCount"></param>
+        /// <returns></returns>
+        /// <remarks>
+        /// Takes the ownership of all the file descriptors, closes them if the handshake is not valid.
+        /// </remarks>
+        private static InterProcessMlosContext OpenAnonymous(byte[] handshake, int[] fileDescriptors, int fileDescriptorCount)
+        {
+            uint signature = BitConverter.ToUInt32(handshake, 0);
+            uint handshakeFileDescriptorCount = BitConverter.ToUInt32(handshake, 4);
+            uint shardCount = BitConverter.ToUInt32(handshake, 8);
+
+            int instanceNameLength = Array.IndexOf(handshake, (byte)0, InstanceNameOffset, MlosContextOptions.MaxInstanceNameLength + 1) - InstanceNameOffset;
+            string instanceName = instanceNameLength >= 0 ? Encoding.ASCII.GetString(handshake, InstanceNameOffset, instanceNameLength) : null;
+
+            if (signature != AnonymousSharedMemoryHandshakeSignature ||
+                !MlosContextOptions.IsValidTelemetryChannelShardCount(shardCount) ||
+                handshakeFileDescriptorCount != AnonymousSharedMemoryFileDescriptorCount + shardCount ||
+                handshakeFileDescriptorCount != fileDescriptorCount ||
+                !MlosContextOptions.IsValidInstanceName(instanceName))
+            {
+                for (int index = 0; index < fileDescriptorCount; index++)
+                {
+                    _ = Linux.Native.Close((IntPtr)fileDescriptors[index]);
+                }
+
+                throw new InvalidOperationException("Invalid anonymous shared memory handshake.");
+            }
+
+            // The views and the events take the ownership of the file descriptors.
+            //
+            var globalMemoryRegionView = new SharedMemoryRegionView<MlosProxyInternal.GlobalMemoryRegion>(Linux.SharedMemoryMapView.OpenFileDescriptor(fileDescriptors[0]));
+            SharedMemoryMapView controlChannelMemoryMapView = Linux.SharedMemoryMapView.OpenFileDescriptor(fileDescriptors[1]);
+            SharedMemoryMapView feedbackChannelMemoryMapView = Linux.SharedMemoryMapView.OpenFileDescriptor(fileDescriptors[2]);
+            SharedMemoryMapView telemetryChannelMemoryMapView = Linux.SharedMemoryMapView.OpenFileDescriptor(fileDescriptors[3]);
+
+            NamedEvent controlChannelNamedEvent = Linux.AnonymousEvent.OpenFileDescriptor(fileDescriptors[4]);
+            NamedEvent feedbackChannelNamedEvent = Linux.AnonymousEvent.OpenFileDescriptor(fileDescriptors[5]);
+            var telemetryChannelNamedEvents = new NamedEvent[shardCount];
+
+            for (int shardIndex = 0; shardIndex < shardCount; shardIndex++)
+            {
+                telemetryChannelNamedEvents[shardIndex] = Linux.AnonymousEvent.OpenFileDescriptor(fileDescriptors[AnonymousSharedMemoryFileDescriptorCount + shardIndex]);
+            }
+
+            var disposables = new List<IDisposable>(telemetryChannelNamedEvents)
+            {
+                globalMemoryRegionView,
+                controlChannelMemoryMapView,
+                feedbackChannelMemoryMapView,
+                telemetryChannelMemoryMapView,
+                controlChannelNamedEvent,
+                feedbackChannelNamedEvent,
+            };
+
+            try
+            {
+                if (globalMemoryRegionView.MemoryRegion().TelemetryChannelShardCount.Load() != shardCount)
+                {
+                    throw new InvalidOperationException("Invalid anonymous shared memory handshake, the telemetry channel shard count does not match.");
+                }
+
+                var options = new MlosContextOptions { InstanceName = instanceName };
+
+                SharedMemoryRegionView<MlosProxyInternal.SharedConfigMemoryRegion> sharedConfigMemoryMapView = SharedMemoryRegionView.CreateOrOpen<MlosProxyInternal.SharedConfigMemoryRegion>(options.GetSharedObjectName(SharedConfigMemoryMapName), SharedConfigMemorySize, options.UseHugePages);
+                disposables.Add(sharedConfigMemoryMapView);
+
+                return new InterProcessMlosContext(
+                    globalMemoryRegionView,
+                    controlChannelMemoryMapView,
+                    feedbackChannelMemoryMapView,
+                    telemetryChannelMemoryMapView,
+                    sharedConfigMemoryMapView,
+                    controlChannelNamedEvent,
+                    feedbackChannelNamedEvent,
+                    telemetryChannelNamedEvents);
+            }
+            catch
+            {
+                foreach (IDisposable disposable in disposables)
+                {
+                    disposable.Dispose();
+                }
+
+                throw;
+            }
+        }
+
+        /// <summary>
+        /// Creates or opens the named events of the telemetry channel shards.
+        /// </summary>
+        /// <param name="globalMemoryRegionView"></param>
+        /// <param name="options"></param>
+        /// <returns></returns>
+        /// <remarks>
+        /// The first process sets the telemetry channel shard count and the frame timestamps, other processes use the existing ones.
+        /// The first shard uses the same event name as the unsharded channel.
+        /// See Also: Mlos.Core/InterProcessMlosContext.cpp.
+        /// </remarks>
+        private static NamedEvent[] CreateOrOpenTelemetryChannelNamedEvents(
+            SharedMemoryRegionView<MlosProxyInternal.GlobalMemoryRegion> globalMemoryRegionView,
+            MlosContextOptions options)
+        {
+            MlosProxyInternal.GlobalMemoryRegion globalMemoryRegion = globalMemoryRegionView.MemoryRegion();
+
+            uint shardCount = globalMemoryRegion.TelemetryChannelShardCount.CompareExchange(options.TelemetryChannelShardCount, 0);
+            if (shardCount == 0)
+            {
+                shardCount = options.TelemetryChannelShardCount;
+
+                for (int shardIndex = 0; shardIndex < MlosContextOptions.MaxTelemetryChannelShardCount; shardIndex++)
+                {
+                    globalMemoryRegion.TelemetryChannelSynchronization[shardIndex].HasFrameTimestamps.Store(options.TelemetryChannelFrameTimestamps);
+                    globalMemoryRegion.TelemetryChannelSynchronization[shardIndex].HasCompactFrameHeaders.Store(options.TelemetryChannelCompactFrameHeaders);
+                }
+            }
+
+            if (!MlosContextOptions.IsValidTelemetryChannelShardCount(shardCount))
+            {
+                throw new InvalidOperationException($"Invalid telemetry channel shard count {shardCount}.");
+            }
+
+            var telemetryChannelNamedEvents = new NamedEvent[shardCount];
+
+            for (uint shardIndex = 0; shardIndex < shardCount; shardIndex++)
+            {
+                string semaphoreName = shardIndex == 0
+                    ? TelemetryChannelSemaphoreName
+                    : $"{TelemetryChannelShardSemaphoreNamePrefix}{shardIndex}";
+
+                telemetryChannelNamedEvents[shardIndex] = NamedEvent.CreateOrOpen(options.GetSharedObjectName(semaphoreName));
+            }
+
+            return telemetryChannelNamedEvents;
+        }
+
+        /// <summary>
+        /// Opens the telemetry channel latency histograms created by the target process.
+        /// </summary>
+        /// <param name="options">The instance name of the MlosContext, uses the default instance if null.</param>
+        /// <returns>Latency memory region view.</returns>
+        /// <remarks>
+        /// The target process creates the memory region in MlosContext::EnableTelemetryChannelLatencyStats.
+        /// The histograms are updated in place, they can be read while the target process and the agent are running.
+        /// </remarks>
+        public static SharedMemoryRegionView<MlosProxyInternal.ChannelLatencyMemoryRegion> OpenTelemetryChannelLatencyStats(MlosContextOptions options = null)
+        {
+            options ??= new MlosContextOptions();
+            options.Verify();
+
+            return SharedMemoryRegionView.Open<MlosProxyInternal.ChannelLatencyMemoryRegion>(
+                options.GetSharedObjectName(TelemetryChannelLatencyMemoryMapName),
+                new MlosProxyInternal.ChannelLatencyMemoryRegion().CodegenTypeSize());
         }
 
         internal InterProcessMlosContext(
             SharedMemoryRegionView<MlosProxyInternal.GlobalMemoryRegion> globalMemoryRegionView,
             SharedMemoryMapView controlChannelMemoryMapView,
             SharedMemoryMapView feedbackChannelMemoryMapView,
+            SharedMemoryMapView telemetryChannelMemoryMapView,
             SharedMemoryRegionView<MlosProxyInternal.SharedConfigMemoryRegion> sharedConfigMemoryMapView,
             NamedEvent controlChannelNamedEvent,
-            NamedEvent feedbackChannelNamedEvent)
+            NamedEvent feedbackChannelNamedEvent,
+            NamedEvent[] telemetryChannelNamedEvents)
         {
             this.globalMemoryRegionView = globalMemoryRegionView;
             this.controlChannelMemoryMapView = controlChannelMemoryMapView;
             this.feedbackChannelMemoryMapView = feedbackChannelMemoryMapView;
+            this.telemetryChannelMemoryMapView = telemetryChannelMemoryMapView;
             this.sharedConfigMemoryMapView = sharedConfigMemoryMapView;
 
             this.controlChannelNamedEvent = controlChannelNamedEvent;
             this.feedbackChannelNamedEvent = feedbackChannelNamedEvent;
+            this.telemetryChannelNamedEvents = telemetryChannelNamedEvents;
+
+            // Shared memory created by another process keeps its size, verify the channels can use it.
+            //
+            if (!MlosContextOptions.IsValidChannelSize(controlChannelMemoryMapView.MemSize) ||
+                !MlosContextOptions.IsValidChannelSize(feedbackChannelMemoryMapView.MemSize) ||
+                !MlosContextOptions.IsValidChannelSize(telemetryChannelMemoryMapView.MemSize / (ulong)telemetryChannelNamedEvents.Length))
+            {
+                throw new InvalidOperationException("Invalid shared channel size, the size must be a power of two.");
+            }
 
             MlosProxyInternal.GlobalMemoryRegion globalMemoryRegion = globalMemoryRegionView.MemoryRegion();
 
@@ -127,6 +401,26 @@ namespace Mlos.Core
             {
                 ChannelPolicy = { NotificationEvent = feedbackChannelNamedEvent },
             };
+
+            // Create the telemetry channel shards, the telemetry channel memory is split into equal shards.
+            //
+            int shardCount = telemetryChannelNamedEvents.Length;
+            uint shardSize = (uint)(telemetryChannelMemoryMapView.MemSize / (ulong)shardCount);
+
+            var telemetryChannelShards = new ISharedChannel[shardCount];
+
+            for (int shardIndex = 0; shardIndex < shardCount; shardIndex++)
+            {
+                telemetryChannelShards[shardIndex] = new SharedChannel<InterProcessSharedChannelPolicy, SharedChannelSpinPolicy>(
+                    buffer: telemetryChannelMemoryMapView.Buffer + (int)(shardIndex * shardSize),
+                    size: shardSize,
+                    sync: globalMemoryRegion.TelemetryChannelSynchronization[shardIndex])
+                {
+                    ChannelPolicy = { NotificationEvent = telemetryChannelNamedEvents[shardIndex] },
+                };
+            }
+
+            TelemetryChannelShards = telemetryChannelShards;
         }
 
         /// <inheritdoc/>
@@ -146,9 +440,15 @@ namespace Mlos.Core
                 globalMemoryRegionView.CleanupOnClose = true;
                 controlChannelMemoryMapView.CleanupOnClose = true;
                 feedbackChannelMemoryMapView.CleanupOnClose = true;
+                telemetryChannelMemoryMapView.CleanupOnClose = true;
                 sharedConfigMemoryMapView.CleanupOnClose = true;
                 controlChannelNamedEvent.CleanupOnClose = true;
                 feedbackChannelNamedEvent.CleanupOnClose = true;
+
+                foreach (NamedEvent telemetryChannelNamedEvent in telemetryChannelNamedEvents)
+                {
+                    telemetryChannelNamedEvent.CleanupOnClose = true;
+                }
             }
 
             base.Dispose(disposing);
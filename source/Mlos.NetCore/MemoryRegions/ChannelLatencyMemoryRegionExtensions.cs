@@ -0,0 +1,166 @@
+// -----------------------------------------------------------------------
+// <copyright file="ChannelLatencyMemoryRegionExtensions.cs" company="Microsoft Corporation">
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License. See LICENSE in the project root
+// for license information.
+// </copyright>
+// -----------------------------------------------------------------------
+
+using System;
+using System.IO;
+using System.Numerics;
+
+namespace Proxy.Mlos.Core.Internal
+{
+    /// <summary>
+    /// Helpers to read the channel latency histograms.
+    /// </summary>
+    /// <remarks>
+    /// See Also: Mlos.Core/ChannelLatencyMemoryRegion.h for the bucket layout.
+    /// </remarks>
+    public static class ChannelLatencyMemoryRegionExtensions
+    {
+        /// <summary>
+        /// Number of the message types with the latency histograms.
+        /// </summary>
+        public const int LatencyStatsTypeCount = 256;
+
+        /// <summary>
+        /// Number of the histogram buckets.
+        /// </summary>
+        public const int BucketCount = 256;
+
+        /// <summary>
+        /// Number of the histogram buckets per power of two.
+        /// </summary>
+        public const int SubBucketCount = 8;
+
+        /// <summary>
+        /// Gets the index of the histogram bucket holding the given value.
+        /// </summary>
+        /// <param name="value"></param>
+        /// <returns></returns>
+        /// <remarks>
+        /// Values beyond the range of the histogram are stored in the last bucket.
+        /// </remarks>
+        public static int BucketIndex(ulong value)
+        {
+            if (value < SubBucketCount)
+            {
+                return (int)value;
+            }
+
+            int shift = 63 - BitOperations.LeadingZeroCount(value) - 3;
+            int bucketIndex = ((shift + 1) * SubBucketCount) + (int)((value >> shift) & (SubBucketCount - 1));
+
+            return Math.Min(bucketIndex, BucketCount - 1);
+        }
+
+        /// <summary>
+        /// Records the latency in the histogram.
+        /// </summary>
+        /// <param name="histogram"></param>
+        /// <param name="latencyInNanoseconds"></param>
+        /// <remarks>
+        /// Multiple readers might update the same histogram, the counters are updated with interlocked operations.
+        /// </remarks>
+        public static void Record(this ChannelLatencyHistogram histogram, ulong latencyInNanoseconds)
+        {
+            histogram.Buckets[BucketIndex(latencyInNanoseconds)].FetchAdd(1);
+            histogram.TotalInNanoseconds.FetchAdd(latencyInNanoseconds);
+            histogram.Count.FetchAdd(1);
+        }
+
+        /// <summary>
+        /// Gets the smallest value stored in the histogram bucket.
+        /// </summary>
+        /// <param name="bucketIndex"></param>
+        /// <returns></returns>
+        public static ulong BucketLowerBound(int bucketIndex)
+        {
+            if (bucketIndex < SubBucketCount)
+            {
+                return (ulong)bucketIndex;
+            }
+
+            int shift = (bucketIndex / SubBucketCount) - 1;
+            ulong subBucket = (ulong)(SubBucketCount + (bucketIndex % SubBucketCount));
+
+            return subBucket << shift;
+        }
+
+        /// <summary>
+        /// Gets the latency in nanoseconds at the given percentile (0-100).
+        /// </summary>
+        /// <param name="histogram"></param>
+        /// <param name="percentile"></param>
+        /// <returns>The upper bound of the bucket containing the percentile, zero if the histogram is empty.</returns>
+        /// <remarks>
+        /// The histogram might be updated concurrently by the target process, the result is computed from a snapshot of the buckets.
+        /// </remarks>
+        public static ulong ValueAtPercentile(this ChannelLatencyHistogram histogram, double percentile)
+        {
+            var buckets = new ulong[BucketCount];
+            ulong totalCount = 0;
+
+            for (int bucketIndex = 0; bucketIndex < BucketCount; bucketIndex++)
+            {
+                buckets[bucketIndex] = histogram.Buckets[bucketIndex].Load();
+                totalCount += buckets[bucketIndex];
+            }
+
+            if (totalCount == 0)
+            {
+                return 0;
+            }
+
+            double clampedPercentile = Math.Min(Math.Max(percentile, 0.0), 100.0);
+            ulong targetCount = Math.Max((ulong)((totalCount * clampedPercentile / 100.0) + 0.5), 1);
+
+            ulong count = 0;
+            for (int bucketIndex = 0; bucketIndex < BucketCount; bucketIndex++)
+            {
+                count += buckets[bucketIndex];
+
+                if (count >= targetCount)
+                {
+                    return BucketLowerBound(bucketIndex + 1) - 1;
+                }
+            }
+
+            return BucketLowerBound(BucketCount) - 1;
+        }
+
+        /// <summary>
+        /// Writes the percentiles of the latencies for each message type.
+        /// </summary>
+        /// <param name="latencyStats"></param>
+        /// <param name="writer"></param>
+        /// <remarks>
+        /// Latencies are in microseconds. The histograms can be read while the target process is running.
+        /// </remarks>
+        public static void WriteLatencyStats(this ChannelLatencyMemoryRegion latencyStats, TextWriter writer)
+        {
+            writer.WriteLine("Telemetry channel latency (us): type index, count, queueing p50/p99/p99.9, handler p50/p99/p99.9");
+
+            for (int codegenTypeIndex = 0; codegenTypeIndex < LatencyStatsTypeCount; codegenTypeIndex++)
+            {
+                ChannelLatencyStats typeLatencyStats = latencyStats.LatencyStatsByType[codegenTypeIndex];
+
+                ulong count = typeLatencyStats.HandlerDuration.Count.Load();
+                if (count == 0)
+                {
+                    continue;
+                }
+
+                ChannelLatencyHistogram queueingDelay = typeLatencyStats.QueueingDelay;
+                ChannelLatencyHistogram handlerDuration = typeLatencyStats.HandlerDuration;
+
+                writer.WriteLine(
+                    $"{codegenTypeIndex}, {count}, " +
+                    $"{queueingDelay.ValueAtPercentile(50) / 1000}/{queueingDelay.ValueAtPercentile(99) / 1000}/{queueingDelay.ValueAtPercentile(99.9) / 1000}, " +
+                    $"{handlerDuration.ValueAtPercentile(50) / 1000}/{handlerDuration.ValueAtPercentile(99) / 1000}/{handlerDuration.ValueAtPercentile(99.9) / 1000}");
+            }
+        }
+    }
+}
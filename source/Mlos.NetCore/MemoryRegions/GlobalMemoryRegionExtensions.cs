@@ -0,0 +1,165 @@
+// -----------------------------------------------------------------------
+// <copyright file="GlobalMemoryRegionExtensions.cs" company="Microsoft Corporation">
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License. See LICENSE in the project root
+// for license information.
+// </copyright>
+// -----------------------------------------------------------------------
+
+using System;
+using System.Linq;
+using System.Reflection;
+
+using Mlos.Core;
+using Mlos.SettingsSystem.Attributes;
+using Proxy.Mlos.SettingsSystem.StdTypes;
+
+namespace Proxy.Mlos.Core.Internal
+{
+    /// <summary>
+    /// Helpers to update the telemetry message subscriptions.
+    /// </summary>
+    /// <remarks>
+    /// See Also: Mlos.Core/MlosContext.inl IsTelemetryMessageSubscribed.
+    /// </remarks>
+    public static class GlobalMemoryRegionExtensions
+    {
+        /// <summary>
+        /// Number of the message types in the subscription bitmap.
+        /// </summary>
+        public const uint TelemetrySubscriptionTypeCount = 64 * 64;
+
+        /// <summary>
+        /// Checks if the telemetry messages of the given type are sent to the agent.
+        /// </summary>
+        /// <param name="globalMemoryRegion"></param>
+        /// <param name="codegenTypeIndex"></param>
+        /// <returns></returns>
+        public static bool IsTelemetrySubscribed(this GlobalMemoryRegion globalMemoryRegion, uint codegenTypeIndex)
+        {
+            if (codegenTypeIndex >= TelemetrySubscriptionTypeCount)
+            {
+                return true;
+            }
+
+            return (globalMemoryRegion.TelemetrySubscriptionBitmap[(int)(codegenTypeIndex / 64)].Load() & (1UL << (int)(codegenTypeIndex % 64))) != 0;
+        }
+
+        /// <summary>
+        /// Enables or disables sending the telemetry messages of the given type.
+        /// </summary>
+        /// <param name="globalMemoryRegion"></param>
+        /// <param name="codegenTypeIndex"></param>
+        /// <param name="isSubscribed"></param>
+        /// <remarks>
+        /// Message types outside of the subscription bitmap are always sent.
+        /// </remarks>
+        public static void SetTelemetrySubscription(this GlobalMemoryRegion globalMemoryRegion, uint codegenTypeIndex, bool isSubscribed)
+        {
+            if (codegenTypeIndex >= TelemetrySubscriptionTypeCount)
+            {
+                return;
+            }
+
+            AtomicUInt64 subscriptionBits = globalMemoryRegion.TelemetrySubscriptionBitmap[(int)(codegenTypeIndex / 64)];
+            ulong mask = 1UL << (int)(codegenTypeIndex % 64);
+
+            ulong currentBits = subscriptionBits.Load();
+
+            while (true)
+            {
+                ulong newBits = isSubscribed ? currentBits | mask : currentBits & ~mask;
+
+                if (newBits == currentBits)
+                {
+                    return;
+                }
+
+                ulong previousBits = subscriptionBits.CompareExchange(newBits, currentBits);
+
+                if (previousBits == currentBits)
+                {
+                    return;
+                }
+
+                currentBits = previousBits;
+            }
+        }
+
+        /// <summary>
+        /// Enables sending the telemetry messages of the given type.
+        /// </summary>
+        /// <typeparam name="T">Message proxy type.</typeparam>
+        /// <param name="globalMemoryRegion"></param>
+        public static void SubscribeTelemetry<T>(this GlobalMemoryRegion globalMemoryRegion)
+            where T : ICodegenProxy, new()
+        {
+            globalMemoryRegion.SetTelemetrySubscription(default(T).CodegenTypeIndex(), isSubscribed: true);
+        }
+
+        /// <summary>
+        /// Disables sending the telemetry messages of the given type.
+        /// </summary>
+        /// <typeparam name="T">Message proxy type.</typeparam>
+        /// <param name="globalMemoryRegion"></param>
+        public static void UnsubscribeTelemetry<T>(this GlobalMemoryRegion globalMemoryRegion)
+            where T : ICodegenProxy, new()
+        {
+            globalMemoryRegion.SetTelemetrySubscription(default(T).CodegenTypeIndex(), isSubscribed: false);
+        }
+
+        /// <summary>
+        /// Subscribes the message types of the settings assembly which have a callback, and unsubscribes the others.
+        /// </summary>
+        /// <param name="globalMemoryRegion"></param>
+        /// <param name="settingsAssembly">Registered settings assembly.</param>
+        /// <remarks>
+        /// The callbacks are the static Callback fields of the proxy types.
+        /// The assembly must be registered first, so the proxies return the global codegen type index.
+        /// </remarks>
+        public static void UpdateTelemetrySubscriptions(this GlobalMemoryRegion globalMemoryRegion, Assembly settingsAssembly)
+        {
+            foreach (Type proxyType in settingsAssembly.GetTypes())
+            {
+                if (!proxyType.IsValueType || !typeof(ICodegenProxy).IsAssignableFrom(proxyType))
+                {
+                    continue;
+                }
+
+                FieldInfo callbackField = proxyType.GetField("Callback", BindingFlags.Public | BindingFlags.Static);
+                if (callbackField == null)
+                {
+                    continue;
+                }
+
+                uint codegenTypeIndex = ((ICodegenProxy)Activator.CreateInstance(proxyType)).CodegenTypeIndex();
+
+                globalMemoryRegion.SetTelemetrySubscription(
+                    codegenTypeIndex,
+                    isSubscribed: callbackField.GetValue(null) != null || IsAlwaysSubscribed(proxyType));
+            }
+        }
+
+        /// <summary>
+        /// Checks if the messages of the proxy type are sent to the agent without a callback.
+        /// </summary>
+        /// <param name="proxyType"></param>
+        /// <returns></returns>
+        /// <remarks>
+        /// Mlos.Core messages (such as TelemetrySamplingReportMessage) are consumed by the agent infrastructure,
+        /// and the telemetry summaries replace the aggregated messages, dropping them would lose the telemetry.
+        /// </remarks>
+        private static bool IsAlwaysSubscribed(Type proxyType)
+        {
+            if (proxyType.Assembly == typeof(ICodegenProxy).Assembly)
+            {
+                return true;
+            }
+
+            Type codegenProxyInterface = proxyType.GetInterfaces().FirstOrDefault(
+                interfaceType => interfaceType.IsGenericType && interfaceType.GetGenericTypeDefinition() == typeof(ICodegenProxy<,>));
+
+            return codegenProxyInterface != null && codegenProxyInterface.GetGenericArguments()[0].IsTelemetrySummaryType();
+        }
+    }
+}
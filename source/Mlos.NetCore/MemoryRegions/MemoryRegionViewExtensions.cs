@@ -30,6 +30,17 @@ namespace Proxy.Mlos.Core.Internal
 
             globalMemoryRegion.RegisteredSettingsAssemblyCount.Store(1);
 
+            // All the telemetry messages are sent until the agent updates the subscriptions.
+            //
+            for (int index = 0; index < GlobalMemoryRegionExtensions.TelemetrySubscriptionTypeCount / 64; index++)
+            {
+                globalMemoryRegion.TelemetrySubscriptionBitmap[index].Store(ulong.MaxValue);
+            }
+
+            // The processes which open the region verify their Mlos.Core types against the hash.
+            //
+            globalMemoryRegion.MlosCoreDispatchTableHash = SettingsAssemblyManager.DispatchTableHash(global::Mlos.Core.ObjectDeserializeHandler.DispatchTable);
+
             return globalMemoryRegion;
         }
 
@@ -17,22 +17,29 @@ namespace Proxy.Mlos.Core.Internal
     {
         public static AllocationEntry Allocate(this SharedConfigMemoryRegion sharedConfigMemoryRegion, ulong size)
         {
-            size += default(AllocationEntry).CodegenTypeSize();
+            ulong allocationEntrySize = default(AllocationEntry).CodegenTypeSize();
+
+            size += allocationEntrySize;
 
             var allocator = sharedConfigMemoryRegion.Allocator;
 
-            if (allocator.FreeOffset + size >= sharedConfigMemoryRegion.MemoryHeader.MemoryRegionSize)
+            // Place the allocation entry so the allocated memory is aligned to 64 bytes.
+            // See Also: Mlos.Core/SharedConfigMemoryRegion.cpp
+            //
+            ulong entryOffset = Utils.Align(allocator.FreeOffset + allocationEntrySize, 64) - allocationEntrySize;
+
+            if (entryOffset + size >= sharedConfigMemoryRegion.MemoryHeader.MemoryRegionSize)
             {
                 throw new OutOfMemoryException();
             }
 
             // Update the address.
             //
-            uint offset = allocator.FreeOffset;
+            uint offset = (uint)entryOffset;
 
             // Update memory region properties.
             //
-            allocator.FreeOffset += (uint)Utils.Align(size, 64);
+            allocator.FreeOffset = (uint)Utils.Align(entryOffset + size, 64);
             allocator.AllocationCount++;
 
             // Update last allocated entry.
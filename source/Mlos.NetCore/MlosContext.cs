@@ -7,6 +7,7 @@
 // -----------------------------------------------------------------------
 
 using System;
+using System.Collections.Generic;
 
 using MlosProxyInternal = Proxy.Mlos.Core.Internal;
 
@@ -38,6 +39,15 @@ namespace Mlos.Core
         /// </summary>
         public static ISharedChannel FeedbackChannel { get; protected set; }
 
+        /// <summary>
+        /// Gets or sets the telemetry channel shards.
+        /// #TODO, those should not be static. Pass a MlosContext to the experiment class.
+        /// </summary>
+        /// <remarks>
+        /// The target process writers select the shard by the current processor, each shard is processed separately.
+        /// </remarks>
+        public static IReadOnlyList<ISharedChannel> TelemetryChannelShards { get; protected set; }
+
         public static ISharedConfigAccessor SharedConfigManager { get; set; }
 
         /// <summary>
@@ -57,10 +67,12 @@ namespace Mlos.Core
         protected SharedMemoryRegionView<MlosProxyInternal.GlobalMemoryRegion> globalMemoryRegionView;
         protected SharedMemoryMapView controlChannelMemoryMapView;
         protected SharedMemoryMapView feedbackChannelMemoryMapView;
+        protected SharedMemoryMapView telemetryChannelMemoryMapView;
         protected SharedMemoryRegionView<MlosProxyInternal.SharedConfigMemoryRegion> sharedConfigMemoryMapView;
 
         protected NamedEvent controlChannelNamedEvent;
         protected NamedEvent feedbackChannelNamedEvent;
+        protected NamedEvent[] telemetryChannelNamedEvents;
 
         protected bool isDisposed;
 
@@ -82,6 +94,9 @@ namespace Mlos.Core
             feedbackChannelMemoryMapView?.Dispose();
             feedbackChannelMemoryMapView = null;
 
+            telemetryChannelMemoryMapView?.Dispose();
+            telemetryChannelMemoryMapView = null;
+
             sharedConfigMemoryMapView?.Dispose();
             sharedConfigMemoryMapView = null;
 
@@ -91,6 +106,16 @@ namespace Mlos.Core
             feedbackChannelNamedEvent?.Dispose();
             feedbackChannelNamedEvent = null;
 
+            if (telemetryChannelNamedEvents != null)
+            {
+                foreach (NamedEvent telemetryChannelNamedEvent in telemetryChannelNamedEvents)
+                {
+                    telemetryChannelNamedEvent.Dispose();
+                }
+
+                telemetryChannelNamedEvents = null;
+            }
+
             isDisposed = true;
         }
 
@@ -124,6 +149,18 @@ namespace Mlos.Core
             feedbackChannelNamedEvent.Signal();
         }
 
+        /// <summary>
+        /// Terminates all telemetry channel shards.
+        /// </summary>
+        public void TerminateTelemetryChannel()
+        {
+            for (int shardIndex = 0; shardIndex < TelemetryChannelShards.Count; shardIndex++)
+            {
+                TelemetryChannelShards[shardIndex].SyncObject.TerminateChannel.Store(true);
+                telemetryChannelNamedEvents[shardIndex].Signal();
+            }
+        }
+
         /// <summary>
         /// Checks if the control channel is still active.
         /// </summary>
@@ -141,5 +178,16 @@ namespace Mlos.Core
         {
             return !FeedbackChannel.SyncObject.TerminateChannel.Load();
         }
+
+        /// <summary>
+        /// Checks if the telemetry channel is still active.
+        /// </summary>
+        /// <returns></returns>
+        public bool IsTelemetryChannelActive()
+        {
+            // All the shards are terminated together.
+            //
+            return !TelemetryChannelShards[0].SyncObject.TerminateChannel.Load();
+        }
     }
 }
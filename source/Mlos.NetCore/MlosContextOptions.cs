@@ -0,0 +1,174 @@
+// -----------------------------------------------------------------------
+// <copyright file="MlosContextOptions.cs" company="Microsoft Corporation">
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License. See LICENSE in the project root
+// for license information.
+// </copyright>
+// -----------------------------------------------------------------------
+
+using System;
+using System.Linq;
+
+namespace Mlos.Core
+{
+    /// <summary>
+    /// Options of the shared memory regions created by the MlosContext.
+    /// </summary>
+    /// <remarks>
+    /// See Also: Mlos.Core/MlosContext.h for the corresponding C++ options.
+    /// If the shared memory already exists (e.g. the target process created it), the existing size is used.
+    /// If the instance name is set, it is appended to the names of the shared memory regions and named events.
+    /// </remarks>
+    public class MlosContextOptions
+    {
+        /// <summary>
+        /// Maximum length of the instance name.
+        /// </summary>
+        public const int MaxInstanceNameLength = 64;
+
+        /// <summary>
+        /// Maximum number of the telemetry channel shards.
+        /// </summary>
+        /// <remarks>
+        /// See Also: Mlos.Core/ShardedSharedChannel.h MaxShardCount.
+        /// </remarks>
+        public const uint MaxTelemetryChannelShardCount = 16;
+
+        public ulong GlobalMemoryRegionSize { get; set; } = 131072;
+
+        public ulong ControlChannelSize { get; set; } = 65536;
+
+        public ulong FeedbackChannelSize { get; set; } = 65536;
+
+        public ulong TelemetryChannelSize { get; set; } = 262144;
+
+        /// <summary>
+        /// Gets or sets the number of the telemetry channel shards, the telemetry channel memory is split into equal shards.
+        /// </summary>
+        /// <remarks>
+        /// Must be a power of two. If the global memory region already exists, the existing shard count is used.
+        /// </remarks>
+        public uint TelemetryChannelShardCount { get; set; } = 1;
+
+        /// <summary>
+        /// Gets or sets a value indicating whether the telemetry channel writers append the send timestamp to each frame.
+        /// </summary>
+        /// <remarks>
+        /// If the global memory region already exists, the existing setting is used.
+        /// </remarks>
+        public bool TelemetryChannelFrameTimestamps { get; set; }
+
+        /// <summary>
+        /// Gets or sets a value indicating whether the telemetry channel frames have the compact header without the type hash.
+        /// </summary>
+        /// <remarks>
+        /// If the global memory region already exists, the existing setting is used.
+        /// </remarks>
+        public bool TelemetryChannelCompactFrameHeaders { get; set; }
+
+        /// <summary>
+        /// Gets or sets a value indicating whether the new channel buffers and the shared config memory region are backed by huge pages.
+        /// </summary>
+        /// <remarks>
+        /// Linux only. The sizes of the new shared memory regions are rounded up to the huge page size.
+        /// If the shared memory already exists, it is used regardless of this setting.
+        /// </remarks>
+        public bool UseHugePages { get; set; }
+
+        /// <summary>
+        /// Gets or sets the name of the MlosContext instance (e.g. a component name or a process id).
+        /// </summary>
+        /// <remarks>
+        /// Allowed characters are letters, digits, '_', '-' and '.'.
+        /// If not set, the MlosContext uses the default names.
+        /// </remarks>
+        public string InstanceName { get; set; }
+
+        /// <summary>
+        /// Verifies the channel sizes and the instance name.
+        /// </summary>
+        /// <exception cref="ArgumentException">Thrown when the channel size or the shard count is not a power of two or the instance name is not valid.</exception>
+        public void Verify()
+        {
+            VerifyChannelSize(ControlChannelSize, nameof(ControlChannelSize));
+            VerifyChannelSize(FeedbackChannelSize, nameof(FeedbackChannelSize));
+            VerifyChannelSize(TelemetryChannelSize, nameof(TelemetryChannelSize));
+
+            if (!IsValidTelemetryChannelShardCount(TelemetryChannelShardCount))
+            {
+                throw new ArgumentException($"Invalid telemetry channel shard count {TelemetryChannelShardCount}.", nameof(TelemetryChannelShardCount));
+            }
+
+            VerifyChannelSize(TelemetryChannelSize / TelemetryChannelShardCount, nameof(TelemetryChannelShardCount));
+
+            if (!IsValidInstanceName(InstanceName))
+            {
+                throw new ArgumentException($"Invalid instance name '{InstanceName}'.", nameof(InstanceName));
+            }
+        }
+
+        /// <summary>
+        /// Gets the name of the shared memory region or named event for the MlosContext instance.
+        /// </summary>
+        /// <param name="baseName"></param>
+        /// <returns></returns>
+        /// <remarks>
+        /// See Also: Mlos.Core/MlosContext.cpp FormatSharedObjectName.
+        /// </remarks>
+        public string GetSharedObjectName(string baseName)
+        {
+            return string.IsNullOrEmpty(InstanceName) ? baseName : $"{baseName}.{InstanceName}";
+        }
+
+        /// <summary>
+        /// Checks if the telemetry channel can be split into the given number of shards.
+        /// </summary>
+        /// <param name="shardCount"></param>
+        /// <returns></returns>
+        public static bool IsValidTelemetryChannelShardCount(uint shardCount)
+        {
+            return shardCount != 0 &&
+                shardCount <= MaxTelemetryChannelShardCount &&
+                (shardCount & (shardCount - 1)) == 0;
+        }
+
+        /// <summary>
+        /// Checks if the instance name can be a part of the shared memory and named event names.
+        /// </summary>
+        /// <param name="instanceName"></param>
+        /// <returns></returns>
+        public static bool IsValidInstanceName(string instanceName)
+        {
+            if (instanceName == null)
+            {
+                return true;
+            }
+
+            return instanceName.Length <= MaxInstanceNameLength &&
+                instanceName.All(c => (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '_' || c == '-' || c == '.');
+        }
+
+        /// <summary>
+        /// Checks if the channel can use a buffer of the given size.
+        /// </summary>
+        /// <param name="size"></param>
+        /// <returns></returns>
+        /// <remarks>
+        /// The size must be a power of two, so the positions wrap around the buffer when they overflow.
+        /// </remarks>
+        public static bool IsValidChannelSize(ulong size)
+        {
+            return size > (ulong)FrameHeader.TypeSize &&
+                size <= (1UL << 31) &&
+                (size & (size - 1)) == 0;
+        }
+
+        private static void VerifyChannelSize(ulong size, string name)
+        {
+            if (!IsValidChannelSize(size))
+            {
+                throw new ArgumentException($"Invalid channel size {size}, the size must be a power of two.", name);
+            }
+        }
+    }
+}
@@ -26,6 +26,11 @@ namespace Mlos.Core.Linux
         /// </summary>
         internal static IntPtr InvalidPointer = IntPtr.Subtract(IntPtr.Zero, 1);
 
+        /// <summary>
+        /// Futex system call number.
+        /// </summary>
+        internal static long SysFutex = RuntimeInformation.ProcessArchitecture == Architecture.Arm64 ? 98 : 202;
+
 #pragma warning disable CA2101 // Specify marshaling for P/Invoke string arguments (CharSet.Ansi is considered unsafe).
 
         /// <summary>
@@ -94,6 +99,34 @@ namespace Mlos.Core.Linux
         [DllImport(RtLib, EntryPoint = "shm_unlink", CharSet = CharSet.Ansi, SetLastError = true)]
         internal static extern int SharedMemoryUnlink(string name);
 
+        /// <summary>
+        /// Opens or creates a file.
+        /// </summary>
+        /// <param name="pathName"></param>
+        /// <param name="openFlags"></param>
+        /// <param name="mode"></param>
+        /// <returns></returns>
+        [DllImport(RtLib, EntryPoint = "open", CharSet = CharSet.Ansi, SetLastError = true)]
+        internal static extern SharedMemorySafeHandle FileOpen(string pathName, OpenFlags openFlags, ModeFlags mode);
+
+        /// <summary>
+        /// Deletes a file.
+        /// </summary>
+        /// <param name="pathName"></param>
+        /// <returns></returns>
+        [DllImport(RtLib, EntryPoint = "unlink", CharSet = CharSet.Ansi, SetLastError = true)]
+        internal static extern int FileUnlink(string pathName);
+
+        /// <summary>
+        /// Gives the kernel advice about the use of the memory.
+        /// </summary>
+        /// <param name="address"></param>
+        /// <param name="length"></param>
+        /// <param name="advice"></param>
+        /// <returns></returns>
+        [DllImport(RtLib, EntryPoint = "madvise", SetLastError = true)]
+        internal static extern int MemoryAdvise(IntPtr address, ulong length, MemoryAdvice advice);
+
         /// <summary>
         /// Map files or devices into the memory.
         /// </summary>
@@ -116,6 +149,16 @@ namespace Mlos.Core.Linux
         [DllImport(RtLib, EntryPoint = "ftruncate", SetLastError = true)]
         internal static extern int FileTruncate(SharedMemorySafeHandle handle, long length);
 
+        /// <summary>
+        /// Repositions the file offset.
+        /// </summary>
+        /// <param name="handle"></param>
+        /// <param name="offset"></param>
+        /// <param name="whence"></param>
+        /// <returns>Returns the resulting offset from the beginning of the file, or -1 on error.</returns>
+        [DllImport(RtLib, EntryPoint = "lseek", SetLastError = true)]
+        internal static extern long FileSeek(SharedMemorySafeHandle handle, long offset, SeekWhence whence);
+
         /// <summary>
         /// Closes a file descriptor.
         /// </summary>
@@ -127,8 +170,122 @@ namespace Mlos.Core.Linux
         [DllImport(RtLib, EntryPoint ="perror", CharSet = CharSet.Ansi)]
         internal static extern void PrintError(string name);
 
+        /// <summary>
+        /// Invokes the futex system call.
+        /// </summary>
+        /// <param name="number">System call number.</param>
+        /// <param name="futex">Address of the futex word.</param>
+        /// <param name="futexOperation"></param>
+        /// <param name="value"></param>
+        /// <param name="timeout"></param>
+        /// <param name="futex2"></param>
+        /// <param name="value3"></param>
+        /// <returns>Returns -1 on error, and errno is set to indicate the error.</returns>
+        [DllImport(RtLib, EntryPoint = "syscall", SetLastError = true)]
+        internal static extern long FutexSyscall(long number, IntPtr futex, FutexOperation futexOperation, uint value, IntPtr timeout, IntPtr futex2, uint value3);
+
+        /// <summary>
+        /// Receives a message and the ancillary data (file descriptors) from a socket.
+        /// </summary>
+        /// <param name="socketHandle"></param>
+        /// <param name="message"></param>
+        /// <param name="messageFlags"></param>
+        /// <returns>Returns the number of bytes received, or -1 on error.</returns>
+        [DllImport(RtLib, EntryPoint = "recvmsg", SetLastError = true)]
+        internal static extern long ReceiveMessage(IntPtr socketHandle, ref MessageHeader message, MessageFlags messageFlags);
+
+        /// <summary>
+        /// Reads the counter of the event file descriptor.
+        /// </summary>
+        /// <param name="handle"></param>
+        /// <param name="value"></param>
+        /// <param name="count"></param>
+        /// <returns>Returns the number of bytes read, or -1 on error.</returns>
+        [DllImport(RtLib, EntryPoint = "read", SetLastError = true)]
+        internal static extern long EventRead(EventSafeHandle handle, ref ulong value, ulong count);
+
+        /// <summary>
+        /// Adds the value to the counter of the event file descriptor.
+        /// </summary>
+        /// <param name="handle"></param>
+        /// <param name="value"></param>
+        /// <param name="count"></param>
+        /// <returns>Returns the number of bytes written, or -1 on error.</returns>
+        [DllImport(RtLib, EntryPoint = "write", SetLastError = true)]
+        internal static extern long EventWrite(EventSafeHandle handle, ref ulong value, ulong count);
+
 #pragma warning restore CA2101 // Specify marshaling for P/Invoke string arguments
 
+        /// <summary>
+        /// Socket level of the ancillary data.
+        /// </summary>
+        internal const int SOL_SOCKET = 1;
+
+        /// <summary>
+        /// Ancillary data type, the data is an array of the file descriptors.
+        /// </summary>
+        internal const int SCM_RIGHTS = 1;
+
+        /// <summary>
+        /// Interrupted system call.
+        /// </summary>
+        internal const int EINTR = 4;
+
+        /// <summary>
+        /// Scatter/gather array item (struct iovec).
+        /// </summary>
+        [StructLayout(LayoutKind.Sequential)]
+        internal struct IoVector
+        {
+            public IntPtr Base;
+            public ulong Length;
+        }
+
+        /// <summary>
+        /// Message header (struct msghdr).
+        /// </summary>
+        [StructLayout(LayoutKind.Sequential)]
+        internal struct MessageHeader
+        {
+            public IntPtr Name;
+            public uint NameLength;
+            public IoVector* IoVector;
+            public ulong IoVectorLength;
+            public IntPtr Control;
+            public ulong ControlLength;
+            public MessageFlags Flags;
+        }
+
+        /// <summary>
+        /// Ancillary data header (struct cmsghdr), followed by the data aligned to the size of the header.
+        /// </summary>
+        [StructLayout(LayoutKind.Sequential)]
+        internal struct ControlMessageHeader
+        {
+            public ulong Length;
+            public int Level;
+            public int Type;
+        }
+
+        [Flags]
+        internal enum MessageFlags : int
+        {
+            /// <summary>
+            /// Ancillary data was discarded due to the lack of space in the buffer.
+            /// </summary>
+            MSG_CTRUNC = 0x8,
+
+            /// <summary>
+            /// Block until the full request is satisfied.
+            /// </summary>
+            MSG_WAITALL = 0x100,
+
+            /// <summary>
+            /// Set the close-on-exec flag on the received file descriptors.
+            /// </summary>
+            MSG_CMSG_CLOEXEC = 0x40000000,
+        }
+
         [Flags]
         internal enum OpenFlags : int
         {
@@ -148,6 +305,37 @@ namespace Mlos.Core.Linux
             O_EXCL = 0x80,
         }
 
+        internal enum SeekWhence : int
+        {
+            /// <summary>
+            /// The file offset is set to offset bytes.
+            /// </summary>
+            SEEK_SET = 0,
+
+            /// <summary>
+            /// The file offset is set to its current location plus offset bytes.
+            /// </summary>
+            SEEK_CUR = 1,
+
+            /// <summary>
+            /// The file offset is set to the size of the file plus offset bytes.
+            /// </summary>
+            SEEK_END = 2,
+        }
+
+        internal enum FutexOperation : int
+        {
+            /// <summary>
+            /// Sleep if the futex word still contains the expected value.
+            /// </summary>
+            FUTEX_WAIT = 0,
+
+            /// <summary>
+            /// Wake up at most the given number of waiters.
+            /// </summary>
+            FUTEX_WAKE = 1,
+        }
+
         [Flags]
         internal enum ModeFlags : uint
         {
@@ -221,6 +409,14 @@ namespace Mlos.Core.Linux
             MAP_ANONYMOUS = 0x20,
         }
 
+        internal enum MemoryAdvice : int
+        {
+            /// <summary>
+            /// Enable transparent huge pages for the memory range.
+            /// </summary>
+            MADV_HUGEPAGE = 14,
+        }
+
         [Flags]
         internal enum ShmIpcFlags : int
         {
@@ -267,6 +463,31 @@ namespace Mlos.Core.Linux
         {
         }
 
+        public SharedMemorySafeHandle(IntPtr handle)
+            : base(true)
+        {
+            SetHandle(handle);
+        }
+
+        protected override bool ReleaseHandle()
+        {
+            return Native.Close(handle) == 0;
+        }
+    }
+
+    /// <summary>
+    /// Event file descriptor handle.
+    /// </summary>
+    [SecurityPermission(SecurityAction.InheritanceDemand, UnmanagedCode = true)]
+    [SecurityPermission(SecurityAction.Demand, UnmanagedCode = true)]
+    internal class EventSafeHandle : SafeHandleZeroOrMinusOneIsInvalid
+    {
+        public EventSafeHandle(IntPtr handle)
+            : base(true)
+        {
+            SetHandle(handle);
+        }
+
         protected override bool ReleaseHandle()
         {
             return Native.Close(handle) == 0;
@@ -29,12 +29,18 @@ namespace Mlos.Core.Windows
 
         internal const int ErrorSuccess = 0;
         internal const int ErrorInsufficientBuffer = 122;
+        internal const int ErrorAlreadyExists = 183;
 
         /// <summary>
         /// Represents invalid pointer (void *) -1.
         /// </summary>
         internal static IntPtr InvalidPointer = IntPtr.Subtract(IntPtr.Zero, 1);
 
+        /// <summary>
+        /// Represents the pseudo handle of the current process (HANDLE)-1.
+        /// </summary>
+        internal static IntPtr CurrentProcess = IntPtr.Subtract(IntPtr.Zero, 1);
+
         #region WinAPI
         [DllImport(KernelLib, SetLastError = true, CharSet = CharSet.Unicode)]
         internal static extern SharedMemorySafeHandle CreateFileMapping(
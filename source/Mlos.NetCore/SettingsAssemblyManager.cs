@@ -30,6 +30,20 @@ namespace Mlos.Core
         /// <param name="assembly"></param>
         /// <param name="dispatchTableBaseIndex"></param>
         public void RegisterAssembly(Assembly assembly, uint dispatchTableBaseIndex)
+        {
+            RegisterAssembly(assembly, dispatchTableBaseIndex, expectedDispatchTableHash: 0);
+        }
+
+        /// <summary>Registers settings assembly.</summary>
+        /// <remarks>
+        /// Update deserialize and dispatch tables.
+        /// If the expected dispatch table hash is not zero, verifies the assembly has the same types as the application.
+        /// The channels with the compact frame headers rely on this check instead of the per frame type hash check.
+        /// </remarks>
+        /// <param name="assembly"></param>
+        /// <param name="dispatchTableBaseIndex"></param>
+        /// <param name="expectedDispatchTableHash">Hash of the application dispatch table, zero if unknown.</param>
+        public void RegisterAssembly(Assembly assembly, uint dispatchTableBaseIndex, ulong expectedDispatchTableHash)
         {
             // Ensure the assembly base index is correct.
             //
@@ -66,6 +80,13 @@ namespace Mlos.Core
             DispatchEntry[] dispatchTable = (DispatchEntry[])objectDeserializeHandler.GetField("DispatchTable", BindingFlags.Static | BindingFlags.Public).GetValue(null);
             DeserializeEntry[] deserializationTable = (DeserializeEntry[])objectDeserializeHandler.GetField("DeserializationCallbackTable", BindingFlags.Static | BindingFlags.Public).GetValue(null);
 
+            // Ensure the application has been compiled with the same settings assembly.
+            //
+            if (expectedDispatchTableHash != 0 && expectedDispatchTableHash != DispatchTableHash(dispatchTable))
+            {
+                throw new InvalidOperationException($"Settings assembly {assembly.FullName} types do not match the application dispatch table.");
+            }
+
             // Init module.
             //
             Type callbackHandlersType = assembly.GetType($"{dispatchTableNamespaceAttribute.Namespace}.AssemblyInitializer");
@@ -83,6 +104,30 @@ namespace Mlos.Core
             // Add settings assembly.
             //
             settingsAssemblies.Add(assembly.FullName, dispatchTableBaseIndex);
+            registeredAssemblies.Add(assembly);
+        }
+
+        /// <summary>
+        /// Combines the type hashes of the dispatch table entries.
+        /// </summary>
+        /// <remarks>
+        /// Computes the same hash as Mlos::Core::DispatchTableHash in Mlos.Core.
+        /// </remarks>
+        /// <param name="dispatchTable"></param>
+        /// <returns>Returns the hash of the dispatch table.</returns>
+        public static ulong DispatchTableHash(DispatchEntry[] dispatchTable)
+        {
+            ulong hash = 0xcbf29ce484222325;
+
+            unchecked
+            {
+                foreach (DispatchEntry dispatchEntry in dispatchTable)
+                {
+                    hash = (hash ^ dispatchEntry.CodegenTypeHash) * 0x100000001b3;
+                }
+            }
+
+            return hash;
         }
 
         /// <summary>
@@ -90,6 +135,11 @@ namespace Mlos.Core
         /// </summary>
         public uint CodegenTypeCount => (uint)globalDeserializationTable.Count;
 
+        /// <summary>
+        /// Gets the registered settings assemblies, in the registration order.
+        /// </summary>
+        public IReadOnlyList<Assembly> RegisteredAssemblies => registeredAssemblies;
+
         /// <summary>
         /// Returns a global deserialization callback table.
         /// </summary>
@@ -110,6 +160,8 @@ namespace Mlos.Core
         /// </remarks>
         private readonly Dictionary<string, uint> settingsAssemblies = new Dictionary<string, uint>();
 
+        private readonly List<Assembly> registeredAssemblies = new List<Assembly>();
+
         private readonly List<DeserializeEntry> globalDeserializationTable = new List<DeserializeEntry>();
 
         private readonly List<DispatchEntry> globalDispatchTable = new List<DispatchEntry>();
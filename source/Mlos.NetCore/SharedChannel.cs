@@ -7,9 +7,14 @@
 // -----------------------------------------------------------------------
 
 using System;
+using System.Diagnostics;
 using System.Runtime.CompilerServices;
+using System.Threading;
+
+using Proxy.Mlos.Core.Internal;
 
 using MlosProxy = Proxy.Mlos.Core;
+using MlosProxyInternal = Proxy.Mlos.Core.Internal;
 using StdTypesProxy = Proxy.Mlos.SettingsSystem.StdTypes;
 
 namespace Mlos.Core
@@ -33,10 +38,36 @@ namespace Mlos.Core
         /// <param name="dispatchTable"></param>
         void ProcessMessages(ref DispatchEntry[] dispatchTable);
 
+        /// <summary>
+        /// Reader loop, process received messages.
+        /// The number of frames the reader acquires at once is limited by the channel settings.
+        /// </summary>
+        /// <param name="dispatchTable"></param>
+        /// <param name="channelSettings"></param>
+        void ProcessMessages(ref DispatchEntry[] dispatchTable, ref ChannelSettings channelSettings);
+
         /// <summary>
         /// Channel synchronization object.
         /// </summary>
         internal MlosProxy.ChannelSynchronization SyncObject { get; }
+
+        /// <summary>
+        /// Gets or sets the latency histograms updated by the reader threads.
+        /// </summary>
+        /// <remarks>
+        /// Latencies are not recorded if the buffer is not set.
+        /// </remarks>
+        MlosProxyInternal.ChannelLatencyMemoryRegion LatencyStats { get; set; }
+
+        /// <summary>
+        /// Gets or sets how long the reader waits for the dispatch table to include the type of the received frame.
+        /// </summary>
+        /// <remarks>
+        /// The settings assemblies are registered by the control channel reader, the target process might send the messages
+        /// to the other channels before the dispatch table is updated. The reader processing ProcessMessages reloads
+        /// the dispatch table before it treats such a frame as invalid. Zero does not wait.
+        /// </remarks>
+        TimeSpan UnregisteredTypeWaitTimeout { get; set; }
     }
 
     /// <summary>
@@ -50,23 +81,6 @@ namespace Mlos.Core
         where TChannelPolicy : ISharedChannelPolicy
         where TChannelSpinPolicy : ISharedChannelSpinPolicy
     {
-        /// <summary>
-        /// ZeroMemory.
-        /// </summary>
-        /// <param name="dest"></param>
-        /// <param name="count"></param>
-        [MethodImpl(MethodImplOptions.AggressiveInlining)]
-        private static void ZeroMemory(IntPtr dest, int count)
-        {
-            unsafe
-            {
-                for (int i = 0; i < count; i++)
-                {
-                    *(byte*)(dest + i) = 0;
-                }
-            }
-        }
-
         /// <summary>
         /// Signals readers that the frame is available to process.
         /// </summary>
@@ -96,11 +110,15 @@ namespace Mlos.Core
         /// Follows the free links until we reach the current read position.
         /// </summary>
         /// <remarks>
-        /// While we follow the links, the method is not cleaning the memory.
-        /// The memory is cleared by the reader after processing the frame.
-        /// The whole memory region is clean except locations where negative frame length values are stored
+        /// Readers do not clear the processed frames, they only store negative frame length values
         /// to signal that the message has been read and the frame is free-able.
-        /// Those locations are always aligned to the size of uint32_t. The current reader continues to spin if it reads negative frame length.
+        /// The writer collects all the consecutive processed frames and advances the free position past them
+        /// with a single compare and exchange. The reclaimed memory is not cleared, the readers do not read
+        /// the frame lengths located after the write position (see PublishWriteRegion).
+        ///
+        /// If other writer has already advanced the free position, the local free position is stale
+        /// and the frames might have been overwritten, so the walk stops at the read position
+        /// and the compare and exchange fails.
         /// </remarks>
         internal void AdvanceFreePosition()
         {
@@ -121,54 +139,67 @@ namespace Mlos.Core
                 return;
             }
 
-            // For diagnostic purposes, by following the free links, we should get the same distance.
+            // Load a frame from the beginning of the free region.
             //
-            uint distance = readPosition - freePosition;
+            int frameLength = Frame(freePosition % Size).Length.Load();
 
-            // Follow the free links up to the current read position.
-            // The cleanup is completed when the free position is equal to the read position.
-            // However, by the time this cleanup is completed, the reader threads might process more frames and advance the read position.
-            //
-            while (freePosition != readPosition)
+            if (frameLength >= 0 || (frameLength & 1) == 1)
             {
-                // Load a frame from the beginning of the free region.
-                // However, other writer threads might already advance the free position.
-                // In this case, local free position points to the write region and
-                // we will fail to advance free offset.
+                // Frame is currently processed.
                 //
-                uint freeOffset = freePosition % Size;
-
-                MlosProxy.FrameHeader frame = Frame(freeOffset);
-                int frameLength = frame.Length.Load();
+                return;
+            }
 
-                if (frameLength >= 0)
-                {
-                    // Frame is currently processed or has been already cleared.
-                    // Other writer thread advanced free position, there is no point to check using compare_exchange_weak.
-                    // Local free offset is now the write region.
-                    //
-                    return;
-                }
+            // Follow the free links up to the current read position.
+            // By the time this cleanup is completed, the reader threads might process more frames and advance the read position.
+            //
+            uint readLength = readPosition - freePosition;
+            uint nextFreePosition = freePosition - (uint)frameLength;
 
-                // Advance free position. The frame length is negative.
-                //
-                uint expectedFreePosition = freePosition;
-                uint nextFreePosition = freePosition - (uint)frameLength;
+            while (nextFreePosition - freePosition < readLength)
+            {
+                int nextFrameLength = Frame(nextFreePosition % Size).Length.Load();
 
-                if (atomicFreePosition.LoadRelaxed() != expectedFreePosition ||
-                    atomicFreePosition.CompareExchange(nextFreePosition, expectedFreePosition) != expectedFreePosition)
+                if (nextFrameLength >= 0 || (nextFrameLength & 1) == 1)
                 {
-                    // Advanced by another writer, local free offset is now the write region.
+                    // Frame is currently processed.
                     //
-                    return;
+                    break;
                 }
 
-                freePosition = nextFreePosition;
+                nextFreePosition -= (uint)nextFrameLength;
+            }
 
-                // Frame length is negative.
+            if (nextFreePosition - freePosition > readLength)
+            {
+                // The local free position is stale, the frames have been overwritten.
                 //
-                distance += (uint)frameLength;
+                return;
             }
+
+            // Advance free position, unless other writer thread has already advanced it.
+            //
+            atomicFreePosition.CompareExchange(nextFreePosition, freePosition);
+        }
+
+        /// <summary>
+        /// Publishes the region acquired by AcquireRegionForWrite to the readers.
+        /// </summary>
+        /// <param name="regionLength"></param>
+        /// <remarks>
+        /// The readers never read the frame lengths located at or after the write position,
+        /// so the reclaimed memory does not have to be cleared. Before the writer publishes the region,
+        /// it must store the frame length (with the incomplete bit if the frame is not written yet).
+        /// Only the writer owning the pending write position updates it.
+        /// </remarks>
+        [MethodImpl(MethodImplOptions.AggressiveInlining)]
+        private void PublishWriteRegion(int regionLength)
+        {
+            StdTypesProxy.AtomicUInt32 atomicWritePosition = Sync.WritePosition;
+
+            uint writePosition = atomicWritePosition.LoadRelaxed() & ~1u;
+
+            atomicWritePosition.Store(writePosition + (uint)regionLength);
         }
 
         /// <summary>
@@ -183,6 +214,8 @@ namespace Mlos.Core
         ///  There is no guarantee that the acquired region is contiguous (it might be overlapping).
         ///  However it ensures that the next write offset will not be greater than the buffer margin,
         ///  so the next writer can write an empty FrameHeader.
+        ///  The writer sets the lowest bit of the write position (pending) instead of advancing it,
+        ///  other writers wait until the region is published by PublishWriteRegion.
         /// </remarks>
         private uint AcquireRegionForWrite(ref int frameLength)
         {
@@ -202,6 +235,14 @@ namespace Mlos.Core
                 uint freePosition = atomicFreePosition.Load();
                 uint writePosition = atomicWritePosition.LoadRelaxed();
 
+                if ((writePosition & 1) == 1)
+                {
+                    // Other writer is storing the frame length of its region.
+                    //
+                    channelSpinPolicy.FailedToAcquireWriteRegion();
+                    continue;
+                }
+
                 // Check if there is enough bytes to write frame (full frame or a link).
                 // Always keep the distance to free offset, at least a size of FrameHeader.
                 // If WritePosition overflown, then (writePosition - freePosition) is still positive value.
@@ -222,6 +263,20 @@ namespace Mlos.Core
                     // Retry after that, as another writer might acquire just the released region.
                     //
                     AdvanceFreePosition();
+
+                    if (atomicFreePosition.Load() != freePosition)
+                    {
+                        continue;
+                    }
+
+                    // The readers have not released any frame yet.
+                    // Spin for a while, then wait for the notification from the readers.
+                    //
+                    if (!channelSpinPolicy.WaitForFreeSpace())
+                    {
+                        WaitForFreeSpace(freePosition);
+                    }
+
                     continue;
                 }
 
@@ -229,30 +284,24 @@ namespace Mlos.Core
                 //
                 uint frameLengthAdj = 0;
 
-                // NextWritePosition is at the frame end.
-                // NextWriteOffset (calculated from NextWritePosition) must be aligned to sizeof(uint32_t)
-                // therefore frame length must be also aligned.
-                //
-                uint nextWritePosition = (uint)(writePosition + frameLength);
-
+                // NextWriteOffset is at the frame end.
+                // NextWriteOffset must be aligned to sizeof(uint32_t) therefore frame length must be also aligned.
                 // Ensure that after a full frame there is enough space for the next frame header.
                 // Otherwise, we will not be able to store next frame, because the frame header will not fit in the buffer.
                 //
-                uint nextWriteOffset = nextWritePosition % Size;
+                uint nextWriteOffset = (uint)(writePosition + frameLength) % Size;
                 if (nextWriteOffset >= margin)
                 {
                     // Update frameLength, as we acquired more than requested.
                     //
                     frameLengthAdj = Size - nextWriteOffset;
-
-                    nextWritePosition += frameLengthAdj;
                 }
 
                 uint expectedWritePosition = writePosition;
                 if (atomicWritePosition.LoadRelaxed() != expectedWritePosition ||
-                    atomicWritePosition.CompareExchange(nextWritePosition, expectedWritePosition) != expectedWritePosition)
+                    atomicWritePosition.CompareExchange(writePosition | 1, expectedWritePosition) != expectedWritePosition)
                 {
-                    // Failed to advance write offset, another writer acquired this region.
+                    // Failed to acquire the write region, another writer acquired this region.
                     //
                     channelSpinPolicy.FailedToAcquireWriteRegion();
                     continue;
@@ -260,7 +309,7 @@ namespace Mlos.Core
 
                 frameLength += (int)frameLengthAdj;
 
-                // The region should be empty except for free links.
+                // The region contains the stale frames, the readers do not read it until the region is published.
                 // Frame links are always stored in offset aligned to sizeof int.
                 //
                 uint writeOffset = writePosition % Size;
@@ -268,12 +317,46 @@ namespace Mlos.Core
             }
         }
 
+        /// <summary>
+        /// Waits until the readers release the processed frames located at the free position.
+        /// </summary>
+        /// <param name="freePosition"></param>
+        /// <remarks>
+        /// Writer function.
+        /// Before the writer waits, it checks the free space for the last time.
+        /// The readers notify the writers after they signal the frames for cleanup,
+        /// so either the writer finds the released frames or the readers wake it up.
+        /// </remarks>
+        private void WaitForFreeSpace(uint freePosition)
+        {
+            uint waitToken = ChannelPolicy.PrepareWaitForFreeSpace();
+
+            Interlocked.MemoryBarrier();
+
+            if (Sync.TerminateChannel.LoadRelaxed())
+            {
+                return;
+            }
+
+            AdvanceFreePosition();
+
+            if (Sync.FreePosition.Load() != freePosition)
+            {
+                return;
+            }
+
+            ChannelPolicy.WaitForFreeSpace(waitToken);
+        }
+
         /// <summary>
         /// Acquire a region to write the frame.
         /// </summary>
         /// <param name="frameLength"></param>
         /// <returns>Returns an offset to acquired memory region that can hold a full frame.</returns>
-        /// <remarks>The acquired region is contiguous.</remarks>
+        /// <remarks>
+        /// The acquired region is contiguous.
+        /// The frame length is stored with incomplete bit and the region is published before the function returns.
+        /// </remarks>
         internal uint AcquireWriteRegionForFrame(ref int frameLength)
         {
             uint expectedFrameLength = (uint)frameLength;
@@ -309,25 +392,35 @@ namespace Mlos.Core
                     //
                     MlosProxy.FrameHeader frame = Frame(writeOffset);
                     frame.CodegenTypeIndex = 0;
-                    SignalFrameIsReady(frame, frameLength);
+                    frame.Length.Store(frameLength);
+                    PublishWriteRegion(frameLength);
                     continue;
                 }
 
                 // Acquired a region that we can write a full frame.
+                // Store the frame length with incomplete bit and publish the region.
                 //
+                Frame(writeOffset).Length.Store(frameLength | 1);
+                PublishWriteRegion(frameLength);
+
                 return writeOffset;
             }
         }
 
         /// <summary>
-        /// Wait for the frame become available.
+        /// Wait for the frames become available.
         /// </summary>
-        /// <returns>Returns an offset to the frame buffer.</returns>
+        /// <param name="maxFrameCount">Maximum number of frames to acquire.</param>
+        /// <param name="maxBatchLength">Maximum total length of acquired frames, zero does not limit the length.</param>
+        /// <param name="frameCount">Number of acquired frames.</param>
+        /// <returns>Returns an offset to the first acquired frame.</returns>
         /// <remarks>
         /// Reader function.
         /// If the wait has been aborted, it returns uint32_t::max.
+        /// The reader acquires all the consecutive completed frames with a single update of the read position.
+        /// If the first frame is still being written, the reader acquires only that frame.
         /// </remarks>
-        internal uint WaitForFrame()
+        internal uint WaitForFrames(uint maxFrameCount, uint maxBatchLength, out uint frameCount)
         {
             uint readPosition;
             TChannelSpinPolicy channelSpinPolicy = default;
@@ -335,12 +428,16 @@ namespace Mlos.Core
             // Create AtomicUInt32 proxy once.
             //
             StdTypesProxy.AtomicUInt32 atomicReadPosition = Sync.ReadPosition;
+            StdTypesProxy.AtomicUInt32 atomicWritePosition = Sync.WritePosition;
             StdTypesProxy.AtomicUInt32 atomicReaderInWaitingStateCount = Sync.ReaderInWaitingStateCount;
             StdTypesProxy.AtomicBool atomicTerminateChannel = Sync.TerminateChannel;
 
             MlosProxy.FrameHeader frame = default;
 
             uint shouldWait = 0;
+            uint waitToken = 0;
+
+            frameCount = 0;
 
             // int spinIndex = 0;
             while (true)
@@ -350,10 +447,14 @@ namespace Mlos.Core
                 //
                 readPosition = atomicReadPosition.Load();
 
+                // The frame lengths are valid only before the published write position, the memory after it is not cleared.
+                //
+                uint writtenLength = (atomicWritePosition.Load() & ~1u) - readPosition;
+
                 uint readOffset = readPosition % Size;
                 frame = Frame(readOffset);
 
-                int frameLength = frame.Length.Load();
+                int frameLength = (writtenLength != 0) ? frame.Length.Load() : 0;
                 if (frameLength > 0)
                 {
                     // Writer had updated the length.
@@ -363,6 +464,36 @@ namespace Mlos.Core
                     uint expectedReadPosition = readPosition;
                     uint nextReadPosition = readPosition + (uint)(frameLength & (~1));
 
+                    frameCount = 1;
+
+                    if ((frameLength & 1) == 0)
+                    {
+                        // The first frame is complete, extend the acquired region by the following completed frames.
+                        // The reader stops at the write position.
+                        //
+                        while (frameCount < maxFrameCount && nextReadPosition - readPosition < writtenLength)
+                        {
+                            int nextFrameLength = Frame(nextReadPosition % Size).Length.Load();
+
+                            if (nextFrameLength <= 0 || (nextFrameLength & 1) == 1)
+                            {
+                                // The next frame is not ready.
+                                //
+                                break;
+                            }
+
+                            if (maxBatchLength != 0 && nextReadPosition + (uint)nextFrameLength - readPosition > maxBatchLength)
+                            {
+                                // Acquired frames would exceed the batch length.
+                                //
+                                break;
+                            }
+
+                            nextReadPosition += (uint)nextFrameLength;
+                            ++frameCount;
+                        }
+                    }
+
                     if (atomicReadPosition.LoadRelaxed() != expectedReadPosition ||
                         atomicReadPosition.CompareExchange(nextReadPosition, expectedReadPosition) != expectedReadPosition)
                     {
@@ -406,7 +537,7 @@ namespace Mlos.Core
                 //
                 if (shouldWait != 0)
                 {
-                    ChannelPolicy.WaitForFrame();
+                    ChannelPolicy.WaitForFrame(waitToken);
                     atomicReaderInWaitingStateCount.FetchSub(shouldWait);
                     shouldWait = 0;
                 }
@@ -416,6 +547,7 @@ namespace Mlos.Core
                     //
                     shouldWait = 1;
                     atomicReaderInWaitingStateCount.FetchAdd(shouldWait);
+                    waitToken = ChannelPolicy.PrepareWaitForFrame();
                 }
 
                 // If (frameLength < 0) there is active cleaning up on this frame by the writer.
@@ -433,35 +565,25 @@ namespace Mlos.Core
         }
 
         /// <summary>
-        /// Waits for a new frame then call proper dispatcher.
+        /// Verifies the acquired frame and calls proper dispatcher.
         /// </summary>
+        /// <param name="readOffset"></param>
         /// <param name="dispatchTable"></param>
-        /// <returns>
-        /// Returns true if reader successfully processed the frame. If the wait has been aborted, it returns false.
-        /// </returns>
+        /// <returns>Returns the length of the frame.</returns>
         /// <remarks>
-        /// To interrupt wait, set buffer.Sync.TerminateReader to true.
+        /// Reader function.
+        /// The frame is not released, the caller signals the frame for cleanup.
         /// </remarks>
-        public bool WaitAndDispatchFrame(DispatchEntry[] dispatchTable)
+        private int DispatchFrame(uint readOffset, DispatchEntry[] dispatchTable)
         {
             TChannelPolicy channelPolicy = default;
 
-            uint readOffset = WaitForFrame();
-
-            if (readOffset == uint.MaxValue)
-            {
-                // Invalid offset, the wait was interrupted.
-                //
-                return false;
-            }
-
             uint dispatchEntryCount = (uint)dispatchTable.Length;
 
             // Verify frame and call dispatcher.
             //
             MlosProxy.FrameHeader frame = Frame(readOffset);
             uint codegenTypeIndex = frame.CodegenTypeIndex;
-            ulong codegenTypeHash = frame.CodegenTypeHash;
 
             int frameLength = frame.Length.LoadRelaxed();
 
@@ -470,18 +592,49 @@ namespace Mlos.Core
             if (codegenTypeIndex != 0 && codegenTypeIndex <= dispatchEntryCount)
             {
                 // Use hash to check the message.
+                // The compact frame headers have no hash, the types are verified when the settings assemblies are registered.
                 //
-                ulong expectedCodegenTypeHash = dispatchTable[codegenTypeIndex - 1].CodegenTypeHash;
-
-                bool isMessageValid = ((uint)frameLength < Size) && (expectedCodegenTypeHash == codegenTypeHash);
+                bool isMessageValid = ((uint)frameLength < Size) &&
+                    (hasCompactFrameHeaders || dispatchTable[codegenTypeIndex - 1].CodegenTypeHash == frame.CodegenTypeHash);
 
                 if (isMessageValid)
                 {
+                    // Latencies are recorded only for the types with the histograms.
+                    //
+                    MlosProxyInternal.ChannelLatencyMemoryRegion latencyStats = LatencyStats;
+                    bool recordLatency = latencyStats.Buffer != IntPtr.Zero &&
+                        codegenTypeIndex < MlosProxyInternal.ChannelLatencyMemoryRegionExtensions.LatencyStatsTypeCount;
+
+                    ulong dispatchTimestamp = recordLatency ? Utils.TimestampInNanoseconds() : 0;
+
+                    if (recordLatency && hasFrameTimestamps && frameLength >= frameHeaderLength + sizeof(ulong))
+                    {
+                        ulong sendTimestamp;
+
+                        unsafe
+                        {
+                            sendTimestamp = Unsafe.ReadUnaligned<ulong>((void*)(Buffer + (int)readOffset + frameLength - sizeof(ulong)));
+                        }
+
+                        // Do not record a negative delay if the timestamp is not valid.
+                        //
+                        ulong queueingDelay = dispatchTimestamp > sendTimestamp ? dispatchTimestamp - sendTimestamp : 0;
+                        latencyStats.LatencyStatsByType[(int)codegenTypeIndex].QueueingDelay.Record(queueingDelay);
+                    }
+
                     unsafe
                     {
                         // Call dispatcher only if type hash is correct.
+                        // The callbacks verify the payload against the length of the frame with the full header.
                         //
-                        isMessageValid = dispatchTable[codegenTypeIndex - 1].Callback(Payload(readOffset), frameLength);
+                        isMessageValid = dispatchTable[codegenTypeIndex - 1].Callback(
+                            Payload(readOffset),
+                            frameLength + FrameHeader.TypeSize - frameHeaderLength);
+                    }
+
+                    if (recordLatency)
+                    {
+                        latencyStats.LatencyStatsByType[(int)codegenTypeIndex].HandlerDuration.Record(Utils.TimestampInNanoseconds() - dispatchTimestamp);
                     }
                 }
 
@@ -491,37 +644,152 @@ namespace Mlos.Core
                     //
                     channelPolicy.ReceivedInvalidFrame();
                 }
+            }
+            else if (codegenTypeIndex != 0)
+            {
+                // Received invalid frame, channel policy decides what how to handle it.
+                //
+                channelPolicy.ReceivedInvalidFrame();
+            }
 
-                // Cleanup. Writer requires clean memory buffer (frameLength != 0).
-                // Clear the whole frame except the length.
+            // Reader does not clear the frame.
+            // The processed frames are reclaimed without clearing the memory, the stale content is never read.
+            // The readers do not read past the published write position, and the writer stores the lengths (with the incomplete bit)
+            // of all the frames in the region before it publishes the region.
+            //
+            return frameLength;
+        }
+
+        /// <summary>
+        /// Waits for a new frame then call proper dispatcher.
+        /// </summary>
+        /// <param name="dispatchTable"></param>
+        /// <returns>
+        /// Returns true if reader successfully processed the frame. If the wait has been aborted, it returns false.
+        /// </returns>
+        /// <remarks>
+        /// To interrupt wait, set buffer.Sync.TerminateReader to true.
+        /// </remarks>
+        public bool WaitAndDispatchFrame(DispatchEntry[] dispatchTable)
+        {
+            return WaitAndDispatchFrames(dispatchTable, maxFrameCount: 1, maxBatchLength: 0);
+        }
+
+        /// <summary>
+        /// Waits for new frames then call proper dispatchers.
+        /// </summary>
+        /// <param name="dispatchTable"></param>
+        /// <param name="maxFrameCount">Maximum number of frames to acquire.</param>
+        /// <param name="maxBatchLength">Maximum total length of acquired frames, zero does not limit the length.</param>
+        /// <returns>
+        /// Returns true if reader successfully processed the frames. If the wait has been aborted, it returns false.
+        /// </returns>
+        /// <remarks>
+        /// To interrupt wait, set buffer.Sync.TerminateReader to true.
+        /// Frames are dispatched in order, then all of them are signaled for cleanup.
+        /// </remarks>
+        public bool WaitAndDispatchFrames(DispatchEntry[] dispatchTable, uint maxFrameCount, uint maxBatchLength)
+        {
+            return WaitAndDispatchFrames(ref dispatchTable, maxFrameCount, maxBatchLength);
+        }
+
+        /// <summary>
+        /// Waits for new frames then call proper dispatchers.
+        /// </summary>
+        /// <param name="dispatchTable">Reference to the dispatch table updated when the settings assemblies are registered.</param>
+        /// <param name="maxFrameCount">Maximum number of frames to acquire.</param>
+        /// <param name="maxBatchLength">Maximum total length of acquired frames, zero does not limit the length.</param>
+        /// <returns>
+        /// Returns true if reader successfully processed the frames. If the wait has been aborted, it returns false.
+        /// </returns>
+        private bool WaitAndDispatchFrames(ref DispatchEntry[] dispatchTable, uint maxFrameCount, uint maxBatchLength)
+        {
+            uint readOffset = WaitForFrames(maxFrameCount, maxBatchLength, out uint frameCount);
+
+            if (readOffset == uint.MaxValue)
+            {
+                // Invalid offset, the wait was interrupted.
                 //
-                ClearPayload(readOffset, frameLength);
+                return false;
             }
-            else
+
+            // Dispatch acquired frames.
+            //
+            DispatchEntry[] currentDispatchTable = Volatile.Read(ref dispatchTable);
+            uint frameOffset = readOffset;
+
+            for (uint frameIndex = 0; frameIndex < frameCount; frameIndex++)
             {
-                if (codegenTypeIndex == 0)
+                // The frame type might belong to a settings assembly registered after the dispatch table was loaded.
+                //
+                uint codegenTypeIndex = Frame(frameOffset).CodegenTypeIndex;
+
+                if (codegenTypeIndex > (uint)currentDispatchTable.Length)
                 {
-                    // Just a link frame, clear the circular region.
-                    //
-                    ClearLinkPayload(readOffset, frameLength, Size);
+                    currentDispatchTable = WaitForTypeRegistration(codegenTypeIndex, ref dispatchTable);
                 }
-                else
-                {
-                    // Received invalid frame, channel policy decides what how to handle it.
-                    //
-                    channelPolicy.ReceivedInvalidFrame();
 
-                    ClearPayload(readOffset, frameLength);
-                }
+                int frameLength = DispatchFrame(frameOffset, currentDispatchTable);
+
+                frameOffset = (frameOffset + (uint)frameLength) % Size;
             }
 
-            // Mark frame that processing is completed (negative length).
+            // Mark frames that processing is completed (negative length).
             //
-            SignalFrameForCleanup(frame, frameLength);
+            frameOffset = readOffset;
+
+            for (uint frameIndex = 0; frameIndex < frameCount; frameIndex++)
+            {
+                MlosProxy.FrameHeader frame = Frame(frameOffset);
+                int frameLength = frame.Length.LoadRelaxed();
+
+                SignalFrameForCleanup(frame, frameLength);
+
+                frameOffset = (frameOffset + (uint)frameLength) % Size;
+            }
+
+            // Notify the writers waiting for the free space.
+            //
+            ChannelPolicy.NotifyExternalWriter();
 
             return true;
         }
 
+        /// <summary>
+        /// Waits until the dispatch table includes the given type.
+        /// </summary>
+        /// <param name="codegenTypeIndex"></param>
+        /// <param name="dispatchTable"></param>
+        /// <returns>Returns the most recent dispatch table.</returns>
+        /// <remarks>
+        /// Reader function.
+        /// The assembly might have been registered by the control channel reader since the reader loaded the dispatch table.
+        /// If the type is not registered when the wait times out or the channel is terminated,
+        /// the frame is dispatched as invalid.
+        /// </remarks>
+        private DispatchEntry[] WaitForTypeRegistration(uint codegenTypeIndex, ref DispatchEntry[] dispatchTable)
+        {
+            DispatchEntry[] currentDispatchTable = Volatile.Read(ref dispatchTable);
+
+            if (codegenTypeIndex <= (uint)currentDispatchTable.Length || UnregisteredTypeWaitTimeout <= TimeSpan.Zero)
+            {
+                return currentDispatchTable;
+            }
+
+            var stopwatch = Stopwatch.StartNew();
+
+            while (codegenTypeIndex > (uint)currentDispatchTable.Length &&
+                stopwatch.Elapsed < UnregisteredTypeWaitTimeout &&
+                !Sync.TerminateChannel.Load())
+            {
+                Thread.Sleep(1);
+
+                currentDispatchTable = Volatile.Read(ref dispatchTable);
+            }
+
+            return currentDispatchTable;
+        }
+
         /// <inheritdoc/>
         public void ProcessMessages(ref DispatchEntry[] dispatchTable)
         {
@@ -534,10 +802,41 @@ namespace Mlos.Core
             bool result = true;
             while (result)
             {
-              result = WaitAndDispatchFrame(dispatchTable);
+                result = WaitAndDispatchFrames(ref dispatchTable, maxFrameCount: 1, maxBatchLength: 0);
+            }
+
+            Sync.ActiveReaderCount.FetchSub(1);
+
+            // The channel has been terminated, wake up the writers waiting for the free space.
+            //
+            ChannelPolicy.NotifyExternalWriter();
+        }
+
+        /// <inheritdoc/>
+        public void ProcessMessages(ref DispatchEntry[] dispatchTable, ref ChannelSettings channelSettings)
+        {
+            // Reader always acquires at least one frame.
+            //
+            uint maxFrameCount = channelSettings.ReaderBatchFrameCount > 1 ? (uint)channelSettings.ReaderBatchFrameCount : 1;
+            uint maxBatchLength = channelSettings.ReaderBatchLength > 0 ? (uint)channelSettings.ReaderBatchLength : 0;
+
+            Sync.TerminateChannel.Store(false);
+
+            Sync.ActiveReaderCount.FetchAdd(1);
+
+            // Receiver thread.
+            //
+            bool result = true;
+            while (result)
+            {
+                result = WaitAndDispatchFrames(ref dispatchTable, maxFrameCount, maxBatchLength);
             }
 
             Sync.ActiveReaderCount.FetchSub(1);
+
+            // The channel has been terminated, wake up the writers waiting for the free space.
+            //
+            ChannelPolicy.NotifyExternalWriter();
         }
 
         /// <inheritdoc/>
@@ -546,9 +845,14 @@ namespace Mlos.Core
         {
             // Calculate frame size.
             //
-            int frameLength = FrameHeader.TypeSize + (int)CodegenTypeExtensions.GetSerializedSize(msg);
+            int frameLength = frameHeaderLength + (int)CodegenTypeExtensions.GetSerializedSize(msg);
             frameLength = Utils.Align(frameLength, sizeof(int));
 
+            if (hasFrameTimestamps)
+            {
+                frameLength += sizeof(ulong);
+            }
+
             // Acquire a write region to write the frame.
             //
             uint writeOffset = AcquireWriteRegionForFrame(ref frameLength);
@@ -560,22 +864,34 @@ namespace Mlos.Core
                 return;
             }
 
-            MlosProxy.FrameHeader frame = Frame(writeOffset);
-
-            // Optimization. Store the frame length with incomplete bit.
+            // The frame length with incomplete bit has been stored before the region was published.
             //
-            frame.Length.Store(frameLength | 1);
+            MlosProxy.FrameHeader frame = Frame(writeOffset);
 
             // Store type index and hash.
             //
             frame.CodegenTypeIndex = msg.CodegenTypeIndex();
-            frame.CodegenTypeHash = msg.CodegenTypeHash();
+
+            if (!hasCompactFrameHeaders)
+            {
+                frame.CodegenTypeHash = msg.CodegenTypeHash();
+            }
 
             // Copy the structure to the buffer.
             //
             IntPtr payload = Payload(writeOffset);
             CodegenTypeExtensions.Serialize(msg, payload);
 
+            if (hasFrameTimestamps)
+            {
+                // Store the send timestamp in the last 8 bytes of the frame.
+                //
+                unsafe
+                {
+                    Unsafe.WriteUnaligned((void*)(Buffer + (int)writeOffset + frameLength - sizeof(ulong)), Utils.TimestampInNanoseconds());
+                }
+            }
+
             // Frame is ready for the reader.
             //
             SignalFrameIsReady(frame, frameLength);
@@ -609,6 +925,9 @@ namespace Mlos.Core
         public SharedChannel(IntPtr buffer, uint size, MlosProxy.ChannelSynchronization sync)
         {
             Sync = sync;
+            hasFrameTimestamps = sync.HasFrameTimestamps.Load();
+            hasCompactFrameHeaders = sync.HasCompactFrameHeaders.Load();
+            frameHeaderLength = hasCompactFrameHeaders ? FrameHeader.CompactTypeSize : FrameHeader.TypeSize;
 
             unsafe
             {
@@ -620,7 +939,7 @@ namespace Mlos.Core
                 //
                 Buffer = buffer;
                 Size = size;
-                margin = Size - (uint)sizeof(FrameHeader);
+                margin = Size - (uint)frameHeaderLength;
             }
 
             // Initialize channel.
@@ -641,15 +960,24 @@ namespace Mlos.Core
             // Recover from the previous failures.
             //
 
+            // Drop the region acquired by the writer that failed before it published the region.
+            //
+            uint writePosition = Sync.WritePosition.LoadRelaxed();
+
+            if ((writePosition & 1) == 1)
+            {
+                writePosition &= ~1u;
+                Sync.WritePosition.Store(writePosition);
+            }
+
             // Advance free region. Follow the free links up to a current read position.
             //
             AdvanceFreePosition();
 
             // We reached first unprocessed frame. Follow the frames untill we reach writePosition.
-            // Clear the partially written frames and convert processed frames into empty ones, so the reader can ignore them.
+            // Convert the partially written frames and processed frames into link frames, so the reader can ignore them.
             //
             uint freePosition = Sync.FreePosition.Load();
-            uint writePosition = Sync.WritePosition.LoadRelaxed();
 
             while (freePosition != writePosition)
             {
@@ -669,7 +997,7 @@ namespace Mlos.Core
 
                     // The frame is partially written. Ignore it.
                     //
-                    ClearPayload(freeOffset, frameLength);
+                    frame.CodegenTypeIndex = 0;
 
                     frame.Length.Store(frameLength);
                 }
@@ -686,35 +1014,25 @@ namespace Mlos.Core
             Sync.ReadPosition.CompareExchange(freePosition, readPosition);
         }
 
-        [MethodImpl(MethodImplOptions.AggressiveInlining)]
-        private void ClearPayload(uint writeOffset, int frameLength)
-        {
-            ZeroMemory(Buffer + (int)writeOffset + sizeof(uint), frameLength - sizeof(uint));
-        }
+        /// <summary>
+        /// Size of the buffer - frameHeaderLength.
+        /// </summary>
+        private readonly uint margin;
 
-        [MethodImpl(MethodImplOptions.AggressiveInlining)]
-        private void ClearLinkPayload(uint writeOffset, int frameLength, uint bufferSize)
-        {
-            writeOffset += sizeof(uint);
-            frameLength -= sizeof(uint);
+        /// <summary>
+        /// If true, the frames include the send timestamp.
+        /// </summary>
+        private readonly bool hasFrameTimestamps;
 
-            if (writeOffset + frameLength > bufferSize)
-            {
-                // Overlapped link.
-                //
-                ZeroMemory(Buffer + (int)writeOffset, (int)(bufferSize - writeOffset));
-                ZeroMemory(Buffer, frameLength + (int)(writeOffset - bufferSize));
-            }
-            else
-            {
-                ZeroMemory(Buffer + (int)writeOffset, frameLength);
-            }
-        }
+        /// <summary>
+        /// If true, the frames have the compact header without the type hash.
+        /// </summary>
+        private readonly bool hasCompactFrameHeaders;
 
         /// <summary>
-        /// Size of the buffer - sizeof(FrameHeader).
+        /// Length of the frame header, FrameHeader.TypeSize or FrameHeader.CompactTypeSize.
         /// </summary>
-        private readonly uint margin;
+        private readonly int frameHeaderLength;
 
         /// <summary>
         /// Channel synchronization object.
@@ -745,7 +1063,7 @@ namespace Mlos.Core
         {
             unsafe
             {
-                return Buffer + (int)offset + sizeof(FrameHeader);
+                return Buffer + (int)offset + frameHeaderLength;
             }
         }
 
@@ -773,5 +1091,11 @@ namespace Mlos.Core
         /// Channel synchronization object.
         /// </summary>
         MlosProxy.ChannelSynchronization ISharedChannel.SyncObject => Sync;
+
+        /// <inheritdoc/>
+        public MlosProxyInternal.ChannelLatencyMemoryRegion LatencyStats { get; set; }
+
+        /// <inheritdoc/>
+        public TimeSpan UnregisteredTypeWaitTimeout { get; set; }
     }
 }
@@ -0,0 +1,807 @@
+// -----------------------------------------------------------------------
+// <copyright file="SharedChannel64.cs" company="Microsoft Corporation">
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License. See LICENSE in the project root
+// for license information.
+// </copyright>
+// -----------------------------------------------------------------------
+
+using System;
+using System.Runtime.CompilerServices;
+using System.Threading;
+
+using MlosProxy = Proxy.Mlos.Core;
+using StdTypesProxy = Proxy.Mlos.SettingsSystem.StdTypes;
+
+namespace Mlos.Core
+{
+    /// <summary>
+    /// Shared channel with 64-bit positions interface.
+    /// </summary>
+    public interface ISharedChannel64
+    {
+        /// <summary>
+        /// Send the message object.
+        /// </summary>
+        /// <typeparam name="TMessage">Type of the message to be send.</typeparam>
+        /// <param name="msg"></param>
+        void SendMessage<TMessage>(ref TMessage msg)
+            where TMessage : ICodegenType;
+
+        /// <summary>
+        /// Reader loop, process received messages.
+        /// </summary>
+        /// <param name="dispatchTable"></param>
+        void ProcessMessages(ref DispatchEntry[] dispatchTable);
+    }
+
+    /// <summary>
+    /// Shared channel with 64-bit positions.
+    /// Exchange protocol is the same as in SharedChannel, it supports the buffers larger than 2 GiB.
+    /// More details in: Doc/CircularBuffer.md.
+    /// </summary>
+    /// <typeparam name="TChannelPolicy">Shared channel policy.</typeparam>
+    /// <typeparam name="TChannelSpinPolicy">Shared channel spin policy.</typeparam>
+    /// <remarks>
+    /// The positions never overflow, the offset in the buffer is calculated by masking the position.
+    /// Frames are aligned to sizeof(long).
+    /// </remarks>
+    public class SharedChannel64<TChannelPolicy, TChannelSpinPolicy> : ISharedChannel64
+        where TChannelPolicy : ISharedChannelPolicy
+        where TChannelSpinPolicy : ISharedChannelSpinPolicy
+    {
+        /// <summary>
+        /// Offset returned when the channel has been terminated.
+        /// </summary>
+        private const ulong InvalidOffset = ulong.MaxValue;
+
+        /// <summary>
+        /// Signals readers that the frame is available to process.
+        /// </summary>
+        /// <param name="frame"></param>
+        /// <param name="frameLength"></param>
+        [MethodImpl(MethodImplOptions.AggressiveInlining)]
+        internal static void SignalFrameIsReady(MlosProxy.FrameHeader64 frame, long frameLength)
+        {
+            frame.Length.Store(frameLength);
+        }
+
+        /// <summary>
+        /// Notify the cleanup thread, that the frame has been processed.
+        /// </summary>
+        /// <param name="frame"></param>
+        /// <param name="frameLength"></param>
+        /// <remarks>Reader function.</remarks>
+        [MethodImpl(MethodImplOptions.AggressiveInlining)]
+        internal static void SignalFrameForCleanup(MlosProxy.FrameHeader64 frame, long frameLength)
+        {
+            frame.Length.Store(-frameLength);
+        }
+
+        /// <summary>
+        /// Follows the free links until we reach the current read position.
+        /// </summary>
+        /// <remarks>
+        /// Same reclaim protocol as SharedChannel.AdvanceFreePosition.
+        /// The reclaimed memory is not cleared, so a region longer than 2 GiB is reclaimed in constant time per frame.
+        /// </remarks>
+        internal void AdvanceFreePosition()
+        {
+            // Create AtomicUInt64 proxies once.
+            //
+            StdTypesProxy.AtomicUInt64 atomicFreePosition = Sync.FreePosition;
+            StdTypesProxy.AtomicUInt64 atomicReadPosition = Sync.ReadPosition;
+
+            // Move free position and allow the writer to advance.
+            //
+            ulong freePosition = atomicFreePosition.Load();
+            ulong readPosition = atomicReadPosition.LoadRelaxed();
+
+            if (freePosition == readPosition)
+            {
+                // Free position points to the current read position.
+                //
+                return;
+            }
+
+            // Load a frame from the beginning of the free region.
+            //
+            long frameLength = Frame(freePosition & mask).Length.Load();
+
+            if (frameLength >= 0 || (frameLength & 1) == 1)
+            {
+                // Frame is currently processed.
+                //
+                return;
+            }
+
+            // Follow the free links up to the current read position.
+            // By the time this cleanup is completed, the reader threads might process more frames and advance the read position.
+            //
+            ulong readLength = readPosition - freePosition;
+            ulong nextFreePosition = freePosition + (ulong)(-frameLength);
+
+            while (nextFreePosition - freePosition < readLength)
+            {
+                long nextFrameLength = Frame(nextFreePosition & mask).Length.Load();
+
+                if (nextFrameLength >= 0 || (nextFrameLength & 1) == 1)
+                {
+                    // Frame is currently processed.
+                    //
+                    break;
+                }
+
+                nextFreePosition += (ulong)(-nextFrameLength);
+            }
+
+            if (nextFreePosition - freePosition > readLength)
+            {
+                // The local free position is stale, the frames have been overwritten.
+                //
+                return;
+            }
+
+            // Advance free position, unless other writer thread has already advanced it.
+            //
+            atomicFreePosition.CompareExchange(nextFreePosition, freePosition);
+        }
+
+        /// <summary>
+        /// Publishes the region acquired by AcquireRegionForWrite to the readers.
+        /// </summary>
+        /// <param name="regionLength"></param>
+        /// <remarks>
+        /// Same as SharedChannel.PublishWriteRegion, the readers never read the frame lengths located at or after the write position.
+        /// </remarks>
+        [MethodImpl(MethodImplOptions.AggressiveInlining)]
+        private void PublishWriteRegion(long regionLength)
+        {
+            StdTypesProxy.AtomicUInt64 atomicWritePosition = Sync.WritePosition;
+
+            ulong writePosition = atomicWritePosition.LoadRelaxed() & ~1UL;
+
+            atomicWritePosition.Store(writePosition + (ulong)regionLength);
+        }
+
+        /// <summary>
+        /// Function returns an offset to the acquired region that can we safely use for write operation.
+        /// </summary>
+        /// <param name="frameLength"></param>
+        /// <returns>
+        /// An offset to the acquired region.
+        /// If reader has been aborted, return ulong.MaxValue.
+        /// </returns>
+        /// <remarks>
+        ///  There is no guarantee that the acquired region is contiguous (it might be overlapping).
+        ///  However it ensures that the next write offset will not be greater than the buffer margin,
+        ///  so the next writer can write an empty FrameHeader64.
+        ///  Same as SharedChannel, the writer sets the pending bit of the write position instead of advancing it,
+        ///  the region is published by PublishWriteRegion.
+        /// </remarks>
+        private ulong AcquireRegionForWrite(ref long frameLength)
+        {
+            // Create AtomicUInt64 proxies once.
+            //
+            StdTypesProxy.AtomicUInt64 atomicFreePosition = Sync.FreePosition;
+            StdTypesProxy.AtomicUInt64 atomicWritePosition = Sync.WritePosition;
+            StdTypesProxy.AtomicBool atomicTerminateChannel = Sync.TerminateChannel;
+
+            TChannelSpinPolicy channelSpinPolicy = default;
+
+            while (true)
+            {
+                // Read FreePosition first. Otherwise, it might advance if we had read WritePosition first.
+                //
+                ulong freePosition = atomicFreePosition.Load();
+                ulong writePosition = atomicWritePosition.LoadRelaxed();
+
+                if ((writePosition & 1) == 1)
+                {
+                    // Other writer is storing the frame length of its region.
+                    //
+                    channelSpinPolicy.FailedToAcquireWriteRegion();
+                    continue;
+                }
+
+                // Check if there is enough bytes to write frame (full frame or a link).
+                // Always keep the distance to free offset, at least a size of FrameHeader64.
+                //
+                if (!(writePosition - freePosition < margin - (ulong)frameLength))
+                {
+                    // Not enough free space to acquire region.
+                    //
+
+                    // Check if the channel is still active.
+                    //
+                    if (atomicTerminateChannel.LoadRelaxed())
+                    {
+                        return InvalidOffset;
+                    }
+
+                    // Advance free position to reclaim memory for writes.
+                    // Retry after that, as another writer might acquire just the released region.
+                    //
+                    AdvanceFreePosition();
+
+                    if (atomicFreePosition.Load() != freePosition)
+                    {
+                        continue;
+                    }
+
+                    // The readers have not released any frame yet.
+                    // Spin for a while, then wait for the notification from the readers.
+                    //
+                    if (!channelSpinPolicy.WaitForFreeSpace())
+                    {
+                        WaitForFreeSpace(freePosition);
+                    }
+
+                    continue;
+                }
+
+                // If the end of the requested frame is located in the buffer margin, extend the acquired region.
+                //
+                ulong frameLengthAdj = 0;
+
+                // NextWriteOffset is at the frame end.
+                // Ensure that after a full frame there is enough space for the next frame header.
+                // Otherwise, we will not be able to store next frame, because the frame header will not fit in the buffer.
+                //
+                ulong nextWriteOffset = (writePosition + (ulong)frameLength) & mask;
+                if (nextWriteOffset >= margin)
+                {
+                    // Update frameLength, as we acquired more than requested.
+                    //
+                    frameLengthAdj = Size - nextWriteOffset;
+                }
+
+                ulong expectedWritePosition = writePosition;
+                if (atomicWritePosition.LoadRelaxed() != expectedWritePosition ||
+                    atomicWritePosition.CompareExchange(writePosition | 1, expectedWritePosition) != expectedWritePosition)
+                {
+                    // Failed to acquire the write region, another writer acquired this region.
+                    //
+                    channelSpinPolicy.FailedToAcquireWriteRegion();
+                    continue;
+                }
+
+                frameLength += (long)frameLengthAdj;
+
+                // The region contains the stale frames, the readers do not read it until the region is published.
+                //
+                return writePosition & mask;
+            }
+        }
+
+        /// <summary>
+        /// Waits until the readers release the processed frames located at the free position.
+        /// </summary>
+        /// <param name="freePosition"></param>
+        /// <remarks>
+        /// Writer function.
+        /// Before the writer waits, it checks the free space for the last time.
+        /// </remarks>
+        private void WaitForFreeSpace(ulong freePosition)
+        {
+            uint waitToken = ChannelPolicy.PrepareWaitForFreeSpace();
+
+            Interlocked.MemoryBarrier();
+
+            if (Sync.TerminateChannel.LoadRelaxed())
+            {
+                return;
+            }
+
+            AdvanceFreePosition();
+
+            if (Sync.FreePosition.Load() != freePosition)
+            {
+                return;
+            }
+
+            ChannelPolicy.WaitForFreeSpace(waitToken);
+        }
+
+        /// <summary>
+        /// Acquire a region to write the frame.
+        /// </summary>
+        /// <param name="frameLength"></param>
+        /// <returns>Returns an offset to acquired memory region that can hold a full frame.</returns>
+        /// <remarks>
+        /// The acquired region is contiguous.
+        /// The frame length is stored with incomplete bit and the region is published before the function returns.
+        /// </remarks>
+        internal ulong AcquireWriteRegionForFrame(ref long frameLength)
+        {
+            long expectedFrameLength = frameLength;
+
+            // Acquire writing region in the buffer.
+            //
+            while (true)
+            {
+                frameLength = expectedFrameLength;
+
+                // Acquire region for writes. Function might adjust frame length.
+                //
+                ulong writeOffset = AcquireRegionForWrite(ref frameLength);
+
+                if (writeOffset == InvalidOffset)
+                {
+                    // The reader has terminated, abandon the write.
+                    //
+                    return writeOffset;
+                }
+
+                // We might acquired a circular region,
+                // check if we can store a full frame without overlapping the buffer.
+                //
+                if (writeOffset + (ulong)frameLength > Size)
+                {
+                    // There is not enough space in the buffer to write the full frame.
+                    // Create an empty frame to adjust the write offset to the beginning of the buffer.
+                    // Retry the whole operation until we write a full frame.
+                    //
+                    MlosProxy.FrameHeader64 frame = Frame(writeOffset);
+                    frame.CodegenTypeIndex = 0;
+                    frame.Length.Store(frameLength);
+                    PublishWriteRegion(frameLength);
+                    continue;
+                }
+
+                // Acquired a region that we can write a full frame.
+                // Store the frame length with incomplete bit and publish the region.
+                //
+                Frame(writeOffset).Length.Store(frameLength | 1);
+                PublishWriteRegion(frameLength);
+
+                return writeOffset;
+            }
+        }
+
+        /// <summary>
+        /// Wait for the frame become available.
+        /// </summary>
+        /// <returns>Returns an offset to the acquired frame.</returns>
+        /// <remarks>
+        /// Reader function.
+        /// If the wait has been aborted, it returns ulong.MaxValue.
+        /// </remarks>
+        internal ulong WaitForFrame()
+        {
+            ulong readPosition;
+            TChannelSpinPolicy channelSpinPolicy = default;
+
+            // Create AtomicUInt64 proxy once.
+            //
+            StdTypesProxy.AtomicUInt64 atomicReadPosition = Sync.ReadPosition;
+            StdTypesProxy.AtomicUInt64 atomicWritePosition = Sync.WritePosition;
+            StdTypesProxy.AtomicUInt32 atomicReaderInWaitingStateCount = Sync.ReaderInWaitingStateCount;
+            StdTypesProxy.AtomicBool atomicTerminateChannel = Sync.TerminateChannel;
+
+            uint shouldWait = 0;
+            uint waitToken = 0;
+
+            while (true)
+            {
+                // Wait for the frame become available.
+                // Spin on current frame (ReadOffset).
+                //
+                readPosition = atomicReadPosition.Load();
+
+                // The frame lengths are valid only before the published write position, the memory after it is not cleared.
+                //
+                ulong writePosition = atomicWritePosition.Load() & ~1UL;
+
+                MlosProxy.FrameHeader64 frame = Frame(readPosition & mask);
+
+                long frameLength = (readPosition != writePosition) ? frame.Length.Load() : 0;
+                if (frameLength > 0)
+                {
+                    // Writer had updated the length.
+                    // Frame is ready and available for the reader.
+                    // Advance ReadIndex to end of the frame, and allow other reads to process next frame.
+                    //
+                    ulong expectedReadPosition = readPosition;
+                    ulong nextReadPosition = readPosition + (ulong)(frameLength & ~1L);
+
+                    if (atomicReadPosition.LoadRelaxed() != expectedReadPosition ||
+                        atomicReadPosition.CompareExchange(nextReadPosition, expectedReadPosition) != expectedReadPosition)
+                    {
+                        // Other reader advanced ReadPosition therefore it will process the frame.
+                        //
+                        channelSpinPolicy.FailedToAcquireReadRegion();
+                        continue;
+                    }
+
+                    // Current reader owns the frame. Wait until the writer completes the write.
+                    //
+                    while ((frameLength & 1) == 1)
+                    {
+                        channelSpinPolicy.WaitForFrameCompletion();
+                        frameLength = frame.Length.Load();
+                    }
+
+                    break;
+                }
+
+                channelSpinPolicy.WaitForNewFrame();
+
+                // No frame yet, spin if the channel is stil active.
+                //
+                if (atomicTerminateChannel.LoadRelaxed())
+                {
+                    atomicReaderInWaitingStateCount.FetchSub(shouldWait);
+                    return InvalidOffset;
+                }
+
+                // Wait for the synchronization primitive.
+                //
+                if (shouldWait != 0)
+                {
+                    ChannelPolicy.WaitForFrame(waitToken);
+                    atomicReaderInWaitingStateCount.FetchSub(shouldWait);
+                    shouldWait = 0;
+                }
+                else
+                {
+                    // Before reader enters wait state it will increase ReaderInWaitingState count and then check if are there any messages in the channel.
+                    //
+                    shouldWait = 1;
+                    atomicReaderInWaitingStateCount.FetchAdd(shouldWait);
+                    waitToken = ChannelPolicy.PrepareWaitForFrame();
+                }
+            }
+
+            // Reset InWaitingState counter.
+            //
+            atomicReaderInWaitingStateCount.FetchSub(shouldWait);
+
+            // Reader acquired read region, frame is ready.
+            //
+            return readPosition & mask;
+        }
+
+        /// <summary>
+        /// Verifies the acquired frame and calls proper dispatcher.
+        /// </summary>
+        /// <param name="readOffset"></param>
+        /// <param name="dispatchTable"></param>
+        /// <returns>Returns the length of the frame.</returns>
+        /// <remarks>
+        /// Reader function.
+        /// The frame is not released, the caller signals the frame for cleanup.
+        /// Only the link frames might be longer than 2 GiB, the message frames are passed to the dispatcher.
+        /// </remarks>
+        private long DispatchFrame(ulong readOffset, DispatchEntry[] dispatchTable)
+        {
+            TChannelPolicy channelPolicy = default;
+
+            uint dispatchEntryCount = (uint)dispatchTable.Length;
+
+            // Verify frame and call dispatcher.
+            //
+            MlosProxy.FrameHeader64 frame = Frame(readOffset);
+            uint codegenTypeIndex = frame.CodegenTypeIndex;
+            ulong codegenTypeHash = frame.CodegenTypeHash;
+
+            long frameLength = frame.Length.LoadRelaxed();
+
+            // Check if this is valid frame or just the link to the beginning of the buffer.
+            //
+            if (codegenTypeIndex != 0 && codegenTypeIndex <= dispatchEntryCount)
+            {
+                // Use hash to check the message.
+                //
+                ulong expectedCodegenTypeHash = dispatchTable[codegenTypeIndex - 1].CodegenTypeHash;
+
+                bool isMessageValid = ((ulong)frameLength < Size) &&
+                    (frameLength <= int.MaxValue) &&
+                    (expectedCodegenTypeHash == codegenTypeHash);
+
+                if (isMessageValid)
+                {
+                    // Call dispatcher only if type hash is correct.
+                    //
+                    isMessageValid = dispatchTable[codegenTypeIndex - 1].Callback(Payload(readOffset), (int)frameLength);
+                }
+
+                if (!isMessageValid)
+                {
+                    // Received invalid frame, channel policy decides what how to handle it.
+                    //
+                    channelPolicy.ReceivedInvalidFrame();
+                }
+            }
+            else if (codegenTypeIndex != 0)
+            {
+                // Received invalid frame, channel policy decides what how to handle it.
+                //
+                channelPolicy.ReceivedInvalidFrame();
+            }
+
+            // Reader does not clear the frame.
+            // The processed frames are reclaimed without clearing the memory, the stale content is never read.
+            // The readers do not read past the published write position, and the writer stores the lengths (with the incomplete bit)
+            // of all the frames in the region before it publishes the region.
+            //
+            return frameLength;
+        }
+
+        /// <summary>
+        /// Waits for a new frame then call proper dispatcher.
+        /// </summary>
+        /// <param name="dispatchTable"></param>
+        /// <returns>
+        /// Returns true if reader successfully processed the frame. If the wait has been aborted, it returns false.
+        /// </returns>
+        /// <remarks>
+        /// To interrupt wait, set buffer.Sync.TerminateChannel to true.
+        /// </remarks>
+        public bool WaitAndDispatchFrame(DispatchEntry[] dispatchTable)
+        {
+            ulong readOffset = WaitForFrame();
+
+            if (readOffset == InvalidOffset)
+            {
+                // Invalid offset, the wait was interrupted.
+                //
+                return false;
+            }
+
+            long frameLength = DispatchFrame(readOffset, dispatchTable);
+
+            // Mark frame that processing is completed (negative length).
+            //
+            SignalFrameForCleanup(Frame(readOffset), frameLength);
+
+            // Notify the writers waiting for the free space.
+            //
+            ChannelPolicy.NotifyExternalWriter();
+
+            return true;
+        }
+
+        /// <inheritdoc/>
+        public void ProcessMessages(ref DispatchEntry[] dispatchTable)
+        {
+            Sync.TerminateChannel.Store(false);
+
+            Sync.ActiveReaderCount.FetchAdd(1);
+
+            // Receiver thread.
+            //
+            bool result = true;
+            while (result)
+            {
+                result = WaitAndDispatchFrame(dispatchTable);
+            }
+
+            Sync.ActiveReaderCount.FetchSub(1);
+
+            // The channel has been terminated, wake up the writers waiting for the free space.
+            //
+            ChannelPolicy.NotifyExternalWriter();
+        }
+
+        /// <inheritdoc/>
+        public void SendMessage<TMessage>(ref TMessage msg)
+            where TMessage : ICodegenType
+        {
+            // Calculate frame size.
+            //
+            long frameLength = (long)Utils.Align(FrameHeader64.TypeSize + CodegenTypeExtensions.GetSerializedSize(msg), sizeof(long));
+
+            // Acquire a write region to write the frame.
+            //
+            ulong writeOffset = AcquireWriteRegionForFrame(ref frameLength);
+
+            if (writeOffset == InvalidOffset)
+            {
+                // The write has been interrupted.
+                //
+                return;
+            }
+
+            // The frame length with incomplete bit has been stored before the region was published.
+            //
+            MlosProxy.FrameHeader64 frame = Frame(writeOffset);
+
+            // Store type index and hash.
+            //
+            frame.CodegenTypeIndex = msg.CodegenTypeIndex();
+            frame.CodegenTypeHash = msg.CodegenTypeHash();
+
+            // Copy the structure to the buffer.
+            //
+            IntPtr payload = Payload(writeOffset);
+            CodegenTypeExtensions.Serialize(msg, payload);
+
+            // Frame is ready for the reader.
+            //
+            SignalFrameIsReady(frame, frameLength);
+
+            // If there are readers in the waiting state, we need to notify them.
+            //
+            if (HasReadersInWaitingState())
+            {
+                ChannelPolicy.NotifyExternalReader();
+            }
+        }
+
+        /// <summary>
+        /// Initializes a new instance of the <see cref="SharedChannel64{TChannelPolicy, TChannelSpinPolicy}"/> class.
+        /// Constructor.
+        /// </summary>
+        /// <param name="sharedMemoryMapView"></param>
+        /// <param name="sync"></param>
+        public SharedChannel64(SharedMemoryMapView sharedMemoryMapView, MlosProxy.ChannelSynchronization64 sync)
+            : this(sharedMemoryMapView.Buffer, (ulong)sharedMemoryMapView.MemSize, sync)
+        {
+        }
+
+        /// <summary>
+        /// Initializes a new instance of the <see cref="SharedChannel64{TChannelPolicy, TChannelSpinPolicy}"/> class.
+        /// Constructor.
+        /// </summary>
+        /// <param name="buffer"></param>
+        /// <param name="size"></param>
+        /// <param name="sync"></param>
+        public SharedChannel64(IntPtr buffer, ulong size, MlosProxy.ChannelSynchronization64 sync)
+        {
+            // Buffer size must be a power of two, the offset is calculated with a mask.
+            //
+            if (size <= FrameHeader64.TypeSize || (size & (size - 1)) != 0)
+            {
+                throw new ArgumentException("Buffer size must be a power of two.", nameof(size));
+            }
+
+            Sync = sync;
+            Buffer = buffer;
+            Size = size;
+            mask = size - 1;
+            margin = size - FrameHeader64.TypeSize;
+
+            // Initialize channel.
+            //
+            InitializeChannel();
+        }
+
+        /// <summary>
+        /// Initializes the shared channel.
+        /// </summary>
+        /// <remarks>
+        /// The method handles the failures when one of the processes has terminated unexpectedly.
+        /// </remarks>
+        private void InitializeChannel()
+        {
+            Sync.TerminateChannel.Store(false);
+
+            // Recover from the previous failures.
+            //
+
+            // Drop the region acquired by the writer that failed before it published the region.
+            //
+            ulong writePosition = Sync.WritePosition.LoadRelaxed();
+
+            if ((writePosition & 1) == 1)
+            {
+                writePosition &= ~1UL;
+                Sync.WritePosition.Store(writePosition);
+            }
+
+            // Advance free region. Follow the free links up to a current read position.
+            //
+            AdvanceFreePosition();
+
+            // We reached first unprocessed frame. Follow the frames untill we reach writePosition.
+            // Convert the partially written frames and processed frames into link frames, so the reader can ignore them.
+            //
+            ulong freePosition = Sync.FreePosition.Load();
+
+            while (freePosition != writePosition)
+            {
+                // Check the current state of the frame by inspecting it's length.
+                //
+                MlosProxy.FrameHeader64 frame = Frame(freePosition & mask);
+
+                long frameLength = frame.Length.Load();
+
+                if (frameLength < 0 || (frameLength & 1) == 1)
+                {
+                    // The frame has been processed or the frame has been partially written.
+                    //
+                    frameLength = frameLength > 0 ? frameLength : -frameLength;
+                    frameLength &= ~1L;
+
+                    // The frame is partially written. Ignore it.
+                    //
+                    frame.CodegenTypeIndex = 0;
+
+                    frame.Length.Store(frameLength);
+                }
+
+                // Move to next frame.
+                //
+                freePosition += (ulong)frameLength;
+            }
+
+            // Set readPosition to freePostion to reprocess the frames.
+            //
+            freePosition = Sync.FreePosition.Load();
+            ulong readPosition = Sync.ReadPosition.Load();
+            Sync.ReadPosition.CompareExchange(freePosition, readPosition);
+        }
+
+        /// <summary>
+        /// Size of the buffer - 1, the offset in the buffer is (position &amp; mask).
+        /// </summary>
+        private readonly ulong mask;
+
+        /// <summary>
+        /// Size of the buffer - sizeof(FrameHeader64).
+        /// </summary>
+        private readonly ulong margin;
+
+        /// <summary>
+        /// Channel synchronization object.
+        /// </summary>
+        internal MlosProxy.ChannelSynchronization64 Sync;
+
+        /// <summary>
+        /// Pointer to the shared memory.
+        /// </summary>
+        internal IntPtr Buffer;
+
+        /// <summary>
+        /// Gets the pointer to the given offset in the buffer.
+        /// </summary>
+        /// <param name="offset"></param>
+        /// <returns></returns>
+        [MethodImpl(MethodImplOptions.AggressiveInlining)]
+        private IntPtr BufferAt(ulong offset)
+        {
+            unsafe
+            {
+                return new IntPtr((byte*)Buffer + offset);
+            }
+        }
+
+        /// <summary>
+        /// Gets the message frame at given offset.
+        /// </summary>
+        /// <param name="offset"></param>
+        /// <returns></returns>
+        [MethodImpl(MethodImplOptions.AggressiveInlining)]
+        internal MlosProxy.FrameHeader64 Frame(ulong offset)
+        {
+            return new MlosProxy.FrameHeader64() { Buffer = BufferAt(offset) };
+        }
+
+        [MethodImpl(MethodImplOptions.AggressiveInlining)]
+        internal IntPtr Payload(ulong offset)
+        {
+            return BufferAt(offset + FrameHeader64.TypeSize);
+        }
+
+        /// <summary>
+        /// Returns true if there are reader threads waiting for external process.
+        /// </summary>
+        /// <returns></returns>
+        [MethodImpl(MethodImplOptions.AggressiveInlining)]
+        internal bool HasReadersInWaitingState()
+        {
+            return Sync.ReaderInWaitingStateCount.Load() != 0;
+        }
+
+        /// <summary>
+        /// Size of the buffer.
+        /// </summary>
+        public ulong Size;
+
+        /// <summary>
+        /// Channel control policy.
+        /// </summary>
+        public TChannelPolicy ChannelPolicy;
+    }
+}
@@ -11,6 +11,11 @@ using System.Diagnostics;
 using System.Runtime.CompilerServices;
 using System.Threading;
 
+using Mlos.Core.Linux;
+
+using MlosProxy = Proxy.Mlos.Core;
+using StdTypesProxy = Proxy.Mlos.SettingsSystem.StdTypes;
+
 namespace Mlos.Core
 {
     /// <summary>
@@ -28,10 +33,34 @@ namespace Mlos.Core
         /// </summary>
         void NotifyExternalReader();
 
+        /// <summary>
+        /// Called when reader thread enters the waiting state, before it checks the frames for the last time.
+        /// </summary>
+        /// <returns>Returns a token passed to WaitForFrame.</returns>
+        uint PrepareWaitForFrame();
+
         /// <summary>
         /// Called when reader thread is no longer processing the messages.
         /// </summary>
-        void WaitForFrame();
+        /// <param name="waitToken">Token returned by PrepareWaitForFrame.</param>
+        void WaitForFrame(uint waitToken);
+
+        /// <summary>
+        /// Notify writers that the readers released the processed frames.
+        /// </summary>
+        void NotifyExternalWriter();
+
+        /// <summary>
+        /// Called when writer thread enters the waiting state, before it checks the free space for the last time.
+        /// </summary>
+        /// <returns>Returns a token passed to WaitForFreeSpace.</returns>
+        uint PrepareWaitForFreeSpace();
+
+        /// <summary>
+        /// Called when writer thread is waiting for the readers to release the processed frames.
+        /// </summary>
+        /// <param name="waitToken">Token returned by PrepareWaitForFreeSpace.</param>
+        void WaitForFreeSpace(uint waitToken);
     }
 
     /// <summary>
@@ -68,6 +97,14 @@ namespace Mlos.Core
         /// </summary>
         void FailedToAcquireReadRegion();
 
+        /// <summary>
+        /// Called when there is not enough free space in the buffer.
+        /// </summary>
+        /// <returns>
+        /// Returns false when the writer exhausted the spin and yield phases, and should wait for the notification instead.
+        /// </returns>
+        bool WaitForFreeSpace();
+
         #endregion
     }
 
@@ -97,8 +134,32 @@ namespace Mlos.Core
 
         /// <inheritdoc/>
         [MethodImpl(MethodImplOptions.AggressiveInlining)]
-        public void WaitForFrame()
+        public uint PrepareWaitForFrame() => 0;
+
+        /// <inheritdoc/>
+        [MethodImpl(MethodImplOptions.AggressiveInlining)]
+        public void WaitForFrame(uint waitToken)
+        {
+        }
+
+        /// <inheritdoc/>
+        [MethodImpl(MethodImplOptions.AggressiveInlining)]
+        public void NotifyExternalWriter()
+        {
+        }
+
+        /// <inheritdoc/>
+        [MethodImpl(MethodImplOptions.AggressiveInlining)]
+        public uint PrepareWaitForFreeSpace() => 0;
+
+        /// <inheritdoc/>
+        /// <remarks>
+        /// The policy does not provide notification, the writer polls for the free space.
+        /// </remarks>
+        [MethodImpl(MethodImplOptions.AggressiveInlining)]
+        public void WaitForFreeSpace(uint waitToken)
         {
+            Thread.Sleep(1);
         }
     }
 
@@ -125,48 +186,323 @@ namespace Mlos.Core
 
         /// <inheritdoc/>
         [MethodImpl(MethodImplOptions.AggressiveInlining)]
-        public void WaitForFrame()
+        public uint PrepareWaitForFrame() => 0;
+
+        /// <inheritdoc/>
+        [MethodImpl(MethodImplOptions.AggressiveInlining)]
+        public void WaitForFrame(uint waitToken)
         {
             NotificationEvent.Wait();
         }
 
+        /// <inheritdoc/>
+        /// <remarks>
+        /// The named event is used only to wake up the readers.
+        /// The writers intentionally poll for the free space, they wait only when the readers fall behind,
+        /// and a writer notification would require a second named event per channel.
+        /// </remarks>
+        [MethodImpl(MethodImplOptions.AggressiveInlining)]
+        public void NotifyExternalWriter()
+        {
+        }
+
+        /// <inheritdoc/>
+        [MethodImpl(MethodImplOptions.AggressiveInlining)]
+        public uint PrepareWaitForFreeSpace() => 0;
+
+        /// <inheritdoc/>
+        /// <remarks>
+        /// The policy does not provide notification, the writer polls for the free space.
+        /// </remarks>
+        [MethodImpl(MethodImplOptions.AggressiveInlining)]
+        public void WaitForFreeSpace(uint waitToken)
+        {
+            Thread.Sleep(1);
+        }
+
         /// <summary>
         /// Inter process synchronization object.
         /// </summary>
         public NamedEvent NotificationEvent;
     }
 
+    /// <summary>
+    /// Shared channel policy, readers wait on the futex word located in the channel synchronization object.
+    /// </summary>
+    /// <remarks>
+    /// Linux only. Both processes must use the futex policy for the channel.
+    /// The lowest bit of the futex word indicates there is a reader going to sleep, the remaining bits are the wakeup sequence.
+    /// The writer wakes up a reader only when it clears the lowest bit and advances the sequence.
+    /// More details in Mlos.Core/SharedChannelPolicies.h.
+    /// </remarks>
+    public struct FutexSharedChannelPolicy : ISharedChannelPolicy
+    {
+        /// <inheritdoc/>
+        [MethodImpl(MethodImplOptions.AggressiveInlining)]
+        public void ReceivedInvalidFrame()
+        {
+            // Invalid frame. Terminate.
+            //
+            Environment.Exit(0);
+        }
+
+        /// <inheritdoc/>
+        public void NotifyExternalReader()
+        {
+            StdTypesProxy.AtomicUInt32 wakeupSequence = Sync.ReaderWakeupSequence;
+
+            if (Sync.TerminateChannel.LoadRelaxed())
+            {
+                // Wake up all the readers.
+                //
+                wakeupSequence.FetchAdd(2);
+                Native.FutexSyscall(Native.SysFutex, wakeupSequence.Buffer, Native.FutexOperation.FUTEX_WAKE, int.MaxValue, IntPtr.Zero, IntPtr.Zero, 0);
+                return;
+            }
+
+            uint currentWakeupSequence = wakeupSequence.LoadRelaxed();
+
+            if ((currentWakeupSequence & 1) == 0)
+            {
+                // There is no reader going to sleep.
+                //
+                return;
+            }
+
+            if (wakeupSequence.CompareExchange((currentWakeupSequence + 2) & ~1U, currentWakeupSequence) != currentWakeupSequence)
+            {
+                // Another writer woke up the reader.
+                //
+                return;
+            }
+
+            Native.FutexSyscall(Native.SysFutex, wakeupSequence.Buffer, Native.FutexOperation.FUTEX_WAKE, 1, IntPtr.Zero, IntPtr.Zero, 0);
+        }
+
+        /// <inheritdoc/>
+        public uint PrepareWaitForFrame()
+        {
+            StdTypesProxy.AtomicUInt32 wakeupSequence = Sync.ReaderWakeupSequence;
+
+            uint currentWakeupSequence = wakeupSequence.Load();
+            uint expectedWakeupSequence;
+
+            do
+            {
+                expectedWakeupSequence = currentWakeupSequence;
+                currentWakeupSequence = wakeupSequence.CompareExchange(expectedWakeupSequence | 1, expectedWakeupSequence);
+            }
+            while (currentWakeupSequence != expectedWakeupSequence);
+
+            return expectedWakeupSequence | 1;
+        }
+
+        /// <inheritdoc/>
+        public void WaitForFrame(uint waitToken)
+        {
+            // The reader sleeps until a writer advances the wakeup sequence.
+            // Spurious wakeups (EAGAIN, EINTR) are handled by the reader loop.
+            //
+            Native.FutexSyscall(Native.SysFutex, Sync.ReaderWakeupSequence.Buffer, Native.FutexOperation.FUTEX_WAIT, waitToken, IntPtr.Zero, IntPtr.Zero, 0);
+        }
+
+        /// <inheritdoc/>
+        public void NotifyExternalWriter()
+        {
+            StdTypesProxy.AtomicUInt32 wakeupSequence = Sync.WriterWakeupSequence;
+
+            // Order the released frames before the check of the waiting writers.
+            //
+            Interlocked.MemoryBarrier();
+
+            if (Sync.TerminateChannel.LoadRelaxed())
+            {
+                // Wake up all the writers.
+                //
+                wakeupSequence.FetchAdd(2);
+                Native.FutexSyscall(Native.SysFutex, wakeupSequence.Buffer, Native.FutexOperation.FUTEX_WAKE, int.MaxValue, IntPtr.Zero, IntPtr.Zero, 0);
+                return;
+            }
+
+            uint currentWakeupSequence = wakeupSequence.LoadRelaxed();
+
+            if ((currentWakeupSequence & 1) == 0)
+            {
+                // There is no writer going to sleep.
+                //
+                return;
+            }
+
+            if (wakeupSequence.CompareExchange((currentWakeupSequence + 2) & ~1U, currentWakeupSequence) != currentWakeupSequence)
+            {
+                // Another reader woke up the writers.
+                //
+                return;
+            }
+
+            Native.FutexSyscall(Native.SysFutex, wakeupSequence.Buffer, Native.FutexOperation.FUTEX_WAKE, int.MaxValue, IntPtr.Zero, IntPtr.Zero, 0);
+        }
+
+        /// <inheritdoc/>
+        public uint PrepareWaitForFreeSpace()
+        {
+            StdTypesProxy.AtomicUInt32 wakeupSequence = Sync.WriterWakeupSequence;
+
+            uint currentWakeupSequence = wakeupSequence.Load();
+            uint expectedWakeupSequence;
+
+            do
+            {
+                expectedWakeupSequence = currentWakeupSequence;
+                currentWakeupSequence = wakeupSequence.CompareExchange(expectedWakeupSequence | 1, expectedWakeupSequence);
+            }
+            while (currentWakeupSequence != expectedWakeupSequence);
+
+            return expectedWakeupSequence | 1;
+        }
+
+        /// <inheritdoc/>
+        public void WaitForFreeSpace(uint waitToken)
+        {
+            Native.FutexSyscall(Native.SysFutex, Sync.WriterWakeupSequence.Buffer, Native.FutexOperation.FUTEX_WAIT, waitToken, IntPtr.Zero, IntPtr.Zero, 0);
+        }
+
+        /// <summary>
+        /// Channel synchronization object containing the futex word.
+        /// </summary>
+        internal MlosProxy.ChannelSynchronization Sync;
+    }
+
     /// <summary>
     /// Spin policy for the shared channel.
     /// </summary>
+    /// <remarks>
+    /// Adaptive spin policy. The waiting thread spins with a single pause instruction first,
+    /// then backs off exponentially, then yields the processor and finally parks for a short period.
+    /// A writer that failed to acquire the write region only spins, backs off and yields, it never parks.
+    /// The channel creates a new policy instance for every wait, so every wait starts with spinning.
+    /// The thresholds are shared by all the channels in the process.
+    /// </remarks>
     public struct SharedChannelSpinPolicy : ISharedChannelSpinPolicy
     {
+        /// <summary>
+        /// Spin policy thresholds.
+        /// </summary>
+        /// <remarks>
+        /// Thread.Sleep has a millisecond resolution, the park duration is rounded up to the full millisecond.
+        /// </remarks>
+        public static SharedChannelSpinPolicyConfig Config = new SharedChannelSpinPolicyConfig
+        {
+            PauseSpinCount = 64,
+            MaxBackoffPauseCount = 1024,
+            YieldCount = 16,
+            ParkDurationInMicroseconds = 100,
+        };
+
         /// <inheritdoc/>
         [MethodImpl(MethodImplOptions.AggressiveInlining)]
         public void WaitForNewFrame()
         {
+            SpinOnce();
         }
 
         /// <inheritdoc/>
         [MethodImpl(MethodImplOptions.AggressiveInlining)]
         public void WaitForFrameCompletion()
         {
+            SpinOnce();
         }
 
         /// <inheritdoc/>
         [MethodImpl(MethodImplOptions.AggressiveInlining)]
         public void FailedToAcquireReadRegion()
         {
-            spinWait.SpinOnce();
+            // The next frame might be already available, retry immediately.
+            //
+            Thread.SpinWait(1);
         }
 
         /// <inheritdoc/>
+        /// <remarks>
+        /// The writers are serialized by the pending write position, the writer never parks while the other writers take turns.
+        /// </remarks>
         [MethodImpl(MethodImplOptions.AggressiveInlining)]
         public void FailedToAcquireWriteRegion()
         {
-            spinWait.SpinOnce();
+            if (!SpinOrBackoff())
+            {
+                // The backoff is exhausted, yield and start the backoff again.
+                //
+                Thread.Yield();
+                backoffPauseCount = 0;
+            }
+        }
+
+        /// <inheritdoc/>
+        public bool WaitForFreeSpace()
+        {
+            if (spinCount >= Config.PauseSpinCount &&
+                backoffPauseCount >= Config.MaxBackoffPauseCount &&
+                yieldCount >= Config.YieldCount)
+            {
+                return false;
+            }
+
+            SpinOnce();
+            return true;
+        }
+
+        private void SpinOnce()
+        {
+            if (SpinOrBackoff())
+            {
+                return;
+            }
+
+            if (yieldCount < Config.YieldCount)
+            {
+                // Yield.
+                //
+                ++yieldCount;
+                Thread.Yield();
+            }
+            else
+            {
+                // Park.
+                //
+                Thread.Sleep((Config.ParkDurationInMicroseconds + 999) / 1000);
+            }
+        }
+
+        /// <summary>
+        /// Spins or backs off exponentially.
+        /// </summary>
+        /// <returns>False if both phases have been exhausted.</returns>
+        private bool SpinOrBackoff()
+        {
+            if (spinCount < Config.PauseSpinCount)
+            {
+                // Spin.
+                //
+                ++spinCount;
+                Thread.SpinWait(1);
+                return true;
+            }
+
+            if (backoffPauseCount < Config.MaxBackoffPauseCount)
+            {
+                // Exponential backoff.
+                //
+                backoffPauseCount = backoffPauseCount == 0 ? 2 : backoffPauseCount * 2;
+                Thread.SpinWait(backoffPauseCount);
+                return true;
+            }
+
+            return false;
         }
 
-        private SpinWait spinWait;
+        private int spinCount;
+        private int backoffPauseCount;
+        private int yieldCount;
     }
 }
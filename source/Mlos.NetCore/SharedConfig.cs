@@ -85,6 +85,14 @@ namespace Mlos.Core
         /// </summary>
         public TProxy Config => new TProxy { Buffer = this.Buffer + SharedConfigHeader.TypeSize };
 
+        /// <summary>
+        /// Notifies the component that the config has been updated.
+        /// </summary>
+        /// <remarks>
+        /// Increments the config id, the components polling the config id (e.g. the telemetry sampler) reload the config.
+        /// </remarks>
+        public void NotifyConfigUpdated() => Header.ConfigId.Increment();
+
         /// <inheritdoc/>
         bool ICodegenProxy.VerifyVariableData(ulong objectOffset, ulong totalDataSize, ref ulong expectedDataOffset) => true;
 
@@ -9,6 +9,7 @@
 using System;
 using System.ComponentModel;
 using System.IO;
+using System.Linq;
 using System.Runtime.InteropServices;
 
 namespace Mlos.Core.Linux
@@ -16,26 +17,42 @@ namespace Mlos.Core.Linux
     /// <summary>
     /// Linux implementation of shared memory map view.
     /// </summary>
+    /// <remarks>
+    /// See Also: Mlos.Core/SharedMemoryMapView.Linux.cpp for the huge pages support.
+    /// </remarks>
     public sealed class SharedMemoryMapView : Mlos.Core.SharedMemoryMapView
     {
+        /// <summary>
+        /// Mount point of hugetlbfs.
+        /// </summary>
+        private const string HugeTlbFsMountPath = "/dev/hugepages";
+
+        /// <summary>
+        /// Size of the transparent huge page (PMD size with 4KB base pages).
+        /// </summary>
+        private const ulong TransparentHugePageSize = 2 * 1024 * 1024;
+
         /// <summary>
         /// Create a new shared memory view.
         /// </summary>
         /// <param name="sharedMemoryMapName"></param>
         /// <param name="sharedMemorySize"></param>
+        /// <param name="useHugePages"></param>
         /// <returns></returns>
-        public static new SharedMemoryMapView Create(string sharedMemoryMapName, ulong sharedMemorySize)
+        public static SharedMemoryMapView Create(string sharedMemoryMapName, ulong sharedMemorySize, bool useHugePages)
         {
             // Try to unlink existing shared memory.
             //
             _ = Native.SharedMemoryUnlink(sharedMemoryMapName);
+            _ = Native.FileUnlink(HugeTlbFsFileName(sharedMemoryMapName));
 
             // Create shared memory view.
             //
             var sharedMemoryMapView = new SharedMemoryMapView(
                 sharedMemoryMapName,
                 sharedMemorySize,
-                Native.OpenFlags.O_CREAT | Native.OpenFlags.O_RDWR | Native.OpenFlags.O_EXCL);
+                Native.OpenFlags.O_CREAT | Native.OpenFlags.O_RDWR | Native.OpenFlags.O_EXCL,
+                useHugePages);
 
             return sharedMemoryMapView;
         }
@@ -45,15 +62,17 @@ namespace Mlos.Core.Linux
         /// </summary>
         /// <param name="sharedMemoryMapName"></param>
         /// <param name="sharedMemorySize"></param>
+        /// <param name="useHugePages"></param>
         /// <returns></returns>
-        public static new SharedMemoryMapView CreateOrOpen(string sharedMemoryMapName, ulong sharedMemorySize)
+        public static SharedMemoryMapView CreateOrOpen(string sharedMemoryMapName, ulong sharedMemorySize, bool useHugePages)
         {
             // Create or open shared memory view.
             //
             var sharedMemoryMapView = new SharedMemoryMapView(
                 sharedMemoryMapName,
                 sharedMemorySize,
-                Native.OpenFlags.O_CREAT | Native.OpenFlags.O_RDWR);
+                Native.OpenFlags.O_CREAT | Native.OpenFlags.O_RDWR,
+                useHugePages);
 
             return sharedMemoryMapView;
         }
@@ -63,25 +82,84 @@ namespace Mlos.Core.Linux
         /// </summary>
         /// <param name="sharedMemoryMapName"></param>
         /// <param name="sharedMemorySize"></param>
+        /// <param name="useHugePages"></param>
         /// <returns></returns>
-        public static new SharedMemoryMapView Open(string sharedMemoryMapName, ulong sharedMemorySize)
+        public static SharedMemoryMapView Open(string sharedMemoryMapName, ulong sharedMemorySize, bool useHugePages)
         {
             return new SharedMemoryMapView(
                 sharedMemoryMapName,
                 sharedMemorySize,
-                Native.OpenFlags.O_RDWR);
+                Native.OpenFlags.O_RDWR,
+                useHugePages);
+        }
+
+        /// <summary>
+        /// Opens the shared memory passed as a file descriptor (memfd), the view takes the ownership of the file descriptor.
+        /// </summary>
+        /// <param name="fileDescriptor"></param>
+        /// <returns></returns>
+        /// <remarks>
+        /// The shared memory keeps the size set by the process which created it.
+        /// </remarks>
+        public static SharedMemoryMapView OpenFileDescriptor(int fileDescriptor)
+        {
+            return new SharedMemoryMapView(new SharedMemorySafeHandle((IntPtr)fileDescriptor));
+        }
+
+        private SharedMemoryMapView(SharedMemorySafeHandle sharedMemoryHandle)
+        {
+            this.sharedMemoryHandle = sharedMemoryHandle;
+
+            long sharedMemorySize = Native.FileSeek(sharedMemoryHandle, 0, Native.SeekWhence.SEEK_END);
+            if (sharedMemorySize <= 0)
+            {
+                int errno = Marshal.GetLastWin32Error();
+                throw new InvalidOperationException(
+                    $"Failed to get the size of the shared memory {sharedMemoryHandle}",
+                    innerException: new Win32Exception(errno));
+            }
+
+            Buffer = Native.MapMemory(
+                address: IntPtr.Zero,
+                length: (ulong)sharedMemorySize,
+                protFlags: Native.ProtFlags.PROT_READ | Native.ProtFlags.PROT_WRITE,
+                mapFlags: Native.MapFlags.MAP_SHARED,
+                handle: sharedMemoryHandle,
+                offset: 0);
+
+            if (Buffer == Native.InvalidPointer)
+            {
+                int errno = Marshal.GetLastWin32Error();
+                throw new InvalidOperationException(
+                    $"Failed to mmap the shared memory {sharedMemoryHandle}",
+                    innerException: new Win32Exception(errno));
+            }
+
+            MemSize = (ulong)sharedMemorySize;
         }
 
-        private SharedMemoryMapView(string sharedMemoryMapName, ulong sharedMemorySize, Native.OpenFlags openFlags)
+        private SharedMemoryMapView(string sharedMemoryMapName, ulong sharedMemorySize, Native.OpenFlags openFlags, bool useHugePages)
         {
             this.sharedMemoryMapName = sharedMemoryMapName;
 
-            // Create shared memory view.
-            //
-            sharedMemoryHandle = Native.SharedMemoryOpen(
-                sharedMemoryMapName,
-                openFlags,
-                Native.ModeFlags.S_IRUSR | Native.ModeFlags.S_IWUSR);
+            bool createdNew = false;
+
+            if (!openFlags.HasFlag(Native.OpenFlags.O_EXCL))
+            {
+                // Open an existing shared memory, a file on hugetlbfs takes precedence over the shared memory object.
+                // The process which created the shared memory decided whether to use huge pages.
+                //
+                OpenExistingSharedMemory();
+            }
+
+            if ((sharedMemoryHandle == null || sharedMemoryHandle.IsInvalid) &&
+                openFlags.HasFlag(Native.OpenFlags.O_CREAT))
+            {
+                sharedMemoryHandle?.Dispose();
+                createdNew = true;
+
+                CreateSharedMemory(openFlags, useHugePages);
+            }
 
             if (sharedMemoryHandle.IsInvalid)
             {
@@ -92,6 +170,131 @@ namespace Mlos.Core.Linux
                     innerException: new Win32Exception(errno));
             }
 
+            if (!openFlags.HasFlag(Native.OpenFlags.O_EXCL))
+            {
+                // Opening an existing shared memory keeps its size.
+                // Resizing the shared memory would invalidate the views mapped by other processes.
+                //
+                long existingSharedMemorySize = Native.FileSeek(sharedMemoryHandle, 0, Native.SeekWhence.SEEK_END);
+                if (existingSharedMemorySize > 0)
+                {
+                    sharedMemorySize = (ulong)existingSharedMemorySize;
+                    createdNew = false;
+                }
+            }
+
+            if (createdNew)
+            {
+                // Round the size of the new shared memory up to the page size.
+                //
+                ulong pageSize = isHugeTlbFsFile ? HugeTlbFsPageSize() : useHugePages ? TransparentHugePageSize : (ulong)Environment.SystemPageSize;
+
+                sharedMemorySize = (sharedMemorySize + pageSize - 1) / pageSize * pageSize;
+            }
+
+            Buffer = MapMemory(sharedMemorySize);
+
+            if (Buffer == Native.InvalidPointer && isHugeTlbFsFile && createdNew)
+            {
+                // We created the hugetlbfs file, but there are not enough free huge pages.
+                // Remove the file and use the shared memory object with the transparent huge pages instead.
+                //
+                sharedMemoryHandle.Dispose();
+                _ = Native.FileUnlink(HugeTlbFsFileName(sharedMemoryMapName));
+                isHugeTlbFsFile = false;
+
+                CreateSharedMemory(Native.OpenFlags.O_CREAT | Native.OpenFlags.O_RDWR, useHugePages: false);
+
+                Buffer = MapMemory(sharedMemorySize);
+            }
+
+            if (Buffer == Native.InvalidPointer)
+            {
+                int errno = Marshal.GetLastWin32Error();
+                throw new InvalidOperationException(
+                    $"Failed to mmap {sharedMemoryMapName} {sharedMemoryHandle}",
+                    innerException: new Win32Exception(errno));
+            }
+
+            if (useHugePages && !isHugeTlbFsFile)
+            {
+                // Request transparent huge pages, fails if they are disabled for the shared memory.
+                // The view remains usable with the regular pages.
+                //
+                _ = Native.MemoryAdvise(Buffer, sharedMemorySize, Native.MemoryAdvice.MADV_HUGEPAGE);
+            }
+
+            MemSize = sharedMemorySize;
+        }
+
+        /// <summary>
+        /// Gets a value indicating whether the shared memory is a file on hugetlbfs.
+        /// </summary>
+        public bool IsHugeTlbFsFile => isHugeTlbFsFile;
+
+        /// <summary>
+        /// Opens an existing shared memory, a file on hugetlbfs or a shared memory object.
+        /// </summary>
+        private void OpenExistingSharedMemory()
+        {
+            if (IsHugeTlbFsMounted())
+            {
+                sharedMemoryHandle = Native.FileOpen(
+                    HugeTlbFsFileName(sharedMemoryMapName),
+                    Native.OpenFlags.O_RDWR,
+                    Native.ModeFlags.S_IRUSR | Native.ModeFlags.S_IWUSR);
+
+                if (!sharedMemoryHandle.IsInvalid)
+                {
+                    isHugeTlbFsFile = true;
+                    return;
+                }
+
+                sharedMemoryHandle.Dispose();
+            }
+
+            sharedMemoryHandle = Native.SharedMemoryOpen(
+                sharedMemoryMapName,
+                Native.OpenFlags.O_RDWR,
+                Native.ModeFlags.S_IRUSR | Native.ModeFlags.S_IWUSR);
+        }
+
+        /// <summary>
+        /// Creates a new shared memory, on hugetlbfs if huge pages are requested and hugetlbfs is mounted.
+        /// </summary>
+        /// <param name="openFlags"></param>
+        /// <param name="useHugePages"></param>
+        private void CreateSharedMemory(Native.OpenFlags openFlags, bool useHugePages)
+        {
+            if (useHugePages && IsHugeTlbFsMounted())
+            {
+                sharedMemoryHandle = Native.FileOpen(
+                    HugeTlbFsFileName(sharedMemoryMapName),
+                    openFlags,
+                    Native.ModeFlags.S_IRUSR | Native.ModeFlags.S_IWUSR);
+
+                if (!sharedMemoryHandle.IsInvalid)
+                {
+                    isHugeTlbFsFile = true;
+                    return;
+                }
+
+                sharedMemoryHandle.Dispose();
+            }
+
+            sharedMemoryHandle = Native.SharedMemoryOpen(
+                sharedMemoryMapName,
+                openFlags,
+                Native.ModeFlags.S_IRUSR | Native.ModeFlags.S_IWUSR);
+        }
+
+        /// <summary>
+        /// Sets the size of the shared memory and maps it.
+        /// </summary>
+        /// <param name="sharedMemorySize"></param>
+        /// <returns>Address of the mapping, Native.InvalidPointer on failure.</returns>
+        private IntPtr MapMemory(ulong sharedMemorySize)
+        {
             if (Native.FileTruncate(sharedMemoryHandle, (long)sharedMemorySize) == -1)
             {
                 int errno = Marshal.GetLastWin32Error();
@@ -100,22 +303,57 @@ namespace Mlos.Core.Linux
                     innerException: new Win32Exception(errno));
             }
 
-            Buffer = Native.MapMemory(
+            return Native.MapMemory(
                 address: IntPtr.Zero,
                 length: sharedMemorySize,
                 protFlags: Native.ProtFlags.PROT_READ | Native.ProtFlags.PROT_WRITE,
                 mapFlags: Native.MapFlags.MAP_SHARED,
                 handle: sharedMemoryHandle,
                 offset: 0);
-            if (Buffer == Native.InvalidPointer)
+        }
+
+        /// <summary>
+        /// Gets the name of the hugetlbfs file backing the shared memory.
+        /// </summary>
+        /// <param name="sharedMemoryMapName"></param>
+        /// <returns></returns>
+        private static string HugeTlbFsFileName(string sharedMemoryMapName) => $"{HugeTlbFsMountPath}/{sharedMemoryMapName}";
+
+        /// <summary>
+        /// Checks if hugetlbfs is mounted, so we never create the files on a different file system.
+        /// </summary>
+        /// <returns></returns>
+        private static bool IsHugeTlbFsMounted()
+        {
+            try
             {
-                int errno = Marshal.GetLastWin32Error();
-                throw new InvalidOperationException(
-                    $"Failed to mmap {sharedMemoryMapName} {sharedMemoryHandle}",
-                    innerException: new Win32Exception(errno));
+                return File.ReadLines("/proc/mounts")
+                    .Select(line => line.Split(' '))
+                    .Any(mount => mount.Length > 2 && mount[1] == HugeTlbFsMountPath && mount[2] == "hugetlbfs");
             }
+            catch (IOException)
+            {
+                return false;
+            }
+        }
 
-            MemSize = sharedMemorySize;
+        /// <summary>
+        /// Gets the default huge page size.
+        /// </summary>
+        /// <returns></returns>
+        private static ulong HugeTlbFsPageSize()
+        {
+            // Format: "Hugepagesize:       2048 kB".
+            //
+            string hugePageSizeLine = File.ReadLines("/proc/meminfo").FirstOrDefault(line => line.StartsWith("Hugepagesize:", StringComparison.Ordinal));
+
+            if (hugePageSizeLine != null &&
+                ulong.TryParse(hugePageSizeLine.Split(' ', StringSplitOptions.RemoveEmptyEntries)[1], out ulong hugePageSizeInKB))
+            {
+                return hugePageSizeInKB * 1024;
+            }
+
+            return TransparentHugePageSize;
         }
 
         /// <summary>
@@ -139,7 +377,9 @@ namespace Mlos.Core.Linux
                 //
                 if (sharedMemoryMapName != null)
                 {
-                    _ = Native.SharedMemoryUnlink(sharedMemoryMapName);
+                    _ = isHugeTlbFsFile
+                        ? Native.FileUnlink(HugeTlbFsFileName(sharedMemoryMapName))
+                        : Native.SharedMemoryUnlink(sharedMemoryMapName);
                 }
 
                 CleanupOnClose = false;
@@ -151,5 +391,7 @@ namespace Mlos.Core.Linux
         private SharedMemorySafeHandle sharedMemoryHandle;
 
         private readonly string sharedMemoryMapName;
+
+        private bool isHugeTlbFsFile;
     }
 }
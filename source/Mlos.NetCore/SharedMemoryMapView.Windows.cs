@@ -6,6 +6,7 @@
 // </copyright>
 // -----------------------------------------------------------------------
 
+using System;
 using System.ComponentModel;
 using System.IO;
 using System.Runtime.InteropServices;
@@ -66,6 +67,13 @@ namespace Mlos.Core.Windows
                     innerException: new Win32Exception(Marshal.GetLastWin32Error()));
             }
 
+            if (Marshal.GetLastWin32Error() == Native.ErrorAlreadyExists)
+            {
+                // The shared memory already exists, map it with its current size.
+                //
+                sharedMemorySize = 0;
+            }
+
             Security.VerifyHandleOwner(sharedMemoryHandle);
 
             return new SharedMemoryMapView(sharedMemoryHandle, sharedMemorySize);
@@ -93,7 +101,9 @@ namespace Mlos.Core.Windows
 
             Security.VerifyHandleOwner(sharedMemoryHandle);
 
-            return new SharedMemoryMapView(sharedMemoryHandle, sharedMemorySize);
+            // Map the existing shared memory with its current size.
+            //
+            return new SharedMemoryMapView(sharedMemoryHandle, sharedMemorySize: 0);
         }
 
         private SharedMemoryMapView(SharedMemorySafeHandle sharedMemoryHandle, ulong sharedMemorySize)
@@ -109,6 +119,24 @@ namespace Mlos.Core.Windows
 
             Buffer = memoryMappingHandle.DangerousGetHandle();
 
+            if (sharedMemorySize == 0)
+            {
+                // Obtain the size of the mapped view.
+                //
+                if (Native.VirtualQueryEx(
+                    Native.CurrentProcess,
+                    Buffer,
+                    out Native.MEMORY_BASIC_INFORMATION memoryInfo,
+                    (uint)Marshal.SizeOf<Native.MEMORY_BASIC_INFORMATION>()) == 0)
+                {
+                    throw new InvalidOperationException(
+                        "Failed to VirtualQueryEx",
+                        innerException: new Win32Exception(Marshal.GetLastWin32Error()));
+                }
+
+                sharedMemorySize = (ulong)memoryInfo.RegionSize.ToInt64();
+            }
+
             MemSize = sharedMemorySize;
         }
 
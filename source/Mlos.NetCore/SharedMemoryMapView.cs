@@ -19,9 +19,10 @@ namespace Mlos.Core
         /// </summary>
         /// <param name="sharedMemoryMapName"></param>
         /// <param name="sharedMemorySize"></param>
+        /// <param name="useHugePages">If true, the shared memory is backed by huge pages (Linux only).</param>
         /// <exception cref="InvalidOperationException">Thrown when executed on unsupported OS.</exception>
         /// <returns></returns>
-        public static SharedMemoryMapView Create(string sharedMemoryMapName, ulong sharedMemorySize)
+        public static SharedMemoryMapView Create(string sharedMemoryMapName, ulong sharedMemorySize, bool useHugePages = false)
         {
             if (RuntimeInformation.IsOSPlatform(OSPlatform.Windows))
             {
@@ -29,7 +30,7 @@ namespace Mlos.Core
             }
             else if (RuntimeInformation.IsOSPlatform(OSPlatform.Linux))
             {
-                return Linux.SharedMemoryMapView.Create(sharedMemoryMapName, sharedMemorySize);
+                return Linux.SharedMemoryMapView.Create(sharedMemoryMapName, sharedMemorySize, useHugePages);
             }
             else
             {
@@ -42,8 +43,9 @@ namespace Mlos.Core
         /// </summary>
         /// <param name="sharedMemoryMapName"></param>
         /// <param name="sharedMemorySize"></param>
+        /// <param name="useHugePages">If true, the new shared memory is backed by huge pages (Linux only).</param>
         /// <returns></returns>
-        public static SharedMemoryMapView CreateOrOpen(string sharedMemoryMapName, ulong sharedMemorySize)
+        public static SharedMemoryMapView CreateOrOpen(string sharedMemoryMapName, ulong sharedMemorySize, bool useHugePages = false)
         {
             if (RuntimeInformation.IsOSPlatform(OSPlatform.Windows))
             {
@@ -51,7 +53,7 @@ namespace Mlos.Core
             }
             else if (RuntimeInformation.IsOSPlatform(OSPlatform.Linux))
             {
-                return Linux.SharedMemoryMapView.CreateOrOpen(sharedMemoryMapName, sharedMemorySize);
+                return Linux.SharedMemoryMapView.CreateOrOpen(sharedMemoryMapName, sharedMemorySize, useHugePages);
             }
             else
             {
@@ -64,8 +66,9 @@ namespace Mlos.Core
         /// </summary>
         /// <param name="sharedMemoryMapName"></param>
         /// <param name="sharedMemorySize"></param>
+        /// <param name="useHugePages">If true, requests the transparent huge pages for the view (Linux only).</param>
         /// <returns></returns>
-        public static SharedMemoryMapView Open(string sharedMemoryMapName, ulong sharedMemorySize)
+        public static SharedMemoryMapView Open(string sharedMemoryMapName, ulong sharedMemorySize, bool useHugePages = false)
         {
             if (RuntimeInformation.IsOSPlatform(OSPlatform.Windows))
             {
@@ -73,7 +76,7 @@ namespace Mlos.Core
             }
             else if (RuntimeInformation.IsOSPlatform(OSPlatform.Linux))
             {
-                return Linux.SharedMemoryMapView.Open(sharedMemoryMapName, sharedMemorySize);
+                return Linux.SharedMemoryMapView.Open(sharedMemoryMapName, sharedMemorySize, useHugePages);
             }
             else
             {
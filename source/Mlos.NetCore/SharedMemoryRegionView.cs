@@ -22,12 +22,13 @@ namespace Mlos.Core
         /// </summary>
         /// <param name="sharedMemoryMapName"></param>
         /// <param name="sharedMemorySize"></param>
+        /// <param name="useHugePages">If true, the memory region is backed by huge pages (Linux only).</param>
         /// <returns></returns>
         /// <typeparam name="T">Memory region type.</typeparam>
-        public static SharedMemoryRegionView<T> Create<T>(string sharedMemoryMapName, ulong sharedMemorySize)
+        public static SharedMemoryRegionView<T> Create<T>(string sharedMemoryMapName, ulong sharedMemorySize, bool useHugePages = false)
             where T : ICodegenProxy, new()
         {
-            var memoryRegionView = new SharedMemoryRegionView<T>(SharedMemoryMapView.Create(sharedMemoryMapName, sharedMemorySize));
+            var memoryRegionView = new SharedMemoryRegionView<T>(SharedMemoryMapView.Create(sharedMemoryMapName, sharedMemorySize, useHugePages));
 
             MlosProxyInternal.MemoryRegionInitializer<T> memoryRegionInitializer = default;
             memoryRegionInitializer.Initalize(memoryRegionView);
@@ -39,18 +40,19 @@ namespace Mlos.Core
         /// </summary>
         /// <param name="sharedMemoryMapName"></param>
         /// <param name="sharedMemorySize"></param>
+        /// <param name="useHugePages">If true, the new memory region is backed by huge pages (Linux only).</param>
         /// <returns></returns>
         /// <typeparam name="T">Memory region type.</typeparam>
-        public static SharedMemoryRegionView<T> CreateOrOpen<T>(string sharedMemoryMapName, ulong sharedMemorySize)
+        public static SharedMemoryRegionView<T> CreateOrOpen<T>(string sharedMemoryMapName, ulong sharedMemorySize, bool useHugePages = false)
             where T : ICodegenProxy, new()
         {
             try
             {
-                return new SharedMemoryRegionView<T>(SharedMemoryMapView.Open(sharedMemoryMapName, sharedMemorySize));
+                return new SharedMemoryRegionView<T>(SharedMemoryMapView.Open(sharedMemoryMapName, sharedMemorySize, useHugePages));
             }
             catch (FileNotFoundException)
             {
-                var memoryRegionView = new SharedMemoryRegionView<T>(SharedMemoryMapView.Create(sharedMemoryMapName, sharedMemorySize));
+                var memoryRegionView = new SharedMemoryRegionView<T>(SharedMemoryMapView.Create(sharedMemoryMapName, sharedMemorySize, useHugePages));
 
                 MlosProxyInternal.MemoryRegionInitializer<T> memoryRegionInitializer = default;
                 memoryRegionInitializer.Initalize(memoryRegionView);
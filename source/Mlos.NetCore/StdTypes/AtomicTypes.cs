@@ -459,6 +459,151 @@ namespace Proxy.Mlos.SettingsSystem.StdTypes
         private unsafe uint* ptr;
     }
 
+    /// <summary>
+    /// CSharp proxy for std::atomic_int64_t.
+    /// </summary>
+    public struct AtomicInt64 : IEquatable<AtomicInt64>, ICodegenProxy
+    {
+        /// <summary>
+        /// Operator ==.
+        /// </summary>
+        /// <param name="left"></param>
+        /// <param name="right"></param>
+        /// <returns></returns>
+        public static bool operator ==(AtomicInt64 left, AtomicInt64 right) => left.Equals(right);
+
+        /// <summary>
+        /// Operator !=.
+        /// </summary>
+        /// <param name="left"></param>
+        /// <param name="right"></param>
+        /// <returns></returns>
+        public static bool operator !=(AtomicInt64 left, AtomicInt64 right) => !(left == right);
+
+        /// <inheritdoc />
+        public override bool Equals(object obj)
+        {
+            if (!(obj is AtomicInt64))
+            {
+                return false;
+            }
+
+            return Equals((AtomicInt64)obj);
+        }
+
+        /// <inheritdoc />
+        public bool Equals(AtomicInt64 other)
+        {
+            unsafe
+            {
+                return ptr == other.ptr;
+            }
+        }
+
+        /// <inheritdoc />
+        public override int GetHashCode()
+        {
+            unsafe
+            {
+                return (int)ptr;
+            }
+        }
+
+        /// <summary>
+        /// Returns a 64-bit value, loaded as an atomic operation.
+        /// </summary>
+        /// <returns></returns>
+        [MethodImpl(MethodImplOptions.AggressiveInlining)]
+        public long Load()
+        {
+            unsafe
+            {
+                return Volatile.Read(ref *ptr);
+            }
+        }
+
+        /// <summary>
+        /// Returns a 64-bit value, loaded as an atomic operation.
+        /// </summary>
+        /// <returns></returns>
+        [MethodImpl(MethodImplOptions.AggressiveInlining)]
+        public long LoadRelaxed()
+        {
+            unsafe
+            {
+                return *ptr;
+            }
+        }
+
+        /// <summary>
+        /// Stores 64-bit value.
+        /// </summary>
+        /// <param name="value"></param>
+        [MethodImpl(MethodImplOptions.AggressiveInlining)]
+        internal void Store(long value)
+        {
+            unsafe
+            {
+                Volatile.Write(ref *ptr, value);
+            }
+        }
+
+        /// <summary>
+        /// Atomically compares two 64-bit signed integers for equality and, if they are equal, replaces the first value.
+        /// </summary>
+        /// <param name="value"></param>
+        /// <param name="comparand"></param>
+        /// <returns></returns>
+        [MethodImpl(MethodImplOptions.AggressiveInlining)]
+        public long CompareExchange(long value, long comparand)
+        {
+            unsafe
+            {
+                return Interlocked.CompareExchange(ref *ptr, value, comparand);
+            }
+        }
+
+        /// <inheritdoc/>
+        uint ICodegenKey.CodegenTypeIndex() => throw new NotImplementedException();
+
+        /// <inheritdoc/>
+        ulong ICodegenKey.CodegenTypeHash() => throw new NotImplementedException();
+
+        /// <inheritdoc/>
+        public ulong CodegenTypeSize() => sizeof(long);
+
+        /// <inheritdoc/>
+        public uint GetKeyHashValue<THash>()
+            where THash : IHash<uint> => throw new NotImplementedException();
+
+        /// <inheritdoc/>
+        public bool CompareKey(ICodegenProxy proxy) => throw new NotImplementedException();
+
+        /// <inheritdoc/>
+        bool ICodegenProxy.VerifyVariableData(ulong objectOffset, ulong totalDataSize, ref ulong expectedDataOffset) => true;
+
+        /// <inheritdoc/>
+        public IntPtr Buffer
+        {
+            get
+            {
+                unsafe
+                {
+                    return new IntPtr(ptr);
+                }
+            }
+            set
+            {
+                unsafe
+                {
+                    ptr = (long*)value.ToPointer();
+                }
+            }
+        }
+
+        private unsafe long* ptr;
+    }
+
     /// <summary>
     /// CSharp proxy for std::atomic_int64_t.
     /// </summary>
@@ -559,6 +704,15 @@ namespace Proxy.Mlos.SettingsSystem.StdTypes
             }
         }
 
+        [MethodImpl(MethodImplOptions.AggressiveInlining)]
+        internal ulong FetchAdd(ulong value)
+        {
+            unsafe
+            {
+                return (ulong)Interlocked.Add(ref *(long*)ptr, (long)value);
+            }
+        }
+
         /// <inheritdoc/>
         uint ICodegenKey.CodegenTypeIndex() => throw new NotImplementedException();
 
@@ -0,0 +1,218 @@
+// -----------------------------------------------------------------------
+// <copyright file="UnixDomainSocket.Linux.cs" company="Microsoft Corporation">
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License. See LICENSE in the project root
+// for license information.
+// </copyright>
+// -----------------------------------------------------------------------
+
+using System;
+using System.ComponentModel;
+using System.IO;
+using System.Net.Sockets;
+using System.Runtime.InteropServices;
+
+namespace Mlos.Core.Linux
+{
+    /// <summary>
+    /// Unix domain socket used to pass the file descriptors between the processes.
+    /// </summary>
+    /// <remarks>
+    /// See Also: Mlos.Core/UnixDomainSocket.Linux.cpp.
+    /// </remarks>
+    public sealed unsafe class UnixDomainSocket : IDisposable
+    {
+        /// <summary>
+        /// Creates a listening socket.
+        /// </summary>
+        /// <param name="socketPath">Path of the socket file, a path starting with '@' is an abstract socket address.</param>
+        /// <returns></returns>
+        /// <remarks>
+        /// Removes a stale socket file left by a process which did not close the socket.
+        /// </remarks>
+        public static UnixDomainSocket Listen(string socketPath)
+        {
+            if (string.IsNullOrEmpty(socketPath))
+            {
+                throw new ArgumentException("Invalid socket path.", nameof(socketPath));
+            }
+
+            bool isAbstract = socketPath[0] == '@';
+
+            if (!isAbstract)
+            {
+                _ = Native.FileUnlink(socketPath);
+            }
+
+            var socket = new Socket(AddressFamily.Unix, SocketType.Stream, ProtocolType.Unspecified);
+
+            try
+            {
+                socket.Bind(new UnixDomainSocketEndPoint(isAbstract ? "\0" + socketPath.Substring(1) : socketPath));
+                socket.Listen(backlog: 1);
+            }
+            catch
+            {
+                socket.Dispose();
+                throw;
+            }
+
+            return new UnixDomainSocket(socket, isAbstract ? null : socketPath);
+        }
+
+        private UnixDomainSocket(Socket socket, string socketFileName)
+        {
+            this.socket = socket;
+            this.socketFileName = socketFileName;
+        }
+
+        /// <summary>
+        /// Waits for a connection on the listening socket.
+        /// </summary>
+        /// <returns>Connected socket.</returns>
+        public UnixDomainSocket Accept()
+        {
+            return new UnixDomainSocket(socket.Accept(), socketFileName: null);
+        }
+
+        /// <summary>
+        /// Sends the buffer.
+        /// </summary>
+        /// <param name="buffer"></param>
+        public void Send(byte[] buffer)
+        {
+            int sentSize = socket.Send(buffer);
+
+            if (sentSize != buffer.Length)
+            {
+                throw new IOException($"Failed to send {buffer.Length} bytes, sent {sentSize}.");
+            }
+        }
+
+        /// <summary>
+        /// Receives the buffer and the file descriptors sent with it.
+        /// </summary>
+        /// <param name="buffer">The buffer is filled completely.</param>
+        /// <param name="fileDescriptors">Receives the file descriptors, the caller takes the ownership.</param>
+        /// <returns>Number of the received file descriptors.</returns>
+        /// <remarks>
+        /// File descriptors which do not fit into the array are closed.
+        /// </remarks>
+        public int Receive(byte[] buffer, int[] fileDescriptors)
+        {
+            int controlBufferSize = sizeof(Native.ControlMessageHeader) + AlignControlMessage(sizeof(int) * fileDescriptors.Length);
+            byte* controlBuffer = stackalloc byte[controlBufferSize];
+
+            long receivedSize;
+            var message = default(Native.MessageHeader);
+
+            fixed (byte* bufferPointer = buffer)
+            {
+                var ioVector = new Native.IoVector
+                {
+                    Base = (IntPtr)bufferPointer,
+                    Length = (ulong)buffer.Length,
+                };
+
+                message.IoVector = &ioVector;
+                message.IoVectorLength = 1;
+                message.Control = (IntPtr)controlBuffer;
+                message.ControlLength = (ulong)controlBufferSize;
+
+                do
+                {
+                    receivedSize = Native.ReceiveMessage(
+                        socket.Handle,
+                        ref message,
+                        Native.MessageFlags.MSG_WAITALL | Native.MessageFlags.MSG_CMSG_CLOEXEC);
+                }
+                while (receivedSize == -1 && Marshal.GetLastWin32Error() == Native.EINTR);
+            }
+
+            if (receivedSize == -1)
+            {
+                throw new IOException(
+                    "Failed to receive a message",
+                    innerException: new Win32Exception(Marshal.GetLastWin32Error()));
+            }
+
+            // Take the ownership of the received file descriptors first, so they are not leaked if the message is not valid.
+            //
+            int fileDescriptorCount = 0;
+            ulong controlMessageOffset = 0;
+
+            while (controlMessageOffset + (ulong)sizeof(Native.ControlMessageHeader) <= message.ControlLength)
+            {
+                var controlMessage = (Native.ControlMessageHeader*)(controlBuffer + controlMessageOffset);
+
+                if (controlMessage->Length < (ulong)sizeof(Native.ControlMessageHeader))
+                {
+                    break;
+                }
+
+                if (controlMessage->Level == Native.SOL_SOCKET && controlMessage->Type == Native.SCM_RIGHTS)
+                {
+                    int count = (int)((controlMessage->Length - (ulong)sizeof(Native.ControlMessageHeader)) / sizeof(int));
+                    int* receivedFileDescriptors = (int*)(controlMessage + 1);
+
+                    for (int index = 0; index < count; index++)
+                    {
+                        if (fileDescriptorCount < fileDescriptors.Length)
+                        {
+                            fileDescriptors[fileDescriptorCount++] = receivedFileDescriptors[index];
+                        }
+                        else
+                        {
+                            _ = Native.Close((IntPtr)receivedFileDescriptors[index]);
+                        }
+                    }
+                }
+
+                controlMessageOffset += (ulong)AlignControlMessage((int)controlMessage->Length);
+            }
+
+            if (receivedSize != buffer.Length || message.Flags.HasFlag(Native.MessageFlags.MSG_CTRUNC))
+            {
+                for (int index = 0; index < fileDescriptorCount; index++)
+                {
+                    _ = Native.Close((IntPtr)fileDescriptors[index]);
+                }
+
+                throw new IOException($"Failed to receive a message, received {receivedSize} of {buffer.Length} bytes.");
+            }
+
+            return fileDescriptorCount;
+        }
+
+        /// <summary>
+        /// Aligns the ancillary data length to the size of the header (CMSG_ALIGN).
+        /// </summary>
+        /// <param name="length"></param>
+        /// <returns></returns>
+        private static int AlignControlMessage(int length) => (length + sizeof(ulong) - 1) & ~(sizeof(ulong) - 1);
+
+        /// <inheritdoc/>
+        public void Dispose()
+        {
+            if (isDisposed)
+            {
+                return;
+            }
+
+            socket.Dispose();
+
+            if (socketFileName != null)
+            {
+                _ = Native.FileUnlink(socketFileName);
+            }
+
+            isDisposed = true;
+        }
+
+        private readonly Socket socket;
+
+        private readonly string socketFileName;
+
+        private bool isDisposed;
+    }
+}
@@ -6,6 +6,7 @@
 // </copyright>
 // -----------------------------------------------------------------------
 
+using System.Diagnostics;
 using System.Runtime.CompilerServices;
 
 namespace Mlos.Core
@@ -27,5 +28,23 @@ namespace Mlos.Core
             high = unchecked((uint)(number >> 32));
             low = unchecked((uint)(number & 0x00000000FFFFFFFFL));
         }
+
+        /// <summary>
+        /// Gets the monotonic timestamp in nanoseconds.
+        /// </summary>
+        /// <returns></returns>
+        /// <remarks>
+        /// Uses the same clock as Mlos.Core MlosPlatform::TimestampInNanoseconds (CLOCK_MONOTONIC on Linux, QueryPerformanceCounter on Windows).
+        /// </remarks>
+        [MethodImpl(MethodImplOptions.AggressiveInlining)]
+        public static ulong TimestampInNanoseconds()
+        {
+            const long NanosecondsPerSecond = 1000000000;
+
+            long timestamp = Stopwatch.GetTimestamp();
+            long frequency = Stopwatch.Frequency;
+
+            return (ulong)(((timestamp / frequency) * NanosecondsPerSecond) + ((timestamp % frequency) * NanosecondsPerSecond / frequency));
+        }
     }
 }
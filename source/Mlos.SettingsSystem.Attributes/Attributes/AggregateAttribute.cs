@@ -0,0 +1,107 @@
+// -----------------------------------------------------------------------
+// <copyright file="AggregateAttribute.cs" company="Microsoft Corporation">
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License. See LICENSE in the project root
+// for license information.
+// </copyright>
+// -----------------------------------------------------------------------
+
+using System;
+
+namespace Mlos.SettingsSystem.Attributes
+{
+    /// <summary>
+    /// Describes how a summary message field is calculated from the aggregated messages.
+    /// </summary>
+    public enum AggregationKind
+    {
+        /// <summary>
+        /// Number of the aggregated messages.
+        /// </summary>
+        Count,
+
+        /// <summary>
+        /// Sum of the source field values.
+        /// </summary>
+        Sum,
+
+        /// <summary>
+        /// Minimum of the source field values.
+        /// </summary>
+        Min,
+
+        /// <summary>
+        /// Maximum of the source field values.
+        /// </summary>
+        Max,
+
+        /// <summary>
+        /// Histogram of the source field values, the field is a fixed size array of counters.
+        /// </summary>
+        /// <remarks>
+        /// Bucket 0 counts zero values, bucket i counts values in the range [2^(i-1), 2^i).
+        /// The last bucket also counts all the larger values.
+        /// </remarks>
+        Histogram,
+
+        /// <summary>
+        /// Id of the component config the messages were aggregated with.
+        /// </summary>
+        ConfigId,
+    }
+
+    /// <summary>
+    /// An attribute class to mark a C# data structure as a summary of the telemetry messages of the given type.
+    /// </summary>
+    /// <remarks>
+    /// CodeGen generates the functions to initialize, accumulate and merge the summaries.
+    /// </remarks>
+    [AttributeUsage(AttributeTargets.Struct | AttributeTargets.Class, AllowMultiple = false)]
+    public class TelemetrySummaryAttribute : BaseCodegenAttribute
+    {
+        /// <summary>
+        /// Gets the type of the aggregated messages.
+        /// </summary>
+        public Type MessageType { get; }
+
+        /// <summary>
+        /// Constructor.
+        /// </summary>
+        /// <param name="messageType">Type of the aggregated messages.</param>
+        public TelemetrySummaryAttribute(Type messageType)
+        {
+            MessageType = messageType;
+        }
+    }
+
+    /// <summary>
+    /// An attribute class to mark how a summary message field is aggregated.
+    /// </summary>
+    [AttributeUsage(AttributeTargets.Field, AllowMultiple = false)]
+    public class AggregateAttribute : BaseCodegenFieldAttribute
+    {
+        /// <summary>
+        /// Gets the aggregation kind.
+        /// </summary>
+        public AggregationKind Kind { get; }
+
+        /// <summary>
+        /// Gets the name of the aggregated message field.
+        /// </summary>
+        /// <remarks>
+        /// Not used by the Count and ConfigId aggregations.
+        /// </remarks>
+        public string SourceField { get; }
+
+        /// <summary>
+        /// Constructor.
+        /// </summary>
+        /// <param name="kind">Aggregation kind.</param>
+        /// <param name="sourceField">Name of the aggregated message field.</param>
+        public AggregateAttribute(AggregationKind kind, string sourceField = null)
+        {
+            Kind = kind;
+            SourceField = sourceField;
+        }
+    }
+}
@@ -39,6 +39,17 @@ namespace Mlos.SettingsSystem.Attributes
                 && type.GetCustomAttributes(typeof(CodegenConfigAttribute), true).Any();
         }
 
+        /// <summary>
+        /// Check if the given type is tagged as a telemetry summary type.
+        /// </summary>
+        /// <param name="type"></param>
+        /// <returns></returns>
+        public static bool IsTelemetrySummaryType(this Type type)
+        {
+            return type != null
+                && type.GetCustomAttributes(typeof(TelemetrySummaryAttribute), true).Any();
+        }
+
         /// <summary>
         /// Get all public (non static) instance files.
         /// </summary>
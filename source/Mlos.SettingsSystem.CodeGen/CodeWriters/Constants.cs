@@ -13,6 +13,11 @@ namespace Mlos.SettingsSystem.CodeGen.CodeWriters
     /// </summary>
     internal static class Constants
     {
+        /// <summary>
+        /// The namespace ObjectAggregation code is generated to.
+        /// </summary>
+        public const string ObjectAggregationNamespace = "ObjectAggregation";
+
         /// <summary>
         /// The namespace ObjectDeserializationCallback code is generated to.
         /// </summary>
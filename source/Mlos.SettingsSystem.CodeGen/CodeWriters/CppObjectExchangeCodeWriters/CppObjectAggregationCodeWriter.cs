@@ -0,0 +1,179 @@
+// -----------------------------------------------------------------------
+// <copyright file="CppObjectAggregationCodeWriter.cs" company="Microsoft Corporation">
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License. See LICENSE in the project root
+// for license information.
+// </copyright>
+// -----------------------------------------------------------------------
+
+using System;
+using System.Collections.Generic;
+using System.Reflection;
+
+using Mlos.SettingsSystem.Attributes;
+
+namespace Mlos.SettingsSystem.CodeGen.CodeWriters.CppObjectExchangeCodeWriters
+{
+    /// <summary>
+    /// Generates the functions which aggregate the telemetry messages into the summary message.
+    /// </summary>
+    /// <remarks>
+    /// For each type marked with TelemetrySummary attribute, generates specializations of
+    /// ObjectAggregation::Initialize, ObjectAggregation::Accumulate and ObjectAggregation::Merge.
+    /// </remarks>
+    internal class CppObjectAggregationCodeWriter : CppCodeWriter
+    {
+        /// <inheritdoc />
+        public override bool Accept(Type sourceType) => sourceType.IsTelemetrySummaryType();
+
+        /// <summary>
+        /// Write beginning of the file.
+        /// </summary>
+        public override void WriteBeginFile()
+        {
+            WriteLine($"namespace {Constants.ObjectAggregationNamespace}");
+            WriteLine("{");
+
+            IndentationLevel++;
+        }
+
+        /// <inheritdoc />
+        public override void WriteEndFile()
+        {
+            IndentationLevel--;
+            WriteLine("};");
+            WriteLine();
+        }
+
+        /// <inheritdoc />
+        public override void WriteOpenTypeNamespace(string @namespace)
+        {
+            // Nothing.
+            //
+        }
+
+        /// <inheritdoc />
+        public override void WriteCloseTypeNamespace(string @namespace)
+        {
+            // Nothing.
+            //
+        }
+
+        /// <inheritdoc />
+        public override void WriteComments(CodeComment codeComment)
+        {
+            // Nothing.
+            //
+        }
+
+        /// <summary>
+        /// Clear the function bodies, they are written at the end of the type.
+        /// </summary>
+        /// <param name="sourceType"></param>
+        public override void BeginVisitType(Type sourceType)
+        {
+            initializeLines.Clear();
+            accumulateLines.Clear();
+            mergeLines.Clear();
+        }
+
+        /// <summary>
+        /// Write the aggregation functions.
+        /// </summary>
+        /// <param name="sourceType"></param>
+        public override void EndVisitType(Type sourceType)
+        {
+            string cppSummaryTypeFullName = CppTypeMapper.GenerateCppFullTypeName(sourceType);
+            string cppMessageTypeFullName = CppTypeMapper.GenerateCppFullTypeName(sourceType.GetCustomAttribute<TelemetrySummaryAttribute>().MessageType);
+
+            WriteBlock($@"
+                template<>
+                inline void Initialize<{cppSummaryTypeFullName}>({cppSummaryTypeFullName}& summary, uint32_t configId)
+                {{
+                    summary = {cppSummaryTypeFullName} {{ }};
+                    (void)configId;");
+            WriteFunctionBody(initializeLines);
+
+            WriteBlock($@"
+                template<>
+                inline void Accumulate<{cppSummaryTypeFullName}, {cppMessageTypeFullName}>({cppSummaryTypeFullName}& summary, const {cppMessageTypeFullName}& message)
+                {{
+                    (void)message;");
+            WriteFunctionBody(accumulateLines);
+
+            WriteBlock($@"
+                template<>
+                inline void Merge<{cppSummaryTypeFullName}>({cppSummaryTypeFullName}& summary, const {cppSummaryTypeFullName}& other)
+                {{
+                    (void)other;");
+            WriteFunctionBody(mergeLines);
+        }
+
+        /// <summary>
+        /// For each aggregated field, add the statements initializing, accumulating and merging the field.
+        /// </summary>
+        /// <param name="cppField"></param>
+        public override void VisitField(CppField cppField)
+        {
+            AggregateAttribute aggregateAttribute = cppField.FieldInfo.GetCustomAttribute<AggregateAttribute>();
+
+            if (aggregateAttribute == null)
+            {
+                // The field is not aggregated, it remains zero.
+                //
+                return;
+            }
+
+            string fieldName = cppField.FieldInfo.Name;
+            string sourceFieldName = aggregateAttribute.SourceField;
+
+            switch (aggregateAttribute.Kind)
+            {
+                case AggregationKind.Count:
+                    accumulateLines.Add($"summary.{fieldName}++;");
+                    mergeLines.Add($"summary.{fieldName} += other.{fieldName};");
+                    break;
+                case AggregationKind.Sum:
+                    accumulateLines.Add($"{Constants.ObjectAggregationNamespace}::AddToSum(summary.{fieldName}, message.{sourceFieldName});");
+                    mergeLines.Add($"{Constants.ObjectAggregationNamespace}::AddToSum(summary.{fieldName}, other.{fieldName});");
+                    break;
+                case AggregationKind.Min:
+                    initializeLines.Add($"{Constants.ObjectAggregationNamespace}::InitializeMin(summary.{fieldName});");
+                    accumulateLines.Add($"{Constants.ObjectAggregationNamespace}::AddToMin(summary.{fieldName}, message.{sourceFieldName});");
+                    mergeLines.Add($"{Constants.ObjectAggregationNamespace}::AddToMin(summary.{fieldName}, other.{fieldName});");
+                    break;
+                case AggregationKind.Max:
+                    initializeLines.Add($"{Constants.ObjectAggregationNamespace}::InitializeMax(summary.{fieldName});");
+                    accumulateLines.Add($"{Constants.ObjectAggregationNamespace}::AddToMax(summary.{fieldName}, message.{sourceFieldName});");
+                    mergeLines.Add($"{Constants.ObjectAggregationNamespace}::AddToMax(summary.{fieldName}, other.{fieldName});");
+                    break;
+                case AggregationKind.Histogram:
+                    accumulateLines.Add($"{Constants.ObjectAggregationNamespace}::AddToHistogram(summary.{fieldName}, message.{sourceFieldName});");
+                    mergeLines.Add($"{Constants.ObjectAggregationNamespace}::MergeHistogram(summary.{fieldName}, other.{fieldName});");
+                    break;
+                case AggregationKind.ConfigId:
+                    initializeLines.Add($"summary.{fieldName} = configId;");
+                    break;
+            }
+        }
+
+        /// <summary>
+        /// Write the statements and close the function.
+        /// </summary>
+        /// <param name="lines"></param>
+        private void WriteFunctionBody(List<string> lines)
+        {
+            IndentationLevel++;
+            lines.ForEach(r => WriteLine(r));
+            IndentationLevel--;
+            WriteLine("}");
+            WriteLine();
+        }
+
+        private readonly List<string> initializeLines = new List<string>();
+
+        private readonly List<string> accumulateLines = new List<string>();
+
+        private readonly List<string> mergeLines = new List<string>();
+    }
+}
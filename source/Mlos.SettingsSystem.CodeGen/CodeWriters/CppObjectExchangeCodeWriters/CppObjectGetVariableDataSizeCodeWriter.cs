@@ -15,6 +15,7 @@ namespace Mlos.SettingsSystem.CodeGen.CodeWriters.CppObjectExchangeCodeWriters
     /// </summary>
     /// <remarks>
     /// Length is sizeof the object, increased by size of the data stored in the variable length fields.
+    /// Also marks the type with HasVariableData, the types without the specialization are serialized with a single copy.
     /// </remarks>
     internal class CppObjectGetVariableDataSizeCodeWriter : CppCodeWriter
     {
@@ -72,6 +73,12 @@ namespace Mlos.SettingsSystem.CodeGen.CodeWriters.CppObjectExchangeCodeWriters
             string cppElementTypeFullName = CppTypeMapper.GenerateCppFullTypeName(sourceType);
 
             WriteBlock($@"
+                template<>
+                constexpr bool HasVariableData<{cppElementTypeFullName}>()
+                {{
+                    return true;
+                }}
+
                 template<>
                 inline size_t GetVariableDataSize<{cppElementTypeFullName}>(const {cppElementTypeFullName}& object)
                 {{
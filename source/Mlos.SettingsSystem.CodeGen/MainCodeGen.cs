@@ -109,6 +109,7 @@ namespace Mlos.SettingsSystem.CodeGen
                     new CppObjectDeserializeHandlerCodeWriter(sourceTypesAssembly),             // object deserialization handlers
                     new CppObjectDeserializeEntryCountCodeWriter(sourceTypesAssembly),          // object deserialization element count
                     new CppProxyVerifyVariableDataCodeWriter(),                                 // cpp proxy verify correctness of the variable data
+                    new CppObjectAggregationCodeWriter(),                                       // telemetry summary aggregation functions
                     new CSharpObjectCodeWriter(),                                               // csharp type extends definition with default constructor
                     new CSharpCodegenKeyCodeWriter(),                                           // csharp codegen key type definition
                     new CSharpCodegenKeyMethodsCodeWriter(sourceTypesAssembly),                 // csharp codegen key ICodegenKey interface implementation
@@ -65,6 +65,14 @@ namespace Mlos.SettingsSystem.CodeGen
             FileLinePosition = SourceCompilation.GetFileLinePosition(fieldInfo),
         });
 
+        private void AddInvalidAggregateAttributeError(Type sourceType, FieldInfo fieldInfo) => this.CodeGenErrors.Add(new CodegenError
+        {
+            ErrorNumber = "Invalid aggregate attribute",
+            ErrorText = $"Aggregated field {fieldInfo.Name} of class '{sourceType}' requires TelemetrySummary attribute and a scalar source field of the aggregated message, histogram fields must be fixed size arrays.",
+            IsWarning = false,
+            FileLinePosition = SourceCompilation.GetFileLinePosition(fieldInfo),
+        });
+
         /// <summary>
         /// Generate the necessary code for a given type.
         /// </summary>
@@ -142,6 +150,12 @@ namespace Mlos.SettingsSystem.CodeGen
                     continue;
                 }
 
+                if (!IsValidAggregateAttribute(sourceType, fieldInfo))
+                {
+                    AddInvalidAggregateAttributeError(sourceType, fieldInfo);
+                    continue;
+                }
+
                 // Align the field offset and update type aligment.
                 //
                 uint fieldAlignment = customFieldAlignment == 0
@@ -198,6 +212,17 @@ namespace Mlos.SettingsSystem.CodeGen
                 return;
             }
 
+            // Check the final structure aligment.
+            // The structure size is a multiple of its alignment (as the size of Cpp alignas structure),
+            // so the elements of the arrays and the following fields are aligned.
+            //
+            AlignAttribute alignmentAttribute = sourceType.GetCustomAttribute<AlignAttribute>();
+
+            if (alignmentAttribute != null)
+            {
+                alignment = alignmentAttribute.Size;
+            }
+
             uint paddingSize = 0;
 
             // Align structure size unless it has explicitly defined size.
@@ -214,15 +239,6 @@ namespace Mlos.SettingsSystem.CodeGen
                 cppStructOffset += paddingSize;
             }
 
-            // Check the final structure aligment.
-            //
-            AlignAttribute alignmentAttribute = sourceType.GetCustomAttribute<AlignAttribute>();
-
-            if (alignmentAttribute != null)
-            {
-                alignment = alignmentAttribute.Size;
-            }
-
             // Define a new Cpp type.
             //
             CppTypeMapper.DefineType(
@@ -352,6 +368,35 @@ namespace Mlos.SettingsSystem.CodeGen
 
             return isValid;
         }
+
+        private bool IsValidAggregateAttribute(Type sourceType, FieldInfo fieldInfo)
+        {
+            AggregateAttribute aggregateAttribute = fieldInfo.GetCustomAttribute<AggregateAttribute>();
+            if (aggregateAttribute == null)
+            {
+                return true;
+            }
+
+            Type messageType = sourceType.GetCustomAttribute<TelemetrySummaryAttribute>()?.MessageType;
+            if (!messageType.IsCodegenType())
+            {
+                return false;
+            }
+
+            if (aggregateAttribute.Kind == AggregationKind.Count || aggregateAttribute.Kind == AggregationKind.ConfigId)
+            {
+                return !fieldInfo.IsFixedSizedArray();
+            }
+
+            // The aggregated source field must be a scalar.
+            //
+            bool isValidSourceField = messageType.GetPublicInstanceFields().Any(
+                r => r.Name == aggregateAttribute.SourceField && !r.IsFixedSizedArray() && !r.IsString());
+
+            bool isHistogram = aggregateAttribute.Kind == AggregationKind.Histogram;
+
+            return isValidSourceField && (fieldInfo.IsFixedSizedArray() == isHistogram);
+        }
     }
 
     /// <summary>
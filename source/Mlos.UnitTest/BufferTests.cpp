@@ -148,4 +148,336 @@ TEST(BufferChannel, CreateMemory)
     //
     mlosContext.TerminateControlChannel();
 }
+
+// Verify the channel sizes are configurable.
+//
+TEST(BufferChannel, VerifyChannelSizeOptions)
+{
+    // Channel sizes must be a power of two.
+    //
+    {
+        MlosContextOptions options;
+        options.TelemetryChannelSize = 100000;
+
+        InternalMlosContextInitializer mlosContextInitializer;
+        HRESULT hr = mlosContextInitializer.Initialize(options);
+        EXPECT_EQ(hr, E_INVALIDARG);
+    }
+
+    // Each channel has its own size.
+    //
+    {
+        MlosContextOptions options;
+        options.ControlChannelSize = 4096;
+        options.FeedbackChannelSize = 8192;
+        options.TelemetryChannelSize = 1024 * 1024;
+
+        InternalMlosContextInitializer mlosContextInitializer;
+        HRESULT hr = mlosContextInitializer.Initialize(options);
+        EXPECT_EQ(hr, S_OK);
+
+        InternalMlosContext mlosContext(std::move(mlosContextInitializer));
+
+        EXPECT_EQ(mlosContext.ControlChannel().Size, 4096);
+        EXPECT_EQ(mlosContext.FeedbackChannel().Size, 8192);
+        EXPECT_EQ(mlosContext.TelemetryChannel().Size, 1024 * 1024);
+    }
+}
+
+// Verify the shared memory backed by huge pages.
+//
+TEST(BufferChannel, VerifyHugePagesOptions)
+{
+    // Create the shared memory with huge pages.
+    // Without hugetlbfs or transparent huge pages for the shared memory, the view uses the regular pages.
+    //
+    SharedMemoryMapView hugePagesMapView;
+    hugePagesMapView.UseHugePages = true;
+
+    HRESULT hr = hugePagesMapView.Create("Test_Mlos.HugePagesMemory", 4096);
+    EXPECT_EQ(hr, S_OK);
+    hugePagesMapView.CleanupOnClose = true;
+
+#ifndef _WIN64
+    // The size is rounded up to the huge page size.
+    //
+    EXPECT_GE(hugePagesMapView.MemSize, 2 * 1024 * 1024);
+    EXPECT_EQ(hugePagesMapView.MemSize % (2 * 1024 * 1024), 0);
+#endif
+
+    // Opening the existing shared memory maps the same memory, regardless of the huge pages setting.
+    //
+    SharedMemoryMapView mapView;
+    hr = mapView.CreateOrOpen("Test_Mlos.HugePagesMemory", 4096);
+    EXPECT_EQ(hr, S_FALSE);
+    EXPECT_EQ(mapView.MemSize, hugePagesMapView.MemSize);
+
+    hugePagesMapView.Buffer.Pointer[hugePagesMapView.MemSize - 1] = 42;
+    EXPECT_EQ(mapView.Buffer.Pointer[mapView.MemSize - 1], 42);
+
+#ifndef _WIN64
+    // The channel uses the whole rounded up buffer.
+    //
+    MlosContextOptions options;
+    options.ControlChannelSize = 4096;
+    options.UseHugePages = true;
+    options.InstanceName = "HugePages";
+
+    InternalMlosContextInitializer mlosContextInitializer;
+    hr = mlosContextInitializer.Initialize(options);
+    EXPECT_EQ(hr, S_OK);
+
+    InternalMlosContext mlosContext(std::move(mlosContextInitializer));
+
+    EXPECT_EQ(mlosContext.ControlChannel().Size, 2 * 1024 * 1024);
+#endif
+}
+
+// Verify the shared memory is prefaulted and locked during the initialization.
+//
+TEST(BufferChannel, VerifyPrefaultOptions)
+{
+    // The context reports the time spent prefaulting the shared memory.
+    //
+    {
+        MlosContextOptions options;
+        options.PrefaultSharedMemory = true;
+        options.InstanceName = "Prefault";
+
+        InternalMlosContextInitializer mlosContextInitializer;
+        HRESULT hr = mlosContextInitializer.Initialize(options);
+        EXPECT_EQ(hr, S_OK);
+
+        InternalMlosContext mlosContext(std::move(mlosContextInitializer));
+
+        EXPECT_NE(mlosContext.SharedMemoryPrefaultDurationInNanoseconds(), 0);
+    }
+
+    // Without the option, the shared memory is not prefaulted.
+    //
+    {
+        InternalMlosContextInitializer mlosContextInitializer;
+        HRESULT hr = mlosContextInitializer.Initialize();
+        EXPECT_EQ(hr, S_OK);
+
+        InternalMlosContext mlosContext(std::move(mlosContextInitializer));
+
+        EXPECT_EQ(mlosContext.SharedMemoryPrefaultDurationInNanoseconds(), 0);
+    }
+
+    // Prefault and lock a small view, it fits into the default locked memory limit.
+    // Prefaulting does not change the content of the shared memory.
+    //
+    SharedMemoryMapView sharedMemoryMapView;
+    HRESULT hr = sharedMemoryMapView.Create("Test_Mlos.PrefaultMemory", 8192);
+    EXPECT_EQ(hr, S_OK);
+    sharedMemoryMapView.CleanupOnClose = true;
+
+    sharedMemoryMapView.Buffer.Pointer[0] = 42;
+
+    hr = sharedMemoryMapView.Prefault(true /* lockMemory */);
+    EXPECT_EQ(hr, S_OK);
+    EXPECT_EQ(sharedMemoryMapView.Buffer.Pointer[0], 42);
+}
+
+// Verify the MlosContext instances with different names do not share the channels.
+//
+TEST(BufferChannel, VerifyInstanceNameOptions)
+{
+    // Instance name must not contain the path separators.
+    //
+    {
+        MlosContextOptions options;
+        options.InstanceName = "Invalid/Name";
+
+        InternalMlosContextInitializer mlosContextInitializer;
+        HRESULT hr = mlosContextInitializer.Initialize(options);
+        EXPECT_EQ(hr, E_INVALIDARG);
+    }
+
+    // The instance name is appended to the shared object names.
+    //
+    {
+        char name[MaxSharedObjectNameLength];
+        HRESULT hr = FormatSharedObjectName("Host_Mlos.GlobalMemory", "SmartCache.1234", name);
+        EXPECT_EQ(hr, S_OK);
+        EXPECT_STREQ(name, "Host_Mlos.GlobalMemory.SmartCache.1234");
+
+        hr = FormatSharedObjectName("Host_Mlos.GlobalMemory", nullptr, name);
+        EXPECT_EQ(hr, S_OK);
+        EXPECT_STREQ(name, "Host_Mlos.GlobalMemory");
+    }
+
+    // Create two instances, a message sent to the first one is not visible in the second one.
+    //
+    MlosContextOptions firstOptions;
+    firstOptions.InstanceName = "FirstInstance";
+
+    InternalMlosContextInitializer firstContextInitializer;
+    HRESULT hr = firstContextInitializer.Initialize(firstOptions);
+    EXPECT_EQ(hr, S_OK);
+
+    InternalMlosContext firstContext(std::move(firstContextInitializer));
+
+    MlosContextOptions secondOptions;
+    secondOptions.InstanceName = "SecondInstance";
+
+    InternalMlosContextInitializer secondContextInitializer;
+    hr = secondContextInitializer.Initialize(secondOptions);
+    EXPECT_EQ(hr, S_OK);
+
+    InternalMlosContext secondContext(std::move(secondContextInitializer));
+
+    Mlos::UnitTest::Point point = { 3, 4 };
+    firstContext.SendTelemetryMessage(point);
+
+    EXPECT_NE(firstContext.TelemetryChannel().Sync.WritePosition.load(), 0);
+    EXPECT_EQ(secondContext.TelemetryChannel().Sync.WritePosition.load(), 0);
+}
+
+// Verify the types are verified at the registration when the telemetry channel has the compact frame headers.
+// The settings assemblies require the dispatch table hash, the Mlos.Core dispatch table hash must match the global memory region.
+//
+TEST(BufferChannel, VerifyCompactFrameHeadersRegistration)
+{
+    MlosContextOptions options;
+    options.InstanceName = "CompactFrameHeaders";
+    options.TelemetryChannelCompactFrameHeaders = true;
+
+    InterProcessMlosContextInitializer mlosContextInitializer;
+    HRESULT hr = mlosContextInitializer.Initialize(options);
+    EXPECT_EQ(hr, S_OK);
+
+    InterProcessMlosContext mlosContext(std::move(mlosContextInitializer));
+
+    hr = mlosContext.RegisterSettingsAssembly(
+        "Mlos.UnitTest.SettingsRegistry.dll",
+        Mlos::UnitTest::ObjectDeserializationHandler::DispatchTableBaseIndex());
+    EXPECT_EQ(hr, E_INVALIDARG);
+
+    hr = mlosContext.RegisterSettingsAssembly(
+        "Mlos.UnitTest.SettingsRegistry.dll",
+        Mlos::UnitTest::ObjectDeserializationHandler::DispatchTableBaseIndex(),
+        DispatchTableHash(Mlos::UnitTest::ObjectDeserializationHandler::DispatchTable));
+    EXPECT_EQ(hr, S_OK);
+
+    // The process which created the global memory region stored its Mlos.Core dispatch table hash.
+    //
+    SharedMemoryRegionView<Internal::GlobalMemoryRegion> globalMemoryRegionView;
+    hr = globalMemoryRegionView.Open("Host_Mlos.GlobalMemory.CompactFrameHeaders");
+    EXPECT_EQ(hr, S_OK);
+
+    Internal::GlobalMemoryRegion& globalMemoryRegion = globalMemoryRegionView.MemoryRegion();
+    const uint64_t mlosCoreDispatchTableHash = globalMemoryRegion.MlosCoreDispatchTableHash;
+    EXPECT_EQ(mlosCoreDispatchTableHash, DispatchTableHash(Mlos::Core::ObjectDeserializationHandler::DispatchTable));
+
+    // A process with different Mlos.Core types fails to open the global memory region.
+    //
+    globalMemoryRegion.MlosCoreDispatchTableHash = mlosCoreDispatchTableHash ^ 1;
+    {
+        InterProcessMlosContextInitializer mismatchedContextInitializer;
+        hr = mismatchedContextInitializer.Initialize(options);
+        EXPECT_EQ(hr, E_INVALIDARG);
+    }
+
+    globalMemoryRegion.MlosCoreDispatchTableHash = mlosCoreDispatchTableHash;
+    {
+        InterProcessMlosContextInitializer secondContextInitializer;
+        hr = secondContextInitializer.Initialize(options);
+        EXPECT_EQ(hr, S_OK);
+
+        InterProcessMlosContext secondContext(std::move(secondContextInitializer));
+    }
+}
+
+#ifndef _WIN64
+// Verify the anonymous shared memory passed to a stand-in agent over the Unix domain socket.
+//
+TEST(BufferChannel, VerifyAnonymousSharedMemory)
+{
+    const char* const socketPath = "@Mlos.UnitTest.AnonymousSharedMemory";
+
+    // Without an agent listening on the socket, the initialization fails.
+    //
+    {
+        InterProcessMlosContextInitializer mlosContextInitializer;
+        HRESULT hr = mlosContextInitializer.InitializeAnonymous(socketPath);
+        EXPECT_TRUE(FAILED(hr));
+    }
+
+    // The stand-in agent accepts the shared memory and events from the target.
+    //
+    UnixDomainSocket listeningSocket;
+    HRESULT hr = listeningSocket.Listen(socketPath);
+    EXPECT_EQ(hr, S_OK);
+
+    InterProcessMlosContextInitializer agentContextInitializer;
+
+    std::future<HRESULT> agentResult = std::async(
+        std::launch::async,
+        [&agentContextInitializer, &listeningSocket]
+        {
+            return agentContextInitializer.AcceptAnonymous(listeningSocket);
+        });
+
+    MlosContextOptions options;
+    options.InstanceName = "Anonymous";
+    options.TelemetryChannelShardCount = 2;
+
+    InterProcessMlosContextInitializer targetContextInitializer;
+    hr = targetContextInitializer.InitializeAnonymous(socketPath, options);
+    EXPECT_EQ(hr, S_OK);
+    EXPECT_EQ(agentResult.get(), S_OK);
+
+    // There is no named shared memory to clean up.
+    //
+    SharedMemoryMapView sharedMemoryMapView;
+    hr = sharedMemoryMapView.Open("Host_Mlos.GlobalMemory.Anonymous");
+    EXPECT_TRUE(FAILED(hr));
+
+    InterProcessMlosContext agentContext(std::move(agentContextInitializer));
+
+    // The messages sent by the target remain readable after the target has closed the shared memory.
+    //
+    {
+        InterProcessMlosContext targetContext(std::move(targetContextInitializer));
+        EXPECT_EQ(targetContext.ControlChannel().Size, agentContext.ControlChannel().Size);
+
+        Mlos::UnitTest::Point point = { 3, 4 };
+        targetContext.SendControlMessage(point);
+    }
+
+    std::atomic<uint32_t> receivedCount(0);
+    ObjectDeserializationCallback::Mlos::UnitTest::Point_Callback = [&receivedCount](Proxy::Mlos::UnitTest::Point&& recvPoint)
+        {
+            EXPECT_EQ(recvPoint.X(), 3);
+            EXPECT_EQ(recvPoint.Y(), 4);
+            receivedCount++;
+        };
+
+    auto globalDispatchTable = GlobalDispatchTable();
+
+    ISharedChannel& controlChannel = agentContext.ControlChannel();
+
+    std::future<bool> resultFromReader = std::async(
+        std::launch::async,
+        [&controlChannel, &globalDispatchTable]
+        {
+            controlChannel.ProcessMessages(globalDispatchTable.data(), globalDispatchTable.size());
+
+            return true;
+        });
+
+    while (receivedCount.load() == 0)
+    {
+        std::this_thread::yield();
+    }
+
+    agentContext.TerminateControlChannel();
+
+    resultFromReader.wait();
+    EXPECT_EQ(resultFromReader.get(), true);
+    EXPECT_EQ(receivedCount.load(), 1);
+}
+#endif
 }
@@ -15,7 +15,10 @@
 
 #include "stdafx.h"
 #include <chrono>
+#include <map>
+#include <mutex>
 #include <thread>
+#include <vector>
 
 using namespace Mlos::Core;
 
@@ -114,7 +117,7 @@ TEST(MessageVerification, DetectInvalidDataMessages)
     offset = (offset - frameLength + controlChannel.Size) % controlChannel.Size;
 
     byte* ptr = reinterpret_cast<TestSharedChannel&>(controlChannel).Buffer.Pointer;
-    ptr += sizeof(FrameHeader) + offsetof(struct ::Mlos::UnitTest::StringViewElement, String);
+    ptr += offset + sizeof(FrameHeader) + offsetof(struct ::Mlos::UnitTest::StringViewElement, String);
     *ptr += 1;
 
     auto globalDispatchTable = GlobalDispatchTable();
@@ -152,4 +155,605 @@ TEST(MessageVerification, DetectInvalidDataMessages)
         //
     }
 }
+
+// Verify telemetry messages are sent using a dedicated channel.
+//
+TEST(MessageVerification, VerifyTelemetryChannel)
+{
+    // Create InternalProcessMlosContext.
+    //
+    InternalMlosContextInitializer mlosContextInitializer;
+    HRESULT hr = mlosContextInitializer.Initialize();
+    EXPECT_EQ(hr, S_OK);
+
+    InternalMlosContext mlosContext(std::move(mlosContextInitializer));
+
+    ISharedChannel& controlChannel = mlosContext.ControlChannel();
+    ISharedChannel& telemetryChannel = mlosContext.TelemetryChannel();
+    EXPECT_NE(&controlChannel.Sync, &telemetryChannel.Sync);
+
+    uint32_t controlChannelWritePosition = controlChannel.Sync.WritePosition;
+    uint32_t telemetryChannelWritePosition = telemetryChannel.Sync.WritePosition;
+
+    Mlos::UnitTest::Point point = { 3, 4 };
+    mlosContext.SendTelemetryMessage(point);
+
+    // Only the telemetry channel contains the message.
+    //
+    EXPECT_EQ(controlChannel.Sync.WritePosition, controlChannelWritePosition);
+    EXPECT_GT(telemetryChannel.Sync.WritePosition, telemetryChannelWritePosition);
+
+    std::atomic<uint32_t> receivedCount(0);
+    ObjectDeserializationCallback::Mlos::UnitTest::Point_Callback = [&receivedCount](Proxy::Mlos::UnitTest::Point&& recvPoint)
+        {
+            EXPECT_EQ(recvPoint.X(), 3);
+            EXPECT_EQ(recvPoint.Y(), 4);
+            receivedCount++;
+        };
+
+    auto globalDispatchTable = GlobalDispatchTable();
+
+    // Read the message from the telemetry channel.
+    //
+    std::future<bool> resultFromReader = std::async(
+        std::launch::async,
+        [&telemetryChannel, &globalDispatchTable]
+        {
+            telemetryChannel.ProcessMessages(globalDispatchTable.data(), globalDispatchTable.size());
+
+            return true;
+        });
+
+    while (receivedCount.load() == 0)
+    {
+        std::this_thread::yield();
+    }
+
+    // Terminate the telemetry channel, the control channel remains active.
+    //
+    mlosContext.TerminateTelemetryChannel();
+
+    // Wait for the reader shutdown.
+    //
+    resultFromReader.wait();
+    EXPECT_EQ(resultFromReader.get(), true);
+
+    EXPECT_EQ(receivedCount.load(), 1);
+    EXPECT_FALSE(mlosContext.IsTelemetryChannelActive());
+    EXPECT_TRUE(mlosContext.IsControlChannelActive());
+}
+
+// Verify telemetry messages are received from all telemetry channel shards.
+//
+TEST(MessageVerification, VerifyShardedTelemetryChannel)
+{
+    // Create InternalProcessMlosContext with four telemetry channel shards.
+    //
+    MlosContextOptions options;
+    options.TelemetryChannelSize = 1024 * 1024;
+    options.TelemetryChannelShardCount = 4;
+
+    InternalMlosContextInitializer mlosContextInitializer;
+    HRESULT hr = mlosContextInitializer.Initialize(options);
+    EXPECT_EQ(hr, S_OK);
+
+    InternalMlosContext mlosContext(std::move(mlosContextInitializer));
+
+    // Each shard uses an equal part of the telemetry channel memory.
+    //
+    EXPECT_EQ(mlosContext.TelemetryChannelShardCount(), 4);
+
+    for (uint32_t shardIndex = 0; shardIndex < mlosContext.TelemetryChannelShardCount(); shardIndex++)
+    {
+        EXPECT_EQ(mlosContext.TelemetryChannel(shardIndex).Size, 256 * 1024);
+    }
+
+    std::atomic<uint32_t> receivedCount(0);
+    ObjectDeserializationCallback::Mlos::UnitTest::Point_Callback = [&receivedCount](Proxy::Mlos::UnitTest::Point&& recvPoint)
+        {
+            EXPECT_EQ(recvPoint.X(), 3);
+            EXPECT_EQ(recvPoint.Y(), 4);
+            receivedCount++;
+        };
+
+    auto globalDispatchTable = GlobalDispatchTable();
+
+    // Start a reader for each shard.
+    //
+    std::vector<std::future<bool>> resultsFromReaders;
+
+    for (uint32_t shardIndex = 0; shardIndex < mlosContext.TelemetryChannelShardCount(); shardIndex++)
+    {
+        ISharedChannel& telemetryChannelShard = mlosContext.TelemetryChannel(shardIndex);
+
+        resultsFromReaders.push_back(std::async(
+            std::launch::async,
+            [&telemetryChannelShard, &globalDispatchTable]
+            {
+                telemetryChannelShard.ProcessMessages(globalDispatchTable.data(), globalDispatchTable.size());
+
+                return true;
+            }));
+    }
+
+    // Send the messages from multiple threads.
+    //
+    const uint32_t writerCount = 4;
+    const uint32_t messageCount = 1000;
+
+    std::vector<std::thread> writers;
+
+    for (uint32_t writerIndex = 0; writerIndex < writerCount; writerIndex++)
+    {
+        writers.emplace_back([&mlosContext]
+            {
+                Mlos::UnitTest::Point point = { 3, 4 };
+
+                for (uint32_t i = 0; i < messageCount; i++)
+                {
+                    mlosContext.SendTelemetryMessage(point);
+                }
+            });
+    }
+
+    for (std::thread& writer : writers)
+    {
+        writer.join();
+    }
+
+    while (receivedCount.load() != writerCount * messageCount)
+    {
+        std::this_thread::yield();
+    }
+
+    // Terminate all the shards.
+    //
+    mlosContext.TerminateTelemetryChannel();
+
+    for (std::future<bool>& resultFromReader : resultsFromReaders)
+    {
+        resultFromReader.wait();
+        EXPECT_EQ(resultFromReader.get(), true);
+    }
+
+    EXPECT_EQ(receivedCount.load(), writerCount * messageCount);
+    EXPECT_FALSE(mlosContext.IsTelemetryChannelActive());
+}
+
+// Verify the telemetry sampler selects the telemetry messages sent by the component config.
+//
+TEST(MessageVerification, VerifyTelemetrySampling)
+{
+    // Create InternalProcessMlosContext.
+    //
+    InternalMlosContextInitializer mlosContextInitializer;
+    HRESULT hr = mlosContextInitializer.Initialize();
+    EXPECT_EQ(hr, S_OK);
+
+    InternalMlosContext mlosContext(std::move(mlosContextInitializer));
+
+    ISharedChannel& telemetryChannel = mlosContext.TelemetryChannel();
+
+    std::atomic<uint64_t> receivedPointCount(0);
+    std::atomic<uint64_t> receivedPoint3dCount(0);
+    std::atomic<uint64_t> receivedReportCount(0);
+    std::atomic<uint64_t> reportedOfferedCount(0);
+    std::atomic<uint64_t> reportedSentCount(0);
+
+    ObjectDeserializationCallback::Mlos::UnitTest::Point_Callback = [&receivedPointCount](Proxy::Mlos::UnitTest::Point&&)
+        {
+            receivedPointCount++;
+        };
+
+    ObjectDeserializationCallback::Mlos::UnitTest::Point3D_Callback = [&receivedPoint3dCount](Proxy::Mlos::UnitTest::Point3D&&)
+        {
+            receivedPoint3dCount++;
+        };
+
+    ObjectDeserializationCallback::Mlos::Core::TelemetrySamplingReportMessage_Callback =
+        [&receivedReportCount, &reportedOfferedCount, &reportedSentCount](Proxy::Mlos::Core::TelemetrySamplingReportMessage&& recvReport)
+        {
+            reportedOfferedCount = recvReport.OfferedCount();
+            reportedSentCount = recvReport.SentCount();
+            receivedReportCount++;
+        };
+
+    auto globalDispatchTable = GlobalDispatchTable();
+
+    std::future<bool> resultFromReader = std::async(
+        std::launch::async,
+        [&telemetryChannel, &globalDispatchTable]
+        {
+            telemetryChannel.ProcessMessages(globalDispatchTable.data(), globalDispatchTable.size());
+
+            return true;
+        });
+
+    auto waitForMessages = [&receivedPointCount, &receivedReportCount](uint64_t pointCount, uint64_t reportCount)
+        {
+            while (receivedPointCount.load() < pointCount || receivedReportCount.load() < reportCount)
+            {
+                std::this_thread::yield();
+            }
+        };
+
+    // Register the component config and its telemetry sampler.
+    //
+    ComponentConfig<ChannelReaderStats> componentConfig(mlosContext);
+    componentConfig.SpinCount = 1;
+    hr = mlosContext.RegisterComponentConfig(componentConfig);
+    EXPECT_EQ(hr, S_OK);
+
+    TelemetrySampler telemetrySampler(mlosContext);
+    hr = mlosContext.RegisterTelemetrySampler(componentConfig, telemetrySampler);
+    EXPECT_EQ(hr, S_OK);
+
+    // Update the sampling config as the agent does, send one in ten messages.
+    // The sampler reports the counts of the previous config before it applies the update.
+    //
+    Proxy::Mlos::Core::TelemetrySamplingConfig samplingConfigProxy = telemetrySampler.SamplingConfig.Proxy();
+    samplingConfigProxy.Policy() = TelemetrySamplingPolicy::OneInN;
+    samplingConfigProxy.SampleInterval() = 10;
+    samplingConfigProxy.ReportInterval() = 100;
+    telemetrySampler.SamplingConfig.NotifySharedConfigUpdated();
+
+    Mlos::UnitTest::Point point = { 3, 4 };
+
+    for (uint32_t i = 0; i < 1000; i++)
+    {
+        componentConfig.SendTelemetryMessage(point);
+    }
+
+    waitForMessages(100, 11);
+
+    EXPECT_EQ(telemetrySampler.OfferedMessageCount(), 1000);
+    EXPECT_EQ(telemetrySampler.SentMessageCount(), 100);
+    EXPECT_EQ(reportedOfferedCount.load(), 1000);
+    EXPECT_EQ(reportedSentCount.load(), 100);
+
+    // Token bucket, one message per second with bursts of five messages.
+    //
+    samplingConfigProxy.Policy() = TelemetrySamplingPolicy::TokenBucket;
+    samplingConfigProxy.RatePerSecond() = 1;
+    samplingConfigProxy.BurstSize() = 5;
+    samplingConfigProxy.ReportInterval() = 0;
+    telemetrySampler.SamplingConfig.NotifySharedConfigUpdated();
+
+    for (uint32_t i = 0; i < 1000; i++)
+    {
+        componentConfig.SendTelemetryMessage(point);
+    }
+
+    waitForMessages(105, 12);
+
+    EXPECT_GE(telemetrySampler.SentMessageCount(), 105);
+    EXPECT_LE(telemetrySampler.SentMessageCount(), 106);
+
+    // Reservoir, the selected messages are sent at the end of the period or on flush.
+    //
+    samplingConfigProxy.Policy() = TelemetrySamplingPolicy::Reservoir;
+    samplingConfigProxy.ReservoirSize() = 8;
+    samplingConfigProxy.ReservoirPeriodInMilliseconds() = 60000;
+    telemetrySampler.SamplingConfig.NotifySharedConfigUpdated();
+
+    const uint64_t sentMessageCount = telemetrySampler.SentMessageCount();
+
+    for (uint32_t i = 0; i < 1000; i++)
+    {
+        componentConfig.SendTelemetryMessage(point);
+    }
+
+    EXPECT_EQ(telemetrySampler.SentMessageCount(), sentMessageCount);
+
+    telemetrySampler.Flush();
+    EXPECT_EQ(telemetrySampler.SentMessageCount(), sentMessageCount + 8);
+
+    waitForMessages(sentMessageCount + 8, 13);
+
+    EXPECT_EQ(telemetrySampler.OfferedMessageCount(), 3000);
+    EXPECT_DOUBLE_EQ(telemetrySampler.EffectiveSamplingRate(), (sentMessageCount + 8) / 3000.0);
+
+    // Each message type has its own reservoir, the messages of one type do not evict the messages of another type.
+    //
+    Mlos::UnitTest::Point3D point3d = { 5, 6, 7 };
+
+    for (uint32_t i = 0; i < 1000; i++)
+    {
+        componentConfig.SendTelemetryMessage(point);
+        componentConfig.SendTelemetryMessage(point3d);
+    }
+
+    telemetrySampler.Flush();
+    EXPECT_EQ(telemetrySampler.SentMessageCount(), sentMessageCount + 24);
+
+    waitForMessages(sentMessageCount + 16, 13);
+
+    while (receivedPoint3dCount.load() < 8)
+    {
+        std::this_thread::yield();
+    }
+
+    mlosContext.TerminateTelemetryChannel();
+
+    resultFromReader.wait();
+    EXPECT_EQ(resultFromReader.get(), true);
+
+    // All the sent messages have been received.
+    //
+    EXPECT_EQ(receivedPoint3dCount.load(), 8);
+    EXPECT_EQ(receivedPointCount.load() + receivedPoint3dCount.load(), telemetrySampler.SentMessageCount());
+}
+
+// Verify the messages not subscribed by the agent are not sent.
+//
+TEST(MessageVerification, VerifyTelemetrySubscription)
+{
+    // Create InternalProcessMlosContext.
+    //
+    InternalMlosContextInitializer mlosContextInitializer;
+    HRESULT hr = mlosContextInitializer.Initialize();
+    EXPECT_EQ(hr, S_OK);
+
+    InternalMlosContext mlosContext(std::move(mlosContextInitializer));
+
+    ISharedChannel& telemetryChannel = mlosContext.TelemetryChannel();
+
+    std::atomic<uint64_t> receivedPointCount(0);
+
+    ObjectDeserializationCallback::Mlos::UnitTest::Point_Callback = [&receivedPointCount](Proxy::Mlos::UnitTest::Point&&)
+        {
+            receivedPointCount++;
+        };
+
+    ObjectDeserializationCallback::Mlos::Core::TelemetrySamplingReportMessage_Callback =
+        [](Proxy::Mlos::Core::TelemetrySamplingReportMessage&&) {};
+
+    auto globalDispatchTable = GlobalDispatchTable();
+
+    std::future<bool> resultFromReader = std::async(
+        std::launch::async,
+        [&telemetryChannel, &globalDispatchTable]
+        {
+            telemetryChannel.ProcessMessages(globalDispatchTable.data(), globalDispatchTable.size());
+
+            return true;
+        });
+
+    ComponentConfig<ChannelReaderStats> componentConfig(mlosContext);
+    hr = mlosContext.RegisterComponentConfig(componentConfig);
+    EXPECT_EQ(hr, S_OK);
+
+    TelemetrySampler telemetrySampler(mlosContext);
+    hr = mlosContext.RegisterTelemetrySampler(componentConfig, telemetrySampler);
+    EXPECT_EQ(hr, S_OK);
+
+    // The shared config memory outlives the context, reset the sampling config left by the other tests.
+    //
+    Proxy::Mlos::Core::TelemetrySamplingConfig samplingConfigProxy = telemetrySampler.SamplingConfig.Proxy();
+    samplingConfigProxy.Policy() = TelemetrySamplingPolicy::None;
+    telemetrySampler.SamplingConfig.NotifySharedConfigUpdated();
+
+    const uint32_t pointTypeIndex = TypeMetadataInfo::CodegenTypeIndex<Mlos::UnitTest::Point>();
+
+    Mlos::UnitTest::Point point = { 3, 4 };
+
+    // All the message types are subscribed when the global memory region is created.
+    //
+    EXPECT_TRUE(mlosContext.IsTelemetryMessageSubscribed<Mlos::UnitTest::Point>());
+    EXPECT_TRUE(mlosContext.IsTelemetryMessageSubscribed<Mlos::UnitTest::Point3D>());
+
+    for (uint32_t i = 0; i < 10; i++)
+    {
+        mlosContext.SendTelemetryMessage(point);
+        componentConfig.SendTelemetryMessage(point);
+    }
+
+    // Unsubscribed messages are dropped before they are offered to the sampler.
+    //
+    mlosContext.SetTelemetryMessageSubscription(pointTypeIndex, false);
+    EXPECT_FALSE(mlosContext.IsTelemetryMessageSubscribed<Mlos::UnitTest::Point>());
+    EXPECT_TRUE(mlosContext.IsTelemetryMessageSubscribed<Mlos::UnitTest::Point3D>());
+
+    for (uint32_t i = 0; i < 10; i++)
+    {
+        mlosContext.SendTelemetryMessage(point);
+        componentConfig.SendTelemetryMessage(point);
+    }
+
+    EXPECT_EQ(telemetrySampler.OfferedMessageCount(), 10);
+
+    mlosContext.SetTelemetryMessageSubscription(pointTypeIndex, true);
+    EXPECT_TRUE(mlosContext.IsTelemetryMessageSubscribed<Mlos::UnitTest::Point>());
+
+    for (uint32_t i = 0; i < 5; i++)
+    {
+        mlosContext.SendTelemetryMessage(point);
+    }
+
+    while (receivedPointCount.load() < 25)
+    {
+        std::this_thread::yield();
+    }
+
+    mlosContext.TerminateTelemetryChannel();
+
+    resultFromReader.wait();
+    EXPECT_EQ(resultFromReader.get(), true);
+
+    EXPECT_EQ(receivedPointCount.load(), 25);
+}
+
+// Verify the telemetry aggregator sends the summaries of the aggregated messages.
+//
+TEST(MessageVerification, VerifyTelemetryAggregation)
+{
+    // Create InternalProcessMlosContext.
+    //
+    InternalMlosContextInitializer mlosContextInitializer;
+    HRESULT hr = mlosContextInitializer.Initialize();
+    EXPECT_EQ(hr, S_OK);
+
+    InternalMlosContext mlosContext(std::move(mlosContextInitializer));
+
+    ISharedChannel& telemetryChannel = mlosContext.TelemetryChannel();
+
+    // Totals of the received summaries, by config id.
+    //
+    struct ReceivedTotals
+    {
+        uint64_t SummaryCount;
+        uint64_t LookupCount;
+        uint64_t HitCount;
+        uint64_t TotalDurationInNanoseconds;
+        uint64_t MinDurationInNanoseconds;
+        uint64_t MaxDurationInNanoseconds;
+        uint64_t HistogramCount;
+    };
+
+    std::mutex receivedTotalsLock;
+    std::map<uint32_t, ReceivedTotals> receivedTotals;
+    std::atomic<uint64_t> receivedLookupCount(0);
+
+    ObjectDeserializationCallback::Mlos::UnitTest::CacheLookupSummary_Callback =
+        [&receivedTotalsLock, &receivedTotals, &receivedLookupCount](Proxy::Mlos::UnitTest::CacheLookupSummary&& recvSummary)
+        {
+            std::lock_guard<std::mutex> lock(receivedTotalsLock);
+
+            auto result = receivedTotals.emplace(
+                recvSummary.ConfigId(),
+                ReceivedTotals { 0, 0, 0, 0, std::numeric_limits<uint64_t>::max(), 0, 0 });
+            ReceivedTotals& totals = result.first->second;
+
+            totals.SummaryCount++;
+            totals.LookupCount += recvSummary.LookupCount();
+            totals.HitCount += recvSummary.HitCount();
+            totals.TotalDurationInNanoseconds += recvSummary.TotalDurationInNanoseconds();
+            totals.MinDurationInNanoseconds = std::min<uint64_t>(totals.MinDurationInNanoseconds, recvSummary.MinDurationInNanoseconds());
+            totals.MaxDurationInNanoseconds = std::max<uint64_t>(totals.MaxDurationInNanoseconds, recvSummary.MaxDurationInNanoseconds());
+
+            for (uint32_t i = 0; i < 16; i++)
+            {
+                totals.HistogramCount += recvSummary.DurationHistogram()[i];
+            }
+
+            receivedLookupCount += recvSummary.LookupCount();
+        };
+
+    auto globalDispatchTable = GlobalDispatchTable();
+
+    std::future<bool> resultFromReader = std::async(
+        std::launch::async,
+        [&telemetryChannel, &globalDispatchTable]
+        {
+            telemetryChannel.ProcessMessages(globalDispatchTable.data(), globalDispatchTable.size());
+
+            return true;
+        });
+
+    ComponentConfig<ChannelReaderStats> componentConfig(mlosContext);
+    componentConfig.SpinCount = 2;
+    hr = mlosContext.RegisterComponentConfig(componentConfig);
+    EXPECT_EQ(hr, S_OK);
+
+    const uint32_t configId = componentConfig.SharedConfigId();
+
+    // Count based window of 1000 messages.
+    //
+    TelemetryAggregator<Mlos::UnitTest::CacheLookupEvent, Mlos::UnitTest::CacheLookupSummary> telemetryAggregator(
+        mlosContext,
+        componentConfig,
+        0,
+        1000);
+
+    const uint32_t writerCount = 4;
+    const uint64_t messageCount = 10000;
+
+    std::vector<std::future<void>> resultsFromWriters;
+
+    for (uint32_t writerIndex = 0; writerIndex < writerCount; writerIndex++)
+    {
+        resultsFromWriters.push_back(std::async(
+            std::launch::async,
+            [&telemetryAggregator, writerIndex, messageCount]
+            {
+                for (uint64_t i = 0; i < messageCount; i++)
+                {
+                    Mlos::UnitTest::CacheLookupEvent event = { i, writerIndex * messageCount + i, static_cast<uint32_t>(i % 2) };
+                    telemetryAggregator.Accumulate(event);
+                }
+            }));
+    }
+
+    for (std::future<void>& resultFromWriter : resultsFromWriters)
+    {
+        resultFromWriter.wait();
+    }
+
+    telemetryAggregator.Flush();
+
+    // Messages accumulated after the config update are summarized separately.
+    //
+    componentConfig.NotifySharedConfigUpdated();
+
+    for (uint64_t i = 0; i < 10; i++)
+    {
+        Mlos::UnitTest::CacheLookupEvent event = { i, 5, 1 };
+        telemetryAggregator.Accumulate(event);
+    }
+
+    telemetryAggregator.Flush();
+
+    const uint64_t totalMessageCount = writerCount * messageCount + 10;
+
+    EXPECT_EQ(telemetryAggregator.AggregatedMessageCount(), totalMessageCount);
+
+    while (receivedLookupCount.load() != totalMessageCount)
+    {
+        std::this_thread::yield();
+    }
+
+    mlosContext.TerminateTelemetryChannel();
+
+    resultFromReader.wait();
+    EXPECT_EQ(resultFromReader.get(), true);
+
+    // The count based window sends far fewer summaries than the messages.
+    //
+    EXPECT_GE(telemetryAggregator.SentSummaryCount(), writerCount * messageCount / 2000);
+    EXPECT_LE(telemetryAggregator.SentSummaryCount(), writerCount * messageCount / 100);
+
+    const uint64_t durationCount = writerCount * messageCount;
+
+    ReceivedTotals& totals = receivedTotals[configId];
+    EXPECT_EQ(totals.LookupCount, durationCount);
+    EXPECT_EQ(totals.HitCount, durationCount / 2);
+    EXPECT_EQ(totals.TotalDurationInNanoseconds, durationCount * (durationCount - 1) / 2);
+    EXPECT_EQ(totals.MinDurationInNanoseconds, 0);
+    EXPECT_EQ(totals.MaxDurationInNanoseconds, durationCount - 1);
+    EXPECT_EQ(totals.HistogramCount, durationCount);
+
+    ReceivedTotals& updatedTotals = receivedTotals[configId + 1];
+    EXPECT_EQ(updatedTotals.SummaryCount, 1);
+    EXPECT_EQ(updatedTotals.LookupCount, 10);
+    EXPECT_EQ(updatedTotals.HitCount, 10);
+    EXPECT_EQ(updatedTotals.MinDurationInNanoseconds, 5);
+    EXPECT_EQ(updatedTotals.MaxDurationInNanoseconds, 5);
+}
+
+// Verify the histogram bucket boundaries of the aggregated summaries.
+//
+TEST(MessageVerification, VerifyAggregationHistogramBuckets)
+{
+    EXPECT_EQ(ObjectAggregation::HistogramBucketIndex(0, 16), 0);
+    EXPECT_EQ(ObjectAggregation::HistogramBucketIndex(-5, 16), 0);
+    EXPECT_EQ(ObjectAggregation::HistogramBucketIndex(1, 16), 1);
+    EXPECT_EQ(ObjectAggregation::HistogramBucketIndex(2, 16), 2);
+    EXPECT_EQ(ObjectAggregation::HistogramBucketIndex(3, 16), 2);
+    EXPECT_EQ(ObjectAggregation::HistogramBucketIndex(4, 16), 3);
+    EXPECT_EQ(ObjectAggregation::HistogramBucketIndex(16383, 16), 14);
+    EXPECT_EQ(ObjectAggregation::HistogramBucketIndex(16384, 16), 15);
+    EXPECT_EQ(ObjectAggregation::HistogramBucketIndex(UINT64_MAX, 16), 15);
+    EXPECT_EQ(ObjectAggregation::HistogramBucketIndex(0.5, 16), 0);
+    EXPECT_EQ(ObjectAggregation::HistogramBucketIndex(2.5, 16), 2);
+}
 }
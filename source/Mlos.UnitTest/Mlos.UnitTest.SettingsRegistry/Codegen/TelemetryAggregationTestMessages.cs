@@ -0,0 +1,67 @@
+// -----------------------------------------------------------------------
+// <copyright file="TelemetryAggregationTestMessages.cs" company="Microsoft Corporation">
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License. See LICENSE in the project root
+// for license information.
+// </copyright>
+// -----------------------------------------------------------------------
+
+using Mlos.SettingsSystem.Attributes;
+
+namespace Mlos.UnitTest
+{
+    /// <summary>
+    /// Telemetry message sent on every cache lookup.
+    /// </summary>
+    [CodegenMessage]
+    internal partial struct CacheLookupEvent
+    {
+        [ScalarSetting]
+        internal ulong Key;
+
+        [ScalarSetting]
+        internal ulong DurationInNanoseconds;
+
+        [ScalarSetting]
+        internal uint HitCount;
+    }
+
+    /// <summary>
+    /// Summary of the cache lookups aggregated in a window.
+    /// </summary>
+    [CodegenMessage]
+    [TelemetrySummary(typeof(CacheLookupEvent))]
+    internal partial class CacheLookupSummary
+    {
+        [ScalarSetting]
+        [Aggregate(AggregationKind.ConfigId)]
+        internal uint ConfigId;
+
+        [ScalarSetting]
+        [Aggregate(AggregationKind.Count)]
+        internal ulong LookupCount;
+
+        [ScalarSetting]
+        [Aggregate(AggregationKind.Sum, nameof(CacheLookupEvent.HitCount))]
+        internal ulong HitCount;
+
+        [ScalarSetting]
+        [Aggregate(AggregationKind.Sum, nameof(CacheLookupEvent.DurationInNanoseconds))]
+        internal ulong TotalDurationInNanoseconds;
+
+        [ScalarSetting]
+        [Aggregate(AggregationKind.Min, nameof(CacheLookupEvent.DurationInNanoseconds))]
+        internal ulong MinDurationInNanoseconds;
+
+        [ScalarSetting]
+        [Aggregate(AggregationKind.Max, nameof(CacheLookupEvent.DurationInNanoseconds))]
+        internal ulong MaxDurationInNanoseconds;
+
+        /// <summary>
+        /// Number of lookups in the power of two duration buckets.
+        /// </summary>
+        [Aggregate(AggregationKind.Histogram, nameof(CacheLookupEvent.DurationInNanoseconds))]
+        [FixedSizeArray(length: 16)]
+        internal readonly ulong[] DurationHistogram;
+    }
+}
@@ -14,6 +14,8 @@
 //*********************************************************************
 
 #include "stdafx.h"
+#include <chrono>
+#include <thread>
 
 template<int T>
 class TestFlatBuffer : public BytePtr
@@ -142,6 +144,74 @@ TEST(SharedChannel, VerifyChannelRestart)
     //
     sharedChannel.AdvanceFreePosition();
     EXPECT_EQ(sync.FreePosition.load(), sync.WritePosition.load());
+
+    ObjectDeserializationCallback::Mlos::UnitTest::Point_Callback = nullptr;
+}
+
+// Verify the channel drops the region acquired by the writer that failed before it published the region.
+// The reclaimed memory is not cleared, the readers must not read the stale frames after the write position.
+//
+TEST(SharedChannel, VerifyUnpublishedRegion)
+{
+    auto globalDispatchTable = GlobalDispatchTable();
+
+    // Define objects (used as a messages).
+    //
+    Mlos::UnitTest::Point point = { 13, 17 };
+
+    // Create the test channel.
+    //
+    TestFlatBuffer<128> buffer;
+    ChannelSynchronization sync = { 0 };
+    TestSharedChannel sharedChannel(sync, buffer, 128);
+
+    // Write three messages and process the first two.
+    //
+    sharedChannel.SendMessage(point);
+    sharedChannel.SendMessage(point);
+    sharedChannel.SendMessage(point);
+
+    sharedChannel.WaitAndDispatchFrame(globalDispatchTable.data(), globalDispatchTable.size());
+    sharedChannel.WaitAndDispatchFrame(globalDispatchTable.data(), globalDispatchTable.size());
+
+    // Simulate the writer failure after it acquired the region, but before it published the region.
+    // The region contains a stale copy of the first frame that looks like a completed frame.
+    //
+    memcpy(buffer.Pointer + 72, buffer.Pointer, 24);
+    *reinterpret_cast<int32_t*>(buffer.Pointer + 72) = 24;
+    sync.WritePosition.store(72 | 1);
+
+    // Simulate channel restart.
+    //
+    sharedChannel.InitializeChannel();
+
+    EXPECT_EQ(sync.WritePosition.load(), 72);
+    EXPECT_EQ(sync.FreePosition.load(), 48);
+    EXPECT_EQ(sync.ReadPosition.load(), 48);
+
+    // Last message was fully written, expect it to be processed.
+    //
+    uint32_t processedCount = 0;
+    ObjectDeserializationCallback::Mlos::UnitTest::Point_Callback = [&processedCount](Proxy::Mlos::UnitTest::Point&& recvPoint)
+        {
+            UNUSED(recvPoint);
+            ++processedCount;
+        };
+
+    sharedChannel.WaitAndDispatchFrame(globalDispatchTable.data(), globalDispatchTable.size());
+    EXPECT_EQ(processedCount, 1);
+
+    // The stale frame located at the write position is not processed.
+    //
+    sync.TerminateChannel.store(true);
+    EXPECT_FALSE(sharedChannel.WaitAndDispatchFrame(globalDispatchTable.data(), globalDispatchTable.size()));
+    EXPECT_EQ(processedCount, 1);
+    EXPECT_EQ(sync.ReadPosition.load(), 72);
+
+    sharedChannel.AdvanceFreePosition();
+    EXPECT_EQ(sync.FreePosition.load(), sync.WritePosition.load());
+
+    ObjectDeserializationCallback::Mlos::UnitTest::Point_Callback = nullptr;
 }
 
 // Verify synchronization positions.
@@ -200,6 +270,1483 @@ TEST(SharedChannel, VerifySyncPositions)
     EXPECT_EQ(sharedChannel.Sync.WritePosition, 128);
 }
 
+// Verify sending messages with a timeout.
+// If the buffer is full, the writer gives up when the timeout expires.
+//
+TEST(SharedChannel, VerifyTrySendMessage)
+{
+    auto globalDispatchTable = GlobalDispatchTable();
+
+    // Create small buffer.
+    //
+    TestFlatBuffer<128> buffer;
+    ChannelSynchronization sync = { 0 };
+    TestSharedChannel sharedChannel(sync, buffer, 128);
+
+    Mlos::UnitTest::Point point = { 13, 17 };
+
+    ObjectDeserializationCallback::Mlos::UnitTest::Point_Callback = [](Proxy::Mlos::UnitTest::Point&&) {};
+
+    // Fill the buffer.
+    //
+    EXPECT_EQ(sharedChannel.TrySendMessage(point, 0), S_OK);
+    EXPECT_EQ(sharedChannel.TrySendMessage(point, 0), S_OK);
+    EXPECT_EQ(sharedChannel.TrySendMessage(point, 0), S_OK);
+    EXPECT_EQ(sharedChannel.TrySendMessage(point, 0), S_OK);
+    EXPECT_EQ(sharedChannel.Sync.WritePosition, 96);
+
+    // There is no space left in the buffer, the reader made no progress.
+    //
+    EXPECT_EQ(sharedChannel.TrySendMessage(point, 0), E_TIMEOUT);
+    EXPECT_EQ(sharedChannel.TrySendMessage(point, 1000), E_TIMEOUT);
+    EXPECT_EQ(sharedChannel.Sync.WritePosition, 96);
+
+    // Read one message, the writer reclaims the released frame.
+    //
+    sharedChannel.WaitAndDispatchFrame(globalDispatchTable.data(), globalDispatchTable.size());
+    EXPECT_EQ(sharedChannel.TrySendMessage(point, 0), S_OK);
+    EXPECT_EQ(sharedChannel.Sync.FreePosition, 24);
+    EXPECT_EQ(sharedChannel.Sync.WritePosition, 128);
+
+    // The writer does not wait on the terminated channel.
+    //
+    sharedChannel.Sync.TerminateChannel.store(true);
+    EXPECT_EQ(sharedChannel.TrySendMessage(point, ISharedChannel::InfiniteTimeout), E_ABORT);
+}
+
+// Verify lossy channel policy.
+// When the buffer is full, the writer drops the new message or discards the oldest one, and counts the dropped messages.
+//
+TEST(SharedChannel, VerifyLossyChannelPolicy)
+{
+    using LossyTestSharedChannel = SharedChannel<LossySharedChannelPolicy<InternalSharedChannelPolicy>, SharedChannelSpinPolicy>;
+
+    auto globalDispatchTable = GlobalDispatchTable();
+
+    Mlos::UnitTest::Point point = { 13, 17 };
+    const uint32_t pointTypeIndex = TypeMetadataInfo::CodegenTypeIndex<Mlos::UnitTest::Point>();
+
+    uint32_t receivedPointCount = 0;
+
+    ObjectDeserializationCallback::Mlos::UnitTest::Point_Callback = [&receivedPointCount](Proxy::Mlos::UnitTest::Point&&)
+        {
+            ++receivedPointCount;
+        };
+
+    {
+        // Drop the newest messages.
+        //
+        TestFlatBuffer<128> buffer;
+        ChannelSynchronization sync = { 0 };
+        LossyTestSharedChannel sharedChannel(
+            sync,
+            buffer,
+            128,
+            LossySharedChannelPolicy<InternalSharedChannelPolicy>(sync, SharedChannelOverflowMode::DropNewest));
+
+        for (int i = 0; i < 4; i++)
+        {
+            sharedChannel.SendMessage(point);
+        }
+
+        EXPECT_EQ(sync.WritePosition, 96);
+
+        // There is no space left in the buffer, the message is dropped.
+        //
+        sharedChannel.SendMessage(point);
+        EXPECT_EQ(sync.WritePosition, 96);
+        EXPECT_EQ(sync.DropStats.DroppedMessageCount, 1);
+        EXPECT_EQ(sync.DropStats.DroppedMessageCountByType[pointTypeIndex], 1);
+
+        // Read one message, the next message fits into the buffer.
+        //
+        sharedChannel.WaitAndDispatchFrame(globalDispatchTable.data(), globalDispatchTable.size());
+        sharedChannel.SendMessage(point);
+        EXPECT_EQ(sync.WritePosition, 128);
+        EXPECT_EQ(sync.DropStats.DroppedMessageCount, 1);
+
+        // TrySendMessage counts the dropped message and reports the drop, not the timeout.
+        //
+        EXPECT_EQ(sharedChannel.TrySendMessage(point, 1000), E_MESSAGE_DROPPED);
+        EXPECT_EQ(sync.WritePosition, 128);
+        EXPECT_EQ(sync.DropStats.DroppedMessageCount, 2);
+        EXPECT_EQ(sync.DropStats.DroppedMessageCountByType[pointTypeIndex], 2);
+    }
+
+    receivedPointCount = 0;
+
+    {
+        // Overwrite the oldest messages.
+        //
+        TestFlatBuffer<128> buffer;
+        ChannelSynchronization sync = { 0 };
+        LossyTestSharedChannel sharedChannel(
+            sync,
+            buffer,
+            128,
+            LossySharedChannelPolicy<InternalSharedChannelPolicy>(sync, SharedChannelOverflowMode::OverwriteOldest));
+
+        for (int i = 0; i < 4; i++)
+        {
+            sharedChannel.SendMessage(point);
+        }
+
+        // The writer discards the first unread frame to make space for the new message.
+        //
+        sharedChannel.SendMessage(point);
+        EXPECT_EQ(sync.DropStats.DroppedMessageCount, 1);
+        EXPECT_EQ(sync.DropStats.DroppedMessageCountByType[pointTypeIndex], 1);
+        EXPECT_EQ(sync.FreePosition, 24);
+        EXPECT_EQ(sync.ReadPosition, 24);
+        EXPECT_EQ(sync.WritePosition, 128);
+
+        for (int i = 0; i < 4; i++)
+        {
+            sharedChannel.WaitAndDispatchFrame(globalDispatchTable.data(), globalDispatchTable.size());
+        }
+
+        EXPECT_EQ(receivedPointCount, 4);
+    }
+}
+
+// Verify sending a batch of messages.
+// All the frames from the batch are stored in a single region and received in order.
+//
+TEST(SharedChannel, VerifySendBatch)
+{
+    auto globalDispatchTable = GlobalDispatchTable();
+
+    // Create buffer large enough to store the batches in a single region (a quarter of the buffer).
+    //
+    TestFlatBuffer<512> buffer;
+    ChannelSynchronization sync = { 0 };
+    TestSharedChannel sharedChannel(sync, buffer, 512);
+
+    Mlos::UnitTest::Point point = { 13, 17 };
+    Mlos::UnitTest::Point3D point3d = { 39, 41, 43 };
+
+    // Setup callbacks to count and verify received objects.
+    //
+    uint32_t receivedPointCount = 0;
+    uint32_t receivedPoint3dCount = 0;
+
+    ObjectDeserializationCallback::Mlos::UnitTest::Point_Callback = [point, &receivedPointCount](Proxy::Mlos::UnitTest::Point&& recvPoint)
+        {
+            EXPECT_EQ(point.X, recvPoint.X());
+            EXPECT_EQ(point.Y, recvPoint.Y());
+            ++receivedPointCount;
+        };
+
+    ObjectDeserializationCallback::Mlos::UnitTest::Point3D_Callback = [point3d, &receivedPoint3dCount](Proxy::Mlos::UnitTest::Point3D&& recvPoint)
+        {
+            EXPECT_EQ(point3d.X, recvPoint.X());
+            EXPECT_EQ(point3d.Y, recvPoint.Y());
+            EXPECT_EQ(point3d.Z, recvPoint.Z());
+            ++receivedPoint3dCount;
+        };
+
+    // Send a batch of messages.
+    //
+    sharedChannel.SendBatch(point, point3d, point3d);
+    EXPECT_EQ(sharedChannel.Sync.WritePosition, 104);
+
+    // Receive all the frames from the batch.
+    //
+    for (int i = 0; i < 3; i++)
+    {
+        sharedChannel.WaitAndDispatchFrame(globalDispatchTable.data(), globalDispatchTable.size());
+    }
+
+    EXPECT_EQ(receivedPointCount, 1);
+    EXPECT_EQ(receivedPoint3dCount, 2);
+    EXPECT_EQ(sharedChannel.Sync.ReadPosition, 104);
+
+    // Move all the positions close to the end of the buffer.
+    //
+    sharedChannel.Sync.FreePosition.store(472);
+    sharedChannel.Sync.ReadPosition.store(472);
+    sharedChannel.Sync.WritePosition.store(472);
+
+    // Send another batch.
+    // The batch does not fit at the end of the buffer, the writer inserts a link frame and stores the batch at the beginning of the buffer.
+    //
+    sharedChannel.SendBatch(point, point);
+    EXPECT_EQ(sharedChannel.Sync.FreePosition, 472);
+    EXPECT_EQ(sharedChannel.Sync.WritePosition, 568);
+
+    // Receive the link frame and both messages.
+    //
+    for (int i = 0; i < 3; i++)
+    {
+        sharedChannel.WaitAndDispatchFrame(globalDispatchTable.data(), globalDispatchTable.size());
+    }
+
+    EXPECT_EQ(receivedPointCount, 3);
+    EXPECT_EQ(sharedChannel.Sync.ReadPosition, 568);
+
+    // Send an array of messages.
+    // Both frames are written to a single region.
+    //
+    Mlos::UnitTest::Point points[] = { point, point };
+    sharedChannel.SendMessages(points, 2);
+    EXPECT_EQ(sharedChannel.Sync.FreePosition, 472);
+    EXPECT_EQ(sharedChannel.Sync.WritePosition, 616);
+
+    for (int i = 0; i < 2; i++)
+    {
+        sharedChannel.WaitAndDispatchFrame(globalDispatchTable.data(), globalDispatchTable.size());
+    }
+
+    EXPECT_EQ(receivedPointCount, 5);
+    EXPECT_EQ(sharedChannel.Sync.ReadPosition, 616);
+}
+
+// Verify sending a batch larger than the buffer.
+// The batch is split into regions of at most a quarter of the buffer, the writer waits for the reader between the regions.
+//
+TEST(SharedChannel, VerifySendOversizedBatch)
+{
+    auto globalDispatchTable = GlobalDispatchTable();
+
+    // Create small buffer, each frame is larger than a quarter of the buffer.
+    //
+    TestFlatBuffer<128> buffer;
+    ChannelSynchronization sync = { 0 };
+    TestSharedChannel sharedChannel(sync, buffer, 128);
+
+    // Setup callbacks to verify the order of received objects.
+    //
+    uint32_t receivedPoint3dCount = 0;
+
+    ObjectDeserializationCallback::Mlos::UnitTest::Point3D_Callback = [&receivedPoint3dCount](Proxy::Mlos::UnitTest::Point3D&& recvPoint)
+        {
+            EXPECT_EQ(recvPoint.X(), static_cast<double>(receivedPoint3dCount));
+            ++receivedPoint3dCount;
+        };
+
+    ObjectDeserializationCallback::Mlos::Core::TerminateReaderThreadRequestMessage_Callback =
+        [&sharedChannel](Proxy::Mlos::Core::TerminateReaderThreadRequestMessage&&)
+        {
+            // Stop the read thread
+            //
+            sharedChannel.Sync.TerminateChannel.store(true);
+        };
+
+    std::future<bool> resultFromReader = std::async(
+        std::launch::async,
+        [&sharedChannel, &globalDispatchTable]
+        {
+            ChannelSettings channelSettings = { 0 };
+
+            sharedChannel.ProcessMessages(globalDispatchTable.data(), globalDispatchTable.size(), channelSettings);
+
+            return true;
+        });
+
+    // Send a batch of 6 frames (240 bytes) larger than the buffer.
+    //
+    sharedChannel.SendBatch(
+        Mlos::UnitTest::Point3D { 0, 1, 2 },
+        Mlos::UnitTest::Point3D { 1, 1, 2 },
+        Mlos::UnitTest::Point3D { 2, 1, 2 },
+        Mlos::UnitTest::Point3D { 3, 1, 2 },
+        Mlos::UnitTest::Point3D { 4, 1, 2 },
+        Mlos::UnitTest::Point3D { 5, 1, 2 });
+
+    sharedChannel.SendMessage(Mlos::Core::TerminateReaderThreadRequestMessage());
+
+    resultFromReader.wait();
+
+    EXPECT_EQ(receivedPoint3dCount, 6);
+    EXPECT_EQ(sharedChannel.Sync.ReadPosition, sharedChannel.Sync.WritePosition);
+
+    ObjectDeserializationCallback::Mlos::UnitTest::Point3D_Callback = nullptr;
+    ObjectDeserializationCallback::Mlos::Core::TerminateReaderThreadRequestMessage_Callback = nullptr;
+}
+
+// Verify batched reads.
+// Reader acquires multiple frames at once, limited by the frame count and the batch length.
+//
+TEST(SharedChannel, VerifyBatchedReads)
+{
+    auto globalDispatchTable = GlobalDispatchTable();
+
+    TestFlatBuffer<256> buffer;
+    ChannelSynchronization sync = { 0 };
+    TestSharedChannel sharedChannel(sync, buffer, 256);
+
+    Mlos::UnitTest::Point point = { 13, 17 };
+    Mlos::UnitTest::Point3D point3d = { 39, 41, 43 };
+
+    // Setup callbacks to count received objects.
+    //
+    uint32_t receivedPointCount = 0;
+    uint32_t receivedPoint3dCount = 0;
+
+    ObjectDeserializationCallback::Mlos::UnitTest::Point_Callback = [&receivedPointCount](Proxy::Mlos::UnitTest::Point&&)
+        {
+            ++receivedPointCount;
+        };
+
+    ObjectDeserializationCallback::Mlos::UnitTest::Point3D_Callback = [&receivedPoint3dCount](Proxy::Mlos::UnitTest::Point3D&&)
+        {
+            ++receivedPoint3dCount;
+        };
+
+    sharedChannel.SendMessage(point);
+    sharedChannel.SendMessage(point3d);
+    sharedChannel.SendMessage(point);
+    sharedChannel.SendMessage(point3d);
+    sharedChannel.SendMessage(point);
+    EXPECT_EQ(sharedChannel.Sync.WritePosition, 152);
+
+    // Read up to three frames.
+    //
+    sharedChannel.WaitAndDispatchFrames(globalDispatchTable.data(), globalDispatchTable.size(), 3, 0);
+    EXPECT_EQ(sharedChannel.Sync.ReadPosition, 88);
+    EXPECT_EQ(receivedPointCount, 2);
+    EXPECT_EQ(receivedPoint3dCount, 1);
+
+    // Read frames up to the batch length. The first frame is always acquired.
+    //
+    sharedChannel.WaitAndDispatchFrames(globalDispatchTable.data(), globalDispatchTable.size(), 16, 40);
+    EXPECT_EQ(sharedChannel.Sync.ReadPosition, 128);
+    EXPECT_EQ(receivedPoint3dCount, 2);
+
+    // Read the remaining frames, reader stops at the write position.
+    //
+    sharedChannel.WaitAndDispatchFrames(globalDispatchTable.data(), globalDispatchTable.size(), 16, 0);
+    EXPECT_EQ(sharedChannel.Sync.ReadPosition, 152);
+    EXPECT_EQ(receivedPointCount, 3);
+
+    // All the frames have been released.
+    //
+    sharedChannel.AdvanceFreePosition();
+    EXPECT_EQ(sharedChannel.Sync.FreePosition, 152);
+}
+
+// Verify the channel counters.
+// Readers own the reader slots, writer counters are updated on links, stalls and the occupancy high-water mark.
+//
+TEST(SharedChannel, VerifyChannelStats)
+{
+    auto globalDispatchTable = GlobalDispatchTable();
+
+    TestFlatBuffer<256> buffer;
+    ChannelSynchronization sync = { 0 };
+    TestSharedChannel sharedChannel(sync, buffer, 256);
+
+    Mlos::UnitTest::Point point = { 13, 17 };
+    Mlos::UnitTest::Point3D point3d = { 39, 41, 43 };
+
+    ObjectDeserializationCallback::Mlos::UnitTest::Point_Callback = [](Proxy::Mlos::UnitTest::Point&&) {};
+    ObjectDeserializationCallback::Mlos::UnitTest::Point3D_Callback = [](Proxy::Mlos::UnitTest::Point3D&&) {};
+
+    // Each reader acquires its own slot.
+    //
+    ChannelReaderStats* readerStats = sharedChannel.AcquireReaderStats();
+    EXPECT_EQ(readerStats, &sync.Stats.ReaderStats[0]);
+
+    ChannelReaderStats* otherReaderStats = sharedChannel.AcquireReaderStats();
+    EXPECT_EQ(otherReaderStats, &sync.Stats.ReaderStats[1]);
+
+    sharedChannel.ReleaseReaderStats(otherReaderStats);
+    EXPECT_EQ(sync.Stats.ReaderStatsSlotMask, 1);
+
+    for (int i = 0; i < 8; i++)
+    {
+        sharedChannel.SendMessage(point);
+    }
+
+    sharedChannel.SendMessage(point3d);
+    EXPECT_EQ(sharedChannel.Sync.WritePosition, 232);
+
+    sharedChannel.WaitAndDispatchFrames(globalDispatchTable.data(), globalDispatchTable.size(), 16, 0, readerStats);
+    EXPECT_EQ(readerStats->MessagesRead, 9);
+    EXPECT_EQ(readerStats->BytesRead, 232);
+
+    // The frame does not fit at the end of the buffer, the writer creates a link.
+    //
+    sharedChannel.SendMessage(point3d);
+    EXPECT_EQ(sharedChannel.Sync.WritePosition, 312);
+
+    // Find the slot used by the current thread.
+    //
+    ChannelWriterStats* writerStats = nullptr;
+
+    for (ChannelWriterStats& stats : sync.Stats.WriterStats)
+    {
+        if (stats.MaxOccupancy != 0)
+        {
+            writerStats = &stats;
+        }
+    }
+
+    ASSERT_NE(writerStats, nullptr);
+    EXPECT_EQ(writerStats->LinkFrameCount, 1);
+    EXPECT_EQ(writerStats->MaxOccupancy, 232);
+
+    // The link is counted as a read frame.
+    //
+    sharedChannel.WaitAndDispatchFrames(globalDispatchTable.data(), globalDispatchTable.size(), 16, 0, readerStats);
+    EXPECT_EQ(readerStats->MessagesRead, 11);
+    EXPECT_EQ(readerStats->BytesRead, 312);
+
+    // Fill the buffer, the writer stalls until the timeout expires.
+    //
+    while (SUCCEEDED(sharedChannel.TrySendMessage(point, 0)))
+    {
+    }
+
+    HRESULT hr = sharedChannel.TrySendMessage(point, 1000);
+    EXPECT_EQ(hr, E_TIMEOUT);
+    EXPECT_EQ(writerStats->FullBufferStallCount, 1);
+    EXPECT_GE(writerStats->FullBufferStallTimeInMicroseconds, 1000);
+
+    sharedChannel.ReleaseReaderStats(readerStats);
+    EXPECT_EQ(sync.Stats.ReaderStatsSlotMask, 0);
+}
+
+// Verify the latency histograms.
+// Frames include the send timestamp, the reader records the queueing delay and the handler duration per message type.
+//
+TEST(SharedChannel, VerifyChannelLatencyStats)
+{
+    auto globalDispatchTable = GlobalDispatchTable();
+
+    TestFlatBuffer<256> buffer;
+    ChannelSynchronization sync = { 0 };
+    sync.HasFrameTimestamps.store(true);
+
+    TestSharedChannel sharedChannel(sync, buffer, 256);
+    EXPECT_TRUE(sharedChannel.HasFrameTimestamps);
+
+    std::unique_ptr<Internal::ChannelLatencyMemoryRegion> latencyStats = std::make_unique<Internal::ChannelLatencyMemoryRegion>();
+    sharedChannel.LatencyStats = latencyStats.get();
+
+    Mlos::UnitTest::Point point = { 13, 17 };
+    Mlos::UnitTest::Point3D point3d = { 39, 41, 43 };
+
+    int pointCount = 0;
+
+    ObjectDeserializationCallback::Mlos::UnitTest::Point_Callback = [&pointCount](Proxy::Mlos::UnitTest::Point&& recvPoint)
+        {
+            EXPECT_EQ(recvPoint.X(), 13);
+            EXPECT_EQ(recvPoint.Y(), 17);
+            pointCount++;
+        };
+    ObjectDeserializationCallback::Mlos::UnitTest::Point3D_Callback = [](Proxy::Mlos::UnitTest::Point3D&& recvPoint3d)
+        {
+            EXPECT_EQ(recvPoint3d.Z(), 43);
+        };
+
+    // Each frame includes the 8 byte timestamp.
+    //
+    for (int i = 0; i < 3; i++)
+    {
+        sharedChannel.SendMessage(point);
+    }
+
+    sharedChannel.SendMessage(point3d);
+    EXPECT_EQ(sharedChannel.Sync.WritePosition, 144);
+
+    sharedChannel.WaitAndDispatchFrames(globalDispatchTable.data(), globalDispatchTable.size(), 16, 0);
+    EXPECT_EQ(pointCount, 3);
+
+    const uint32_t pointTypeIndex = TypeMetadataInfo::CodegenTypeIndex<Mlos::UnitTest::Point>();
+    const uint32_t point3dTypeIndex = TypeMetadataInfo::CodegenTypeIndex<Mlos::UnitTest::Point3D>();
+
+    const Internal::ChannelLatencyStats& pointLatencyStats = latencyStats->LatencyStatsByType[pointTypeIndex];
+    EXPECT_EQ(pointLatencyStats.QueueingDelay.Count, 3);
+    EXPECT_EQ(pointLatencyStats.HandlerDuration.Count, 3);
+    EXPECT_GT(pointLatencyStats.QueueingDelay.TotalInNanoseconds, 0);
+
+    const Internal::ChannelLatencyStats& point3dLatencyStats = latencyStats->LatencyStatsByType[point3dTypeIndex];
+    EXPECT_EQ(point3dLatencyStats.QueueingDelay.Count, 1);
+    EXPECT_EQ(point3dLatencyStats.HandlerDuration.Count, 1);
+
+    // The percentile is the upper bound of the bucket, the recorded delays are within the bucket range.
+    //
+    const uint64_t maxQueueingDelay = Internal::ChannelLatencyHistogramValueAtPercentile(pointLatencyStats.QueueingDelay, 100);
+    EXPECT_GE(maxQueueingDelay * 3, pointLatencyStats.QueueingDelay.TotalInNanoseconds.load());
+}
+
+// Verify the latency histogram buckets.
+//
+TEST(SharedChannel, VerifyChannelLatencyHistogramBuckets)
+{
+    const uint32_t bucketCount = 256;
+
+    // Small values have their own bucket, every power of two is split into 8 buckets.
+    //
+    EXPECT_EQ(Internal::ChannelLatencyHistogramBucketIndex(0, bucketCount), 0);
+    EXPECT_EQ(Internal::ChannelLatencyHistogramBucketIndex(7, bucketCount), 7);
+    EXPECT_EQ(Internal::ChannelLatencyHistogramBucketIndex(8, bucketCount), 8);
+    EXPECT_EQ(Internal::ChannelLatencyHistogramBucketIndex(15, bucketCount), 15);
+    EXPECT_EQ(Internal::ChannelLatencyHistogramBucketIndex(16, bucketCount), 16);
+    EXPECT_EQ(Internal::ChannelLatencyHistogramBucketIndex(17, bucketCount), 16);
+    EXPECT_EQ(Internal::ChannelLatencyHistogramBucketIndex(31, bucketCount), 23);
+    EXPECT_EQ(Internal::ChannelLatencyHistogramBucketIndex(std::numeric_limits<uint64_t>::max(), bucketCount), bucketCount - 1);
+
+    // Each value is within the range of its bucket.
+    //
+    for (uint64_t value : { 9ull, 100ull, 1000ull, 123456ull, 1000000000ull })
+    {
+        const uint32_t bucketIndex = Internal::ChannelLatencyHistogramBucketIndex(value, bucketCount);
+        EXPECT_LE(Internal::ChannelLatencyHistogramBucketLowerBound(bucketIndex), value);
+        EXPECT_GT(Internal::ChannelLatencyHistogramBucketLowerBound(bucketIndex + 1), value);
+    }
+
+    std::unique_ptr<Internal::ChannelLatencyHistogram> histogram = std::make_unique<Internal::ChannelLatencyHistogram>();
+    EXPECT_EQ(Internal::ChannelLatencyHistogramValueAtPercentile(*histogram, 50), 0);
+
+    for (uint64_t value = 1; value <= 100; value++)
+    {
+        Internal::RecordChannelLatency(*histogram, value * 1000);
+    }
+
+    EXPECT_EQ(histogram->Count, 100);
+    EXPECT_EQ(histogram->TotalInNanoseconds, 5050000);
+
+    // Bucket width is at most 1/8 of its lower bound.
+    //
+    const uint64_t median = Internal::ChannelLatencyHistogramValueAtPercentile(*histogram, 50);
+    EXPECT_GE(median, 50000);
+    EXPECT_LE(median, 50000 + 50000 / 8);
+
+    const uint64_t p99 = Internal::ChannelLatencyHistogramValueAtPercentile(*histogram, 99);
+    EXPECT_GE(p99, 99000);
+    EXPECT_LE(p99, 99000 + 99000 / 8);
+}
+
+// Verify the compact frame headers.
+// Frames store the length and the type index only, the reader dispatches them without the type hash check.
+// Compares the number of bytes per message with the full frame headers.
+//
+TEST(SharedChannel, VerifyCompactFrameHeaders)
+{
+    auto globalDispatchTable = GlobalDispatchTable();
+
+    TestFlatBuffer<4096> buffer;
+    ChannelSynchronization sync = { 0 };
+    TestSharedChannel sharedChannel(sync, buffer, 4096);
+    EXPECT_FALSE(sharedChannel.HasCompactFrameHeaders);
+
+    TestFlatBuffer<4096> compactBuffer;
+    ChannelSynchronization compactSync = { 0 };
+    compactSync.HasCompactFrameHeaders.store(true);
+    TestSharedChannel compactSharedChannel(compactSync, compactBuffer, 4096);
+    EXPECT_TRUE(compactSharedChannel.HasCompactFrameHeaders);
+    EXPECT_EQ(compactSharedChannel.Margin, 4096 - 8);
+
+    Mlos::UnitTest::Point point = { 13, 17 };
+    Mlos::UnitTest::CacheLookupEvent cacheLookupEvent = { 7, 1000, 1 };
+    Mlos::UnitTest::StringViewElement stringViewElement;
+    stringViewElement.Id = 5;
+    stringViewElement.String = "Test_Name9876";
+
+    int pointCount = 0;
+    int cacheLookupEventCount = 0;
+    int stringViewElementCount = 0;
+
+    ObjectDeserializationCallback::Mlos::UnitTest::Point_Callback = [&pointCount](Proxy::Mlos::UnitTest::Point&& recvPoint)
+        {
+            EXPECT_EQ(recvPoint.X(), 13);
+            EXPECT_EQ(recvPoint.Y(), 17);
+            pointCount++;
+        };
+    ObjectDeserializationCallback::Mlos::UnitTest::CacheLookupEvent_Callback =
+        [&cacheLookupEventCount](Proxy::Mlos::UnitTest::CacheLookupEvent&& recvCacheLookupEvent)
+        {
+            EXPECT_EQ(recvCacheLookupEvent.DurationInNanoseconds(), 1000);
+            cacheLookupEventCount++;
+        };
+    ObjectDeserializationCallback::Mlos::UnitTest::StringViewElement_Callback =
+        [&stringViewElementCount](Proxy::Mlos::UnitTest::StringViewElement&& recvStringViewElement)
+        {
+            StringPtr recvString = recvStringViewElement.String();
+            EXPECT_EQ(recvStringViewElement.Id(), 5);
+            EXPECT_EQ(std::string(recvString.Data, recvString.Length), "Test_Name9876");
+            stringViewElementCount++;
+        };
+
+    // Bytes per message, 8 bytes saved on each frame.
+    //
+    for (int i = 0; i < 10; i++)
+    {
+        sharedChannel.SendMessage(point);
+        compactSharedChannel.SendMessage(point);
+    }
+
+    EXPECT_EQ(sharedChannel.Sync.WritePosition / 10, sizeof(FrameHeader) + sizeof(Mlos::UnitTest::Point));
+    EXPECT_EQ(compactSharedChannel.Sync.WritePosition / 10, 8 + sizeof(Mlos::UnitTest::Point));
+
+    uint32_t writePosition = sharedChannel.Sync.WritePosition;
+    uint32_t compactWritePosition = compactSharedChannel.Sync.WritePosition;
+
+    for (int i = 0; i < 10; i++)
+    {
+        sharedChannel.SendMessage(cacheLookupEvent);
+        compactSharedChannel.SendMessage(cacheLookupEvent);
+    }
+
+    EXPECT_EQ(
+        (sharedChannel.Sync.WritePosition - writePosition) - (compactSharedChannel.Sync.WritePosition - compactWritePosition),
+        10 * 8);
+
+    // Messages with the variable length data are verified against the shorter frame.
+    //
+    sharedChannel.SendMessage(stringViewElement);
+    compactSharedChannel.SendMessage(stringViewElement);
+
+    EXPECT_EQ(sharedChannel.Sync.WritePosition - compactSharedChannel.Sync.WritePosition, 21 * 8);
+
+    compactSharedChannel.WaitAndDispatchFrames(globalDispatchTable.data(), globalDispatchTable.size(), 32, 0);
+    EXPECT_EQ(pointCount, 10);
+    EXPECT_EQ(cacheLookupEventCount, 10);
+    EXPECT_EQ(stringViewElementCount, 1);
+    EXPECT_EQ(compactSharedChannel.Sync.ReadPosition, compactSharedChannel.Sync.WritePosition);
+
+    sharedChannel.WaitAndDispatchFrames(globalDispatchTable.data(), globalDispatchTable.size(), 32, 0);
+    EXPECT_EQ(pointCount, 20);
+    EXPECT_EQ(cacheLookupEventCount, 20);
+    EXPECT_EQ(stringViewElementCount, 2);
+
+    // The frames wrap around the end of the buffer.
+    //
+    for (int i = 0; i < 1000; i++)
+    {
+        compactSharedChannel.SendMessage(point);
+        compactSharedChannel.WaitAndDispatchFrames(globalDispatchTable.data(), globalDispatchTable.size(), 32, 0);
+    }
+
+    EXPECT_EQ(pointCount, 1020);
+}
+
+// Verify the frame length of the messages without variable length fields.
+// The messages sent with the channel type and through the ISharedChannel interface use the same frames.
+//
+TEST(SharedChannel, VerifyFixedSizeFrameLength)
+{
+    static_assert(!ObjectSerialization::HasVariableData<Mlos::UnitTest::Point>(), "Point has a fixed size");
+    static_assert(!ObjectSerialization::HasVariableData<Mlos::UnitTest::Graph>(), "Graph has a fixed size");
+    static_assert(ObjectSerialization::HasVariableData<Mlos::UnitTest::StringViewElement>(), "StringViewElement has a string");
+    static_assert(ObjectSerialization::HasVariableData<Mlos::UnitTest::StringViewElements>(), "StringViewElements has nested strings");
+
+    auto globalDispatchTable = GlobalDispatchTable();
+
+    TestFlatBuffer<4096> buffer;
+    ChannelSynchronization sync = { 0 };
+    sync.HasCompactFrameHeaders.store(true);
+    sync.HasFrameTimestamps.store(true);
+    TestSharedChannel sharedChannel(sync, buffer, 4096);
+
+    std::unique_ptr<Internal::ChannelLatencyMemoryRegion> latencyStats = std::make_unique<Internal::ChannelLatencyMemoryRegion>();
+    sharedChannel.LatencyStats = latencyStats.get();
+
+    ISharedChannel& channelInterface = sharedChannel;
+
+    Mlos::UnitTest::Point3D point3d = { 13, 17, 19 };
+
+    int point3dCount = 0;
+
+    ObjectDeserializationCallback::Mlos::UnitTest::Point3D_Callback = [&point3dCount](Proxy::Mlos::UnitTest::Point3D&& recvPoint3d)
+        {
+            EXPECT_EQ(recvPoint3d.X(), 13);
+            EXPECT_EQ(recvPoint3d.Z(), 19);
+            point3dCount++;
+        };
+
+    // Compact header, payload and the timestamp.
+    //
+    const uint32_t frameLength = 8 + sizeof(Mlos::UnitTest::Point3D) + sizeof(uint64_t);
+
+    sharedChannel.SendMessage(point3d);
+    EXPECT_EQ(sharedChannel.Sync.WritePosition, frameLength);
+
+    channelInterface.SendMessage(point3d);
+    EXPECT_EQ(sharedChannel.Sync.WritePosition, 2 * frameLength);
+
+    sharedChannel.WaitAndDispatchFrame(globalDispatchTable.data(), globalDispatchTable.size());
+    sharedChannel.WaitAndDispatchFrame(globalDispatchTable.data(), globalDispatchTable.size());
+
+    EXPECT_EQ(point3dCount, 2);
+    EXPECT_EQ(sharedChannel.Sync.ReadPosition, 2 * frameLength);
+}
+
+// Verify the messages constructed in place in the channel buffer.
+// The aborted messages are skipped by the reader, the messages are aborted if they are not committed.
+// The fields which are not set are zero.
+//
+TEST(SharedChannel, VerifyEmplace)
+{
+    auto globalDispatchTable = GlobalDispatchTable();
+
+    TestFlatBuffer<512> buffer;
+    ChannelSynchronization sync = { 0 };
+    TestSharedChannel sharedChannel(sync, buffer, 512);
+
+    int graphCount = 0;
+    int point3dCount = 0;
+
+    ObjectDeserializationCallback::Mlos::UnitTest::Graph_Callback = [&graphCount](Proxy::Mlos::UnitTest::Graph&& recvGraph)
+        {
+            EXPECT_EQ(recvGraph.Points()[0].X(), 0);
+            EXPECT_EQ(recvGraph.Points()[3].X(), 3);
+            EXPECT_EQ(recvGraph.Points()[15].Y(), 15);
+            graphCount++;
+        };
+    ObjectDeserializationCallback::Mlos::UnitTest::Point3D_Callback = [&point3dCount](Proxy::Mlos::UnitTest::Point3D&& recvPoint3d)
+        {
+            EXPECT_EQ(recvPoint3d.X(), 13);
+            EXPECT_EQ(recvPoint3d.Y(), 0);
+            EXPECT_EQ(recvPoint3d.Z(), 19);
+            point3dCount++;
+        };
+
+    const uint32_t graphFrameLength = sizeof(FrameHeader) + sizeof(Mlos::UnitTest::Graph);
+
+    // Fill the message in place and commit it.
+    //
+    {
+        EmplacedMessage<Mlos::UnitTest::Graph> emplacedGraph = sharedChannel.Emplace<Mlos::UnitTest::Graph>();
+        EXPECT_TRUE(emplacedGraph.IsReserved());
+
+        for (uint32_t i = 0; i < 16; i++)
+        {
+            emplacedGraph.Message().Points()[i].X() = static_cast<float>(i);
+            emplacedGraph.Message().Points()[i].Y() = static_cast<float>(i);
+        }
+
+        // The frame is reserved, but the reader cannot see the message yet.
+        //
+        EXPECT_EQ(sharedChannel.Sync.WritePosition, graphFrameLength);
+        EXPECT_EQ(reinterpret_cast<FrameHeader*>(sharedChannel.Buffer.Pointer)->Length.load() & 1, 1);
+
+        emplacedGraph.Commit();
+        EXPECT_FALSE(emplacedGraph.IsReserved());
+    }
+
+    sharedChannel.WaitAndDispatchFrame(globalDispatchTable.data(), globalDispatchTable.size());
+    EXPECT_EQ(graphCount, 1);
+
+    // Aborted and abandoned messages are skipped by the reader.
+    //
+    {
+        EmplacedMessage<Mlos::UnitTest::Point3D> emplacedPoint3d = sharedChannel.Emplace<Mlos::UnitTest::Point3D>();
+        emplacedPoint3d.Message().X() = 1;
+        emplacedPoint3d.Abort();
+    }
+
+    {
+        EmplacedMessage<Mlos::UnitTest::Point3D> emplacedPoint3d = sharedChannel.Emplace<Mlos::UnitTest::Point3D>();
+        emplacedPoint3d.Message().X() = 1;
+    }
+
+    // The fields which are not set are zero.
+    //
+    {
+        EmplacedMessage<Mlos::UnitTest::Point3D> emplacedPoint3d = sharedChannel.Emplace<Mlos::UnitTest::Point3D>();
+        emplacedPoint3d.Message().X() = 13;
+        emplacedPoint3d.Message().Z() = 19;
+        emplacedPoint3d.Commit();
+    }
+
+    for (int i = 0; i < 3; i++)
+    {
+        sharedChannel.WaitAndDispatchFrame(globalDispatchTable.data(), globalDispatchTable.size());
+    }
+
+    EXPECT_EQ(point3dCount, 1);
+    EXPECT_EQ(sharedChannel.Sync.ReadPosition, sharedChannel.Sync.WritePosition);
+
+    // Wrap around the buffer several times, the fields which are not set are zero in the reused frames.
+    //
+    for (int i = 0; i < 100; i++)
+    {
+        EmplacedMessage<Mlos::UnitTest::Point3D> emplacedPoint3d = sharedChannel.Emplace<Mlos::UnitTest::Point3D>();
+        emplacedPoint3d.Message().X() = 13;
+        emplacedPoint3d.Message().Z() = 19;
+        emplacedPoint3d.Commit();
+
+        while (sharedChannel.Sync.ReadPosition != sharedChannel.Sync.WritePosition)
+        {
+            sharedChannel.WaitAndDispatchFrame(globalDispatchTable.data(), globalDispatchTable.size());
+        }
+    }
+
+    EXPECT_EQ(point3dCount, 101);
+
+    ObjectDeserializationCallback::Mlos::UnitTest::Graph_Callback = nullptr;
+    ObjectDeserializationCallback::Mlos::UnitTest::Point3D_Callback = nullptr;
+}
+
+// Verify the emplaced messages with 8-byte aligned fields.
+// With the compact frame headers, the payload is aligned only to sizeof(int32_t).
+//
+TEST(SharedChannel, VerifyEmplaceUnalignedPayload)
+{
+    static_assert(alignof(Mlos::UnitTest::Point3D) == sizeof(uint64_t), "Point3D has double fields");
+
+    auto globalDispatchTable = GlobalDispatchTable();
+
+    TestFlatBuffer<512> buffer;
+    ChannelSynchronization sync = { 0 };
+    sync.HasCompactFrameHeaders.store(true);
+    TestSharedChannel sharedChannel(sync, buffer, 512);
+
+    int index3dCount = 0;
+    int point3dCount = 0;
+
+    ObjectDeserializationCallback::Mlos::UnitTest::Index3D_Callback = [&index3dCount](Proxy::Mlos::UnitTest::Index3D&&)
+        {
+            index3dCount++;
+        };
+    ObjectDeserializationCallback::Mlos::UnitTest::Point3D_Callback = [&point3dCount](Proxy::Mlos::UnitTest::Point3D&& recvPoint3d)
+        {
+            EXPECT_EQ(recvPoint3d.X(), 13.5);
+            EXPECT_EQ(recvPoint3d.Y(), 0);
+            EXPECT_EQ(recvPoint3d.Z(), 19.25);
+            point3dCount++;
+        };
+
+    // Wrap around the buffer several times.
+    // Each Index3D frame (20 bytes) moves the following frame to the other 4-byte boundary of the 8-byte word.
+    //
+    for (int i = 0; i < 100; i++)
+    {
+        sharedChannel.SendMessage(Mlos::UnitTest::Index3D { 1, 2, 3 });
+
+        const uint32_t writeOffset = sharedChannel.Sync.WritePosition % 512;
+
+        {
+            EmplacedMessage<Mlos::UnitTest::Point3D> emplacedPoint3d = sharedChannel.Emplace<Mlos::UnitTest::Point3D>();
+            EXPECT_TRUE(emplacedPoint3d.IsReserved());
+
+            emplacedPoint3d.Message().X() = 13.5;
+            emplacedPoint3d.Message().Z() = 19.25;
+            emplacedPoint3d.Commit();
+        }
+
+        if (i == 0)
+        {
+            // The payload of the first emplaced message is not aligned to the field alignment.
+            //
+            EXPECT_EQ((writeOffset + 8) % sizeof(uint64_t), sizeof(uint32_t));
+        }
+
+        while (sharedChannel.Sync.ReadPosition != sharedChannel.Sync.WritePosition)
+        {
+            sharedChannel.WaitAndDispatchFrame(globalDispatchTable.data(), globalDispatchTable.size());
+        }
+    }
+
+    EXPECT_EQ(index3dCount, 100);
+    EXPECT_EQ(point3dCount, 100);
+
+    ObjectDeserializationCallback::Mlos::UnitTest::Index3D_Callback = nullptr;
+    ObjectDeserializationCallback::Mlos::UnitTest::Point3D_Callback = nullptr;
+}
+
+// Verify the messages dispatched by the worker pool.
+// The reader releases the frames while the callback is blocked, until the worker queue is full.
+// The messages of the same type are dispatched in order.
+//
+TEST(SharedChannel, VerifyDispatchWorkerPool)
+{
+    auto globalDispatchTable = GlobalDispatchTable();
+
+    TestFlatBuffer<1024> buffer;
+    ChannelSynchronization sync = { 0 };
+    TestSharedChannel sharedChannel(sync, buffer, 1024);
+
+    DispatchWorkerPool workerPool(2 /* workerCount */, 4 /* queueLength */);
+
+    std::atomic<bool> isCallbackReleased(false);
+    std::vector<float> receivedPoints;
+
+    ObjectDeserializationCallback::Mlos::UnitTest::Point_Callback =
+        [&isCallbackReleased, &receivedPoints](Proxy::Mlos::UnitTest::Point&& recvPoint)
+        {
+            while (!isCallbackReleased.load())
+            {
+                std::this_thread::yield();
+            }
+
+            receivedPoints.push_back(recvPoint.X());
+        };
+
+    std::vector<std::future<void>> workers;
+
+    for (uint32_t workerIndex = 0; workerIndex < workerPool.WorkerCount; workerIndex++)
+    {
+        workers.push_back(
+            std::async(
+                std::launch::async,
+                [&workerPool, workerIndex] { workerPool.ProcessWorkItems(workerIndex); }));
+    }
+
+    ChannelReaderStats* readerStats = sharedChannel.AcquireReaderStats();
+
+    // The queue slot is released after the callback returns, the queue holds all four messages.
+    //
+    for (int i = 0; i < 4; i++)
+    {
+        Mlos::UnitTest::Point point = { static_cast<float>(i), 0 };
+        sharedChannel.SendMessage(point);
+
+        sharedChannel.WaitAndDispatchFrames(globalDispatchTable.data(), globalDispatchTable.size(), 1, 0, readerStats, &workerPool);
+    }
+
+    EXPECT_EQ(sync.ReadPosition.load(), sync.WritePosition.load());
+    EXPECT_EQ(readerStats->MessagesRead, 4);
+    EXPECT_EQ(readerStats->DispatchStallCount, 0);
+    EXPECT_TRUE(receivedPoints.empty());
+
+    // The queue is full, the reader waits until the callback is released.
+    //
+    Mlos::UnitTest::Point point = { 4, 0 };
+    sharedChannel.SendMessage(point);
+
+    std::future<bool> reader = std::async(
+        std::launch::async,
+        [&sharedChannel, &globalDispatchTable, readerStats, &workerPool]
+        {
+            return sharedChannel.WaitAndDispatchFrames(globalDispatchTable.data(), globalDispatchTable.size(), 1, 0, readerStats, &workerPool);
+        });
+
+    while (*static_cast<volatile uint64_t*>(&readerStats->DispatchStallCount) == 0)
+    {
+        std::this_thread::yield();
+    }
+
+    isCallbackReleased.store(true);
+
+    EXPECT_TRUE(reader.get());
+    EXPECT_EQ(readerStats->DispatchStallCount, 1);
+
+    workerPool.WaitForIdle();
+    EXPECT_EQ(receivedPoints, std::vector<float>({ 0, 1, 2, 3, 4 }));
+
+    // The workers return after the pool is terminated, the reader dispatches the messages itself.
+    //
+    workerPool.Terminate();
+
+    for (std::future<void>& worker : workers)
+    {
+        worker.get();
+    }
+
+    sharedChannel.SendMessage(point);
+    sharedChannel.WaitAndDispatchFrames(globalDispatchTable.data(), globalDispatchTable.size(), 1, 0, readerStats, &workerPool);
+    EXPECT_EQ(receivedPoints.size(), 6);
+
+    EXPECT_EQ(workerPool.InvalidMessageCount(), 0);
+
+    sharedChannel.ReleaseReaderStats(readerStats);
+
+    ObjectDeserializationCallback::Mlos::UnitTest::Point_Callback = nullptr;
+}
+
+// Verify the worker pool after it has been terminated.
+// The reader dispatches the message itself only after the queued messages of the same type are dispatched.
+// The invalid messages dispatched by the workers are handled by the channel policy.
+//
+TEST(SharedChannel, VerifyDispatchWorkerPoolTerminate)
+{
+    auto globalDispatchTable = GlobalDispatchTable();
+
+    TestFlatBuffer<1024> buffer;
+    ChannelSynchronization sync = { 0 };
+    TestSharedChannel sharedChannel(sync, buffer, 1024);
+
+    std::atomic<bool> isCallbackReleased(false);
+    std::vector<float> receivedPoints;
+
+    ObjectDeserializationCallback::Mlos::UnitTest::Point_Callback =
+        [&isCallbackReleased, &receivedPoints](Proxy::Mlos::UnitTest::Point&& recvPoint)
+        {
+            while (!isCallbackReleased.load())
+            {
+                std::this_thread::yield();
+            }
+
+            receivedPoints.push_back(recvPoint.X());
+        };
+
+    {
+        DispatchWorkerPool workerPool(1 /* workerCount */, 4 /* queueLength */);
+
+        std::future<void> worker = std::async(
+            std::launch::async,
+            [&workerPool] { workerPool.ProcessWorkItems(0); });
+
+        for (int i = 0; i < 2; i++)
+        {
+            Mlos::UnitTest::Point point = { static_cast<float>(i), 0 };
+            sharedChannel.SendMessage(point);
+
+            sharedChannel.WaitAndDispatchFrames(globalDispatchTable.data(), globalDispatchTable.size(), 1, 0, nullptr, &workerPool);
+        }
+
+        // The pool is terminated while the worker holds the queued messages.
+        //
+        workerPool.Terminate();
+
+        Mlos::UnitTest::Point point = { 2, 0 };
+        sharedChannel.SendMessage(point);
+
+        std::future<bool> reader = std::async(
+            std::launch::async,
+            [&sharedChannel, &globalDispatchTable, &workerPool]
+            {
+                return sharedChannel.WaitAndDispatchFrames(globalDispatchTable.data(), globalDispatchTable.size(), 1, 0, nullptr, &workerPool);
+            });
+
+        isCallbackReleased.store(true);
+
+        EXPECT_TRUE(reader.get());
+        worker.get();
+
+        EXPECT_EQ(receivedPoints, std::vector<float>({ 0, 1, 2 }));
+    }
+
+    {
+        // No worker has been started, the reader dispatches the queued messages itself after the pool is terminated.
+        //
+        DispatchWorkerPool workerPool(1 /* workerCount */, 4 /* queueLength */);
+
+        for (int i = 3; i < 5; i++)
+        {
+            Mlos::UnitTest::Point point = { static_cast<float>(i), 0 };
+            sharedChannel.SendMessage(point);
+
+            sharedChannel.WaitAndDispatchFrames(globalDispatchTable.data(), globalDispatchTable.size(), 1, 0, nullptr, &workerPool);
+        }
+
+        EXPECT_EQ(receivedPoints.size(), 3);
+
+        workerPool.Terminate();
+
+        Mlos::UnitTest::Point point = { 5, 0 };
+        sharedChannel.SendMessage(point);
+
+        EXPECT_TRUE(sharedChannel.WaitAndDispatchFrames(globalDispatchTable.data(), globalDispatchTable.size(), 1, 0, nullptr, &workerPool));
+        EXPECT_EQ(receivedPoints, std::vector<float>({ 0, 1, 2, 3, 4, 5 }));
+    }
+
+    {
+        // The callback rejects the message, the worker reports it to the channel policy.
+        //
+        globalDispatchTable[TypeMetadataInfo::CodegenTypeIndex<Mlos::UnitTest::Point>() - 1].Callback =
+            [](BytePtr&&, int) { return false; };
+
+        DispatchWorkerPool workerPool(1 /* workerCount */, 4 /* queueLength */);
+
+        std::future<void> worker = std::async(
+            std::launch::async,
+            [&workerPool] { workerPool.ProcessWorkItems(0); });
+
+        Mlos::UnitTest::Point point = { 6, 0 };
+        sharedChannel.SendMessage(point);
+
+        sharedChannel.WaitAndDispatchFrames(globalDispatchTable.data(), globalDispatchTable.size(), 1, 0, nullptr, &workerPool);
+
+        // InternalSharedChannelPolicy throws on the invalid frame.
+        //
+        EXPECT_THROW(worker.get(), std::exception);
+        EXPECT_EQ(workerPool.InvalidMessageCount(), 1);
+    }
+
+    ObjectDeserializationCallback::Mlos::UnitTest::Point_Callback = nullptr;
+}
+
+// Verify the workers steal the messages from the queues of the other workers.
+// Only one worker is started, it dispatches the messages queued to the worker that is not running.
+//
+TEST(SharedChannel, VerifyDispatchWorkerPoolWorkStealing)
+{
+    auto globalDispatchTable = GlobalDispatchTable();
+
+    TestFlatBuffer<1024> buffer;
+    ChannelSynchronization sync = { 0 };
+    TestSharedChannel sharedChannel(sync, buffer, 1024);
+
+    DispatchWorkerPool workerPool(2 /* workerCount */, 4 /* queueLength */);
+
+    std::vector<float> receivedPoints;
+
+    ObjectDeserializationCallback::Mlos::UnitTest::Point_Callback =
+        [&receivedPoints](Proxy::Mlos::UnitTest::Point&& recvPoint)
+        {
+            receivedPoints.push_back(recvPoint.X());
+        };
+
+    // Start the worker which does not own the queue of the Point messages.
+    //
+    const uint32_t ownerWorkerIndex =
+        (TypeMetadataInfo::CodegenTypeIndex<Mlos::UnitTest::Point>() % workerPool.QueueCount) % workerPool.WorkerCount;
+
+    std::future<void> worker = std::async(
+        std::launch::async,
+        [&workerPool, ownerWorkerIndex] { workerPool.ProcessWorkItems((ownerWorkerIndex + 1) % workerPool.WorkerCount); });
+
+    for (int i = 0; i < 8; i++)
+    {
+        Mlos::UnitTest::Point point = { static_cast<float>(i), 0 };
+        sharedChannel.SendMessage(point);
+
+        sharedChannel.WaitAndDispatchFrames(globalDispatchTable.data(), globalDispatchTable.size(), 1, 0, nullptr, &workerPool);
+    }
+
+    workerPool.WaitForIdle();
+    EXPECT_EQ(receivedPoints, std::vector<float>({ 0, 1, 2, 3, 4, 5, 6, 7 }));
+
+    workerPool.Terminate();
+    worker.get();
+
+    ObjectDeserializationCallback::Mlos::UnitTest::Point_Callback = nullptr;
+}
+
+// Verify the single producer single consumer channel.
+// One writer and one reader thread, the reader receives the messages in the order they have been sent,
+// including the frames wrapped around the end of the buffer.
+//
+TEST(SharedChannel, VerifySingleProducerSingleConsumerChannel)
+{
+    auto globalDispatchTable = GlobalDispatchTable();
+
+    TestFlatBuffer<256> buffer;
+    ChannelSynchronization sync = { 0 };
+    SingleProducerSingleConsumerTestSharedChannel sharedChannel(sync, buffer, 256);
+
+    // Setup callbacks to verify the order of received objects.
+    //
+    uint32_t receivedPointCount = 0;
+
+    ObjectDeserializationCallback::Mlos::UnitTest::Point_Callback = [&receivedPointCount](Proxy::Mlos::UnitTest::Point&& recvPoint)
+        {
+            EXPECT_EQ(recvPoint.X(), static_cast<float>(receivedPointCount));
+            ++receivedPointCount;
+        };
+
+    ObjectDeserializationCallback::Mlos::Core::TerminateReaderThreadRequestMessage_Callback =
+        [&sharedChannel](Proxy::Mlos::Core::TerminateReaderThreadRequestMessage&&)
+        {
+            // Stop the read thread
+            //
+            sharedChannel.Sync.TerminateChannel.store(true);
+        };
+
+    std::future<bool> resultFromReader = std::async(
+        std::launch::async,
+        [&sharedChannel, &globalDispatchTable]
+        {
+            ChannelSettings channelSettings = { 0 };
+            channelSettings.ReaderBatchFrameCount = 4;
+
+            sharedChannel.ProcessMessages(globalDispatchTable.data(), globalDispatchTable.size(), channelSettings);
+
+            return true;
+        });
+
+    constexpr uint32_t numberOfMessages = 100 * 1000;
+
+    for (uint32_t i = 0; i < numberOfMessages; i++)
+    {
+        Mlos::UnitTest::Point point = { static_cast<float>(i), 17 };
+        sharedChannel.SendMessage(point);
+    }
+
+    sharedChannel.SendMessage(Mlos::Core::TerminateReaderThreadRequestMessage());
+
+    resultFromReader.wait();
+
+    EXPECT_EQ(receivedPointCount, numberOfMessages);
+    EXPECT_EQ(sharedChannel.Sync.ReadPosition, sharedChannel.Sync.WritePosition);
+}
+
+// Verify the positions of the channel with 64-bit positions.
+// Frames are aligned to sizeof(int64_t).
+//
+TEST(SharedChannel, VerifySyncPositions64)
+{
+    auto globalDispatchTable = GlobalDispatchTable();
+
+    // Create small buffer.
+    //
+    TestFlatBuffer<128> buffer;
+    ChannelSynchronization64 sync = { 0 };
+    TestSharedChannel64 sharedChannel(sync, buffer, 128);
+
+    Mlos::UnitTest::Point point = { 13, 17 };
+    Mlos::UnitTest::Point3D point3d = { 39, 41, 43 };
+
+    // Setup empty callbacks.
+    //
+    ObjectDeserializationCallback::Mlos::UnitTest::Point_Callback = [](Proxy::Mlos::UnitTest::Point&&) {};
+    ObjectDeserializationCallback::Mlos::UnitTest::Point3D_Callback = [](Proxy::Mlos::UnitTest::Point3D&&) {};
+
+    sharedChannel.SendMessage(point);
+    EXPECT_EQ(sharedChannel.Sync.WritePosition, 32);
+
+    sharedChannel.SendMessage(point3d);
+    EXPECT_EQ(sharedChannel.Sync.WritePosition, 80);
+
+    // Read both messages.
+    //
+    sharedChannel.WaitAndDispatchFrame(globalDispatchTable.data(), globalDispatchTable.size());
+    sharedChannel.WaitAndDispatchFrame(globalDispatchTable.data(), globalDispatchTable.size());
+    EXPECT_EQ(sharedChannel.Sync.FreePosition, 0);
+    EXPECT_EQ(sharedChannel.Sync.ReadPosition, 80);
+
+    // The frame ends at the end of the buffer. The writer reclaims the processed frames.
+    //
+    sharedChannel.SendMessage(point3d);
+    EXPECT_EQ(sharedChannel.Sync.FreePosition, 80);
+    EXPECT_EQ(sharedChannel.Sync.WritePosition, 128);
+
+    // There is no space left in the buffer, the reader made no progress.
+    //
+    EXPECT_EQ(sharedChannel.TrySendMessage(point3d, 0), S_OK);
+    EXPECT_EQ(sharedChannel.TrySendMessage(point3d, 0), E_TIMEOUT);
+
+    sharedChannel.Sync.TerminateChannel.store(true);
+    EXPECT_EQ(sharedChannel.TrySendMessage(point3d, ISharedChannel64::InfiniteTimeout), E_ABORT);
+}
+
+// Verify the channel with 64-bit positions, the positions exceed the range of uint32_t.
+//
+TEST(SharedChannel, VerifyPositionsAbove4GiB)
+{
+    auto globalDispatchTable = GlobalDispatchTable();
+
+    EXPECT_TRUE(ISharedChannel64::IsValidBufferSize(static_cast<uint64_t>(1) << 33));
+    EXPECT_FALSE(ISharedChannel64::IsValidBufferSize(static_cast<uint64_t>(3) << 32));
+
+    // Start close to the uint32_t overflow.
+    //
+    const uint64_t startPosition = (static_cast<uint64_t>(1) << 32) - 1024;
+
+    TestFlatBuffer<4096> buffer;
+    ChannelSynchronization64 sync = { 0 };
+    sync.ReadPosition.store(startPosition);
+    sync.WritePosition.store(startPosition);
+    sync.FreePosition.store(startPosition);
+
+    TestSharedChannel64 sharedChannel(sync, buffer, 4096);
+
+    // Setup callbacks to verify the order of received objects.
+    //
+    uint32_t receivedPointCount = 0;
+
+    ObjectDeserializationCallback::Mlos::UnitTest::Point_Callback = [&receivedPointCount](Proxy::Mlos::UnitTest::Point&& recvPoint)
+        {
+            EXPECT_EQ(recvPoint.X(), static_cast<float>(receivedPointCount));
+            ++receivedPointCount;
+        };
+
+    ObjectDeserializationCallback::Mlos::Core::TerminateReaderThreadRequestMessage_Callback =
+        [&sharedChannel](Proxy::Mlos::Core::TerminateReaderThreadRequestMessage&&)
+        {
+            // Stop the read thread
+            //
+            sharedChannel.Sync.TerminateChannel.store(true);
+        };
+
+    std::future<bool> resultFromReader = std::async(
+        std::launch::async,
+        [&sharedChannel, &globalDispatchTable]
+        {
+            sharedChannel.ProcessMessages(globalDispatchTable.data(), globalDispatchTable.size());
+
+            return true;
+        });
+
+    constexpr uint32_t numberOfMessages = 100 * 1000;
+
+    for (uint32_t i = 0; i < numberOfMessages; i++)
+    {
+        Mlos::UnitTest::Point point = { static_cast<float>(i), 17 };
+        sharedChannel.SendMessage(point);
+    }
+
+    sharedChannel.SendMessage(Mlos::Core::TerminateReaderThreadRequestMessage());
+
+    resultFromReader.wait();
+
+    EXPECT_EQ(receivedPointCount, numberOfMessages);
+    EXPECT_EQ(sharedChannel.Sync.ReadPosition, sharedChannel.Sync.WritePosition);
+    EXPECT_GT(sharedChannel.Sync.WritePosition, static_cast<uint64_t>(1) << 32);
+}
+
+#ifndef _WIN64
+// Verify the futex channel policy.
+// Writer sends the messages with delays, so the readers go to sleep on the futex word between the messages.
+//
+TEST(SharedChannel, VerifyFutexChannelPolicy)
+{
+    auto globalDispatchTable = GlobalDispatchTable();
+
+    TestFlatBuffer<4096> buffer;
+    ChannelSynchronization sync = { 0 };
+    FutexInterProcessSharedChannel sharedChannel(sync, buffer, 4096, FutexSharedChannelPolicy(sync));
+
+    Mlos::UnitTest::Point point = { 13, 17 };
+
+    std::atomic<uint32_t> receivedPointCount(0);
+
+    ObjectDeserializationCallback::Mlos::UnitTest::Point_Callback = [&receivedPointCount](Proxy::Mlos::UnitTest::Point&&)
+        {
+            receivedPointCount.fetch_add(1);
+        };
+
+    ObjectDeserializationCallback::Mlos::Core::TerminateReaderThreadRequestMessage_Callback =
+        [&sync](Proxy::Mlos::Core::TerminateReaderThreadRequestMessage&&)
+        {
+            sync.TerminateChannel.store(true);
+        };
+
+    std::future<bool> resultFromReader1 = std::async(
+        std::launch::async,
+        [&sharedChannel, &globalDispatchTable]
+        {
+            sharedChannel.ProcessMessages(globalDispatchTable.data(), globalDispatchTable.size());
+
+            return true;
+        });
+
+    std::future<bool> resultFromReader2 = std::async(
+        std::launch::async,
+        [&sharedChannel, &globalDispatchTable]
+        {
+            sharedChannel.ProcessMessages(globalDispatchTable.data(), globalDispatchTable.size());
+
+            return true;
+        });
+
+    constexpr uint32_t numberOfMessages = 100;
+
+    for (uint32_t i = 0; i < numberOfMessages; i++)
+    {
+        sharedChannel.SendMessage(point);
+
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    }
+
+    // Wait until the readers process all the messages and go to sleep.
+    //
+    while (receivedPointCount.load() != numberOfMessages || sync.ReaderInWaitingStateCount.load() != 2)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    // Terminate the channel, the notification wakes up all the readers.
+    //
+    sync.TerminateChannel.store(true);
+    sharedChannel.SendMessage(Mlos::Core::TerminateReaderThreadRequestMessage());
+
+    bool result =
+        resultFromReader1.get() &&
+        resultFromReader2.get();
+
+    EXPECT_TRUE(result);
+    EXPECT_EQ(receivedPointCount.load(), numberOfMessages);
+}
+#endif
+
+// Verify the context copies the spin policy thresholds when the shared config registered by the context is updated.
+//
+TEST(SharedChannel, VerifySpinPolicyConfig)
+{
+    const SharedChannelSpinPolicyConfig defaultConfig = SharedChannelSpinPolicy::CurrentConfig();
+
+    {
+        InternalMlosContextInitializer mlosContextInitializer;
+        HRESULT hr = mlosContextInitializer.Initialize();
+        EXPECT_EQ(hr, S_OK);
+
+        InternalMlosContext mlosContext(std::move(mlosContextInitializer));
+
+        // The context has registered the config, the lookup returns the shared config.
+        //
+        ComponentConfig<SharedChannelSpinPolicyConfig> spinPolicyConfig(mlosContext);
+        hr = mlosContext.RegisterComponentConfig(spinPolicyConfig);
+        EXPECT_EQ(hr, S_OK);
+        EXPECT_EQ(spinPolicyConfig.PauseSpinCount, defaultConfig.PauseSpinCount);
+
+        // Update the shared config as the agent does.
+        //
+        spinPolicyConfig.Proxy().PauseSpinCount() = 8;
+        spinPolicyConfig.Proxy().YieldCount() = 2;
+        spinPolicyConfig.NotifySharedConfigUpdated();
+
+        // The waits keep the current thresholds until the context copies the updated shared config.
+        //
+        EXPECT_EQ(SharedChannelSpinPolicy::CurrentConfig().PauseSpinCount, defaultConfig.PauseSpinCount);
+
+        mlosContext.RefreshSharedChannelSpinPolicyConfig();
+
+        SharedChannelSpinPolicy spinPolicy;
+        EXPECT_TRUE(spinPolicy.WaitForFreeSpace());
+
+        SharedChannelSpinPolicyConfig currentConfig = SharedChannelSpinPolicy::CurrentConfig();
+        EXPECT_EQ(currentConfig.PauseSpinCount, 8);
+        EXPECT_EQ(currentConfig.YieldCount, 2);
+        EXPECT_EQ(currentConfig.MaxBackoffPauseCount, defaultConfig.MaxBackoffPauseCount);
+
+        // Update the shared config again and send SharedConfigUpdatedFeedbackMessage, as the agent does.
+        // The component copies the thresholds when its feedback channel reader receives the message.
+        //
+        std::promise<void> configRefreshed;
+
+        ObjectDeserializationCallback::Mlos::Core::SharedConfigUpdatedFeedbackMessage_Callback =
+            [&mlosContext, &configRefreshed](Proxy::Mlos::Core::SharedConfigUpdatedFeedbackMessage&&)
+            {
+                mlosContext.RefreshSharedChannelSpinPolicyConfig();
+                configRefreshed.set_value();
+            };
+
+        ISharedChannel& feedbackChannel = mlosContext.FeedbackChannel();
+
+        std::future<bool> feedbackChannelReader = std::async(
+            std::launch::async,
+            [&feedbackChannel]
+            {
+                auto globalDispatchTable = GlobalDispatchTable();
+
+                feedbackChannel.ProcessMessages(globalDispatchTable.data(), globalDispatchTable.size());
+
+                return true;
+            });
+
+        spinPolicyConfig.Proxy().MaxBackoffPauseCount() = 16;
+        spinPolicyConfig.NotifySharedConfigUpdated();
+
+        Mlos::Core::SharedConfigUpdatedFeedbackMessage feedbackMsg;
+        mlosContext.SendFeedbackMessage(feedbackMsg);
+
+        configRefreshed.get_future().wait();
+
+        mlosContext.TerminateFeedbackChannel();
+        feedbackChannelReader.wait();
+
+        ObjectDeserializationCallback::Mlos::Core::SharedConfigUpdatedFeedbackMessage_Callback = nullptr;
+
+        currentConfig = SharedChannelSpinPolicy::CurrentConfig();
+        EXPECT_EQ(currentConfig.PauseSpinCount, 8);
+        EXPECT_EQ(currentConfig.MaxBackoffPauseCount, 16);
+    }
+
+    // The copied thresholds remain in use after the context is destroyed.
+    //
+    SharedChannelSpinPolicy spinPolicy;
+    EXPECT_TRUE(spinPolicy.WaitForFreeSpace());
+    EXPECT_EQ(SharedChannelSpinPolicy::CurrentConfig().PauseSpinCount, 8);
+
+    SharedChannelSpinPolicy::UpdateConfig(defaultConfig);
+}
+
 // Verify if structes containing fixed size arrays can be serialized and read by the receiver.
 //
 TEST(SharedChannel, VerifySendingReceivingArrayStruct)